@@ -283,7 +283,7 @@ wat_write_inst_imm(
     break;
   case PWASM_IMM_BLOCK:
     // write block type
-    wat_write_block_type(wat, mod, in.v_block.block_type);
+    wat_write_block_type(wat, mod, mod->blocks[in.v_block].block_type);
     break;
   case PWASM_IMM_INDEX:
   case PWASM_IMM_LANE_INDEX:
@@ -317,7 +317,7 @@ wat_write_inst_imm(
   case PWASM_IMM_V128_CONST:
     fprintf(wat->io, " i32x4");
     for (size_t i = 0; i < 4; i++) {
-      fprintf(wat->io, " 0x%08x", in.v_v128.i32[i]);
+      fprintf(wat->io, " 0x%08x", mod->v128s[in.v_v128].i32[i]);
     }
 
     break;
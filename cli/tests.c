@@ -1,5 +1,5 @@
 #include <stdlib.h>
-#include <string.h> // strlen()
+#include <string.h> // strlen(), memcpy()
 #include "tests.h"
 
 static const cli_test_t TESTS[] = {{
@@ -12,6 +12,36 @@ static const cli_test_t TESTS[] = {{
   .test   = "mods",
   .text   = "Test mod parsing with pwasm_mod_init().",
   .func   = test_init_mods,
+}, {
+  .suite  = "init",
+  .test   = "check-parallel",
+  .text   = "Test parallel mod validation with pwasm_mod_check_parallel().",
+  .func   = test_init_check_parallel,
+}, {
+  .suite  = "init",
+  .test   = "stream",
+  .text   = "Test streaming mod parsing with pwasm_mod_stream_feed().",
+  .func   = test_init_stream,
+}, {
+  .suite  = "init",
+  .test   = "no-copy",
+  .text   = "Test mod parsing with PWASM_MOD_INIT_FLAG_NO_COPY.",
+  .func   = test_init_no_copy,
+}, {
+  .suite  = "init",
+  .test   = "arena",
+  .text   = "Test mod parsing with an arena-backed memory context.",
+  .func   = test_init_arena,
+}, {
+  .suite  = "init",
+  .test   = "leb128",
+  .text   = "Test batched LEB128 decoding of large function sections.",
+  .func   = test_init_leb128,
+}, {
+  .suite  = "init",
+  .test   = "utf8",
+  .text   = "Test UTF-8 validation of long import names.",
+  .func   = test_init_utf8,
 }, {
   .suite  = "native",
   .test   = "calls",
@@ -22,11 +52,71 @@ static const cli_test_t TESTS[] = {{
   .test   = "calls",
   .text   = "Test function calls into WASM modules.",
   .func   = test_wasm_calls,
+}, {
+  .suite  = "wasm",
+  .test   = "exports",
+  .text   = "Test export lookup in modules with many exports.",
+  .func   = test_wasm_exports,
+}, {
+  .suite  = "wasm",
+  .test   = "snapshot",
+  .text   = "Test module instance snapshots.",
+  .func   = test_wasm_snapshot,
+}, {
+  .suite  = "wasm",
+  .test   = "call-indirect",
+  .text   = "Test call_indirect type and bounds checks.",
+  .func   = test_wasm_call_indirect,
+}, {
+  .suite  = "wasm",
+  .test   = "call-depth",
+  .text   = "Test interpreter call depth limit and deep recursion.",
+  .func   = test_wasm_call_depth,
 }, {
   .suite  = "aot-jit",
   .test   = "call",
   .text   = "Test DynASM AOT JIT compiler.",
   .func   = test_aot_jit,
+}, {
+  .suite  = "aot-jit",
+  .test   = "regs",
+  .text   = "Test DynASM AOT JIT compiler with the register tier.",
+  .func   = test_aot_jit_regs,
+}, {
+  .suite  = "aot-jit",
+  .test   = "guard-pages",
+  .text   = "Test DynASM AOT JIT compiler with guarded memory.",
+  .func   = test_aot_jit_guard_pages,
+}, {
+  .suite  = "aot-jit",
+  .test   = "baseline",
+  .text   = "Test DynASM AOT JIT compiler without optional CPU features.",
+  .func   = test_aot_jit_baseline,
+}, {
+  .suite  = "aot-jit",
+  .test   = "tiered",
+  .text   = "Test tiered interpreter and DynASM JIT compiler.",
+  .func   = test_aot_jit_tiered,
+}, {
+  .suite  = "aot-jit",
+  .test   = "lazy",
+  .text   = "Test DynASM JIT compiler with lazy compilation.",
+  .func   = test_aot_jit_lazy,
+}, {
+  .suite  = "aot-jit",
+  .test   = "parallel",
+  .text   = "Test DynASM AOT JIT compiler with parallel compilation.",
+  .func   = test_aot_jit_parallel,
+}, {
+  .suite  = "aot-jit",
+  .test   = "cache",
+  .text   = "Test DynASM AOT JIT compiler with the code cache.",
+  .func   = test_aot_jit_cache,
+}, {
+  .suite  = "aot-jit",
+  .test   = "br-table",
+  .text   = "Test DynASM AOT JIT compiler br_table lowering.",
+  .func   = test_aot_jit_br_table,
 }};
 
 cli_test_ctx_t cli_test_ctx_init(
@@ -95,3 +185,46 @@ void cli_each_test(
     }
   }
 }
+
+/**
+ * Write LEB128-encoded value +val+ to +dst+, and return the number of
+ * bytes written.
+ */
+size_t cli_test_leb128_encode(
+  uint8_t * const dst,
+  uint32_t val,
+  const bool is_signed
+) {
+  size_t len = 0;
+
+  while (true) {
+    const uint8_t b = val & 0x7F;
+    val >>= 7;
+
+    // done if remaining bits are zero (and, for signed values, the sign
+    // bit of this byte is clear)
+    if (!val && !(is_signed && (b & 0x40))) {
+      dst[len++] = b;
+      return len;
+    }
+
+    dst[len++] = b | 0x80;
+  }
+}
+
+/**
+ * Append section with ID +id+ and body +body+ to +dst+, and return the
+ * number of bytes written.
+ */
+size_t cli_test_append_section(
+  uint8_t * const dst,
+  const uint8_t id,
+  const uint8_t * const body,
+  const size_t body_len
+) {
+  size_t len = 0;
+  dst[len++] = id;
+  len += cli_test_leb128_encode(dst + len, body_len, false);
+  memcpy(dst + len, body, body_len);
+  return len + body_len;
+}
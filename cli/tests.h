@@ -1,6 +1,10 @@
 #ifndef CLI_TESTS_H
 #define CLI_TESTS_H
 
+#include <stdbool.h> // bool
+#include <stddef.h> // size_t
+#include <stdint.h> // uint8_t, uint32_t
+
 typedef struct cli_test_t cli_test_t;
 typedef struct cli_test_ctx_t cli_test_ctx_t;
 
@@ -53,11 +57,33 @@ void cli_each_test(
   void *
 );
 
+// module building helpers for tests which build modules in memory
+size_t cli_test_leb128_encode(uint8_t *, uint32_t, const bool);
+size_t cli_test_append_section(uint8_t *, const uint8_t, const uint8_t *, const size_t);
+
 void test_cli_null(cli_test_ctx_t *, const cli_test_t *);
 void test_init_mods(cli_test_ctx_t *, const cli_test_t *);
+void test_init_check_parallel(cli_test_ctx_t *, const cli_test_t *);
+void test_init_stream(cli_test_ctx_t *, const cli_test_t *);
+void test_init_no_copy(cli_test_ctx_t *, const cli_test_t *);
+void test_init_arena(cli_test_ctx_t *, const cli_test_t *);
+void test_init_leb128(cli_test_ctx_t *, const cli_test_t *);
+void test_init_utf8(cli_test_ctx_t *, const cli_test_t *);
 void test_native_calls(cli_test_ctx_t *, const cli_test_t *);
 void test_wasm_calls(cli_test_ctx_t *, const cli_test_t *);
+void test_wasm_exports(cli_test_ctx_t *, const cli_test_t *);
+void test_wasm_snapshot(cli_test_ctx_t *, const cli_test_t *);
+void test_wasm_call_indirect(cli_test_ctx_t *, const cli_test_t *);
+void test_wasm_call_depth(cli_test_ctx_t *, const cli_test_t *);
 void test_aot_jit(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_regs(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_guard_pages(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_baseline(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_tiered(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_lazy(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_parallel(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_cache(cli_test_ctx_t *, const cli_test_t *);
+void test_aot_jit_br_table(cli_test_ctx_t *, const cli_test_t *);
 // TODO: void test_aot_init(cli_test_ctx_t *, const cli_test_t *);
 // TODO: void test_aot_calls(cli_test_ctx_t *, const cli_test_t *);
 
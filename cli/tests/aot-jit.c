@@ -4,6 +4,8 @@
 #include <string.h> // strlen()
 #include <err.h> // errx()
 #include <math.h> // fabs()
+#include <dirent.h> // opendir()
+#include <unistd.h> // rmdir()
 #include "../tests.h"
 #include "../result-type.h"
 #include "../../pwasm.h"
@@ -5304,7 +5306,7 @@ TEST_CALLS[] = {{
   .mod      = "aot",
   .func     = "memory_grow",
   .type     = PROTO_I32_VOID,
-  .results = {{ .i32 = 1 }},
+  .results = {{ .i32 = -1 }},
 }, {
   .mod      = "aot",
   .func     = "i16x8_load8x8_s",
@@ -5654,9 +5656,13 @@ static void check_results(
   }
 }
 
-void test_aot_jit(
+static void run_aot_jit_tests(
   cli_test_ctx_t * const test_ctx,
-  const cli_test_t * const cli_test
+  const cli_test_t * const cli_test,
+  const uint64_t jit_flags,
+  const uint32_t jit_threshold,
+  const size_t jit_threads,
+  const char * const cache_dir
 ) {
   // create a memory context
   pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
@@ -5670,14 +5676,26 @@ void test_aot_jit(
 
   // init jit compiler
   pwasm_jit_t jit;
-  if (!pwasm_dynasm_jit_init(&jit, &mem_ctx)) {
+  if (!pwasm_dynasm_jit_init_with_flags(&jit, &mem_ctx, jit_flags)) {
     cli_test_error(test_ctx, "pwasm_dynasm_jit_compiler_init() failed");
     return;
   }
 
-  // get aot jit callbacks
+  // enable code cache, check for error
+  if (cache_dir && !pwasm_dynasm_jit_set_cache_dir(&jit, cache_dir)) {
+    cli_test_error(test_ctx, "pwasm_dynasm_jit_set_cache_dir() failed");
+    return;
+  }
+
+  // get aot jit (or tiered jit or parallel jit) callbacks
   pwasm_env_cbs_t cbs;
-  pwasm_aot_jit_get_cbs(&cbs, &jit);
+  if (jit_threshold > 0) {
+    pwasm_tiered_jit_get_cbs(&cbs, &jit, jit_threshold);
+  } else if (jit_threads > 0) {
+    pwasm_parallel_jit_get_cbs(&cbs, &jit, jit_threads);
+  } else {
+    pwasm_aot_jit_get_cbs(&cbs, &jit);
+  }
 
   // create aot jit environment, check for error
   pwasm_env_t env;
@@ -5753,3 +5771,454 @@ void test_aot_jit(
   pwasm_env_fini(&env);
   pwasm_jit_fini(&jit);
 }
+
+/**
+ * Call function "sum" of module "recurse" with the parameter +n+.
+ *
+ * Returns false on error.
+ */
+static bool
+recurse_call(
+  pwasm_env_t * const env,
+  const uint32_t n,
+  uint32_t * const ret_val
+) {
+  env->stack->pos = 1;
+  env->stack->ptr[0].i32 = n;
+  if (!pwasm_call(env, "recurse", "sum") || env->stack->pos != 1) {
+    return false;
+  }
+
+  *ret_val = env->stack->ptr[0].i32;
+  return true;
+}
+
+/**
+ * Run a recursive function past the end of the value stack and past
+ * the maximum call depth, and check that both calls fail cleanly.
+ *
+ * Compiled functions call each other directly, so these limits are
+ * checked by the generated code rather than by pwasm_env_call_func().
+ */
+static void
+run_aot_jit_recurse_tests(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test,
+  const uint32_t jit_threshold
+) {
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module which exports "sum", which returns the sum of the
+  // integers from 0 to the first parameter and recurses with call
+  static uint8_t wasm[256];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = { 0x01, 0x60, 0x01, 0x7F, 0x01, 0x7F };
+    static const uint8_t FUNCS[] = { 0x01, 0x00 };
+    static const uint8_t EXPORTS[] = { 0x01, 0x03, 's', 'u', 'm', 0x00, 0x00 };
+    static const uint8_t CODES[] = {
+      0x01,
+
+      // sum
+      0x15, 0x00,
+      0x20, 0x00, 0x45, // local.get 0, i32.eqz
+      0x04, 0x7F, // if (result i32)
+        0x41, 0x00, // i32.const 0
+      0x05, // else
+        0x20, 0x00, // local.get 0
+        0x20, 0x00, 0x41, 0x01, 0x6B, // local.get 0, i32.const 1, i32.sub
+        0x10, 0x00, // call 0
+        0x6A, // i32.add
+      0x0B, // end
+      0x0B,
+    };
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, FUNCS, sizeof(FUNCS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, EXPORTS, sizeof(EXPORTS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, CODES, sizeof(CODES));
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "recurse.wasm: pwasm_mod_init() failed");
+    return;
+  }
+
+  // init jit compiler
+  pwasm_jit_t jit;
+  if (!pwasm_dynasm_jit_init(&jit, &mem_ctx)) {
+    cli_test_error(test_ctx, "pwasm_dynasm_jit_init() failed");
+    return;
+  }
+
+  // value stack which is large enough to reach the call depth limit
+  static pwasm_val_t large_vals[1 << 14];
+
+  // small value stack, unlimited call depth
+  pwasm_val_t small_vals[MAX_STACK_DEPTH];
+
+  const struct {
+    const char *name;
+    pwasm_val_t *vals;
+    size_t len;
+    size_t max_depth;
+  } tests[] = {
+    { "value stack overflow", small_vals, LEN(small_vals), 0 },
+    { "call depth overflow", large_vals, LEN(large_vals), 100 },
+  };
+
+  for (size_t i = 0; i < LEN(tests); i++) {
+    char buf[512];
+
+    pwasm_stack_t stack = {
+      .ptr = tests[i].vals,
+      .len = tests[i].len,
+    };
+
+    // get aot jit (or tiered jit) callbacks, set maximum call depth
+    pwasm_env_cbs_t cbs;
+    if (jit_threshold > 0) {
+      pwasm_tiered_jit_get_cbs(&cbs, &jit, jit_threshold);
+    } else {
+      pwasm_aot_jit_get_cbs(&cbs, &jit);
+    }
+    cbs.max_call_depth = tests[i].max_depth;
+
+    // create environment, check for error
+    pwasm_env_t env;
+    if (!pwasm_env_init(&env, &mem_ctx, &cbs, &stack, NULL)) {
+      cli_test_error(test_ctx, "pwasm_env_init() failed");
+      return;
+    }
+
+    // add mod to env, check for error
+    if (!pwasm_env_add_mod(&env, "recurse", &mod)) {
+      cli_test_error(test_ctx, "recurse: pwasm_env_add_mod() failed");
+      return;
+    }
+
+    // recurse within the limits, then (effectively) without bound
+    uint32_t a = 0, b = 0, val;
+    const bool limit_ok = (
+      recurse_call(&env, 20, &a) && (a == 210) &&
+      !recurse_call(&env, 0xFFFFFFFF, &val)
+    );
+
+    snprintf(buf, sizeof(buf), "recurse: %s: fail unbounded recursion", tests[i].name);
+    if (limit_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // check that the environment is still usable
+    const bool after_ok = (
+      (env.call_depth == 0) &&
+      recurse_call(&env, 10, &b) && (b == 55)
+    );
+
+    snprintf(buf, sizeof(buf), "recurse: %s: call after failure", tests[i].name);
+    if (after_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // finalize environment
+    pwasm_env_fini(&env);
+  }
+
+  // finalize jit and mod
+  pwasm_jit_fini(&jit);
+  pwasm_mod_fini(&mod);
+}
+
+void test_aot_jit(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  run_aot_jit_tests(test_ctx, cli_test, 0, 0, 0, NULL);
+  run_aot_jit_recurse_tests(test_ctx, cli_test, 0);
+}
+
+void test_aot_jit_regs(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  run_aot_jit_tests(test_ctx, cli_test, PWASM_DYNASM_JIT_FLAG_REGS, 0, 0, NULL);
+}
+
+void test_aot_jit_guard_pages(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  run_aot_jit_tests(test_ctx, cli_test, PWASM_DYNASM_JIT_FLAG_GUARD_PAGES, 0, 0, NULL);
+}
+
+void test_aot_jit_baseline(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // ignore cpu features, emulate instructions which need them
+  run_aot_jit_tests(test_ctx, cli_test, PWASM_DYNASM_JIT_FLAG_BASELINE, 0, 0, NULL);
+}
+
+void test_aot_jit_tiered(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // use a low threshold so that both tiers are exercised
+  run_aot_jit_tests(test_ctx, cli_test, 0, 2, 0, NULL);
+  run_aot_jit_recurse_tests(test_ctx, cli_test, 2);
+}
+
+void test_aot_jit_lazy(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // compile functions on first call
+  run_aot_jit_tests(test_ctx, cli_test, 0, 1, 0, NULL);
+}
+
+void test_aot_jit_parallel(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // compile functions on several threads
+  run_aot_jit_tests(test_ctx, cli_test, 0, 0, 4, NULL);
+}
+
+void test_aot_jit_cache(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // create temporary cache directory
+  char dir[] = "/tmp/pwasm-jit-cache-XXXXXX";
+  if (!mkdtemp(dir)) {
+    cli_test_error(test_ctx, "mkdtemp() failed");
+    return;
+  }
+
+  // populate code cache, then run again from code cache
+  run_aot_jit_tests(test_ctx, cli_test, 0, 0, 0, dir);
+  run_aot_jit_tests(test_ctx, cli_test, 0, 0, 0, dir);
+
+  // remove cache files
+  DIR * const dh = opendir(dir);
+  if (dh) {
+    struct dirent *de;
+    while ((de = readdir(dh))) {
+      if (de->d_name[0] != '.') {
+        char path[sizeof(dir) + 256];
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        unlink(path);
+      }
+    }
+
+    closedir(dh);
+  }
+
+  // remove cache directory
+  rmdir(dir);
+}
+
+/**
+ * Append body of a function which dispatches its i32 parameter through
+ * a br_table with the given depths (the last depth is the default).
+ *
+ * The branch targets are nested blocks.  Each block end increments the
+ * result, so the function returns `num_blocks - depth` for the taken
+ * branch.
+ *
+ * Returns the number of bytes written.
+ */
+static size_t
+br_table_append_func(
+  uint8_t * const dst,
+  const uint8_t * const depths,
+  const size_t num_depths,
+  const size_t num_blocks
+) {
+  static uint8_t body[1024];
+  size_t len = 0;
+
+  // one i32 local (result)
+  body[len++] = 0x01;
+  body[len++] = 0x01;
+  body[len++] = 0x7F;
+
+  // open blocks
+  for (size_t i = 0; i < num_blocks; i++) {
+    body[len++] = 0x02;
+    body[len++] = 0x40;
+  }
+
+  // local.get 0, br_table
+  body[len++] = 0x20;
+  body[len++] = 0x00;
+  body[len++] = 0x0E;
+  len += cli_test_leb128_encode(body + len, num_depths - 1, false);
+  memcpy(body + len, depths, num_depths);
+  len += num_depths;
+
+  // close blocks, increment result after each block
+  for (size_t i = 0; i < num_blocks; i++) {
+    static const uint8_t INC[] = { 0x0B, 0x20, 0x01, 0x41, 0x01, 0x6A, 0x21, 0x01 };
+    memcpy(body + len, INC, sizeof(INC));
+    len += sizeof(INC);
+  }
+
+  // local.get 1, end
+  body[len++] = 0x20;
+  body[len++] = 0x01;
+  body[len++] = 0x0B;
+
+  // write size and body
+  const size_t size_len = cli_test_leb128_encode(dst, len, false);
+  memcpy(dst + size_len, body, len);
+  return size_len + len;
+}
+
+// number of entries in the dense br_table test
+#define BR_TABLE_NUM_DENSE 32
+
+// number of entries in the sparse br_table test
+#define BR_TABLE_NUM_SPARSE 64
+
+void test_aot_jit_br_table(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  char buf[512];
+
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with the following functions:
+  // * dense: br_table with a distinct target for each index (lowered
+  //   to a jump table)
+  // * sparse: br_table where most indices use the default target
+  //   (lowered to a binary search)
+  static uint8_t wasm[4096];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = { 0x01, 0x60, 0x01, 0x7F, 0x01, 0x7F };
+    static const uint8_t FUNCS[] = { 0x02, 0x00, 0x00 };
+    static const uint8_t EXPORTS[] = {
+      0x02,
+      0x05, 'd', 'e', 'n', 's', 'e', 0x00, 0x00,
+      0x06, 's', 'p', 'a', 'r', 's', 'e', 0x00, 0x01,
+    };
+
+    // dense: index i branches to depth i, default is depth
+    // BR_TABLE_NUM_DENSE
+    uint8_t dense[BR_TABLE_NUM_DENSE + 1];
+    for (size_t i = 0; i < LEN(dense); i++) {
+      dense[i] = i;
+    }
+
+    // sparse: index 5 branches to depth 0, indices 40-47 branch to
+    // depth 1, everything else is depth 2
+    uint8_t sparse[BR_TABLE_NUM_SPARSE + 1];
+    for (size_t i = 0; i < LEN(sparse); i++) {
+      sparse[i] = (i == 5) ? 0 : ((i >= 40 && i < 48) ? 1 : 2);
+    }
+
+    static uint8_t codes[2048];
+    size_t codes_len = 0;
+    codes[codes_len++] = 0x02;
+    codes_len += br_table_append_func(codes + codes_len, dense, LEN(dense), BR_TABLE_NUM_DENSE + 1);
+    codes_len += br_table_append_func(codes + codes_len, sparse, LEN(sparse), 3);
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, FUNCS, sizeof(FUNCS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, EXPORTS, sizeof(EXPORTS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, codes, codes_len);
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "br_table.wasm: pwasm_mod_init() failed");
+    return;
+  }
+
+  // set up stack
+  pwasm_val_t stack_vals[MAX_STACK_DEPTH];
+  pwasm_stack_t stack = {
+    .ptr = stack_vals,
+    .len = MAX_STACK_DEPTH,
+  };
+
+  // init jit compiler
+  pwasm_jit_t jit;
+  if (!pwasm_dynasm_jit_init(&jit, &mem_ctx)) {
+    cli_test_error(test_ctx, "pwasm_dynasm_jit_init() failed");
+    return;
+  }
+
+  // create aot jit environment, check for error
+  pwasm_env_cbs_t cbs;
+  pwasm_aot_jit_get_cbs(&cbs, &jit);
+  pwasm_env_t env;
+  if (!pwasm_env_init(&env, &mem_ctx, &cbs, &stack, NULL)) {
+    cli_test_error(test_ctx, "pwasm_env_init() failed");
+    return;
+  }
+
+  // add mod to env, check for error
+  if (!pwasm_env_add_mod(&env, "br_table", &mod)) {
+    cli_test_error(test_ctx, "br_table: pwasm_env_add_mod() failed");
+    return;
+  }
+
+  // indices to test (including out of range and negative indices)
+  static const uint32_t INDICES[] = {
+    0, 1, 4, 5, 6, 17, 31, 32, 39, 40, 47, 48, 63, 64, 65, 1000, 0xFFFFFFFF,
+  };
+
+  for (size_t i = 0; i < LEN(INDICES); i++) {
+    const uint32_t index = INDICES[i];
+
+    // get expected results
+    const uint32_t dense_exp = BR_TABLE_NUM_DENSE + 1 - ((index < BR_TABLE_NUM_DENSE) ? index : BR_TABLE_NUM_DENSE);
+    const uint32_t sparse_exp = 3 - ((index == 5) ? 0 : ((index >= 40 && index < 48) ? 1 : 2));
+
+    const struct {
+      const char *name;
+      uint32_t exp;
+    } calls[] = {
+      { "dense", dense_exp },
+      { "sparse", sparse_exp },
+    };
+
+    for (size_t j = 0; j < LEN(calls); j++) {
+      // call function
+      stack.ptr[0].i32 = index;
+      stack.pos = 1;
+      const bool ok = pwasm_call(&env, "br_table", calls[j].name);
+
+      // check result
+      snprintf(buf, sizeof(buf), "%s(%u)", calls[j].name, index);
+      if (ok && stack.pos == 1 && stack.ptr[0].i32 == calls[j].exp) {
+        cli_test_pass(test_ctx, cli_test, buf);
+      } else {
+        cli_test_fail(test_ctx, cli_test, buf);
+      }
+    }
+  }
+
+  // finalize environment, jit, and mod
+  pwasm_env_fini(&env);
+  pwasm_jit_fini(&jit);
+  pwasm_mod_fini(&mod);
+}
@@ -1,9 +1,11 @@
 #include <stdbool.h> // bool
 #include <stdint.h> // size_t
+#include <string.h> // memcpy()
 #include "../tests.h"
 #include "../../pwasm.h"
 
 #define LEN(ary) (sizeof(ary) / sizeof(ary[0]))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
 
 typedef struct {
   char *name;
@@ -444,3 +446,314 @@ void test_init_mods(
     pwasm_mod_fini(&mod);
   }
 }
+
+void test_init_check_parallel(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  const pwasm_mod_check_cbs_t cbs = {
+    .on_error = mem_ctx.cbs->on_error,
+  };
+
+  for (size_t i = 0; i < LEN(TESTS); i++) {
+    // get test, skip invalid mods
+    const init_test_t test = TESTS[i];
+    if (!test.want) {
+      continue;
+    }
+
+    // parse mod
+    pwasm_mod_t mod;
+    const pwasm_buf_t buf = { DATA + test.ofs, test.len };
+    if (!pwasm_mod_init(&mem_ctx, &mod, buf)) {
+      cli_test_fail(test_ctx, cli_test, test.name);
+      continue;
+    }
+
+    // re-check mod with several worker threads
+    if (pwasm_mod_check_parallel(&mod, &cbs, mem_ctx.cb_data, 4)) {
+      cli_test_pass(test_ctx, cli_test, test.name);
+    } else {
+      cli_test_fail(test_ctx, cli_test, test.name);
+    }
+
+    // free mod
+    pwasm_mod_fini(&mod);
+  }
+}
+
+void test_init_stream(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  for (size_t i = 0; i < LEN(TESTS); i++) {
+    // get test
+    const init_test_t test = TESTS[i];
+
+    // init streaming loader, check for error
+    pwasm_mod_stream_t stream;
+    if (!pwasm_mod_stream_init(&stream, &mem_ctx, 2)) {
+      cli_test_fail(test_ctx, cli_test, test.name);
+      continue;
+    }
+
+    // feed source in chunks of 1, 2, 3, ... bytes so that headers and
+    // sections are split at every offset
+    bool ok = true;
+    for (size_t ofs = 0, len = 1; ok && ofs < test.len; ofs += len, len++) {
+      const pwasm_buf_t buf = { DATA + test.ofs + ofs, MIN(len, test.len - ofs) };
+      ok = pwasm_mod_stream_feed(&stream, buf);
+    }
+
+    // finish stream, get result
+    pwasm_mod_t mod;
+    const size_t len = ok ? pwasm_mod_stream_finish(&stream, &mod) : 0;
+
+    // check test result
+    if ((len > 0) == test.want) {
+      cli_test_pass(test_ctx, cli_test, test.name);
+    } else {
+      cli_test_fail(test_ctx, cli_test, test.name);
+    }
+
+    if (len > 0) {
+      // free mod
+      pwasm_mod_fini(&mod);
+    }
+
+    // free streaming loader
+    pwasm_mod_stream_fini(&stream);
+  }
+}
+
+void test_init_no_copy(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  for (size_t i = 0; i < LEN(TESTS); i++) {
+    // get test, build source buffer
+    const init_test_t test = TESTS[i];
+    const pwasm_buf_t buf = { DATA + test.ofs, test.len };
+
+    // parse mod without copying bytes, get result
+    pwasm_mod_t mod;
+    const size_t len = pwasm_mod_init_with_flags(&mem_ctx, &mod, buf, PWASM_MOD_INIT_FLAG_NO_COPY);
+
+    // check test result (valid mods must refer to the source buffer)
+    const bool refs_src = (len > 0) && (mod.bytes == buf.ptr);
+    if ((len > 0) == test.want && (!len || refs_src)) {
+      cli_test_pass(test_ctx, cli_test, test.name);
+    } else {
+      cli_test_fail(test_ctx, cli_test, test.name);
+    }
+
+    // free mod
+    pwasm_mod_fini(&mod);
+  }
+}
+
+void test_init_arena(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init parent mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  for (size_t i = 0; i < LEN(TESTS); i++) {
+    // get test, build source buffer
+    const init_test_t test = TESTS[i];
+    const pwasm_buf_t buf = { DATA + test.ofs, test.len };
+
+    // init arena with a tiny block size to exercise block chaining
+    pwasm_arena_t arena;
+    pwasm_arena_init(&arena, &mem_ctx, 64);
+    pwasm_mem_ctx_t arena_mem_ctx = pwasm_arena_get_mem_ctx(&arena);
+
+    // init builder, pre-size vectors from section headers
+    pwasm_builder_t builder;
+    const bool reserved = (
+      pwasm_builder_init(&arena_mem_ctx, &builder) &&
+      pwasm_builder_reserve(&builder, buf)
+    );
+    pwasm_builder_fini(&builder);
+
+    // parse mod from arena, get result
+    pwasm_mod_t mod;
+    const size_t len = pwasm_mod_init(&arena_mem_ctx, &mod, buf);
+
+    // check test result
+    if (reserved && (len > 0) == test.want) {
+      cli_test_pass(test_ctx, cli_test, test.name);
+    } else {
+      cli_test_fail(test_ctx, cli_test, test.name);
+    }
+
+    // free mod and arena
+    pwasm_mod_fini(&mod);
+    pwasm_arena_fini(&arena);
+  }
+}
+
+// number of function types and functions in the leb128 test module
+#define LEB128_NUM_TYPES 200
+#define LEB128_NUM_FUNCS 300
+
+void test_init_leb128(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with enough types that function type indices mix
+  // single-byte and multi-byte values
+  static uint8_t buf[4096];
+  size_t len = 0, funcs_ofs = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    memcpy(buf, HEADER, sizeof(HEADER));
+    len += sizeof(HEADER);
+
+    // section bodies
+    uint8_t types[1024], funcs[1024], codes[1024];
+    size_t types_len = cli_test_leb128_encode(types, LEB128_NUM_TYPES, false);
+    size_t funcs_len = cli_test_leb128_encode(funcs, LEB128_NUM_FUNCS, false);
+    size_t codes_len = cli_test_leb128_encode(codes, LEB128_NUM_FUNCS, false);
+
+    for (size_t i = 0; i < LEB128_NUM_TYPES; i++) {
+      // () -> ()
+      types[types_len++] = 0x60;
+      types[types_len++] = 0x00;
+      types[types_len++] = 0x00;
+    }
+
+    for (size_t i = 0; i < LEB128_NUM_FUNCS; i++) {
+      funcs_len += cli_test_leb128_encode(funcs + funcs_len, i % LEB128_NUM_TYPES, false);
+
+      // body size, no locals, end
+      codes[codes_len++] = 0x02;
+      codes[codes_len++] = 0x00;
+      codes[codes_len++] = 0x0b;
+    }
+
+    // append sections
+    const struct { uint8_t id; const uint8_t *ptr; size_t len; } sections[] = {
+      { 1, types, types_len },
+      { 3, funcs, funcs_len },
+      { 10, codes, codes_len },
+    };
+
+    for (size_t i = 0; i < LEN(sections); i++) {
+      funcs_ofs = (sections[i].id == 3) ? len : funcs_ofs;
+      len += cli_test_append_section(buf + len, sections[i].id, sections[i].ptr, sections[i].len);
+    }
+  }
+
+  {
+    // parse mod, check function type indices
+    pwasm_mod_t mod;
+    bool ok = pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { buf, len }) && (mod.num_funcs == LEB128_NUM_FUNCS);
+    for (size_t i = 0; ok && i < LEB128_NUM_FUNCS; i++) {
+      ok = (mod.funcs[i] == i % LEB128_NUM_TYPES);
+    }
+
+    // check test result
+    if (ok) {
+      cli_test_pass(test_ctx, cli_test, "leb128 funcs");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "leb128 funcs");
+    }
+
+    // free mod
+    pwasm_mod_fini(&mod);
+  }
+
+  {
+    // truncate module in the middle of the function section
+    const size_t trunc_len = funcs_ofs + 150;
+
+    // parse truncated mod, check for failure
+    pwasm_mod_t mod;
+    if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { buf, trunc_len })) {
+      cli_test_pass(test_ctx, cli_test, "leb128 truncated funcs");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "leb128 truncated funcs");
+    }
+
+    // free mod
+    pwasm_mod_fini(&mod);
+  }
+}
+
+void test_init_utf8(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // init mem ctx
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // import names longer than one scan block, with non-ASCII bytes at
+  // block boundaries and after runs of ASCII bytes
+  static const struct {
+    const char *name;
+    const bool want;
+    const char *val;
+  } TESTS[] = {
+    { "utf8: ascii",                 true,  "abcdefghijklmnopqrstuvwxyz0123456789" },
+    { "utf8: 2-byte after block",    true,  "abcdefghijklmnop\xc3\xa9qrstuvwxyz" },
+    { "utf8: 2-byte across block",   true,  "abcdefghijklmno\xc3\xa9pqrstuvwxyz" },
+    { "utf8: 4-byte at end",         true,  "abcdefghijklmnopq\xf0\x9f\x98\x80" },
+    { "utf8: bad lead byte",         false, "abcdefghijklmnopqrst\xffuvwxyz" },
+    { "utf8: bad continuation byte", false, "abcdefghijklmnopqrst\xc3\x41uvwxyz" },
+    { "utf8: truncated at end",      false, "abcdefghijklmnopqrstuvwxyz\xe2\x82" },
+  };
+
+  for (size_t i = 0; i < LEN(TESTS); i++) {
+    // header and type section: () -> ()
+    static const uint8_t HEAD[] = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00,
+      0x01, 0x04, 0x01, 0x60, 0x00, 0x00,
+    };
+    const size_t name_len = strlen(TESTS[i].val);
+
+    // build module which imports function "m" "<val>" (all lengths are
+    // less than 128, so they fit in a single byte)
+    uint8_t buf[128];
+    size_t len = 0;
+    memcpy(buf, HEAD, sizeof(HEAD));
+    len += sizeof(HEAD);
+    buf[len++] = 0x02; // import section
+    buf[len++] = name_len + 6;
+    buf[len++] = 0x01; // count
+    buf[len++] = 0x01; // module name
+    buf[len++] = 'm';
+    buf[len++] = name_len; // entry name
+    memcpy(buf + len, TESTS[i].val, name_len);
+    len += name_len;
+    buf[len++] = 0x00; // func
+    buf[len++] = 0x00; // type index
+
+    // parse mod, get result
+    pwasm_mod_t mod;
+    const bool ok = pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { buf, len }) > 0;
+
+    // check test result
+    if (ok == TESTS[i].want) {
+      cli_test_pass(test_ctx, cli_test, TESTS[i].name);
+    } else {
+      cli_test_fail(test_ctx, cli_test, TESTS[i].name);
+    }
+
+    // free mod
+    pwasm_mod_fini(&mod);
+  }
+}
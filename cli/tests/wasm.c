@@ -10907,3 +10907,737 @@ void test_wasm_calls(
   // finalize environment
   pwasm_env_fini(&env);
 }
+
+// number of exported functions in the exports test module
+#define EXPORTS_NUM_FUNCS 300
+
+void test_wasm_exports(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  char buf[1024];
+
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with EXPORTS_NUM_FUNCS functions; function "fN" returns
+  // N as an i32
+  static uint8_t wasm[16384];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = { 0x01, 0x60, 0x00, 0x01, 0x7F };
+    static uint8_t funcs[1024], exports[8192], codes[4096];
+    size_t funcs_len = cli_test_leb128_encode(funcs, EXPORTS_NUM_FUNCS, false);
+    size_t exports_len = cli_test_leb128_encode(exports, EXPORTS_NUM_FUNCS, false);
+    size_t codes_len = cli_test_leb128_encode(codes, EXPORTS_NUM_FUNCS, false);
+
+    for (size_t i = 0; i < EXPORTS_NUM_FUNCS; i++) {
+      // function type
+      funcs[funcs_len++] = 0x00;
+
+      // export name, export type, function index
+      const int name_len = snprintf(buf, sizeof(buf), "f%zu", i);
+      exports[exports_len++] = name_len;
+      memcpy(exports + exports_len, buf, name_len);
+      exports_len += name_len;
+      exports[exports_len++] = 0x00;
+      exports_len += cli_test_leb128_encode(exports + exports_len, i, false);
+
+      // body: no locals, i32.const i, end
+      uint8_t body[8];
+      size_t body_len = 0;
+      body[body_len++] = 0x00;
+      body[body_len++] = 0x41;
+      body_len += cli_test_leb128_encode(body + body_len, i, true);
+      body[body_len++] = 0x0B;
+      codes_len += cli_test_leb128_encode(codes + codes_len, body_len, false);
+      memcpy(codes + codes_len, body, body_len);
+      codes_len += body_len;
+    }
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, funcs, funcs_len);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, exports, exports_len);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, codes, codes_len);
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "exports.wasm: pwasm_mod_init() failed");
+  }
+
+  // set up stack
+  pwasm_val_t stack_vals[MAX_STACK_DEPTH];
+  pwasm_stack_t stack = {
+    .ptr = stack_vals,
+    .len = MAX_STACK_DEPTH,
+  };
+
+  // create environment, check for error
+  pwasm_env_t env;
+  if (!pwasm_env_init(&env, &mem_ctx, pwasm_new_interpreter_get_cbs(), &stack, NULL)) {
+    cli_test_error(test_ctx, "pwasm_env_init() failed");
+  }
+
+  // add mod to env, check for error
+  if (!pwasm_env_add_mod(&env, "exports", &mod)) {
+    cli_test_error(test_ctx, "exports: pwasm_env_add_mod() failed");
+  }
+
+  // find and call every export (in reverse order), check results
+  bool ok = true;
+  for (size_t i = EXPORTS_NUM_FUNCS; ok && i > 0; i--) {
+    snprintf(buf, sizeof(buf), "f%zu", i - 1);
+    stack.pos = 0;
+    ok = pwasm_call(&env, "exports", buf) && (stack.pos == 1) && (stack.ptr[0].i32 == i - 1);
+  }
+
+  if (ok) {
+    cli_test_pass(test_ctx, cli_test, "find and call exports");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "find and call exports");
+  }
+
+  // check unknown names and export types
+  const bool missing_ok = (
+    !pwasm_find_func(&env, "exports", "f300") &&
+    !pwasm_find_func(&env, "exports", "f") &&
+    !pwasm_find_func(&env, "exports", "") &&
+    !pwasm_get_mem(&env, "exports", "f0")
+  );
+
+  if (missing_ok) {
+    cli_test_pass(test_ctx, cli_test, "missing exports");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "missing exports");
+  }
+
+  // finalize environment, free mod
+  pwasm_env_fini(&env);
+  pwasm_mod_fini(&mod);
+}
+
+/**
+ * Call function +func+ of module "snapshot" and return the result in
+ * +ret_val+.
+ *
+ * Returns false on error.
+ */
+static bool
+snapshot_call(
+  pwasm_env_t * const env,
+  const char * const func,
+  uint32_t * const ret_val
+) {
+  env->stack->pos = 0;
+  if (!pwasm_call(env, "snapshot", func)) {
+    return false;
+  }
+
+  if (ret_val) {
+    *ret_val = (env->stack->pos == 1) ? env->stack->ptr[0].i32 : (uint32_t) -1;
+  }
+
+  return true;
+}
+
+void test_wasm_snapshot(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with one memory (initial byte 42), one mutable global
+  // (initial value 7), and the following functions:
+  // * bump: increment global, store 99 to byte 0, grow memory by 1 page
+  // * get: return global value
+  // * load: return byte 0 of memory
+  // * size: return memory size, in pages
+  static uint8_t wasm[512];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = { 0x02, 0x60, 0x00, 0x00, 0x60, 0x00, 0x01, 0x7F };
+    static const uint8_t FUNCS[] = { 0x04, 0x00, 0x01, 0x01, 0x01 };
+    static const uint8_t MEMS[] = { 0x01, 0x00, 0x01 };
+    static const uint8_t GLOBALS[] = { 0x01, 0x7F, 0x01, 0x41, 0x07, 0x0B };
+    static const uint8_t EXPORTS[] = {
+      0x04,
+      0x04, 'b', 'u', 'm', 'p', 0x00, 0x00,
+      0x03, 'g', 'e', 't', 0x00, 0x01,
+      0x04, 'l', 'o', 'a', 'd', 0x00, 0x02,
+      0x04, 's', 'i', 'z', 'e', 0x00, 0x03,
+    };
+    static const uint8_t CODES[] = {
+      0x04,
+
+      // bump
+      0x14, 0x00,
+      0x23, 0x00, 0x41, 0x01, 0x6A, 0x24, 0x00, // global.set 0 (global.get 0 + 1)
+      0x41, 0x00, 0x41, 0xE3, 0x00, 0x3A, 0x00, 0x00, // i32.store8 0 99
+      0x41, 0x01, 0x40, 0x00, 0x1A, // memory.grow 1, drop
+      0x0B,
+
+      // get
+      0x04, 0x00, 0x23, 0x00, 0x0B,
+
+      // load
+      0x07, 0x00, 0x41, 0x00, 0x2D, 0x00, 0x00, 0x0B,
+
+      // size
+      0x04, 0x00, 0x3F, 0x00, 0x0B,
+    };
+    static const uint8_t DATA[] = { 0x01, 0x00, 0x41, 0x00, 0x0B, 0x01, 0x2A };
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, FUNCS, sizeof(FUNCS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 5, MEMS, sizeof(MEMS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 6, GLOBALS, sizeof(GLOBALS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, EXPORTS, sizeof(EXPORTS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, CODES, sizeof(CODES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 11, DATA, sizeof(DATA));
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "snapshot.wasm: pwasm_mod_init() failed");
+  }
+
+  // set up stack
+  pwasm_val_t stack_vals[MAX_STACK_DEPTH];
+  pwasm_stack_t stack = {
+    .ptr = stack_vals,
+    .len = MAX_STACK_DEPTH,
+  };
+
+  // create environment, check for error
+  pwasm_env_t env;
+  if (!pwasm_env_init(&env, &mem_ctx, pwasm_new_interpreter_get_cbs(), &stack, NULL)) {
+    cli_test_error(test_ctx, "pwasm_env_init() failed");
+  }
+
+  // add mod to env, check for error
+  const uint32_t mod_id = pwasm_env_add_mod(&env, "snapshot", &mod);
+  if (!mod_id) {
+    cli_test_error(test_ctx, "snapshot: pwasm_env_add_mod() failed");
+  }
+
+  static const struct {
+    const char * const name;
+    const uint64_t flags;
+  } SNAPSHOT_TYPES[] = {
+    { "arena", 0 },
+    { "memfd", PWASM_ENV_SNAPSHOT_FLAG_MEMFD },
+  };
+
+  for (size_t i = 0; i < LEN(SNAPSHOT_TYPES); i++) {
+    const char * const name = SNAPSHOT_TYPES[i].name;
+    char buf[256];
+
+    // take snapshot
+    pwasm_env_snapshot_t snap;
+    const bool snap_ok = pwasm_env_snapshot_mod_with_flags(&env, mod_id, &snap, SNAPSHOT_TYPES[i].flags);
+    snprintf(buf, sizeof(buf), "%s: snapshot module", name);
+    if (snap_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // change global, memory contents, and memory size
+    uint32_t val = 0, byte = 0, size = 0;
+    const bool bump_ok = (
+      snapshot_call(&env, "bump", NULL) &&
+      snapshot_call(&env, "bump", NULL) &&
+      snapshot_call(&env, "get", &val) && (val == 9) &&
+      snapshot_call(&env, "load", &byte) && (byte == 99) &&
+      snapshot_call(&env, "size", &size) && (size == 3)
+    );
+
+    snprintf(buf, sizeof(buf), "%s: change module state", name);
+    if (bump_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // restore snapshot, check state
+    const bool restore_ok = (
+      pwasm_env_restore_mod(&env, mod_id, &snap) &&
+      snapshot_call(&env, "get", &val) && (val == 7) &&
+      snapshot_call(&env, "load", &byte) && (byte == 42) &&
+      snapshot_call(&env, "size", &size) && (size == 1)
+    );
+
+    snprintf(buf, sizeof(buf), "%s: restore module state", name);
+    if (restore_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // check that snapshot can be applied repeatedly
+    const bool repeat_ok = (
+      snapshot_call(&env, "bump", NULL) &&
+      pwasm_env_restore_mod(&env, mod_id, &snap) &&
+      snapshot_call(&env, "get", &val) && (val == 7) &&
+      snapshot_call(&env, "load", &byte) && (byte == 42) &&
+      snapshot_call(&env, "size", &size) && (size == 1)
+    );
+
+    snprintf(buf, sizeof(buf), "%s: restore module state again", name);
+    if (repeat_ok) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // check invalid module ID
+    snprintf(buf, sizeof(buf), "%s: restore invalid module", name);
+    if (!pwasm_env_restore_mod(&env, mod_id + 1, &snap)) {
+      cli_test_pass(test_ctx, cli_test, buf);
+    } else {
+      cli_test_fail(test_ctx, cli_test, buf);
+    }
+
+    // free snapshot
+    pwasm_env_snapshot_fini(&snap);
+  }
+
+  // check that memory still works after the snapshot is freed
+  uint32_t byte = 0;
+  const bool after_ok = (
+    snapshot_call(&env, "bump", NULL) &&
+    snapshot_call(&env, "load", &byte) && (byte == 99)
+  );
+
+  if (after_ok) {
+    cli_test_pass(test_ctx, cli_test, "use memory after snapshot is freed");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "use memory after snapshot is freed");
+  }
+
+  // finalize environment, free mod
+  pwasm_env_fini(&env);
+  pwasm_mod_fini(&mod);
+}
+
+/**
+ * Call function +func+ of module "call_indirect" with the table element
+ * offset +elem_ofs+.
+ *
+ * Returns false on error.
+ */
+static bool
+call_indirect_call(
+  pwasm_env_t * const env,
+  const char * const func,
+  const uint32_t elem_ofs,
+  pwasm_val_t * const ret_val
+) {
+  env->stack->pos = 1;
+  env->stack->ptr[0].i32 = elem_ofs;
+  if (!pwasm_call(env, "call_indirect", func) || env->stack->pos != 1) {
+    return false;
+  }
+
+  *ret_val = env->stack->ptr[0];
+  return true;
+}
+
+void test_wasm_call_indirect(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with a table of four elements (the last one is not
+  // set):
+  //
+  //   0: f42: () -> i32 (type 0), returns 42
+  //   1: f33: () -> i64 (type 1), returns 33
+  //   2: f7: () -> i32 (type 4, a duplicate of type 0), returns 7
+  //
+  // and the following exported functions, which call_indirect the
+  // table element given as the first parameter:
+  //
+  // * call: with type 0 () -> i32
+  // * call64: with type 1 () -> i64
+  // * call_dup: with type 4, a duplicate of type 0
+  static uint8_t wasm[512];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = {
+      0x05,
+      0x60, 0x00, 0x01, 0x7F, // () -> i32
+      0x60, 0x00, 0x01, 0x7E, // () -> i64
+      0x60, 0x01, 0x7F, 0x01, 0x7F, // (i32) -> i32
+      0x60, 0x01, 0x7F, 0x01, 0x7E, // (i32) -> i64
+      0x60, 0x00, 0x01, 0x7F, // () -> i32 (duplicate of type 0)
+    };
+    static const uint8_t FUNCS[] = { 0x06, 0x00, 0x01, 0x04, 0x02, 0x03, 0x02 };
+    static const uint8_t TABLES[] = { 0x01, 0x70, 0x00, 0x04 };
+    static const uint8_t EXPORTS[] = {
+      0x03,
+      0x04, 'c', 'a', 'l', 'l', 0x00, 0x03,
+      0x06, 'c', 'a', 'l', 'l', '6', '4', 0x00, 0x04,
+      0x08, 'c', 'a', 'l', 'l', '_', 'd', 'u', 'p', 0x00, 0x05,
+    };
+    static const uint8_t ELEMS[] = { 0x01, 0x00, 0x41, 0x00, 0x0B, 0x03, 0x00, 0x01, 0x02 };
+    static const uint8_t CODES[] = {
+      0x06,
+
+      // f42
+      0x04, 0x00, 0x41, 0x2A, 0x0B,
+
+      // f33
+      0x04, 0x00, 0x42, 0x21, 0x0B,
+
+      // f7
+      0x04, 0x00, 0x41, 0x07, 0x0B,
+
+      // call
+      0x07, 0x00, 0x20, 0x00, 0x11, 0x00, 0x00, 0x0B,
+
+      // call64
+      0x07, 0x00, 0x20, 0x00, 0x11, 0x01, 0x00, 0x0B,
+
+      // call_dup
+      0x07, 0x00, 0x20, 0x00, 0x11, 0x04, 0x00, 0x0B,
+    };
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, FUNCS, sizeof(FUNCS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 4, TABLES, sizeof(TABLES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, EXPORTS, sizeof(EXPORTS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 9, ELEMS, sizeof(ELEMS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, CODES, sizeof(CODES));
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "call_indirect.wasm: pwasm_mod_init() failed");
+  }
+
+  // set up stack
+  pwasm_val_t stack_vals[MAX_STACK_DEPTH];
+  pwasm_stack_t stack = {
+    .ptr = stack_vals,
+    .len = MAX_STACK_DEPTH,
+  };
+
+  // create environment, check for error
+  pwasm_env_t env;
+  if (!pwasm_env_init(&env, &mem_ctx, pwasm_new_interpreter_get_cbs(), &stack, NULL)) {
+    cli_test_error(test_ctx, "pwasm_env_init() failed");
+  }
+
+  // add mod to env, check for error
+  const uint32_t mod_id = pwasm_env_add_mod(&env, "call_indirect", &mod);
+  if (!mod_id) {
+    cli_test_error(test_ctx, "call_indirect: pwasm_env_add_mod() failed");
+  }
+
+  // call functions with matching types
+  pwasm_val_t a, b, c, d;
+  const bool match_ok = (
+    call_indirect_call(&env, "call", 0, &a) && (a.i32 == 42) &&
+    call_indirect_call(&env, "call64", 1, &b) && (b.i64 == 33) &&
+    call_indirect_call(&env, "call_dup", 0, &c) && (c.i32 == 42) &&
+    call_indirect_call(&env, "call", 2, &d) && (d.i32 == 7)
+  );
+
+  if (match_ok) {
+    cli_test_pass(test_ctx, cli_test, "call elements with matching types");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "call elements with matching types");
+  }
+
+  // check type mismatches (the result types differ, the parameter
+  // types match)
+  pwasm_val_t val;
+  const bool mismatch_ok = (
+    !call_indirect_call(&env, "call", 1, &val) &&
+    !call_indirect_call(&env, "call64", 0, &val) &&
+    !call_indirect_call(&env, "call64", 2, &val)
+  );
+
+  if (mismatch_ok) {
+    cli_test_pass(test_ctx, cli_test, "call elements with mismatched types");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "call elements with mismatched types");
+  }
+
+  // check unset and out of bounds elements
+  const bool bounds_ok = (
+    !call_indirect_call(&env, "call", 3, &val) &&
+    !call_indirect_call(&env, "call", 4, &val) &&
+    !call_indirect_call(&env, "call", UINT32_MAX, &val)
+  );
+
+  if (bounds_ok) {
+    cli_test_pass(test_ctx, cli_test, "call unset and out of bounds elements");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "call unset and out of bounds elements");
+  }
+
+  // check element types after restoring a snapshot
+  pwasm_env_snapshot_t snap;
+  const bool restore_ok = (
+    pwasm_env_snapshot_mod(&env, mod_id, &snap) &&
+    pwasm_env_restore_mod(&env, mod_id, &snap) &&
+    call_indirect_call(&env, "call", 0, &a) && (a.i32 == 42) &&
+    call_indirect_call(&env, "call", 2, &d) && (d.i32 == 7) &&
+    !call_indirect_call(&env, "call", 1, &val) &&
+    !call_indirect_call(&env, "call", 3, &val)
+  );
+  pwasm_env_snapshot_fini(&snap);
+
+  if (restore_ok) {
+    cli_test_pass(test_ctx, cli_test, "call elements after restoring snapshot");
+  } else {
+    cli_test_fail(test_ctx, cli_test, "call elements after restoring snapshot");
+  }
+
+  // finalize environment, free mod
+  pwasm_env_fini(&env);
+  pwasm_mod_fini(&mod);
+}
+
+/**
+ * Call function +func+ of module "call_depth" with the parameter +n+.
+ *
+ * Returns false on error.
+ */
+static bool
+call_depth_call(
+  pwasm_env_t * const env,
+  const char * const func,
+  const uint32_t n,
+  uint32_t * const ret_val
+) {
+  env->stack->pos = 1;
+  env->stack->ptr[0].i32 = n;
+  if (!pwasm_call(env, "call_depth", func) || env->stack->pos != 1) {
+    return false;
+  }
+
+  *ret_val = env->stack->ptr[0].i32;
+  return true;
+}
+
+void test_wasm_call_depth(
+  cli_test_ctx_t * const test_ctx,
+  const cli_test_t * const cli_test
+) {
+  // create a memory context
+  pwasm_mem_ctx_t mem_ctx = pwasm_mem_ctx_init_defaults(NULL);
+
+  // build module with the following exported functions, which return
+  // the sum of the integers from 0 to the first parameter:
+  //
+  // * sum: recurses with call
+  // * isum: recurses with call_indirect (table element 0)
+  static uint8_t wasm[256];
+  size_t wasm_len = 0;
+  {
+    static const uint8_t HEADER[] = { 0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00 };
+    static const uint8_t TYPES[] = { 0x01, 0x60, 0x01, 0x7F, 0x01, 0x7F };
+    static const uint8_t FUNCS[] = { 0x02, 0x00, 0x00 };
+    static const uint8_t TABLES[] = { 0x01, 0x70, 0x00, 0x01 };
+    static const uint8_t EXPORTS[] = {
+      0x02,
+      0x03, 's', 'u', 'm', 0x00, 0x00,
+      0x04, 'i', 's', 'u', 'm', 0x00, 0x01,
+    };
+    static const uint8_t ELEMS[] = { 0x01, 0x00, 0x41, 0x00, 0x0B, 0x01, 0x01 };
+    static const uint8_t CODES[] = {
+      0x02,
+
+      // sum
+      0x15, 0x00,
+      0x20, 0x00, 0x45, // local.get 0, i32.eqz
+      0x04, 0x7F, // if (result i32)
+        0x41, 0x00, // i32.const 0
+      0x05, // else
+        0x20, 0x00, // local.get 0
+        0x20, 0x00, 0x41, 0x01, 0x6B, // local.get 0, i32.const 1, i32.sub
+        0x10, 0x00, // call 0
+        0x6A, // i32.add
+      0x0B, // end
+      0x0B,
+
+      // isum
+      0x18, 0x00,
+      0x20, 0x00, 0x45, // local.get 0, i32.eqz
+      0x04, 0x7F, // if (result i32)
+        0x41, 0x00, // i32.const 0
+      0x05, // else
+        0x20, 0x00, // local.get 0
+        0x20, 0x00, 0x41, 0x01, 0x6B, // local.get 0, i32.const 1, i32.sub
+        0x41, 0x00, 0x11, 0x00, 0x00, // i32.const 0, call_indirect 0
+        0x6A, // i32.add
+      0x0B, // end
+      0x0B,
+    };
+
+    memcpy(wasm, HEADER, sizeof(HEADER));
+    wasm_len += sizeof(HEADER);
+    wasm_len += cli_test_append_section(wasm + wasm_len, 1, TYPES, sizeof(TYPES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 3, FUNCS, sizeof(FUNCS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 4, TABLES, sizeof(TABLES));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 7, EXPORTS, sizeof(EXPORTS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 9, ELEMS, sizeof(ELEMS));
+    wasm_len += cli_test_append_section(wasm + wasm_len, 10, CODES, sizeof(CODES));
+  }
+
+  // parse mod, check for error
+  pwasm_mod_t mod;
+  if (!pwasm_mod_init(&mem_ctx, &mod, (pwasm_buf_t) { wasm, wasm_len })) {
+    cli_test_error(test_ctx, "call_depth.wasm: pwasm_mod_init() failed");
+  }
+
+  // set up a value stack which is large enough for deep recursion
+  static pwasm_val_t stack_vals[1 << 17];
+  const size_t stack_len = sizeof(stack_vals) / sizeof(stack_vals[0]);
+
+  {
+    pwasm_stack_t stack = {
+      .ptr = stack_vals,
+      .len = stack_len,
+    };
+
+    // get interpreter callbacks with a maximum call depth of 1000
+    pwasm_env_cbs_t cbs;
+    pwasm_new_interpreter_get_cbs_with_max_depth(&cbs, 1000);
+
+    // create environment, check for error
+    pwasm_env_t env;
+    if (!pwasm_env_init(&env, &mem_ctx, &cbs, &stack, NULL)) {
+      cli_test_error(test_ctx, "pwasm_env_init() failed");
+    }
+
+    // add mod to env, check for error
+    if (!pwasm_env_add_mod(&env, "call_depth", &mod)) {
+      cli_test_error(test_ctx, "call_depth: pwasm_env_add_mod() failed");
+    }
+
+    // recurse to the maximum depth (n + 1 calls), then one call past it
+    uint32_t a = 0, b = 0, val;
+    const bool limit_ok = (
+      call_depth_call(&env, "sum", 999, &a) && (a == 499500) &&
+      call_depth_call(&env, "isum", 999, &b) && (b == 499500) &&
+      !call_depth_call(&env, "sum", 1000, &val) &&
+      !call_depth_call(&env, "isum", 1000, &val)
+    );
+
+    if (limit_ok) {
+      cli_test_pass(test_ctx, cli_test, "fail calls past maximum call depth");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "fail calls past maximum call depth");
+    }
+
+    // check that the environment is still usable
+    const bool after_ok = (
+      call_depth_call(&env, "sum", 10, &a) && (a == 55) &&
+      call_depth_call(&env, "isum", 999, &b) && (b == 499500)
+    );
+
+    if (after_ok) {
+      cli_test_pass(test_ctx, cli_test, "call after exceeding maximum call depth");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "call after exceeding maximum call depth");
+    }
+
+    // finalize environment
+    pwasm_env_fini(&env);
+  }
+
+  {
+    pwasm_stack_t stack = {
+      .ptr = stack_vals,
+      .len = stack_len,
+    };
+
+    // create environment with the default maximum call depth, check for
+    // error
+    pwasm_env_t env;
+    if (!pwasm_env_init(&env, &mem_ctx, pwasm_new_interpreter_get_cbs(), &stack, NULL)) {
+      cli_test_error(test_ctx, "pwasm_env_init() failed");
+    }
+
+    // add mod to env, check for error
+    if (!pwasm_env_add_mod(&env, "call_depth", &mod)) {
+      cli_test_error(test_ctx, "call_depth: pwasm_env_add_mod() failed");
+    }
+
+    // recurse deeper than the host stack allows for recursive calls in C
+    uint32_t a = 0, b = 0;
+    const bool deep_ok = (
+      call_depth_call(&env, "sum", 50000, &a) && (a == 1250025000) &&
+      call_depth_call(&env, "isum", 50000, &b) && (b == 1250025000)
+    );
+
+    if (deep_ok) {
+      cli_test_pass(test_ctx, cli_test, "deep recursion");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "deep recursion");
+    }
+
+    // finalize environment
+    pwasm_env_fini(&env);
+  }
+
+  {
+    // set up a small value stack
+    pwasm_val_t small_vals[MAX_STACK_DEPTH];
+    pwasm_stack_t stack = {
+      .ptr = small_vals,
+      .len = MAX_STACK_DEPTH,
+    };
+
+    // create environment, check for error
+    pwasm_env_t env;
+    if (!pwasm_env_init(&env, &mem_ctx, pwasm_new_interpreter_get_cbs(), &stack, NULL)) {
+      cli_test_error(test_ctx, "pwasm_env_init() failed");
+    }
+
+    // add mod to env, check for error
+    if (!pwasm_env_add_mod(&env, "call_depth", &mod)) {
+      cli_test_error(test_ctx, "call_depth: pwasm_env_add_mod() failed");
+    }
+
+    // check that value stack overflow fails instead of writing past the
+    // end of the stack
+    uint32_t val;
+    const bool overflow_ok = (
+      !call_depth_call(&env, "sum", 1000, &val) &&
+      call_depth_call(&env, "sum", 10, &val) && (val == 55)
+    );
+
+    if (overflow_ok) {
+      cli_test_pass(test_ctx, cli_test, "fail on value stack overflow");
+    } else {
+      cli_test_fail(test_ctx, cli_test, "fail on value stack overflow");
+    }
+
+    // finalize environment
+    pwasm_env_fini(&env);
+  }
+
+  // free mod
+  pwasm_mod_fini(&mod);
+}
@@ -1,7 +1,12 @@
 #include <stdbool.h> // bool
 #include <stdlib.h> // size_t
+#include <stdint.h> // uint8_t
 #include <stdio.h> // fopen(), printf()
 #include <err.h> // err()
+#include <fcntl.h> // open()
+#include <unistd.h> // close()
+#include <sys/mman.h> // mmap()
+#include <sys/stat.h> // fstat()
 #include "utils.h"
 
 /**
@@ -67,6 +72,59 @@ cli_read_file(
   };
 }
 
+/**
+ * Map contents of file read-only and return result as a buffer.
+ *
+ * Returns a buffer with a NULL pointer if the file is not a regular,
+ * non-empty file or if the file can not be mapped.
+ *
+ * Note: This method calls err() and exits if the file can not be
+ * opened.
+ */
+pwasm_buf_t
+cli_map_file(
+  const char * const path
+) {
+  // open file, check for error
+  const int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    // exit with error
+    err(EXIT_FAILURE, "open(\"%s\")", path);
+  }
+
+  // get file size, check for regular file
+  struct stat st;
+  const bool is_file = !fstat(fd, &st) && S_ISREG(st.st_mode) && (st.st_size > 0);
+
+  // map file
+  void * const ptr = is_file ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+
+  // close file, check for error (the mapping remains valid)
+  if (close(fd)) {
+    // log error, continue
+    warn("close()");
+  }
+
+  // return result
+  return (pwasm_buf_t) {
+    .ptr = (ptr != MAP_FAILED) ? ptr : NULL,
+    .len = (ptr != MAP_FAILED) ? (size_t) st.st_size : 0,
+  };
+}
+
+/**
+ * Unmap file mapped with cli_map_file().
+ */
+void
+cli_unmap_file(
+  const pwasm_buf_t buf
+) {
+  if (buf.ptr && munmap((void*) buf.ptr, buf.len)) {
+    // log error, continue
+    warn("munmap()");
+  }
+}
+
 #define FLUSH() do { \
   if (tmp_ofs) { \
     on_data((pwasm_buf_t) { tmp, tmp_ofs }, data); \
@@ -151,21 +209,72 @@ void cli_with_mod(
   void (*on_mod)(const pwasm_mod_t *, void *),
   void *data
 ) {
-  // read file data
-  pwasm_buf_t buf = cli_read_file(mem_ctx, path);
+  // map regular files
+  const pwasm_buf_t map = cli_map_file(path);
+  if (map.ptr) {
+    // parse mod without copying data from mapped file, check for error
+    pwasm_mod_t mod;
+    if (!pwasm_mod_init_with_flags(mem_ctx, &mod, map, PWASM_MOD_INIT_FLAG_NO_COPY)) {
+      errx(EXIT_FAILURE, "%s: pwasm_mod_init_with_flags() failed", path);
+    }
+
+    // write module to output
+    on_mod(&mod, data);
+
+    // free mod, unmap file
+    pwasm_mod_fini(&mod);
+    cli_unmap_file(map);
+    return;
+  }
+
+  // open file, check for error (path may be a pipe, so read the file
+  // in chunks instead of seeking to get the length)
+  FILE *fh = fopen(path, "rb");
+  if (!fh) {
+    // exit with error
+    err(EXIT_FAILURE, "fopen(\"%s\")", path);
+  }
 
-  // parse mod, check for error
+  // init streaming loader, check for error
+  pwasm_mod_stream_t stream;
+  if (!pwasm_mod_stream_init(&stream, mem_ctx, 0)) {
+    errx(EXIT_FAILURE, "%s: pwasm_mod_stream_init() failed", path);
+  }
+
+  // feed file data to loader as it is read
+  uint8_t buf[1 << 16];
+  size_t len;
+  while ((len = fread(buf, 1, sizeof(buf), fh)) > 0) {
+    // parse chunk, check for error
+    if (!pwasm_mod_stream_feed(&stream, (pwasm_buf_t) { buf, len })) {
+      errx(EXIT_FAILURE, "%s: pwasm_mod_stream_feed() failed", path);
+    }
+  }
+
+  // check for read error
+  if (ferror(fh)) {
+    // exit with error
+    err(EXIT_FAILURE, "fread()");
+  }
+
+  // close file, check for error
+  if (fclose(fh)) {
+    // log error, continue
+    warn("fclose()");
+  }
+
+  // build mod, check for error
   pwasm_mod_t mod;
-  if (!pwasm_mod_init(mem_ctx, &mod, buf)) {
-    errx(EXIT_FAILURE, "%s: pwasm_mod_init() failed", path);
+  if (!pwasm_mod_stream_finish(&stream, &mod)) {
+    errx(EXIT_FAILURE, "%s: pwasm_mod_stream_finish() failed", path);
   }
 
+  // free streaming loader
+  pwasm_mod_stream_fini(&stream);
+
   // write module to output
   on_mod(&mod, data);
 
   // free mod
   pwasm_mod_fini(&mod);
-
-  // free file data
-  pwasm_realloc(mem_ctx, (void*) buf.ptr, 0);
 }
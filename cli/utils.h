@@ -14,6 +14,22 @@ pwasm_buf_t cli_read_file(
   const char * const
 );
 
+/**
+ * Map contents of file read-only and return result as a buffer.
+ *
+ * Returns a buffer with a NULL pointer if the file is not a regular,
+ * non-empty file or if the file can not be mapped.
+ *
+ * Note: This method calls err() and exits if the file can not be
+ * opened.
+ */
+pwasm_buf_t cli_map_file(const char * const);
+
+/**
+ * Unmap file mapped with cli_map_file().
+ */
+void cli_unmap_file(const pwasm_buf_t);
+
 /**
  * write escaped UTF-8 data from mod to file handle.
  */
@@ -25,8 +41,12 @@ void cli_escape_bytes(
 );
 
 /**
- * Load module in given file, invoke callback with parsed mod, then free
- * the memory associated with the module and return.
+ * Load module in given file (which may be a pipe), invoke callback
+ * with parsed mod, then free the memory associated with the module and
+ * return.
+ *
+ * Regular files are mapped and parsed without copying names, custom
+ * sections, or data segments; other files are streamed.
  *
  */
 void cli_with_mod(
@@ -3758,7 +3758,7 @@
 
   ;;
   ;; memory_grow:
-  ;;   expect i32 1
+  ;;   expect i32 -1 (the memory has a maximum of 1 page)
   ;;
   (func $memory_grow (result i32)
     (memory.grow (i32.const 1))
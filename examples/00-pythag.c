@@ -7,7 +7,7 @@
  *   cc -c -W -Wall -Wextra -Werror -pedantic -std=c11 -I. -O3 pwasm.c
  *
  *   # link and build as ./example-00-pythag
- *   cc -o ./example-00-pythag {00-pythag,pwasm}.o -lm
+ *   cc -o ./example-00-pythag {00-pythag,pwasm}.o -lm -lpthread
  *
  * Output:
  *   # run example-00-pythag
@@ -13,6 +13,43 @@ extern "C" {
 
 #include "pwasm.h"
 
+/**
+ * DynASM JIT compiler flag: keep the values at the top of the operand
+ * stack in registers, and only spill them to the stack at calls, block
+ * boundaries, helper calls, and instructions which are not handled by
+ * the register tier.
+ *
+ * @ingroup jit
+ */
+#define PWASM_DYNASM_JIT_FLAG_REGS (1 << 0)
+
+/**
+ * DynASM JIT compiler flag: reserve 8GiB of address space for each
+ * linear memory and emit memory loads and stores inline.  Accesses
+ * past the end of linear memory hit inaccessible pages, and the
+ * resulting `SIGSEGV` is converted into a trap.
+ *
+ * @note Setting this flag installs a process-wide `SIGSEGV` handler
+ * which chains to the previously installed handler for faults outside
+ * of linear memory.
+ *
+ * @ingroup jit
+ */
+#define PWASM_DYNASM_JIT_FLAG_GUARD_PAGES (1 << 1)
+
+/**
+ * DynASM JIT compiler flag: ignore the optional CPU features of the
+ * host and only generate code for the x86-64 baseline (SSE2).
+ *
+ * By default the compiler probes the host CPU with `cpuid` and uses
+ * SSSE3, SSE4.1, POPCNT, LZCNT, BMI1, BMI2, and AVX2 instruction
+ * sequences when they are available.  Instructions without a short
+ * baseline equivalent are emulated by a helper function.
+ *
+ * @ingroup jit
+ */
+#define PWASM_DYNASM_JIT_FLAG_BASELINE (1 << 2)
+
 /**
  * Initialize DynASM JIT compiler.
  *
@@ -30,6 +67,56 @@ _Bool pwasm_dynasm_jit_init(
   pwasm_mem_ctx_t *mem_ctx  ///< memory context
 );
 
+/**
+ * Initialize DynASM JIT compiler with the given compiler flags.
+ *
+ * @note This function is architecture and operating system specific.
+ *
+ * @ingroup jit
+ *
+ * @param[out] jit     Destination JIT compiler.
+ * @param[in]  mem_ctx Memory context.
+ * @param[in]  flags   Compiler flags (e.g. `PWASM_DYNASM_JIT_FLAG_REGS`).
+ *
+ * @return `true` on success or `false` if an error occurred.
+ */
+_Bool pwasm_dynasm_jit_init_with_flags(
+  pwasm_jit_t *jit, ///< destination JIT compiler
+  pwasm_mem_ctx_t *mem_ctx, ///< memory context
+  const uint64_t flags ///< compiler flags
+);
+
+/**
+ * Enable the code cache of a DynASM JIT compiler.
+ *
+ * When the code cache is enabled, the compiled functions of each
+ * module added to an AOT JIT environment are saved to a file in the
+ * cache directory, and later loads of the same module map the cached
+ * file instead of compiling the module again.
+ *
+ * Cache files are keyed by a hash of the module source, the compiler
+ * flags, and the CPU feature set.  Stale or invalid cache files are
+ * ignored and replaced.
+ *
+ * @note Cache files contain native code which is executed without
+ * validation, so the cache directory must only be writable by trusted
+ * users.
+ *
+ * @note The code cache is only used when all functions of a module are
+ * compiled at once (e.g. `pwasm_aot_jit_get_cbs()`).
+ *
+ * @ingroup jit
+ *
+ * @param[in] jit   DynASM JIT compiler.
+ * @param[in] path  Cache directory, or `NULL` to disable the code cache.
+ *
+ * @return `true` on success or `false` if an error occurred.
+ */
+_Bool pwasm_dynasm_jit_set_cache_dir(
+  pwasm_jit_t *jit, ///< JIT compiler
+  const char *path ///< cache directory
+);
+
 #ifdef __cplusplus
 };
 #endif /* __cplusplus */
@@ -1,9 +1,23 @@
+#ifdef __linux__
+#define _GNU_SOURCE // memfd_create()
+#endif /* __linux__ */
 #include <stdbool.h> // bool
 #include <string.h> // memcmp()
 #include <stdlib.h> // realloc()
 #include <unistd.h> // sysconf()
 #include <string.h> // snprintf()
 #include <math.h> // fabs(), fabsf(), etc
+#include <pthread.h> // pthread_create()
+#include <stdio.h> // snprintf()
+#ifdef __SSE2__
+#include <emmintrin.h> // _mm_movemask_epi8()
+#include <tmmintrin.h> // _mm_abs_epi8()
+#include <smmintrin.h> // _mm_min_epi8()
+#endif /* __SSE2__ */
+#ifdef __linux__
+#include <sys/mman.h> // mmap(), memfd_create()
+#define PWASM_HAVE_MEMFD 1
+#endif /* __linux__ */
 #include "pwasm.h"
 
 /**
@@ -23,6 +37,11 @@
  */
 #define PWASM_PAGE_SIZE (1 << 16)
 
+/**
+ * Maximum number of worker pool threads.
+ */
+#define PWASM_POOL_MAX_THREADS 64
+
 /**
  * Void block type.
  *
@@ -80,6 +99,40 @@ pwasm_buf_str(
   };
 }
 
+/**
+ * Number of bytes scanned at once by pwasm_scan_high_bits().
+ */
+#ifdef __SSE2__
+#define PWASM_SCAN_BLOCK_SIZE 16
+#else /* !__SSE2__ */
+#define PWASM_SCAN_BLOCK_SIZE 8
+#endif /* __SSE2__ */
+
+/**
+ * Get the high bits of the first PWASM_SCAN_BLOCK_SIZE bytes of +ptr+
+ * as a bitmask (bit N is set if byte N has its high bit set).
+ *
+ * Used to find LEB128 continuation bytes and non-ASCII UTF-8 bytes.
+ */
+static inline uint32_t
+pwasm_scan_high_bits(
+  const uint8_t * const ptr
+) {
+#ifdef __SSE2__
+  return _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ptr));
+#else /* !__SSE2__ */
+  // load 8 bytes as a little-endian word (compiles to a single load on
+  // little-endian targets)
+  uint64_t val = 0;
+  for (size_t i = 0; i < 8; i++) {
+    val |= ((uint64_t) ptr[i]) << (8 * i);
+  }
+
+  // gather the high bit of each byte into the top byte
+  return ((val & 0x8080808080808080ULL) * 0x0002040810204081ULL) >> 56;
+#endif /* __SSE2__ */
+}
+
 /**
  * Get the size (in bytes) of the UTF-8 codepoint beginning with the
  * given byte.
@@ -145,12 +198,29 @@ pwasm_utf8_get_codepoint(
 /**
  * Returns true if the given buffer contains a sequence of valid UTF_8
  * codepoints, and false otherwise.
+ *
+ * Runs of ASCII bytes are skipped a block at a time; multibyte
+ * sequences are always decoded one codepoint at a time.  This check is
+ * lax (overlong encodings and surrogates are accepted), so a standard
+ * SIMD UTF-8 validator would reject names which are accepted here.
  */
 static inline bool
 pwasm_utf8_is_valid(
   const pwasm_buf_t src
 ) {
   for (size_t i = 0; i < src.len;) {
+    if (src.len - i >= PWASM_SCAN_BLOCK_SIZE) {
+      // fast path: skip block of ASCII bytes
+      const uint32_t mask = pwasm_scan_high_bits(src.ptr + i);
+      if (!mask) {
+        i += PWASM_SCAN_BLOCK_SIZE;
+        continue;
+      }
+
+      // skip leading ASCII bytes in block
+      i += __builtin_ctz(mask);
+    }
+
     // get length of next utf-8 codepoint (in bytes), check for error
     const size_t len = pwasm_utf8_get_codepoint_size(src.ptr[i]);
     if (!len) {
@@ -179,6 +249,75 @@ pwasm_utf8_is_valid(
   return true;
 }
 
+// initial value of 64-bit FNV-1a hash
+#define PWASM_HASH_INIT 0xcbf29ce484222325ULL
+
+/**
+ * Continue the 64-bit FNV-1a hash +r+ with the first +len+ bytes of
+ * +ptr+ and return the result.
+ */
+static inline uint64_t
+pwasm_hash_step(
+  uint64_t r,
+  const uint8_t * const ptr,
+  const size_t len
+) {
+  for (size_t i = 0; i < len; i++) {
+    r = (r ^ ptr[i]) * 0x100000001b3ULL;
+  }
+
+  return r;
+}
+
+/**
+ * Returns the 64-bit FNV-1a hash of the first +len+ bytes of +ptr+.
+ */
+static inline uint64_t
+pwasm_hash(
+  const uint8_t * const ptr,
+  const size_t len
+) {
+  return pwasm_hash_step(PWASM_HASH_INIT, ptr, len);
+}
+
+/**
+ * Get the length of the LEB128-encoded value at the beginning of the
+ * buffer +src+.
+ *
+ * Returns the number of bytes in the value, or 0 if the value is
+ * truncated or longer than +max_len+ bytes.
+ */
+static inline size_t
+pwasm_leb128_get_len(
+  const pwasm_buf_t src,
+  const size_t max_len
+) {
+  // fast path: single-byte value (most counts, indices, and immediates)
+  if (src.len > 0 && !(src.ptr[0] & 0x80)) {
+    return 1;
+  }
+
+  if (src.len >= PWASM_SCAN_BLOCK_SIZE) {
+    // find terminating byte in block without a per-byte branch
+    const uint32_t mask = pwasm_scan_high_bits(src.ptr);
+    const size_t ofs = __builtin_ctz(~mask);
+    if (ofs < PWASM_SCAN_BLOCK_SIZE) {
+      return (ofs < max_len) ? (ofs + 1) : 0;
+    }
+  }
+
+  // slow path: short buffer or value longer than block
+  const size_t len = MIN(max_len, src.len);
+  for (size_t i = 0; i < len; i++) {
+    if (!(src.ptr[i] & 0x80)) {
+      return i + 1;
+    }
+  }
+
+  // return zero (failure)
+  return 0;
+}
+
 /**
  * Decode the LEB128-encoded unsigned 32-bit integer at the beginning of
  * the buffer +src+ and return the value in +dst+.
@@ -190,40 +329,84 @@ pwasm_u32_decode(
   uint32_t * const dst,
   const pwasm_buf_t src
 ) {
-  const size_t len = MIN(5, src.len);
-
-  if (dst) {
-    uint32_t val = 0, shift = 0;
+  const size_t len = pwasm_leb128_get_len(src, 5);
 
+  if (len && dst) {
+    uint32_t val = 0;
     for (size_t i = 0; i < len; i++) {
-      const uint32_t b = src.ptr[i];
-      val |= ((b & 0x7F) << shift);
+      val |= ((uint32_t) (src.ptr[i] & 0x7F)) << (7 * i);
+    }
 
-      if (!(b & 0x80)) {
-        // write result
-        *dst = val;
+    // write result
+    *dst = val;
+  }
 
-        // return length (success)
-        return i + 1;
-      }
+  // return length (0 on failure)
+  return len;
+}
 
-      shift += 7;
-    }
-  } else {
-    // no destination, just count size
+/**
+ * Decode up to +num+ consecutive LEB128-encoded unsigned 32-bit
+ * integers at the beginning of the buffer +src+ into +dst+.
+ *
+ * Runs of single-byte values (the common case for type indices, function
+ * indices, and branch labels) are widened a block at a time.
+ *
+ * Returns the number of bytes consumed, or 0 on error.
+ */
+static size_t
+pwasm_u32s_decode(
+  uint32_t * const dst,
+  const size_t num,
+  const pwasm_buf_t src
+) {
+  size_t ofs = 0;
 
-    for (size_t i = 0; i < len; i++) {
-      const uint32_t b = src.ptr[i];
+  for (size_t i = 0; i < num;) {
+    if (src.len - ofs >= PWASM_SCAN_BLOCK_SIZE) {
+      // count leading single-byte values in block
+      const uint32_t mask = pwasm_scan_high_bits(src.ptr + ofs);
+      const size_t run = MIN(num - i, mask ? (size_t) __builtin_ctz(mask) : PWASM_SCAN_BLOCK_SIZE);
+
+      if (run > 0) {
+#ifdef __SSE2__
+        if (run == PWASM_SCAN_BLOCK_SIZE) {
+          // widen 16 bytes to 16 u32s
+          const __m128i zero = _mm_setzero_si128();
+          const __m128i v = _mm_loadu_si128((const __m128i *) (src.ptr + ofs));
+          const __m128i lo = _mm_unpacklo_epi8(v, zero);
+          const __m128i hi = _mm_unpackhi_epi8(v, zero);
+          _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_unpacklo_epi16(lo, zero));
+          _mm_storeu_si128((__m128i *) (dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+          _mm_storeu_si128((__m128i *) (dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+          _mm_storeu_si128((__m128i *) (dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+        } else
+#endif /* __SSE2__ */
+        for (size_t j = 0; j < run; j++) {
+          dst[i + j] = src.ptr[ofs + j];
+        }
 
-      if (!(b & 0x80)) {
-        // return length (success)
-        return i + 1;
+        // advance
+        i += run;
+        ofs += run;
+        continue;
       }
     }
+
+    // decode multi-byte value (or value near end of buffer)
+    const size_t len = pwasm_u32_decode(dst + i, pwasm_buf_step(src, ofs));
+    if (!len) {
+      // return zero (failure)
+      return 0;
+    }
+
+    // advance
+    i++;
+    ofs += len;
   }
 
-  // return zero (failure)
-  return 0;
+  // return number of bytes consumed
+  return ofs;
 }
 
 /**
@@ -237,40 +420,20 @@ pwasm_u64_decode(
   uint64_t * const dst,
   const pwasm_buf_t src
 ) {
-  const size_t len = MIN(10, src.len);
-
-  if (dst) {
-    uint64_t val = 0, shift = 0;
+  const size_t len = pwasm_leb128_get_len(src, 10);
 
+  if (len && dst) {
+    uint64_t val = 0;
     for (size_t i = 0; i < len; i++) {
-      const uint64_t b = src.ptr[i];
-      val |= ((b & 0x7F) << shift);
-
-      if (!(b & 0x80)) {
-        // write result
-        *dst = val;
-
-        // return length (success)
-        return i + 1;
-      }
-
-      shift += 7;
+      val |= ((uint64_t) (src.ptr[i] & 0x7F)) << (7 * i);
     }
-  } else {
-    // no destination, just count size
-
-    for (size_t i = 0; i < len; i++) {
-      const uint64_t b = src.ptr[i];
 
-      if (!(b & 0x80)) {
-        // return length (success)
-        return i + 1;
-      }
-    }
+    // write result
+    *dst = val;
   }
 
-  // return zero (failure)
-  return 0;
+  // return length (0 on failure)
+  return len;
 }
 
 static void
@@ -312,36 +475,29 @@ pwasm_s32_decode(
   int32_t * const dst,
   const pwasm_buf_t src
 ) {
-  const size_t len = MIN(5, src.len);
-
-  if (dst) {
-    uint32_t val = 0, shift = 0;
+  const size_t len = pwasm_leb128_get_len(src, 5);
 
+  if (len && dst) {
+    uint32_t val = 0;
     for (size_t i = 0; i < len; i++) {
-      const uint32_t b = src.ptr[i];
-      val |= ((b & 0x7F) << shift);
-
-      shift += 7;
-
-      if (!(b & 0x80)) {
-        if ((shift < 32) && (b & 0x40)) {
-          val |= (~0UL << shift);
-        }
+      val |= ((uint32_t) (src.ptr[i] & 0x7F)) << (7 * i);
+    }
 
-        // dump decoded result
-        pwasm_s32_dump_decode(src, i + 1, val);
+    // sign-extend result
+    const size_t shift = 7 * len;
+    if ((shift < 32) && (src.ptr[len - 1] & 0x40)) {
+      val |= (~0UL << shift);
+    }
 
-        // write result
-        *dst = val;
+    // dump decoded result
+    pwasm_s32_dump_decode(src, len, val);
 
-        // return length (success)
-        return i + 1;
-      }
-    }
+    // write result
+    *dst = val;
   }
 
-  // return zero (failure)
-  return 0;
+  // return length (0 on failure)
+  return len;
 }
 
 /**
@@ -4312,37 +4468,22 @@ pwasm_parse_u32s(
   pwasm_buf_t curr = pwasm_buf_step(src, count_len);
   uint32_t items[PWASM_BATCH_SIZE];
 
-  size_t ofs = 0;
-  for (size_t i = 0; i < count; i++) {
-    if (!curr.len) {
-    }
-    if (num_bytes > src.len) {
-      cbs.on_error("u32 vector buffer overflow", cb_data);
-      return 0;
-    }
-
-    // decode value, check for error
-    const size_t len = pwasm_u32_decode(items + ofs, curr);
+  for (size_t i = 0; i < count;) {
+    // decode batch of values, check for error
+    const size_t num = MIN(count - i, LEN(items));
+    const size_t len = pwasm_u32s_decode(items, num, curr);
     if (!len) {
       cbs.on_error("bad u32 in u32 vector", cb_data);
       return 0;
     }
 
+    // flush batch
+    cbs.on_items(items, num, cb_data);
+
     // increment buffer, byte count, and offset
     curr = pwasm_buf_step(curr, len);
     num_bytes += len;
-    ofs++;
-
-    if (ofs == LEN(items)) {
-      // flush batch, reset offset
-      cbs.on_items(items, LEN(items), cb_data);
-      ofs = 0;
-    }
-  }
-
-  if (ofs > 0) {
-    // flush remaining values
-    cbs.on_items(items, ofs, cb_data);
+    i += num;
   }
 
   // return success
@@ -4836,6 +4977,8 @@ pwasm_parse_table(
 
 typedef struct {
   pwasm_slice_t (*on_labels)(const uint32_t *, const size_t, void *);
+  pwasm_slice_t (*on_blocks)(const pwasm_block_t *, const size_t, void *);
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
   void (*on_error)(const char *, void *);
 } pwasm_parse_inst_cbs_t;
 
@@ -5778,8 +5921,21 @@ pwasm_parse_inst(
         return 0;
       }
 
-      // save block type
-      in.v_block.block_type = block_type;
+      // check for block callback
+      if (!cbs->on_blocks) {
+        cbs->on_error("unexpected block instruction", cb_data);
+        return 0;
+      }
+
+      // save block metadata, check for error
+      const pwasm_block_t block = { .block_type = block_type };
+      const pwasm_slice_t blocks = cbs->on_blocks(&block, 1, cb_data);
+      if (!blocks.len) {
+        return 0;
+      }
+
+      // save block metadata offset
+      in.v_block = blocks.ofs;
 
       // advance
       curr = pwasm_buf_step(curr, len);
@@ -5804,7 +5960,7 @@ pwasm_parse_inst(
       }
 
       // save labels buffer, increment length
-      in.v_br_table = labels;
+      in.v_br_table = (pwasm_inst_slice_t) { labels.ofs, labels.len };
 
       // advance
       curr = pwasm_buf_step(curr, len);
@@ -6012,8 +6168,24 @@ pwasm_parse_inst(
         return 0;
       }
 
-      // copy immediate value, increment length
-      memcpy(in.v_v128.i8, curr.ptr, len);
+      // check for v128 callback
+      if (!cbs->on_v128s) {
+        cbs->on_error("unexpected v128 immediate", cb_data);
+        return 0;
+      }
+
+      // copy immediate value
+      pwasm_v128_t val;
+      memcpy(val.i8, curr.ptr, len);
+
+      // save immediate value, check for error
+      const pwasm_slice_t v128s = cbs->on_v128s(&val, 1, cb_data);
+      if (!v128s.len) {
+        return 0;
+      }
+
+      // save immediate value offset
+      in.v_v128 = v128s.ofs;
 
       // advance
       curr = pwasm_buf_step(curr, len);
@@ -6047,6 +6219,8 @@ typedef struct {
 
 typedef struct {
   pwasm_slice_t (*on_labels)(const uint32_t *, const size_t, void *);
+  pwasm_slice_t (*on_blocks)(const pwasm_block_t *, const size_t, void *);
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
   pwasm_slice_t (*on_insts)(const pwasm_inst_t *, const size_t, void *);
   pwasm_slice_t (*on_stats)(const pwasm_expr_stats_t, void *);
   void (*on_error)(const char *, void *);
@@ -6076,6 +6250,8 @@ pwasm_parse_expr(
   // build instruction parser callbacks
   const pwasm_parse_inst_cbs_t in_cbs = {
     .on_labels  = cbs->on_labels,
+    .on_blocks  = cbs->on_blocks,
+    .on_v128s   = cbs->on_v128s,
     .on_error   = cbs->on_error,
   };
 
@@ -6593,6 +6769,7 @@ pwasm_parse_export(
 typedef struct {
   pwasm_slice_t (*on_funcs)(const uint32_t *, const size_t, void *);
   // pwasm_slice_t (*on_labels)(const pwasm_inst_t *, const size_t, void *);
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
   pwasm_slice_t (*on_insts)(const pwasm_inst_t *, const size_t, void *);
   void (*on_error)(const char *, void *);
 } pwasm_parse_elem_cbs_t;
@@ -6666,6 +6843,7 @@ pwasm_parse_elem(
   {
     // build parse expr callbacks
     const pwasm_parse_expr_cbs_t expr_cbs = {
+      .on_v128s = cbs->on_v128s,
       .on_insts = cbs->on_insts,
       .on_error = cbs->on_error,
     };
@@ -6724,6 +6902,8 @@ pwasm_parse_elem(
 typedef struct {
   pwasm_slice_t (*on_locals)(const pwasm_local_t *, size_t, void *);
   pwasm_slice_t (*on_labels)(const uint32_t *, const size_t, void *);
+  pwasm_slice_t (*on_blocks)(const pwasm_block_t *, const size_t, void *);
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
   pwasm_slice_t (*on_insts)(const pwasm_inst_t *, const size_t, void *);
   void (*on_error)(const char *, void *);
 } pwasm_parse_code_cbs_t;
@@ -6888,6 +7068,8 @@ pwasm_parse_code_expr(
   // build callbacks
   const pwasm_parse_expr_cbs_t cbs = {
     .on_labels  = src_cbs->on_labels,
+    .on_blocks  = src_cbs->on_blocks,
+    .on_v128s   = src_cbs->on_v128s,
     .on_insts   = src_cbs->on_insts,
     .on_error   = src_cbs->on_error,
   };
@@ -6996,6 +7178,15 @@ typedef struct {
    */
   pwasm_slice_t (*on_insts)(const pwasm_inst_t *, const size_t, void *);
 
+  /**
+   * Called with v128 immediates that should be cached.
+   *
+   * Callback should append the values to an internal list of v128
+   * immediates and then return a slice indicating the offset and length
+   * within the internal list.
+   */
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
+
   /**
    * Called when a parse error occurs.
    */
@@ -7030,6 +7221,7 @@ pwasm_parse_segment(
   {
     // build expr parse cbs
     const pwasm_parse_expr_cbs_t expr_cbs = {
+      .on_v128s = cbs->on_v128s,
       .on_insts = cbs->on_insts,
       .on_error = cbs->on_error,
     };
@@ -7158,6 +7350,211 @@ pwasm_fail(
   mem_ctx->cbs->on_error(text, mem_ctx->cb_data);
 }
 
+//
+// arena allocator: allocations are carved out of blocks from the
+// backing memory context.  each allocation is preceded by a header
+// which stores the allocation size so that it can be resized.
+//
+
+// default size of first arena block
+#define PWASM_ARENA_DEFAULT_BLOCK_SIZE (64 * 1024)
+
+// arena allocation alignment
+#define PWASM_ARENA_ALIGN 16
+
+/**
+ * Arena block.
+ */
+typedef struct pwasm_arena_block_t {
+  struct pwasm_arena_block_t *prev; // previous block
+  size_t size; // usable size, in bytes
+  size_t used; // number of bytes used
+  _Alignas(PWASM_ARENA_ALIGN) uint8_t data[]; // block data
+} pwasm_arena_block_t;
+
+/**
+ * Arena allocation header.
+ */
+typedef struct {
+  _Alignas(PWASM_ARENA_ALIGN) size_t size; // allocation size, in bytes
+} pwasm_arena_head_t;
+
+void
+pwasm_arena_init(
+  pwasm_arena_t * const arena,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const size_t block_size
+) {
+  *arena = (pwasm_arena_t) {
+    .mem_ctx    = mem_ctx,
+    .block_size = block_size ? block_size : PWASM_ARENA_DEFAULT_BLOCK_SIZE,
+  };
+}
+
+void
+pwasm_arena_fini(
+  pwasm_arena_t * const arena
+) {
+  // free blocks
+  pwasm_arena_block_t *block = arena->tail;
+  while (block) {
+    pwasm_arena_block_t * const prev = block->prev;
+    pwasm_realloc(arena->mem_ctx, block, 0);
+    block = prev;
+  }
+
+  arena->tail = NULL;
+  arena->last = NULL;
+}
+
+/**
+ * Get the header of an arena allocation.
+ */
+static inline pwasm_arena_head_t *
+pwasm_arena_get_head(
+  void * const ptr
+) {
+  return (pwasm_arena_head_t*) ptr - 1;
+}
+
+/**
+ * Allocate +size+ bytes from arena.
+ */
+static void *
+pwasm_arena_alloc(
+  pwasm_arena_t * const arena,
+  const size_t size
+) {
+  // get number of bytes needed, including header (aligned), check for
+  // overflow
+  const size_t align = PWASM_ARENA_ALIGN;
+  const size_t need = sizeof(pwasm_arena_head_t) + ((size + align - 1) & ~(align - 1));
+  if (need < size) {
+    return NULL;
+  }
+
+  pwasm_arena_block_t *block = arena->tail;
+  if (!block || (block->size - block->used < need)) {
+    // get block size (blocks double in size), check for overflow
+    const size_t block_size = MAX(arena->block_size, need);
+    if (block_size > SIZE_MAX - sizeof(pwasm_arena_block_t)) {
+      return NULL;
+    }
+
+    // allocate block, check for error
+    block = pwasm_realloc(arena->mem_ctx, NULL, sizeof(pwasm_arena_block_t) + block_size);
+    if (!block) {
+      return NULL;
+    }
+
+    // populate block
+    block->prev = arena->tail;
+    block->size = block_size;
+    block->used = 0;
+
+    // append block, double size of next block
+    arena->tail = block;
+    arena->block_size = (block_size <= SIZE_MAX / 2) ? 2 * block_size : block_size;
+  }
+
+  // bump allocate from block, write header
+  pwasm_arena_head_t * const head = (pwasm_arena_head_t*) (block->data + block->used);
+  head->size = size;
+  block->used += need;
+
+  // save and return allocation
+  arena->last = head + 1;
+  return head + 1;
+}
+
+/**
+ * Arena memory context realloc callback.
+ */
+static void *
+pwasm_arena_on_realloc(
+  void *ptr,
+  size_t size,
+  void *cb_data
+) {
+  pwasm_arena_t * const arena = cb_data;
+  pwasm_arena_block_t * const block = arena->tail;
+  const bool is_last = ptr && (ptr == arena->last);
+  const size_t align = PWASM_ARENA_ALIGN;
+
+  if (!ptr) {
+    // allocate
+    return size ? pwasm_arena_alloc(arena, size) : NULL;
+  }
+
+  // get old size and size of last allocation (excluding header)
+  pwasm_arena_head_t * const head = pwasm_arena_get_head(ptr);
+  const size_t old_size = head->size;
+  const size_t old_need = (old_size + align - 1) & ~(align - 1);
+
+  if (!size) {
+    if (is_last) {
+      // free last allocation
+      block->used -= sizeof(pwasm_arena_head_t) + old_need;
+      arena->last = NULL;
+    }
+
+    // other allocations are released by pwasm_arena_fini()
+    return NULL;
+  }
+
+  if (is_last) {
+    // get space available for last allocation
+    const size_t ofs = (uint8_t*) ptr - block->data;
+    const size_t avail = block->size - ofs;
+
+    if (size <= avail) {
+      // resize last allocation in place
+      block->used = ofs + ((size + align - 1) & ~(align - 1));
+      head->size = size;
+      return ptr;
+    }
+  }
+
+  // allocate new space, check for error
+  void * const new_ptr = pwasm_arena_alloc(arena, size);
+  if (!new_ptr) {
+    return NULL;
+  }
+
+  // copy data, return pointer
+  memcpy(new_ptr, ptr, MIN(old_size, size));
+  return new_ptr;
+}
+
+/**
+ * Arena memory context error callback (forwards errors to the backing
+ * memory context).
+ */
+static void
+pwasm_arena_on_error(
+  const char * const text,
+  void *cb_data
+) {
+  pwasm_arena_t * const arena = cb_data;
+  pwasm_fail(arena->mem_ctx, text);
+}
+
+static const pwasm_mem_cbs_t
+PWASM_ARENA_MEM_CBS = {
+  .on_realloc = pwasm_arena_on_realloc,
+  .on_error   = pwasm_arena_on_error,
+};
+
+pwasm_mem_ctx_t
+pwasm_arena_get_mem_ctx(
+  pwasm_arena_t * const arena
+) {
+  return (pwasm_mem_ctx_t) {
+    .cbs      = &PWASM_ARENA_MEM_CBS,
+    .cb_data  = arena,
+  };
+}
+
 static inline size_t
 pwasm_get_num_bytes(
   const size_t stride,
@@ -7260,8 +7657,10 @@ pwasm_vec_push_uninitialized(
     return false;
   }
 
-  // resize (if necessary), check for error
-  if ((new_len >= vec->max_rows) && !pwasm_vec_resize(vec, new_len)) {
+  // resize (if necessary), check for error.  capacity grows
+  // geometrically so that appends cost amortized O(1) reallocations
+  const size_t new_max = MAX(new_len, 2 * vec->max_rows);
+  if ((new_len > vec->max_rows) && !pwasm_vec_resize(vec, new_max)) {
     // return failure
     return false;
   }
@@ -7278,6 +7677,15 @@ pwasm_vec_push_uninitialized(
   return true;
 }
 
+bool
+pwasm_vec_reserve(
+  pwasm_vec_t * const vec,
+  const size_t num_rows
+) {
+  // resize (if necessary), return result
+  return (num_rows <= vec->max_rows) || pwasm_vec_resize(vec, num_rows);
+}
+
 bool
 pwasm_vec_push(
   pwasm_vec_t * const vec,
@@ -7372,7 +7780,8 @@ pwasm_vec_shrink(
   BUILDER_VEC(type, pwasm_type_t, custom_section) \
   BUILDER_VEC(import, pwasm_import_t, type) \
   BUILDER_VEC(inst, pwasm_inst_t, import) \
-  BUILDER_VEC(global, pwasm_global_t, inst) \
+  BUILDER_VEC(v128, pwasm_v128_t, inst) \
+  BUILDER_VEC(global, pwasm_global_t, v128) \
   BUILDER_VEC(func, uint32_t, global) \
   BUILDER_VEC(table, pwasm_table_t, func) \
   BUILDER_VEC(mem, pwasm_limits_t, table) \
@@ -7381,11 +7790,19 @@ pwasm_vec_shrink(
   BUILDER_VEC(code, pwasm_func_t, local) \
   BUILDER_VEC(elem, pwasm_elem_t, code) \
   BUILDER_VEC(segment, pwasm_segment_t, elem) \
-  BUILDER_VEC(byte, uint8_t, segment) // note: keep at tail for alignment
+  BUILDER_VEC(block, pwasm_block_t, segment) \
+  BUILDER_VEC(byte, uint8_t, block) // note: keep at tail for alignment
 
-bool
-pwasm_builder_init(
+/**
+ * Create module builder whose vectors allocate from +vecs_mem_ctx+.
+ *
+ * The built module is allocated from +mem_ctx+, so +vecs_mem_ctx+ may
+ * be a scratch arena which is released once the module is built.
+ */
+static bool
+pwasm_builder_init_with_vecs_mem_ctx(
   pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_mem_ctx_t * const vecs_mem_ctx,
   pwasm_builder_t * const ret
 ) {
   pwasm_builder_t b = {
@@ -7393,7 +7810,7 @@ pwasm_builder_init(
   };
 
 #define BUILDER_VEC(NAME, TYPE, PREV) \
-  if (!pwasm_vec_init(mem_ctx, &(b.NAME ## s), sizeof(TYPE))) { \
+  if (!pwasm_vec_init(vecs_mem_ctx, &(b.NAME ## s), sizeof(TYPE))) { \
     return false; \
   }
 BUILDER_VECS
@@ -7406,14 +7823,104 @@ BUILDER_VECS
   return true;
 }
 
-void
-pwasm_builder_fini(
-  pwasm_builder_t * const builder
+bool
+pwasm_builder_init(
+  pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_builder_t * const ret
 ) {
-#define BUILDER_VEC(name, type, prev) \
-  if (!pwasm_vec_fini(&(builder->name ## s))) { \
-    /* log error */ \
-    pwasm_fail(builder->mem_ctx, "finalizing builder " #name " failed"); \
+  return pwasm_builder_init_with_vecs_mem_ctx(mem_ctx, mem_ctx, ret);
+}
+
+bool
+pwasm_builder_reserve(
+  pwasm_builder_t * const builder,
+  const pwasm_buf_t src
+) {
+  // total section length and total vector count, by section type
+  size_t lens[PWASM_SECTION_TYPE_LAST] = { 0 };
+  size_t nums[PWASM_SECTION_TYPE_LAST] = { 0 };
+  size_t num_sections = 0;
+
+  // walk section headers (stop at the first invalid header and let the
+  // parser report the error)
+  pwasm_buf_t curr = pwasm_buf_step(src, MIN(src.len, sizeof(PWASM_HEADER)));
+  while (curr.len > 0) {
+    // get section header, check for error
+    pwasm_header_t head;
+    const size_t head_len = pwasm_header_parse(&head, curr);
+    if (!head_len || head.type >= PWASM_SECTION_TYPE_LAST || head.len > curr.len - head_len) {
+      break;
+    }
+    curr = pwasm_buf_step(curr, head_len);
+
+    // get vector count (custom sections count as one entry, and the
+    // start section has no vector)
+    uint32_t num = 1;
+    if (head.type != PWASM_SECTION_TYPE_CUSTOM && !pwasm_u32_decode(&num, (pwasm_buf_t) { curr.ptr, head.len })) {
+      num = 0;
+    }
+
+    // add section length and vector count (every entry is at least
+    // one byte long, which limits bogus counts)
+    lens[head.type] += head.len;
+    nums[head.type] += (head.type != PWASM_SECTION_TYPE_START) ? MIN(num, head.len) : 0;
+    num_sections++;
+
+    // advance
+    curr = pwasm_buf_step(curr, head.len);
+  }
+
+  // estimate sizes of vectors which are not counted directly:
+  // - insts: function bodies average at least two bytes per
+  //   instruction; global, element, and segment offset expressions
+  //   add a few instructions each.
+  // - u32s: type parameters and results and element function indices.
+  // - bytes: names, custom sections, and data segments (unless bytes
+  //   refer to the source buffer).
+  const size_t num_insts = (
+    lens[PWASM_SECTION_TYPE_CODE] / 2 +
+    lens[PWASM_SECTION_TYPE_GLOBAL] / 2 +
+    lens[PWASM_SECTION_TYPE_ELEMENT] / 2 +
+    2 * nums[PWASM_SECTION_TYPE_SEGMENT]
+  );
+  const size_t num_u32s = lens[PWASM_SECTION_TYPE_TYPE] + lens[PWASM_SECTION_TYPE_ELEMENT];
+  const size_t num_bytes = builder->src.ptr ? 0 : (
+    lens[PWASM_SECTION_TYPE_CUSTOM] +
+    lens[PWASM_SECTION_TYPE_IMPORT] +
+    lens[PWASM_SECTION_TYPE_EXPORT] +
+    lens[PWASM_SECTION_TYPE_SEGMENT]
+  );
+
+  // reserve space, return result
+  return (
+    pwasm_vec_reserve(&(builder->sections), num_sections) &&
+    pwasm_vec_reserve(&(builder->custom_sections), nums[PWASM_SECTION_TYPE_CUSTOM]) &&
+    pwasm_vec_reserve(&(builder->types), nums[PWASM_SECTION_TYPE_TYPE]) &&
+    pwasm_vec_reserve(&(builder->imports), nums[PWASM_SECTION_TYPE_IMPORT]) &&
+    pwasm_vec_reserve(&(builder->funcs), nums[PWASM_SECTION_TYPE_FUNCTION]) &&
+    pwasm_vec_reserve(&(builder->tables), nums[PWASM_SECTION_TYPE_TABLE]) &&
+    pwasm_vec_reserve(&(builder->mems), nums[PWASM_SECTION_TYPE_MEMORY]) &&
+    pwasm_vec_reserve(&(builder->globals), nums[PWASM_SECTION_TYPE_GLOBAL]) &&
+    pwasm_vec_reserve(&(builder->exports), nums[PWASM_SECTION_TYPE_EXPORT]) &&
+    pwasm_vec_reserve(&(builder->elems), nums[PWASM_SECTION_TYPE_ELEMENT]) &&
+    pwasm_vec_reserve(&(builder->codes), nums[PWASM_SECTION_TYPE_CODE]) &&
+    pwasm_vec_reserve(&(builder->locals), nums[PWASM_SECTION_TYPE_CODE]) &&
+    pwasm_vec_reserve(&(builder->segments), nums[PWASM_SECTION_TYPE_SEGMENT]) &&
+    pwasm_vec_reserve(&(builder->blocks), lens[PWASM_SECTION_TYPE_CODE] / 16) &&
+    pwasm_vec_reserve(&(builder->insts), num_insts) &&
+    pwasm_vec_reserve(&(builder->u32s), num_u32s) &&
+    pwasm_vec_reserve(&(builder->bytes), num_bytes)
+  );
+}
+
+void
+pwasm_builder_fini(
+  pwasm_builder_t * const builder
+) {
+#define BUILDER_VEC(name, type, prev) \
+  if (!pwasm_vec_fini(&(builder->name ## s))) { \
+    /* log error */ \
+    pwasm_fail(builder->mem_ctx, "finalizing builder " #name " failed"); \
   }
 BUILDER_VECS
 #undef BUILDER_VEC
@@ -7458,6 +7965,7 @@ pwasm_builder_resolve_jumps(
   pwasm_mod_t * const mod
 ) {
   pwasm_inst_t * const insts = (pwasm_inst_t*) mod->insts;
+  pwasm_block_t * const blocks = (pwasm_block_t*) mod->blocks;
 
   // init offset stack
   pwasm_vec_t stack;
@@ -7473,8 +7981,8 @@ pwasm_builder_resolve_jumps(
     pwasm_vec_clear(&stack);
 
     {
-      // push control offset
-      const size_t expr_ofs = 0;
+      // push control offset (function body has no block metadata)
+      const size_t expr_ofs = SIZE_MAX;
       if (!pwasm_vec_push(&stack, 1, &expr_ofs, NULL)) {
         pwasm_fail(builder->mem_ctx, "builder control stack push");
         return false;
@@ -7495,8 +8003,8 @@ pwasm_builder_resolve_jumps(
         }
 
         // clear else/end offsets
-        insts[func.expr.ofs + j].v_block.else_ofs = 0;
-        insts[func.expr.ofs + j].v_block.end_ofs = 0;
+        blocks[in.v_block].else_ofs = 0;
+        blocks[in.v_block].end_ofs = 0;
 
         break;
       case PWASM_OP_ELSE:
@@ -7508,8 +8016,18 @@ pwasm_builder_resolve_jumps(
             return false;
           }
 
-          // save else offset
-          insts[func.expr.ofs + *ofs].v_block.else_ofs = j - *ofs;
+          // check for if inst (checked again in pwasm_checker_check())
+          if (*ofs == SIZE_MAX || insts[func.expr.ofs + *ofs].op != PWASM_OP_IF) {
+            pwasm_fail(builder->mem_ctx, "else: missing if");
+            return false;
+          }
+
+          // get if block metadata offset
+          const uint32_t block_ofs = insts[func.expr.ofs + *ofs].v_block;
+
+          // save else offset, share block metadata with else inst
+          blocks[block_ofs].else_ofs = j - *ofs;
+          insts[func.expr.ofs + j].v_block = block_ofs;
         }
 
         break;
@@ -7522,19 +8040,10 @@ pwasm_builder_resolve_jumps(
             return false;
           }
 
-          if (
-            (insts[func.expr.ofs + ofs].op == PWASM_OP_IF) &&
-            (insts[func.expr.ofs + ofs].v_block.else_ofs)
-          ) {
-            const size_t if_ofs = func.expr.ofs + ofs;
-            const size_t else_ofs = if_ofs + insts[if_ofs].v_block.else_ofs;
-
-            // cache end ofs for else inst
-            insts[else_ofs].v_block.end_ofs = j - else_ofs;
+          if (ofs != SIZE_MAX) {
+            // save end offset
+            blocks[insts[func.expr.ofs + ofs].v_block].end_ofs = j - ofs;
           }
-
-          // save end offset
-          insts[func.expr.ofs + ofs].v_block.end_ofs = j - ofs;
         }
 
         break;
@@ -7624,6 +8133,12 @@ pwasm_builder_build_mod(
   // copy result to output
   memcpy(dst, &mod, sizeof(pwasm_mod_t));
 
+  if (builder->src.ptr) {
+    // no-copy mode: byte slices refer to the source buffer
+    memcpy((void*) &(dst->bytes), &(builder->src.ptr), sizeof(dst->bytes));
+    memcpy((void*) &(dst->num_bytes), &(builder->src.len), sizeof(dst->num_bytes));
+  }
+
   // resolve else/end insts for if/loop/block
   if (!pwasm_builder_resolve_jumps(builder, dst)) {
     // return failure
@@ -7636,7 +8151,6 @@ pwasm_builder_build_mod(
 
 DEF_VEC_PARSER(type, pwasm_type_t)
 DEF_VEC_PARSER(import, pwasm_import_t)
-DEF_VEC_PARSER(func, uint32_t)
 DEF_VEC_PARSER(table, pwasm_table_t)
 DEF_VEC_PARSER(mem, pwasm_limits_t)
 DEF_VEC_PARSER(global, pwasm_global_t)
@@ -7645,6 +8159,75 @@ DEF_VEC_PARSER(elem, pwasm_elem_t)
 DEF_VEC_PARSER(code, pwasm_func_t)
 DEF_VEC_PARSER(segment, pwasm_segment_t)
 
+static void
+pwasm_mod_parse_funcs_null_on_funcs(
+  const uint32_t * rows,
+  const size_t num,
+  void *cb_data
+) {
+  (void) rows;
+  (void) num;
+  (void) cb_data;
+}
+
+/**
+ * Parse function section.
+ *
+ * This is equivalent to the DEF_VEC_PARSER() parsers above, except that
+ * function type indices are decoded in batches with pwasm_u32s_decode().
+ *
+ * Returns the number of bytes consumed, or 0 on error.
+ */
+static size_t
+pwasm_mod_parse_funcs(
+  const pwasm_buf_t src,
+  const pwasm_mod_parse_cbs_t * const cbs,
+  void *cb_data
+) {
+  void (*on_error)(const char *, void *) = cbs->on_error ? cbs->on_error : pwasm_null_on_error;
+  void (*on_funcs)(const uint32_t *, const size_t, void *) = cbs->on_funcs ? cbs->on_funcs : pwasm_mod_parse_funcs_null_on_funcs;
+
+  // get count, check for error
+  uint32_t count = 0;
+  const size_t count_len = pwasm_u32_decode(&count, src);
+  if (!count_len) {
+    on_error("funcs: invalid count", cb_data);
+    return 0;
+  }
+
+  // track number of bytes and current buffer
+  size_t num_bytes = count_len;
+  pwasm_buf_t curr = pwasm_buf_step(src, count_len);
+  uint32_t dst[PWASM_BATCH_SIZE];
+
+  for (size_t i = 0; i < count;) {
+    // check for underflow
+    if (!curr.len) {
+      on_error("funcs: underflow", cb_data);
+      return 0;
+    }
+
+    // decode batch of function type indices, check for error
+    const size_t num = MIN(count - i, LEN(dst));
+    const size_t len = pwasm_u32s_decode(dst, num, curr);
+    if (!len) {
+      on_error("invalid function id", cb_data);
+      return 0;
+    }
+
+    // flush batch
+    on_funcs(dst, num, cb_data);
+
+    // advance
+    curr = pwasm_buf_step(curr, len);
+    num_bytes += len;
+    i += num;
+  }
+
+  // return number of bytes consumed
+  return num_bytes;
+}
+
 static size_t
 pwasm_mod_parse_custom_section(
   const pwasm_buf_t src,
@@ -7696,20 +8279,6 @@ pwasm_mod_parse_import(
   return pwasm_parse_import(dst, src, &cbs, cb_data);
 }
 
-static size_t
-pwasm_mod_parse_func(
-  uint32_t * const dst,
-  const pwasm_buf_t src,
-  const pwasm_mod_parse_cbs_t * const cbs,
-  void * const cb_data
-) {
-  const size_t len = pwasm_u32_decode(dst, src);
-  if (!len) {
-    cbs->on_error("invalid function id", cb_data);
-  }
-
-  return len;
-}
 
 static size_t
 pwasm_mod_parse_table(
@@ -7742,6 +8311,8 @@ pwasm_mod_parse_global(
 
   const pwasm_parse_expr_cbs_t cbs = {
     .on_labels  = src_cbs->on_labels,
+    .on_blocks  = src_cbs->on_blocks,
+    .on_v128s   = src_cbs->on_v128s,
     .on_insts   = src_cbs->on_insts,
     .on_error   = src_cbs->on_error,
   };
@@ -7772,6 +8343,7 @@ pwasm_mod_parse_elem(
 ) {
   const pwasm_parse_elem_cbs_t cbs = {
     .on_funcs = src_cbs->on_u32s,
+    .on_v128s = src_cbs->on_v128s,
     .on_insts = src_cbs->on_insts,
     .on_error = src_cbs->on_error,
   };
@@ -7787,6 +8359,8 @@ pwasm_mod_parse_code(
 ) {
   const pwasm_parse_code_cbs_t cbs = {
     .on_labels  = src_cbs->on_u32s,
+    .on_blocks  = src_cbs->on_blocks,
+    .on_v128s   = src_cbs->on_v128s,
     .on_locals  = src_cbs->on_locals,
     .on_insts   = src_cbs->on_insts,
     .on_error   = src_cbs->on_error,
@@ -7803,6 +8377,7 @@ pwasm_mod_parse_segment(
 ) {
   const pwasm_parse_segment_cbs_t cbs = {
     .on_bytes   = src_cbs->on_bytes,
+    .on_v128s   = src_cbs->on_v128s,
     .on_insts   = src_cbs->on_insts,
     .on_error   = src_cbs->on_error,
   };
@@ -7943,6 +8518,12 @@ pwasm_mod_parse(
     cbs.on_section(&head, cb_data);
 
     if (head.len > 0) {
+      // check section length
+      if (head.len > curr.len) {
+        cbs.on_error("truncated section", cb_data);
+        return 0;
+      }
+
       // build body buffer
       const pwasm_buf_t body = { curr.ptr, head.len };
 
@@ -7953,6 +8534,11 @@ pwasm_mod_parse(
         return 0;
       }
 
+      if (body_len != head.len) {
+        cbs.on_error("section length mismatch", cb_data);
+        return 0;
+      }
+
       // advance
       curr = pwasm_buf_step(curr, body_len);
       num_bytes += body_len;
@@ -7963,118 +8549,446 @@ pwasm_mod_parse(
   return num_bytes;
 }
 
-typedef struct {
-  pwasm_builder_t * const builder;
-  bool success;
-} pwasm_mod_init_unsafe_t;
+//
+// streaming module parser: buffers the current section header or
+// section body until it is complete, and then parses it with the same
+// functions as pwasm_mod_parse().  complete sections in the fed bytes
+// are parsed in place without buffering.
+//
 
-static void
-pwasm_mod_init_unsafe_on_error(
-  const char * const text,
+// streaming module parser states
+typedef enum {
+  PWASM_MOD_PARSER_STATE_MAGIC, // reading module header
+  PWASM_MOD_PARSER_STATE_HEAD, // reading section header
+  PWASM_MOD_PARSER_STATE_BODY, // reading section body
+  PWASM_MOD_PARSER_STATE_FAIL, // failed
+} pwasm_mod_parser_state_t;
+
+bool
+pwasm_mod_parser_init(
+  pwasm_mod_parser_t * const parser,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const pwasm_mod_parse_cbs_t * const cbs,
   void *cb_data
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
+  // clear parser (pwasm_vec_t has a const member, so the struct cannot
+  // be assigned)
+  memset(parser, 0, sizeof(pwasm_mod_parser_t));
+  parser->cbs = cbs;
+  parser->cb_data = cb_data;
+  parser->state = PWASM_MOD_PARSER_STATE_MAGIC;
 
-  if (data->success) {
-    pwasm_fail(data->builder->mem_ctx, text);
-    data->success = false;
-  }
+  // init buffer, return result
+  return pwasm_vec_init(mem_ctx, &(parser->buf), 1);
 }
 
-static pwasm_slice_t
-pwasm_mod_init_unsafe_on_u32s(
-  const uint32_t * const rows,
-  const size_t num,
-  void *cb_data
+void
+pwasm_mod_parser_fini(
+  pwasm_mod_parser_t * const parser
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
+  pwasm_vec_fini(&(parser->buf));
+}
 
-  const pwasm_slice_t ret = pwasm_builder_push_u32s(data->builder, rows, num);
-  if (!ret.len) {
-    pwasm_mod_init_unsafe_on_error("push u32s failed", data);
+/**
+ * Report error and mark streaming parser as failed.
+ *
+ * Always returns false.
+ */
+static bool
+pwasm_mod_parser_fail(
+  pwasm_mod_parser_t * const parser,
+  const char * const text
+) {
+  parser->cbs->on_error(text, parser->cb_data);
+  parser->state = PWASM_MOD_PARSER_STATE_FAIL;
+  return false;
+}
+
+/**
+ * Get the length of the complete section header at the start of
+ * +src+, or 0 if more bytes are needed.
+ */
+static size_t
+pwasm_mod_parser_get_head_len(
+  const pwasm_buf_t src
+) {
+  // section type, followed by a u32 length of at most 5 bytes
+  const size_t len = MIN(src.len, 6);
+  for (size_t i = 1; i < len; i++) {
+    if (!(src.ptr[i] & 0x80)) {
+      return i + 1;
+    }
   }
 
-  return ret;
+  return (len == 6) ? len : 0;
 }
 
-static pwasm_slice_t
-pwasm_mod_init_unsafe_on_bytes(
-  const uint8_t * const bytes,
-  const size_t num,
-  void *cb_data
+/**
+ * Handle complete section header in +src+.
+ */
+static bool
+pwasm_mod_parser_on_head(
+  pwasm_mod_parser_t * const parser,
+  const pwasm_buf_t src
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
+  // get section header, check for error
+  pwasm_header_t head;
+  if (!pwasm_header_parse(&head, src)) {
+    return pwasm_mod_parser_fail(parser, "invalid section header");
+  }
 
-  D("bytes = %p, num = %zu", (void*) bytes, num);
+  // check section type
+  if (head.type >= PWASM_SECTION_TYPE_LAST) {
+    return pwasm_mod_parser_fail(parser, "invalid section type");
+  }
 
-  const pwasm_slice_t ret = pwasm_builder_push_bytes(data->builder, bytes, num);
-  if (ret.len != num) {
-    pwasm_mod_init_unsafe_on_error("push bytes failed", data);
+  // check section order for non-custom sections
+  if (head.type != PWASM_SECTION_TYPE_CUSTOM) {
+    if (head.type <= parser->max_type) {
+      const char * const text = (head.type < parser->max_type) ? "invalid section order" : "duplicate section";
+      return pwasm_mod_parser_fail(parser, text);
+    }
+
+    // update maximum section type
+    parser->max_type = head.type;
   }
 
-  return ret;
-}
+  // invoke section header callback
+  parser->cbs->on_section(&head, parser->cb_data);
 
-static void
-pwasm_mod_init_unsafe_on_section(
-  const pwasm_header_t * const header,
-  void *cb_data
-) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
-  if (!pwasm_builder_push_sections(data->builder, header, 1).len) {
-    pwasm_mod_init_unsafe_on_error("push sections failed", data);
+  if (head.len > 0) {
+    // save header, read body
+    parser->head = head;
+    parser->state = PWASM_MOD_PARSER_STATE_BODY;
+  } else if (head.type != PWASM_SECTION_TYPE_CUSTOM) {
+    // empty section, mark section as done
+    parser->done_type = head.type;
   }
+
+  // return success
+  return true;
 }
 
-static void
-pwasm_mod_init_unsafe_on_custom_section(
-  const pwasm_custom_section_t * const section,
-  void *cb_data
+/**
+ * Handle complete section body in +src+.
+ */
+static bool
+pwasm_mod_parser_on_body(
+  pwasm_mod_parser_t * const parser,
+  const pwasm_buf_t src
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
-  if (!pwasm_builder_push_custom_sections(data->builder, section, 1).len) {
-    pwasm_mod_init_unsafe_on_error("push custom sections failed", data);
+  const pwasm_header_t head = parser->head;
+
+  // parse section, check for error
+  const size_t len = pwasm_mod_parse_section(head.type, src, parser->cbs, parser->cb_data);
+  if (!len) {
+    // mark parser as failed (error was reported by section parser)
+    parser->state = PWASM_MOD_PARSER_STATE_FAIL;
+    return false;
   }
+
+  // check section length
+  if (len != head.len) {
+    return pwasm_mod_parser_fail(parser, "section length mismatch");
+  }
+
+  if (head.type != PWASM_SECTION_TYPE_CUSTOM) {
+    // mark section as done
+    parser->done_type = head.type;
+  }
+
+  // read next section header
+  parser->state = PWASM_MOD_PARSER_STATE_HEAD;
+
+  // return success
+  return true;
 }
 
-static void
-pwasm_mod_init_unsafe_on_types(
-  const pwasm_type_t * const rows,
-  const size_t num,
-  void *cb_data
+/**
+ * Append +len+ bytes from +src+ to the pending buffer of the streaming
+ * parser.
+ */
+static bool
+pwasm_mod_parser_push(
+  pwasm_mod_parser_t * const parser,
+  const pwasm_buf_t src,
+  const size_t len
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
-  if (!pwasm_builder_push_types(data->builder, rows, num).len) {
-    pwasm_mod_init_unsafe_on_error("push types failed", data);
+  if (!pwasm_vec_push(&(parser->buf), len, src.ptr, NULL)) {
+    return pwasm_mod_parser_fail(parser, "buffer section failed");
   }
+
+  // return success
+  return true;
 }
 
-static void
-pwasm_mod_init_unsafe_on_imports(
-  const pwasm_import_t * const rows,
-  const size_t num,
-  void *cb_data
+bool
+pwasm_mod_parser_feed(
+  pwasm_mod_parser_t * const parser,
+  const pwasm_buf_t src
 ) {
-  pwasm_mod_init_unsafe_t * const data = cb_data;
-
-  if (!pwasm_builder_push_imports(data->builder, rows, num).len) {
-    pwasm_mod_init_unsafe_on_error("push imports failed", data);
-    return;
+  if (parser->state == PWASM_MOD_PARSER_STATE_FAIL) {
+    // return failure
+    return false;
   }
 
-  for (size_t i = 0; i < num; i++) {
-    switch (rows[i].type) {
-    case PWASM_IMPORT_TYPE_FUNC:
+  // update source length
+  parser->num_bytes += src.len;
+
+  pwasm_vec_t * const buf = &(parser->buf);
+  pwasm_buf_t curr = src;
+  while (curr.len > 0) {
+    const size_t buf_len = pwasm_vec_get_size(buf);
+
+    switch (parser->state) {
+    case PWASM_MOD_PARSER_STATE_MAGIC:
       {
-        if (!pwasm_builder_push_funcs(data->builder, &(rows[i].func), 1).len) {
-          pwasm_mod_init_unsafe_on_error("push func import failed", data);
-          return;
+        // buffer module header, check for error
+        const size_t len = MIN(curr.len, sizeof(PWASM_HEADER) - buf_len);
+        if (!pwasm_mod_parser_push(parser, curr, len)) {
+          return false;
+        }
+        curr = pwasm_buf_step(curr, len);
+
+        if (buf_len + len == sizeof(PWASM_HEADER)) {
+          // check magic and version
+          if (memcmp(pwasm_vec_get_data(buf), PWASM_HEADER, sizeof(PWASM_HEADER))) {
+            return pwasm_mod_parser_fail(parser, "invalid module header");
+          }
+
+          // clear buffer, read first section header
+          pwasm_vec_clear(buf);
+          parser->state = PWASM_MOD_PARSER_STATE_HEAD;
         }
       }
 
       break;
-    case PWASM_IMPORT_TYPE_TABLE:
-      {
+    case PWASM_MOD_PARSER_STATE_HEAD:
+      if (!buf_len) {
+        // parse complete section header in place
+        const size_t len = pwasm_mod_parser_get_head_len(curr);
+        if (len > 0) {
+          if (!pwasm_mod_parser_on_head(parser, (pwasm_buf_t) { curr.ptr, len })) {
+            return false;
+          }
+
+          curr = pwasm_buf_step(curr, len);
+          break;
+        }
+      }
+
+      {
+        // buffer one byte of section header, check for error
+        if (!pwasm_mod_parser_push(parser, curr, 1)) {
+          return false;
+        }
+        curr = pwasm_buf_step(curr, 1);
+
+        // check for complete section header
+        const pwasm_buf_t head_buf = { pwasm_vec_get_data(buf), buf_len + 1 };
+        if (pwasm_mod_parser_get_head_len(head_buf) > 0) {
+          if (!pwasm_mod_parser_on_head(parser, head_buf)) {
+            return false;
+          }
+
+          // clear buffer
+          pwasm_vec_clear(buf);
+        }
+      }
+
+      break;
+    case PWASM_MOD_PARSER_STATE_BODY:
+      {
+        const size_t body_len = parser->head.len;
+        if (!buf_len && curr.len >= body_len) {
+          // parse complete section body in place
+          if (!pwasm_mod_parser_on_body(parser, (pwasm_buf_t) { curr.ptr, body_len })) {
+            return false;
+          }
+
+          curr = pwasm_buf_step(curr, body_len);
+          break;
+        }
+
+        // buffer partial section body, check for error
+        const size_t len = MIN(curr.len, body_len - buf_len);
+        if (!pwasm_mod_parser_push(parser, curr, len)) {
+          return false;
+        }
+        curr = pwasm_buf_step(curr, len);
+
+        if (buf_len + len == body_len) {
+          // parse buffered section body
+          const pwasm_buf_t body = { pwasm_vec_get_data(buf), body_len };
+          if (!pwasm_mod_parser_on_body(parser, body)) {
+            return false;
+          }
+
+          // clear buffer
+          pwasm_vec_clear(buf);
+        }
+      }
+
+      break;
+    default:
+      // never reached
+      return false;
+    }
+  }
+
+  // return success
+  return true;
+}
+
+size_t
+pwasm_mod_parser_finish(
+  pwasm_mod_parser_t * const parser
+) {
+  switch (parser->state) {
+  case PWASM_MOD_PARSER_STATE_MAGIC:
+    pwasm_mod_parser_fail(parser, "source too small");
+    return 0;
+  case PWASM_MOD_PARSER_STATE_HEAD:
+    if (pwasm_vec_get_size(&(parser->buf)) > 0) {
+      pwasm_mod_parser_fail(parser, "invalid section header");
+      return 0;
+    }
+
+    // return number of bytes consumed
+    return parser->num_bytes;
+  case PWASM_MOD_PARSER_STATE_BODY:
+    pwasm_mod_parser_fail(parser, "truncated section");
+    return 0;
+  default:
+    // return failure
+    return 0;
+  }
+}
+
+typedef struct {
+  pwasm_builder_t * const builder;
+  bool success;
+} pwasm_mod_init_unsafe_t;
+
+static void
+pwasm_mod_init_unsafe_on_error(
+  const char * const text,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+
+  if (data->success) {
+    pwasm_fail(data->builder->mem_ctx, text);
+    data->success = false;
+  }
+}
+
+static pwasm_slice_t
+pwasm_mod_init_unsafe_on_u32s(
+  const uint32_t * const rows,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+
+  const pwasm_slice_t ret = pwasm_builder_push_u32s(data->builder, rows, num);
+  if (!ret.len) {
+    pwasm_mod_init_unsafe_on_error("push u32s failed", data);
+  }
+
+  return ret;
+}
+
+static pwasm_slice_t
+pwasm_mod_init_unsafe_on_bytes(
+  const uint8_t * const bytes,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+  const pwasm_buf_t src = data->builder->src;
+
+  D("bytes = %p, num = %zu", (void*) bytes, num);
+
+  if (src.ptr) {
+    // no-copy mode: return slice of source buffer, check for error
+    const bool ok = (bytes >= src.ptr) && (num <= src.len) && ((size_t) (bytes - src.ptr) <= src.len - num);
+    if (!ok) {
+      pwasm_mod_init_unsafe_on_error("bytes outside of source", data);
+      return (pwasm_slice_t) { 0, 0 };
+    }
+
+    return (pwasm_slice_t) { bytes - src.ptr, num };
+  }
+
+  const pwasm_slice_t ret = pwasm_builder_push_bytes(data->builder, bytes, num);
+  if (ret.len != num) {
+    pwasm_mod_init_unsafe_on_error("push bytes failed", data);
+  }
+
+  return ret;
+}
+
+static void
+pwasm_mod_init_unsafe_on_section(
+  const pwasm_header_t * const header,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+  if (!pwasm_builder_push_sections(data->builder, header, 1).len) {
+    pwasm_mod_init_unsafe_on_error("push sections failed", data);
+  }
+}
+
+static void
+pwasm_mod_init_unsafe_on_custom_section(
+  const pwasm_custom_section_t * const section,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+  if (!pwasm_builder_push_custom_sections(data->builder, section, 1).len) {
+    pwasm_mod_init_unsafe_on_error("push custom sections failed", data);
+  }
+}
+
+static void
+pwasm_mod_init_unsafe_on_types(
+  const pwasm_type_t * const rows,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+  if (!pwasm_builder_push_types(data->builder, rows, num).len) {
+    pwasm_mod_init_unsafe_on_error("push types failed", data);
+  }
+}
+
+static void
+pwasm_mod_init_unsafe_on_imports(
+  const pwasm_import_t * const rows,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+
+  if (!pwasm_builder_push_imports(data->builder, rows, num).len) {
+    pwasm_mod_init_unsafe_on_error("push imports failed", data);
+    return;
+  }
+
+  for (size_t i = 0; i < num; i++) {
+    switch (rows[i].type) {
+    case PWASM_IMPORT_TYPE_FUNC:
+      {
+        if (!pwasm_builder_push_funcs(data->builder, &(rows[i].func), 1).len) {
+          pwasm_mod_init_unsafe_on_error("push func import failed", data);
+          return;
+        }
+      }
+
+      break;
+    case PWASM_IMPORT_TYPE_TABLE:
+      {
         if (!pwasm_builder_push_tables(data->builder, &(rows[i].table), 1).len) {
           pwasm_mod_init_unsafe_on_error("push table import failed", data);
           return;
@@ -8247,6 +9161,38 @@ pwasm_mod_init_unsafe_on_labels(
   return ret;
 }
 
+static pwasm_slice_t
+pwasm_mod_init_unsafe_on_blocks(
+  const pwasm_block_t * const rows,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+
+  pwasm_slice_t ret = pwasm_builder_push_blocks(data->builder, rows, num);
+  if (!ret.len) {
+    pwasm_mod_init_unsafe_on_error("push blocks failed", data);
+  }
+
+  return ret;
+}
+
+static pwasm_slice_t
+pwasm_mod_init_unsafe_on_v128s(
+  const pwasm_v128_t * const rows,
+  const size_t num,
+  void *cb_data
+) {
+  pwasm_mod_init_unsafe_t * const data = cb_data;
+
+  pwasm_slice_t ret = pwasm_builder_push_v128s(data->builder, rows, num);
+  if (!ret.len) {
+    pwasm_mod_init_unsafe_on_error("push v128s failed", data);
+  }
+
+  return ret;
+}
+
 static void
 pwasm_mod_init_unsafe_on_codes(
   const pwasm_func_t * const rows,
@@ -8358,25 +9304,56 @@ PWASM_MOD_INIT_UNSAFE_PARSE_CBS = {
   .on_start           = pwasm_mod_init_unsafe_on_start,
   .on_locals          = pwasm_mod_init_unsafe_on_locals,
   .on_labels          = pwasm_mod_init_unsafe_on_labels,
+  .on_blocks          = pwasm_mod_init_unsafe_on_blocks,
+  .on_v128s           = pwasm_mod_init_unsafe_on_v128s,
   .on_codes           = pwasm_mod_init_unsafe_on_codes,
   .on_elems           = pwasm_mod_init_unsafe_on_elems,
   .on_segments        = pwasm_mod_init_unsafe_on_segments,
 };
 
-size_t
-pwasm_mod_init_unsafe(
+/**
+ * Parse a module without validating it, applying the given module init
+ * flags.
+ */
+static size_t
+pwasm_mod_init_unsafe_with_flags(
   pwasm_mem_ctx_t * const mem_ctx,
   pwasm_mod_t * const mod,
-  pwasm_buf_t src
+  pwasm_buf_t src,
+  const uint64_t flags
 ) {
   // unconditionally zero out backing memory to prevent a segfault if
   // someone tries to pwasm_mod_fini() on a mod that isn't initialized
   // because pwasm_mod_init() fails (e.g., me)
   memset(&(mod->mem), 0, sizeof(pwasm_buf_t));
+  memset((void*) &(mod->heights), 0, sizeof(mod->heights));
+
+  // init scratch arena for builder vectors, sized so that most modules
+  // fit in the first block (the arena is released once the module has
+  // been built; the module itself is allocated from mem_ctx)
+  pwasm_arena_t arena;
+  const size_t arena_block_size = (src.len < SIZE_MAX / 16) ? (
+    8 * src.len + 2 * PWASM_ARENA_DEFAULT_BLOCK_SIZE
+  ) : 0;
+  pwasm_arena_init(&arena, mem_ctx, arena_block_size);
+  pwasm_mem_ctx_t arena_mem_ctx = pwasm_arena_get_mem_ctx(&arena);
 
   // init builder, check for error
   pwasm_builder_t builder;
-  if (!pwasm_builder_init(mem_ctx, &builder)) {
+  if (!pwasm_builder_init_with_vecs_mem_ctx(mem_ctx, &arena_mem_ctx, &builder)) {
+    pwasm_arena_fini(&arena);
+    return 0;
+  }
+
+  if (flags & PWASM_MOD_INIT_FLAG_NO_COPY) {
+    // refer to bytes in source buffer instead of copying them
+    builder.src = src;
+  }
+
+  // pre-size builder vectors from section headers, check for error
+  if (!pwasm_builder_reserve(&builder, src)) {
+    pwasm_builder_fini(&builder);
+    pwasm_arena_fini(&arena);
     return 0;
   }
 
@@ -8386,72 +9363,234 @@ pwasm_mod_init_unsafe(
     .success = true,
   };
 
-  // parse mod into builder, check for error
+  // parse mod into builder, then build mod
   const size_t len = pwasm_mod_parse(src, &PWASM_MOD_INIT_UNSAFE_PARSE_CBS, &ctx);
-  if (!len) {
-    return 0;
-  }
+  const bool ok = len && pwasm_builder_build_mod(&builder, mod);
 
-  // build mod, check for error
-  if (!pwasm_builder_build_mod(&builder, mod)) {
+  // finalize builder and scratch arena
+  pwasm_builder_fini(&builder);
+  pwasm_arena_fini(&arena);
+
+  // check for error
+  if (!ok) {
     return 0;
   }
 
-  // finalize builder
-  pwasm_builder_fini(&builder);
-
   // return number of bytes consumed
   return len;
 }
 
 size_t
-pwasm_mod_init(
+pwasm_mod_init_unsafe(
   pwasm_mem_ctx_t * const mem_ctx,
   pwasm_mod_t * const mod,
   pwasm_buf_t src
 ) {
-  // init mod
-  const size_t len = pwasm_mod_init_unsafe(mem_ctx, mod, src);
-  if (!len) {
-    // return failure
-    return 0;
-  }
+  return pwasm_mod_init_unsafe_with_flags(mem_ctx, mod, src, 0);
+}
 
-  const pwasm_mod_check_cbs_t cbs = {
-    // TODO: .on_warning = mem_ctx->cbs->on_error,
-    .on_error = mem_ctx->cbs->on_error,
-  };
+/**
+ * Value stack height table (see the `heights` member of `pwasm_mod_t`).
+ */
+typedef struct {
+  pwasm_mem_ctx_t *mem_ctx; // memory context
+  uint32_t *rows; // block heights, followed by function body heights
+  size_t num_blocks; // number of block heights
+} pwasm_mod_heights_t;
 
-  // check module
-  if (!pwasm_mod_check(mod, &cbs, mem_ctx->cb_data)) {
-    // return failure
-    return 0;
+/**
+ * Allocate a zeroed value stack height table for the given module.
+ */
+static bool
+pwasm_mod_heights_init(
+  pwasm_mod_heights_t * const heights,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const pwasm_mod_t * const mod
+) {
+  const size_t num_bytes = sizeof(uint32_t) * (mod->num_blocks + mod->num_codes);
+  uint32_t * const rows = num_bytes ? pwasm_realloc(mem_ctx, NULL, num_bytes) : NULL;
+  if (num_bytes && !rows) {
+    pwasm_fail(mem_ctx, "allocate value stack heights failed");
+    return false;
   }
 
-  // return success
-  return len;
+  if (num_bytes) {
+    // clear heights
+    memset(rows, 0, num_bytes);
+  }
+
+  // populate result, return success
+  heights->mem_ctx = mem_ctx;
+  heights->rows = rows;
+  heights->num_blocks = mod->num_blocks;
+  return true;
 }
 
 /**
- * Finalize a parsed mod and free all memory associated with it.
+ * Free value stack height table.
  */
-void
-pwasm_mod_fini(
-  pwasm_mod_t * const mod
+static void
+pwasm_mod_heights_fini(
+  pwasm_mod_heights_t * const heights
 ) {
-  if (mod->mem.ptr && (mod->mem.len > 0)) {
-    pwasm_realloc(mod->mem_ctx, (void*) mod->mem.ptr, 0);
-    mod->mem.ptr = 0;
-    mod->mem.len = 0;
+  if (heights->rows) {
+    pwasm_realloc(heights->mem_ctx, heights->rows, 0);
+    heights->rows = NULL;
   }
 }
 
 /**
- * Convert a slice in a parse module to a buffer.
+ * Save block height (mod check callback).
  */
-static pwasm_buf_t
-pwasm_mod_get_buf(
-  const pwasm_mod_t * const mod,
+static void
+pwasm_mod_heights_on_block(
+  const size_t block_ofs,
+  const size_t height,
+  void *cb_data
+) {
+  pwasm_mod_heights_t * const heights = cb_data;
+  heights->rows[block_ofs] = height;
+}
+
+/**
+ * Save function body height (mod check callback).
+ */
+static void
+pwasm_mod_heights_on_code(
+  const size_t code_ofs,
+  const size_t height,
+  void *cb_data
+) {
+  pwasm_mod_heights_t * const heights = cb_data;
+  heights->rows[heights->num_blocks + code_ofs] = height;
+}
+
+/**
+ * Forward error to memory context (mod check callback).
+ */
+static void
+pwasm_mod_heights_on_error(
+  const char * const text,
+  void *cb_data
+) {
+  const pwasm_mod_heights_t * const heights = cb_data;
+  pwasm_fail(heights->mem_ctx, text);
+}
+
+/**
+ * Move value stack height table to the given module.
+ */
+static void
+pwasm_mod_heights_attach(
+  pwasm_mod_heights_t * const heights,
+  pwasm_mod_t * const mod
+) {
+  memcpy((void*) &(mod->heights), &(heights->rows), sizeof(mod->heights));
+  heights->rows = NULL;
+}
+
+static bool pwasm_mod_check_with_threads(const pwasm_mod_t *, const pwasm_mod_check_cbs_t *, void *, const size_t);
+
+/**
+ * Verify that a parsed module is valid with the given number of
+ * threads, and record the value stack heights of the module in
+ * `heights`.
+ *
+ * Errors are reported to the memory context `mem_ctx`.  On success,
+ * the caller owns `heights` and must free it with
+ * pwasm_mod_heights_fini() or move it to a module with
+ * pwasm_mod_heights_attach().
+ */
+static bool
+pwasm_mod_check_heights(
+  const pwasm_mod_t * const mod,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const size_t num_threads,
+  pwasm_mod_heights_t * const heights
+) {
+  static const pwasm_mod_check_cbs_t cbs = {
+    .on_error = pwasm_mod_heights_on_error,
+    .on_block = pwasm_mod_heights_on_block,
+    .on_code  = pwasm_mod_heights_on_code,
+  };
+
+  // allocate heights, check for error
+  if (!pwasm_mod_heights_init(heights, mem_ctx, mod)) {
+    return false;
+  }
+
+  // check module, check for error
+  if (!pwasm_mod_check_with_threads(mod, &cbs, heights, num_threads)) {
+    pwasm_mod_heights_fini(heights);
+    return false;
+  }
+
+  // return success
+  return true;
+}
+
+size_t
+pwasm_mod_init_with_flags(
+  pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_mod_t * const mod,
+  pwasm_buf_t src,
+  const uint64_t flags
+) {
+  // init mod
+  const size_t len = pwasm_mod_init_unsafe_with_flags(mem_ctx, mod, src, flags);
+  if (!len) {
+    // return failure
+    return 0;
+  }
+
+  // check module and record value stack heights, check for error
+  pwasm_mod_heights_t heights;
+  if (!pwasm_mod_check_heights(mod, mem_ctx, 1, &heights)) {
+    // return failure
+    return 0;
+  }
+
+  // save value stack heights
+  pwasm_mod_heights_attach(&heights, mod);
+
+  // return success
+  return len;
+}
+
+size_t
+pwasm_mod_init(
+  pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_mod_t * const mod,
+  pwasm_buf_t src
+) {
+  return pwasm_mod_init_with_flags(mem_ctx, mod, src, 0);
+}
+
+/**
+ * Finalize a parsed mod and free all memory associated with it.
+ */
+void
+pwasm_mod_fini(
+  pwasm_mod_t * const mod
+) {
+  if (mod->mem.ptr && (mod->mem.len > 0)) {
+    pwasm_realloc(mod->mem_ctx, (void*) mod->mem.ptr, 0);
+    mod->mem.ptr = 0;
+    mod->mem.len = 0;
+  }
+
+  if (mod->heights) {
+    pwasm_realloc(mod->mem_ctx, (void*) mod->heights, 0);
+    memset((void*) &(mod->heights), 0, sizeof(mod->heights));
+  }
+}
+
+/**
+ * Convert a slice in a parse module to a buffer.
+ */
+static pwasm_buf_t
+pwasm_mod_get_buf(
+  const pwasm_mod_t * const mod,
   const pwasm_slice_t slice
 ) {
   return (pwasm_buf_t) {
@@ -8627,6 +9766,9 @@ typedef struct {
   void *cb_data; // user data
   pwasm_vec_t types; // vec(pwasm_checker_type_t)
   pwasm_vec_t ctrls; // vec(pwasm_checker_ctrl_t)
+
+  // maximum value stack height of the last checked function
+  size_t max_height;
 } pwasm_checker_t;
 
 /**
@@ -8645,6 +9787,7 @@ pwasm_checker_init(
   const pwasm_mod_check_cbs_t cbs = {
     .on_warning = (src_cbs && src_cbs->on_warning) ? src_cbs->on_warning : pwasm_null_on_warning,
     .on_error = (src_cbs && src_cbs->on_error) ? src_cbs->on_error : pwasm_null_on_error,
+    .on_block = src_cbs ? src_cbs->on_block : NULL,
   };
 
   // init type stack, check for error
@@ -8697,6 +9840,7 @@ pwasm_checker_clear(
 ) {
   pwasm_vec_clear(&(checker->types));
   pwasm_vec_clear(&(checker->ctrls));
+  checker->max_height = 0;
 }
 
 /**
@@ -8790,11 +9934,15 @@ pwasm_checker_type_push(
   const pwasm_checker_type_t type
 ) {
   // push entry, check for error.
-  if (!pwasm_vec_push(&(checker->types), 1, &type, NULL)) {
+  size_t ofs;
+  if (!pwasm_vec_push(&(checker->types), 1, &type, &ofs)) {
     pwasm_checker_fail(checker, "checker type stack push failed");
     return false;
   }
 
+  // update maximum height
+  checker->max_height = MAX(checker->max_height, ofs + 1);
+
   // return success
   return true;
 }
@@ -9547,9 +10695,10 @@ pwasm_checker_check_lane(
   case PWASM_OP_V8X16_SHUFFLE:
     // check lanes
     for (size_t i = 0; i < 16; i++) {
-      if (in.v_v128.i8[i] > 31) {
+      const uint8_t lane = checker->mod->v128s[in.v_v128].i8[i];
+      if (lane > 31) {
         // log error, return failure
-        D("lane %zu = %u", i, in.v_v128.i8[i]);
+        D("lane %zu = %u", i, lane);
         pwasm_checker_fail(checker, "v8x16.shuffle: invalid lane index (>31)");
         return false;
       }
@@ -10056,7 +11205,7 @@ pwasm_checker_check(
     case PWASM_OP_LOOP:
       {
         // get block type
-        const int32_t block_type = in.v_block.block_type;
+        const int32_t block_type = mod->blocks[in.v_block].block_type;
 
         // check params
         if (!pwasm_checker_type_check_params(checker, block_type)) {
@@ -10075,10 +11224,15 @@ pwasm_checker_check(
         // build control frame
         const pwasm_checker_ctrl_t ctrl = {
           .op   = in.op,
-          .block_type = in.v_block.block_type,
+          .block_type = block_type,
           .size = pwasm_checker_type_get_size(checker) - num_params,
         };
 
+        if (checker->cbs.on_block) {
+          // report block height
+          checker->cbs.on_block(in.v_block, ctrl.size, checker->cb_data);
+        }
+
         // push control frame, check for error
         if (!pwasm_checker_ctrl_push(checker, ctrl)) {
           // return failure
@@ -10098,7 +11252,7 @@ pwasm_checker_check(
         }
 
         // get block type
-        const int32_t block_type = in.v_block.block_type;
+        const int32_t block_type = mod->blocks[in.v_block].block_type;
 
         // check params
         if (!pwasm_checker_type_check_params(checker, block_type)) {
@@ -10117,10 +11271,15 @@ pwasm_checker_check(
         // build control frame
         const pwasm_checker_ctrl_t ctrl = {
           .op   = in.op,
-          .block_type = in.v_block.block_type,
+          .block_type = block_type,
           .size = pwasm_checker_type_get_size(checker) - num_params,
         };
 
+        if (checker->cbs.on_block) {
+          // report block height
+          checker->cbs.on_block(in.v_block, ctrl.size, checker->cb_data);
+        }
+
         // push control frame, check for error
         if (!pwasm_checker_ctrl_push(checker, ctrl)) {
           // return failure
@@ -10227,7 +11386,7 @@ pwasm_checker_check(
     case PWASM_OP_BR_TABLE:
       {
         const uint32_t max_label = pwasm_checker_ctrl_get_size(checker);
-        const pwasm_slice_t slice = in.v_br_table;
+        const pwasm_inst_slice_t slice = in.v_br_table;
         const uint32_t * const labels = mod->u32s + slice.ofs;
         const uint32_t num_labels = slice.len;
         const uint32_t last_label = labels[num_labels - 1];
@@ -11130,6 +12289,7 @@ typedef struct {
   const pwasm_mod_check_cbs_t cbs; /** callbacks */
   void *cb_data; /** user data */
   pwasm_checker_t checker; /** code checker */
+  size_t num_threads; /** number of function body validation threads */
 } pwasm_mod_check_t;
 
 /**
@@ -11140,7 +12300,8 @@ pwasm_mod_check_init(
   pwasm_mod_check_t * const check,
   const pwasm_mod_t * const mod,
   const pwasm_mod_check_cbs_t * const cbs,
-  void *cb_data
+  void *cb_data,
+  const size_t num_threads
 ) {
   // init code checker, check for error
   pwasm_checker_t checker;
@@ -11154,10 +12315,13 @@ pwasm_mod_check_init(
     .cbs = {
       .on_warning = (cbs && cbs->on_warning) ? cbs->on_warning : pwasm_null_on_warning,
       .on_error = (cbs && cbs->on_error) ? cbs->on_error : pwasm_null_on_error,
+      .on_block = cbs ? cbs->on_block : NULL,
+      .on_code = cbs ? cbs->on_code : NULL,
     },
     .cb_data = cb_data,
 
     .checker = checker,
+    .num_threads = num_threads,
   };
 
   // copy to destination
@@ -11769,8 +12933,8 @@ pwasm_mod_check_start(
 /**
  * Mod checks.
  *
- * Note: The start function check is handled separately in
- * pwasm_mod_check().
+ * Note: The start function and function body checks are handled
+ * separately in pwasm_mod_check().
  */
 #define MOD_CHECKS \
   MOD_CHECK(custom_section) \
@@ -11782,8 +12946,7 @@ pwasm_mod_check_start(
   MOD_CHECK(mem) \
   MOD_CHECK(elem) \
   MOD_CHECK(table) \
-  MOD_CHECK(export) \
-  MOD_CHECK(code)
+  MOD_CHECK(export)
 
 #define MOD_CHECK(NAME) \
   static bool pwasm_mod_check_ ## NAME ## s( \
@@ -11802,29 +12965,316 @@ pwasm_mod_check_start(
 MOD_CHECKS
 #undef MOD_CHECK
 
+//
+// worker pool: runs a batch of independent jobs on several threads
+//
+
 /**
- * Verify that a parsed module is valid.
+ * Worker pool job callback.
  *
- * Returns true if the module validates successfully and false
- * otherwise.
+ * Called with the worker data and job offset.  Returns `true` on
+ * success or `false` on failure.
+ */
+typedef bool (*pwasm_pool_job_t)(void *, const size_t);
+
+/**
+ * Worker pool state.
+ */
+typedef struct {
+  pthread_mutex_t mutex; // protects next and fail_ofs
+  pwasm_pool_job_t on_job; // job callback
+  const size_t num_jobs; // total number of jobs
+  size_t next; // offset of next unclaimed job
+  size_t fail_ofs; // offset of first failed job, or SIZE_MAX
+} pwasm_pool_t;
+
+/**
+ * Worker thread state.
+ */
+typedef struct {
+  pwasm_pool_t *pool; // parent pool
+  void *data; // worker data (passed to job callback)
+} pwasm_pool_worker_t;
+
+/**
+ * Worker thread body.
  *
- * If a validation error occurs, and the +cbs+ parameter and
- * +cbs->on_error+ are both non-NULL, then +cbs->on_error+ will be
- * called with an error message describing the validation error.
+ * Claims jobs in order until there are no jobs left or until a job
+ * after a failed job would be claimed.
+ */
+static void *
+pwasm_pool_worker_run(
+  void *arg
+) {
+  pwasm_pool_worker_t * const worker = arg;
+  pwasm_pool_t * const pool = worker->pool;
+
+  while (true) {
+    // claim next job
+    pthread_mutex_lock(&(pool->mutex));
+    const size_t ofs = pool->next++;
+    const bool done = (ofs >= pool->num_jobs) || (ofs > pool->fail_ofs);
+    pthread_mutex_unlock(&(pool->mutex));
+
+    if (done) {
+      // no jobs left, stop worker
+      return NULL;
+    }
+
+    // run job, check for error
+    if (!pool->on_job(worker->data, ofs)) {
+      // save offset of first failed job
+      pthread_mutex_lock(&(pool->mutex));
+      pool->fail_ofs = MIN(pool->fail_ofs, ofs);
+      pthread_mutex_unlock(&(pool->mutex));
+    }
+  }
+}
+
+/**
+ * Run `num_jobs` jobs on `num_workers` threads, where `worker_data` is
+ * an array of `num_workers` pointers to per-worker data which is passed
+ * to the job callback.
  *
- * Note: this function is called by `pwasm_mod_init()`, so you only
- * need to call `pwasm_mod_check()` if you parsed the module with
- * `pwasm_mod_init_unsafe()`.
+ * The calling thread is used as the first worker.  If a thread cannot
+ * be started then the jobs are spread across the remaining workers.
+ *
+ * Jobs are claimed in order.  Once a job fails, jobs after it are not
+ * started, but every job before it runs to completion, so the result
+ * does not depend on thread scheduling.
+ *
+ * Returns the offset of the first failed job, or `SIZE_MAX` if every
+ * job succeeded.
  */
-bool
-pwasm_mod_check(
+static size_t
+pwasm_pool_run(
+  void ** const worker_data,
+  const size_t num_workers,
+  const size_t num_jobs,
+  const pwasm_pool_job_t on_job
+) {
+  pwasm_pool_t pool = {
+    .on_job   = on_job,
+    .num_jobs = num_jobs,
+    .next     = 0,
+    .fail_ofs = SIZE_MAX,
+  };
+
+  // init mutex
+  pthread_mutex_init(&(pool.mutex), NULL);
+
+  pwasm_pool_worker_t workers[PWASM_POOL_MAX_THREADS];
+  pthread_t threads[PWASM_POOL_MAX_THREADS];
+  bool started[PWASM_POOL_MAX_THREADS] = { 0 };
+  const size_t num = MAX(MIN(num_workers, LEN(workers)), 1);
+
+  // start worker threads (worker 0 is the calling thread)
+  for (size_t i = 0; i < num; i++) {
+    workers[i] = (pwasm_pool_worker_t) {
+      .pool = &pool,
+      .data = worker_data[i],
+    };
+
+    if (i > 0) {
+      started[i] = !pthread_create(threads + i, NULL, pwasm_pool_worker_run, workers + i);
+    }
+  }
+
+  // run jobs on calling thread
+  pwasm_pool_worker_run(workers);
+
+  // wait for worker threads
+  for (size_t i = 1; i < num; i++) {
+    if (started[i]) {
+      pthread_join(threads[i], NULL);
+    }
+  }
+
+  // free mutex
+  pthread_mutex_destroy(&(pool.mutex));
+
+  // return offset of first failed job
+  return pool.fail_ofs;
+}
+
+/**
+ * Get the default number of worker threads (the number of online
+ * processors).
+ */
+static size_t
+pwasm_pool_get_default_num_threads(void) {
+  const long num = sysconf(_SC_NPROCESSORS_ONLN);
+  return (num > 0) ? (size_t) num : 1;
+}
+
+/**
+ * Function body validation worker data.
+ */
+typedef struct {
+  const pwasm_mod_t *mod; // mod
+  const pwasm_mod_check_t *check; // mod check context
+  pwasm_checker_t checker; // code checker for this worker
+  char text[256]; // first error message for current function
+  size_t fail_ofs; // offset of first failed function, or SIZE_MAX
+  char fail_text[256]; // first error message for first failed function
+} pwasm_mod_check_worker_t;
+
+/**
+ * Save the first error message for the current function.
+ */
+static void
+pwasm_mod_check_worker_on_error(
+  const char * const text,
+  void *cb_data
+) {
+  pwasm_mod_check_worker_t * const worker = cb_data;
+
+  if (!worker->text[0]) {
+    snprintf(worker->text, sizeof(worker->text), "%s", text);
+  }
+}
+
+/**
+ * Forward block height to mod check callback (worker checker callback).
+ */
+static void
+pwasm_mod_check_worker_on_block(
+  const size_t block_ofs,
+  const size_t height,
+  void *cb_data
+) {
+  const pwasm_mod_check_worker_t * const worker = cb_data;
+  worker->check->cbs.on_block(block_ofs, height, worker->check->cb_data);
+}
+
+/**
+ * Check function body (worker pool job callback).
+ */
+static bool
+pwasm_mod_check_worker_on_job(
+  void *data,
+  const size_t ofs
+) {
+  pwasm_mod_check_worker_t * const worker = data;
+
+  // clear error message
+  worker->text[0] = '\0';
+
+  // check function body
+  if (pwasm_checker_check(&(worker->checker), worker->mod, worker->mod->codes[ofs])) {
+    if (worker->check->cbs.on_code) {
+      // report maximum value stack height
+      worker->check->cbs.on_code(ofs, worker->checker.max_height, worker->check->cb_data);
+    }
+
+    // return success
+    return true;
+  }
+
+  if (ofs < worker->fail_ofs) {
+    // save failed function offset and error message
+    worker->fail_ofs = ofs;
+    memcpy(worker->fail_text, worker->text, sizeof(worker->text));
+  }
+
+  // return failure
+  return false;
+}
+
+/**
+ * Check function bodies.
+ *
+ * If `check->num_threads` is greater than one, then the function
+ * bodies are checked in parallel with one code checker per thread.
+ * Errors are reported for the first invalid function body, as in the
+ * single-threaded case.
+ */
+static bool
+pwasm_mod_check_codes(
+  const pwasm_mod_t * const mod,
+  pwasm_mod_check_t * const check
+) {
+  const size_t num_threads = MIN(MIN(check->num_threads, mod->num_codes), PWASM_POOL_MAX_THREADS);
+
+  if (num_threads <= 1) {
+    // check function bodies serially
+    for (size_t i = 0; i < mod->num_codes; i++) {
+      if (!pwasm_mod_check_code(mod, check, mod->codes[i])) {
+        return false;
+      }
+
+      if (check->cbs.on_code) {
+        // report maximum value stack height
+        check->cbs.on_code(i, check->checker.max_height, check->cb_data);
+      }
+    }
+
+    // return success
+    return true;
+  }
+
+  pwasm_mod_check_worker_t workers[PWASM_POOL_MAX_THREADS];
+  void *worker_data[PWASM_POOL_MAX_THREADS];
+  size_t num_workers = 0;
+
+  // init workers
+  for (size_t i = 0; i < num_threads; i++) {
+    pwasm_mod_check_worker_t * const worker = workers + num_workers;
+    worker->mod = mod;
+    worker->check = check;
+    worker->text[0] = '\0';
+    worker->fail_ofs = SIZE_MAX;
+    worker->fail_text[0] = '\0';
+
+    // init checker, check for error
+    const pwasm_mod_check_cbs_t worker_cbs = {
+      .on_error = pwasm_mod_check_worker_on_error,
+      .on_block = check->cbs.on_block ? pwasm_mod_check_worker_on_block : NULL,
+    };
+    if (!pwasm_checker_init(&(worker->checker), mod, &worker_cbs, worker)) {
+      // use fewer workers
+      break;
+    }
+
+    worker_data[num_workers++] = worker;
+  }
+
+  // check function bodies
+  const size_t fail_ofs = num_workers ? pwasm_pool_run(worker_data, num_workers, mod->num_codes, pwasm_mod_check_worker_on_job) : 0;
+
+  // report error for first failed function
+  if (fail_ofs != SIZE_MAX) {
+    const char *text = "init code checker failed";
+    for (size_t i = 0; i < num_workers; i++) {
+      if (workers[i].fail_ofs == fail_ofs) {
+        text = workers[i].fail_text;
+      }
+    }
+
+    check->cbs.on_error(text, check->cb_data);
+  }
+
+  // free workers
+  for (size_t i = 0; i < num_workers; i++) {
+    pwasm_checker_fini(&(workers[i].checker));
+  }
+
+  // return result
+  return fail_ofs == SIZE_MAX;
+}
+
+/**
+ * Verify everything in a parsed module except for function bodies.
+ */
+static bool
+pwasm_mod_check_sections(
   const pwasm_mod_t * const mod,
   const pwasm_mod_check_cbs_t * const cbs,
   void *cb_data
 ) {
   // init mod check context
   pwasm_mod_check_t check;
-  if (!pwasm_mod_check_init(&check, mod, cbs, cb_data)) {
+  if (!pwasm_mod_check_init(&check, mod, cbs, cb_data, 1)) {
     return false;
   }
 
@@ -11848,15 +13298,418 @@ pwasm_mod_check(
   return true;
 }
 
-bool
-pwasm_jit_compile(
-  pwasm_jit_t *jit, // JIT compiler
-  pwasm_buf_t *dst, // destination buffer
-  pwasm_env_t *env, // env
-  const uint32_t mod_id, // module instance handle
-  const size_t func_ofs // function offset
-) {
-  if (!jit || !jit->cbs || !jit->cbs->compile) {
+/**
+ * Verify the function bodies of a parsed module with the given number
+ * of threads.
+ *
+ * Note: function bodies may only be checked once the rest of the module
+ * has been checked with pwasm_mod_check_sections().
+ */
+static bool
+pwasm_mod_check_bodies(
+  const pwasm_mod_t * const mod,
+  const pwasm_mod_check_cbs_t * const cbs,
+  void *cb_data,
+  const size_t num_threads
+) {
+  // init mod check context
+  pwasm_mod_check_t check;
+  if (!pwasm_mod_check_init(&check, mod, cbs, cb_data, num_threads)) {
+    return false;
+  }
+
+  // check function bodies
+  const bool ok = pwasm_mod_check_codes(mod, &check);
+
+  // fini mod check context
+  pwasm_mod_check_fini(&check);
+
+  // return result
+  return ok;
+}
+
+/**
+ * Verify that a parsed module is valid, checking function bodies with
+ * the given number of threads.
+ */
+static bool
+pwasm_mod_check_with_threads(
+  const pwasm_mod_t * const mod,
+  const pwasm_mod_check_cbs_t * const cbs,
+  void *cb_data,
+  const size_t num_threads
+) {
+  return (
+    pwasm_mod_check_sections(mod, cbs, cb_data) &&
+    pwasm_mod_check_bodies(mod, cbs, cb_data, num_threads)
+  );
+}
+
+/**
+ * Verify that a parsed module is valid.
+ *
+ * Returns true if the module validates successfully and false
+ * otherwise.
+ *
+ * If a validation error occurs, and the +cbs+ parameter and
+ * +cbs->on_error+ are both non-NULL, then +cbs->on_error+ will be
+ * called with an error message describing the validation error.
+ *
+ * Note: this function is called by `pwasm_mod_init()`, so you only
+ * need to call `pwasm_mod_check()` if you parsed the module with
+ * `pwasm_mod_init_unsafe()`.
+ */
+bool
+pwasm_mod_check(
+  const pwasm_mod_t * const mod,
+  const pwasm_mod_check_cbs_t * const cbs,
+  void *cb_data
+) {
+  return pwasm_mod_check_with_threads(mod, cbs, cb_data, 1);
+}
+
+/**
+ * Verify that a parsed module is valid, checking function bodies in
+ * parallel.
+ *
+ * Function bodies are checked on `num_threads` threads (or one thread
+ * per online processor if `num_threads` is zero).  Errors are reported
+ * exactly as they are by pwasm_mod_check().
+ */
+bool
+pwasm_mod_check_parallel(
+  const pwasm_mod_t * const mod,
+  const pwasm_mod_check_cbs_t * const cbs,
+  void *cb_data,
+  const size_t num_threads
+) {
+  const size_t num = num_threads ? num_threads : pwasm_pool_get_default_num_threads();
+  return pwasm_mod_check_with_threads(mod, cbs, cb_data, num);
+}
+
+//
+// streaming module loader: parses source bytes into a builder with a
+// streaming parser.  once the code section has been parsed, a
+// provisional module is built and its function bodies are checked on a
+// background thread while the remaining sections are fed.  the code
+// section is the last section which function bodies depend on, so the
+// result also applies to the final module.
+//
+
+/**
+ * Streaming module loader internal data.
+ */
+typedef struct {
+  pwasm_mem_ctx_t *mem_ctx; // memory context
+  pwasm_builder_t builder; // module builder
+  pwasm_mod_init_unsafe_t ctx; // builder parser callback data
+  pwasm_mod_parser_t parser; // streaming parser
+  size_t num_threads; // number of function body check threads
+  bool failed; // did an error occur?
+
+  // function body check state
+  pwasm_mod_t code_mod; // provisional module
+  pwasm_mod_heights_t code_heights; // value stack heights of provisional module
+  bool code_started; // has the function body check been started?
+  bool code_threaded; // is the check running on a background thread?
+  pthread_t thread; // background thread
+  bool code_ok; // check result
+  char code_text[256]; // first function body error message
+} pwasm_mod_stream_data_t;
+
+/**
+ * Save the first function body error message.
+ */
+static void
+pwasm_mod_stream_on_code_error(
+  const char * const text,
+  void *cb_data
+) {
+  pwasm_mod_stream_data_t * const data = cb_data;
+
+  if (!data->code_text[0]) {
+    snprintf(data->code_text, sizeof(data->code_text), "%s", text);
+  }
+}
+
+/**
+ * Save block height of provisional module.
+ */
+static void
+pwasm_mod_stream_on_code_block(
+  const size_t block_ofs,
+  const size_t height,
+  void *cb_data
+) {
+  pwasm_mod_stream_data_t * const data = cb_data;
+  pwasm_mod_heights_on_block(block_ofs, height, &(data->code_heights));
+}
+
+/**
+ * Save function body height of provisional module.
+ */
+static void
+pwasm_mod_stream_on_code_code(
+  const size_t code_ofs,
+  const size_t height,
+  void *cb_data
+) {
+  pwasm_mod_stream_data_t * const data = cb_data;
+  pwasm_mod_heights_on_code(code_ofs, height, &(data->code_heights));
+}
+
+static const pwasm_mod_check_cbs_t
+PWASM_MOD_STREAM_CODE_CHECK_CBS = {
+  .on_error = pwasm_mod_stream_on_code_error,
+  .on_block = pwasm_mod_stream_on_code_block,
+  .on_code  = pwasm_mod_stream_on_code_code,
+};
+
+/**
+ * Check function bodies of provisional module (background thread
+ * body).
+ */
+static void *
+pwasm_mod_stream_check_code(
+  void *arg
+) {
+  pwasm_mod_stream_data_t * const data = arg;
+  data->code_ok = pwasm_mod_check_bodies(&(data->code_mod), &PWASM_MOD_STREAM_CODE_CHECK_CBS, data, data->num_threads);
+  return NULL;
+}
+
+/**
+ * Build a provisional module, check everything except function bodies,
+ * and start checking function bodies on a background thread.
+ */
+static bool
+pwasm_mod_stream_start_code_check(
+  pwasm_mod_stream_data_t * const data
+) {
+  data->code_started = true;
+
+  // build provisional module, check for error
+  if (!pwasm_builder_build_mod(&(data->builder), &(data->code_mod))) {
+    // return failure
+    return false;
+  }
+
+  // allocate value stack heights, check for error
+  if (!pwasm_mod_heights_init(&(data->code_heights), data->mem_ctx, &(data->code_mod))) {
+    // return failure
+    return false;
+  }
+
+  // check sections, check for error
+  const pwasm_mod_check_cbs_t cbs = {
+    .on_error = data->mem_ctx->cbs->on_error,
+  };
+  if (!pwasm_mod_check_sections(&(data->code_mod), &cbs, data->mem_ctx->cb_data)) {
+    // return failure
+    return false;
+  }
+
+  // start background thread
+  data->code_threaded = !pthread_create(&(data->thread), NULL, pwasm_mod_stream_check_code, data);
+  if (!data->code_threaded) {
+    // could not start thread, check function bodies now
+    pwasm_mod_stream_check_code(data);
+  }
+
+  // return success
+  return true;
+}
+
+/**
+ * Wait for function body check.
+ */
+static void
+pwasm_mod_stream_wait(
+  pwasm_mod_stream_data_t * const data
+) {
+  if (data->code_threaded) {
+    pthread_join(data->thread, NULL);
+    data->code_threaded = false;
+  }
+}
+
+bool
+pwasm_mod_stream_init(
+  pwasm_mod_stream_t * const stream,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const size_t num_threads
+) {
+  // allocate loader data, check for error
+  pwasm_mod_stream_data_t *data = pwasm_realloc(mem_ctx, NULL, sizeof(pwasm_mod_stream_data_t));
+  if (!data) {
+    pwasm_fail(mem_ctx, "pwasm_realloc() failed");
+    return false;
+  }
+
+  // clear loader data (the struct has const members, so it cannot be
+  // assigned)
+  memset(data, 0, sizeof(pwasm_mod_stream_data_t));
+  data->mem_ctx = mem_ctx;
+  data->num_threads = num_threads ? num_threads : pwasm_pool_get_default_num_threads();
+
+  // init builder, check for error
+  if (!pwasm_builder_init(mem_ctx, &(data->builder))) {
+    pwasm_realloc(mem_ctx, data, 0);
+    return false;
+  }
+
+  // init builder parser callback data
+  const pwasm_mod_init_unsafe_t ctx = {
+    .builder = &(data->builder),
+    .success = true,
+  };
+  memcpy(&(data->ctx), &ctx, sizeof(pwasm_mod_init_unsafe_t));
+
+  // init parser, check for error
+  if (!pwasm_mod_parser_init(&(data->parser), mem_ctx, &PWASM_MOD_INIT_UNSAFE_PARSE_CBS, &(data->ctx))) {
+    pwasm_builder_fini(&(data->builder));
+    pwasm_realloc(mem_ctx, data, 0);
+    return false;
+  }
+
+  // populate result
+  *stream = (pwasm_mod_stream_t) {
+    .mem_ctx  = mem_ctx,
+    .data     = data,
+  };
+
+  // return success
+  return true;
+}
+
+bool
+pwasm_mod_stream_feed(
+  pwasm_mod_stream_t * const stream,
+  const pwasm_buf_t src
+) {
+  pwasm_mod_stream_data_t * const data = stream->data;
+  if (data->failed) {
+    // return failure
+    return false;
+  }
+
+  // parse bytes, check for error
+  if (!pwasm_mod_parser_feed(&(data->parser), src) || !data->ctx.success) {
+    data->failed = true;
+    return false;
+  }
+
+  // start function body check once the code section has been parsed
+  const bool code_done = data->parser.done_type >= PWASM_SECTION_TYPE_CODE;
+  if (code_done && !data->code_started && !pwasm_mod_stream_start_code_check(data)) {
+    data->failed = true;
+    return false;
+  }
+
+  // return success
+  return true;
+}
+
+size_t
+pwasm_mod_stream_finish(
+  pwasm_mod_stream_t * const stream,
+  pwasm_mod_t * const mod
+) {
+  pwasm_mod_stream_data_t * const data = stream->data;
+
+  // unconditionally zero out backing memory (see
+  // pwasm_mod_init_unsafe())
+  memset(&(mod->mem), 0, sizeof(pwasm_buf_t));
+  memset((void*) &(mod->heights), 0, sizeof(mod->heights));
+
+  // finish parsing, check for error
+  const size_t len = data->failed ? 0 : pwasm_mod_parser_finish(&(data->parser));
+
+  // wait for function body check
+  pwasm_mod_stream_wait(data);
+
+  if (!len || !data->ctx.success) {
+    // return failure
+    data->failed = true;
+    return 0;
+  }
+
+  // build mod, check for error
+  if (!pwasm_builder_build_mod(&(data->builder), mod)) {
+    // free mod, return failure
+    pwasm_mod_fini(mod);
+    data->failed = true;
+    return 0;
+  }
+
+  const pwasm_mod_check_cbs_t cbs = {
+    .on_error = data->mem_ctx->cbs->on_error,
+  };
+
+  if (!data->code_started) {
+    // no code section, check module now
+    data->code_ok = pwasm_mod_check_heights(mod, data->mem_ctx, data->num_threads, &(data->code_heights));
+    data->code_text[0] = '\0';
+  } else if (!pwasm_mod_check_sections(mod, &cbs, data->mem_ctx->cb_data)) {
+    // sections after the code section are invalid
+    data->code_ok = false;
+    data->code_text[0] = '\0';
+  } else if (!data->code_ok) {
+    // report function body error
+    pwasm_fail(data->mem_ctx, data->code_text[0] ? data->code_text : "invalid function body");
+  }
+
+  if (!data->code_ok) {
+    // free mod, return failure
+    pwasm_mod_fini(mod);
+    data->failed = true;
+    return 0;
+  }
+
+  // save value stack heights (the heights of the provisional module
+  // only apply if no blocks were added after the code section)
+  if (!data->code_started || data->code_heights.num_blocks == mod->num_blocks) {
+    pwasm_mod_heights_attach(&(data->code_heights), mod);
+  }
+
+  // return number of bytes consumed
+  return len;
+}
+
+void
+pwasm_mod_stream_fini(
+  pwasm_mod_stream_t * const stream
+) {
+  pwasm_mod_stream_data_t * const data = stream->data;
+  if (!data) {
+    return;
+  }
+
+  // wait for function body check
+  pwasm_mod_stream_wait(data);
+
+  // free provisional module and value stack heights
+  if (data->code_started) {
+    pwasm_mod_fini(&(data->code_mod));
+  }
+  pwasm_mod_heights_fini(&(data->code_heights));
+
+  // free parser, builder, and loader data
+  pwasm_mod_parser_fini(&(data->parser));
+  pwasm_builder_fini(&(data->builder));
+  pwasm_realloc(stream->mem_ctx, data, 0);
+  stream->data = NULL;
+}
+
+bool
+pwasm_jit_compile(
+  pwasm_jit_t *jit, // JIT compiler
+  pwasm_buf_t *dst, // destination buffer
+  pwasm_env_t *env, // env
+  const uint32_t mod_id, // module instance handle
+  const size_t func_ofs // function offset
+) {
+  if (!jit || !jit->cbs || !jit->cbs->compile) {
     // return failure
     return false;
   }
@@ -11864,6 +13717,33 @@ pwasm_jit_compile(
   return jit->cbs->compile(jit, dst, env, mod_id, func_ofs);
 }
 
+bool
+pwasm_jit_load_mod(
+  pwasm_jit_t *jit, // JIT compiler
+  pwasm_buf_t *dst, // destination buffers
+  pwasm_env_t *env, // env
+  const uint32_t mod_id // module instance handle
+) {
+  if (!jit || !jit->cbs || !jit->cbs->load_mod) {
+    // no code cache, return failure
+    return false;
+  }
+
+  return jit->cbs->load_mod(jit, dst, env, mod_id);
+}
+
+void
+pwasm_jit_save_mod(
+  pwasm_jit_t *jit, // JIT compiler
+  const pwasm_buf_t *fns, // compiled functions
+  pwasm_env_t *env, // env
+  const uint32_t mod_id // module instance handle
+) {
+  if (jit && jit->cbs && jit->cbs->save_mod) {
+    jit->cbs->save_mod(jit, fns, env, mod_id);
+  }
+}
+
 void
 pwasm_jit_fini(
   pwasm_jit_t *jit // JIT compiler
@@ -11967,6 +13847,14 @@ pwasm_env_get_mod_name(
   return (cbs && cbs->get_mod_name) ? cbs->get_mod_name(env, mod_id) : NULL;
 }
 
+size_t
+pwasm_env_get_max_call_depth(
+  const pwasm_env_t * const env
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+  return (cbs && cbs->max_call_depth) ? cbs->max_call_depth : PWASM_DEFAULT_MAX_CALL_DEPTH;
+}
+
 uint32_t
 pwasm_env_find_mod(
   pwasm_env_t * const env,
@@ -12063,20 +13951,78 @@ pwasm_env_get_table_index(
   return (cbs && cbs->get_table_index) ? cbs->get_table_index(env, mod_id, table_ofs) : false;
 }
 
-bool
-pwasm_env_mem_load(
+uint32_t
+pwasm_env_get_mem_index(
   pwasm_env_t * const env,
-  const uint32_t mem_id,
-  const pwasm_inst_t in,
-  const uint32_t ofs,
-  pwasm_val_t * const ret_val
+  const uint32_t mod_id,
+  const uint32_t mem_ofs
 ) {
   const pwasm_env_cbs_t * const cbs = env->cbs;
-  const bool have_cb = (cbs && cbs->mem_load);
-  return have_cb ? cbs->mem_load(env, mem_id, in, ofs, ret_val) : false;
+  return (cbs && cbs->get_mem_index) ? cbs->get_mem_index(env, mod_id, mem_ofs) : 0;
 }
 
-bool
+void **
+pwasm_env_get_call_slot(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+  return (cbs && cbs->get_call_slot) ? cbs->get_call_slot(env, mod_id, func_ofs) : NULL;
+}
+
+bool
+pwasm_env_snapshot_mod_with_flags(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap,
+  const uint64_t flags
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+  const bool have_cb = (cbs && cbs->snapshot_mod);
+
+  // clear snapshot so that pwasm_env_snapshot_fini() is always safe
+  memset(snap, 0, sizeof(pwasm_env_snapshot_t));
+  snap->flags = flags;
+
+  return have_cb ? cbs->snapshot_mod(env, mod_id, snap) : false;
+}
+
+bool
+pwasm_env_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap
+) {
+  return pwasm_env_snapshot_mod_with_flags(env, mod_id, snap, 0);
+}
+
+bool
+pwasm_env_restore_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_env_snapshot_t * const snap
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+
+  const bool have_cb = (cbs && cbs->restore_mod);
+  return have_cb ? cbs->restore_mod(env, mod_id, snap) : false;
+}
+
+bool
+pwasm_env_mem_load(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  const pwasm_inst_t in,
+  const uint32_t ofs,
+  pwasm_val_t * const ret_val
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+  const bool have_cb = (cbs && cbs->mem_load);
+  return have_cb ? cbs->mem_load(env, mem_id, in, ofs, ret_val) : false;
+}
+
+bool
 pwasm_env_mem_store(
   pwasm_env_t * const env,
   const uint32_t mem_id,
@@ -12124,6 +14070,19 @@ pwasm_env_get_elem(
   return have_cb ? cbs->get_elem(env, table_id, elem_ofs, ret_id) : false;
 }
 
+bool
+pwasm_env_call_indirect(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_id,
+  const uint32_t type_ofs,
+  const uint32_t elem_ofs
+) {
+  const pwasm_env_cbs_t * const cbs = env->cbs;
+  const bool have_cb = (cbs && cbs->call_indirect);
+  return have_cb ? cbs->call_indirect(env, mod_id, table_id, type_ofs, elem_ofs) : false;
+}
+
 uint32_t
 pwasm_env_find_import(
   pwasm_env_t * const env,
@@ -12243,84 +14202,196 @@ pwasm_call(
 }
 
 //
-// control stack: used by new interpreter to manage control frames
+// export index: maps export types and names to item offsets within a
+// module so that environments can resolve exports and imports by name
+// without walking and comparing every export
 //
 
-#define CTRL_TYPES \
-  CTRL_TYPE(BLOCK) \
-  CTRL_TYPE(LOOP) \
-  CTRL_TYPE(IF) \
-  CTRL_TYPE(ELSE)
+typedef struct {
+  // export name (refers to module bytes or native names)
+  pwasm_buf_t name;
 
-typedef enum {
-#define CTRL_TYPE(a) CTRL_ ## a,
-CTRL_TYPES
-#undef CTRL_TYPE
-  CTRL_LAST,
-} pwasm_ctrl_stack_entry_type_t;
+  // hash of export type and name
+  uint64_t hash;
 
-typedef struct {
-  pwasm_ctrl_stack_entry_type_t type; // stack entry type
-  size_t depth; // value stack depth
-  size_t ofs; // inst ofs
-  uint32_t func_type;
-} pwasm_ctrl_stack_entry_t;
+  // export type
+  pwasm_import_type_t type;
+
+  // item offset in module (export ID for modules, row offset for
+  // native modules)
+  uint32_t ofs;
+
+  // is this slot in use?
+  bool used;
+} pwasm_exports_row_t;
 
 typedef struct {
-  pwasm_vec_t stack;
-} pwasm_ctrl_stack_t;
+  // open-addressed slots (NULL if there are no exports)
+  pwasm_exports_row_t *rows;
 
-static bool
-pwasm_ctrl_stack_init(
-  pwasm_ctrl_stack_t * const stack,
-  pwasm_mem_ctx_t * const mem_ctx
+  // number of slots minus one (number of slots is a power of two)
+  size_t mask;
+} pwasm_exports_t;
+
+static inline uint64_t
+pwasm_exports_hash(
+  const pwasm_import_type_t type,
+  const pwasm_buf_t name
 ) {
-  const size_t stride = sizeof(pwasm_ctrl_stack_entry_t);
-  return pwasm_vec_init(mem_ctx, &(stack->stack), stride);
+  const uint8_t type_byte = type;
+  const uint64_t hash = pwasm_hash_step(PWASM_HASH_INIT, &type_byte, 1);
+  return pwasm_hash_step(hash, name.ptr, name.len);
 }
 
+/**
+ * Add export to index.
+ *
+ * If the index already contains an export with the same type and name,
+ * then the existing entry is kept, so lookups match the first export
+ * in declaration order.
+ */
 static void
-pwasm_ctrl_stack_fini(
-  pwasm_ctrl_stack_t * const stack
-) {
-  pwasm_vec_fini(&(stack->stack));
-}
+pwasm_exports_add(
+  pwasm_exports_t * const exports,
+  const pwasm_import_type_t type,
+  const pwasm_buf_t name,
+  const uint32_t ofs
+) {
+  const uint64_t hash = pwasm_exports_hash(type, name);
+
+  // linear probe for empty or matching slot
+  for (size_t i = hash & exports->mask;; i = (i + 1) & exports->mask) {
+    pwasm_exports_row_t * const row = exports->rows + i;
+
+    if (!row->used) {
+      // populate empty slot
+      *row = (pwasm_exports_row_t) {
+        .name = name,
+        .hash = hash,
+        .type = type,
+        .ofs  = ofs,
+        .used = true,
+      };
 
-#if 0
-static size_t
-pwasm_ctrl_stack_get_size(
-  const pwasm_ctrl_stack_t * const stack
-) {
-  return pwasm_vec_get_size(&(stack->stack));
+      return;
+    }
+
+    if (
+      (row->hash == hash) &&
+      (row->type == type) &&
+      (row->name.len == name.len) &&
+      !memcmp(row->name.ptr, name.ptr, name.len)
+    ) {
+      // keep existing entry
+      return;
+    }
+  }
 }
-#endif /* 0 */
 
-static const void *
-pwasm_ctrl_stack_peek_tail(
-  const pwasm_ctrl_stack_t * const stack,
-  const size_t ofs
+/**
+ * Allocate empty export index with room for +num+ exports.
+ *
+ * Returns false if memory allocation failed.
+ */
+static bool
+pwasm_exports_alloc(
+  pwasm_exports_t * const exports,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const size_t num
 ) {
-  return pwasm_vec_peek_tail(&(stack->stack), ofs);
+  // clear index
+  memset(exports, 0, sizeof(pwasm_exports_t));
+  if (!num) {
+    // no exports, return success
+    return true;
+  }
+
+  // get number of slots (power of two, load factor at most 1/2)
+  size_t num_slots = 8;
+  while (num_slots < 2 * num) {
+    num_slots *= 2;
+  }
+
+  // allocate and clear slots, check for error
+  const size_t num_bytes = num_slots * sizeof(pwasm_exports_row_t);
+  pwasm_exports_row_t * const rows = pwasm_realloc(mem_ctx, NULL, num_bytes);
+  if (!rows) {
+    return false;
+  }
+  memset(rows, 0, num_bytes);
+
+  // save slots and mask, return success
+  exports->rows = rows;
+  exports->mask = num_slots - 1;
+  return true;
 }
 
+/**
+ * Build export index for module +mod+.
+ *
+ * Returns false if memory allocation failed.
+ */
 static bool
-pwasm_ctrl_stack_pop(
-  pwasm_ctrl_stack_t * const stack,
-  void * const dst
+pwasm_exports_init_mod(
+  pwasm_exports_t * const exports,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const pwasm_mod_t * const mod
 ) {
-  // pop final entry, return result
-  return pwasm_vec_pop(&(stack->stack), dst);
+  // allocate index, check for error
+  if (!pwasm_exports_alloc(exports, mem_ctx, mod->num_exports)) {
+    return false;
+  }
+
+  // add exports
+  for (size_t i = 0; i < mod->num_exports; i++) {
+    const pwasm_export_t row = mod->exports[i];
+    const pwasm_buf_t name = { mod->bytes + row.name.ofs, row.name.len };
+    pwasm_exports_add(exports, row.type, name, row.id);
+  }
+
+  // return success
+  return true;
 }
 
+/**
+ * Build export index for the named functions, memories, and globals of
+ * native module +mod+.
+ *
+ * Returns false if memory allocation failed.
+ */
 static bool
-pwasm_ctrl_stack_popn(
-  pwasm_ctrl_stack_t * const stack,
-  const size_t num
+pwasm_exports_init_native(
+  pwasm_exports_t * const exports,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const pwasm_native_t * const mod
 ) {
-  // pop entries
-  for (size_t i = 0; i < num; i++) {
-    if (!pwasm_vec_pop(&(stack->stack), NULL)) {
-      return false;
+  // allocate index, check for error
+  const size_t num = mod->num_funcs + mod->num_mems + mod->num_globals;
+  if (!pwasm_exports_alloc(exports, mem_ctx, num)) {
+    return false;
+  }
+
+  // add functions
+  for (size_t i = 0; i < mod->num_funcs; i++) {
+    const pwasm_buf_t name = pwasm_buf_str(mod->funcs[i].name);
+    if (name.ptr) {
+      pwasm_exports_add(exports, PWASM_IMPORT_TYPE_FUNC, name, i);
+    }
+  }
+
+  // add memories
+  for (size_t i = 0; i < mod->num_mems; i++) {
+    const pwasm_buf_t name = pwasm_buf_str(mod->mems[i].name);
+    if (name.ptr) {
+      pwasm_exports_add(exports, PWASM_IMPORT_TYPE_MEM, name, i);
+    }
+  }
+
+  // add globals
+  for (size_t i = 0; i < mod->num_globals; i++) {
+    const pwasm_buf_t name = pwasm_buf_str(mod->globals[i].name);
+    if (name.ptr) {
+      pwasm_exports_add(exports, PWASM_IMPORT_TYPE_GLOBAL, name, i);
     }
   }
 
@@ -12328,4598 +14399,7022 @@ pwasm_ctrl_stack_popn(
   return true;
 }
 
+/**
+ * Find export of the given +type+ and +name+ in the export index.
+ *
+ * On success, the item offset of the export is written to +ret_ofs+ and
+ * this function returns true.  Returns false if the export was not
+ * found.
+ */
 static bool
-pwasm_ctrl_stack_push(
-  pwasm_ctrl_stack_t * const stack,
-  const pwasm_ctrl_stack_entry_t entry
+pwasm_exports_find(
+  const pwasm_exports_t * const exports,
+  const pwasm_import_type_t type,
+  const pwasm_buf_t name,
+  uint32_t * const ret_ofs
 ) {
-  return pwasm_vec_push(&(stack->stack), 1, &entry, NULL);
-}
+  if (!exports->rows) {
+    // no exports, return failure
+    return false;
+  }
 
-//
-// new interpreter
-//
+  const uint64_t hash = pwasm_exports_hash(type, name);
 
-typedef enum {
-  PWASM_NEW_INTERP_MOD_TYPE_MOD,
-  PWASM_NEW_INTERP_MOD_TYPE_NATIVE,
-  PWASM_NEW_INTERP_MOD_TYPE_LAST,
-} pwasm_new_interp_mod_type_t;
+  // linear probe until match or empty slot
+  for (size_t i = hash & exports->mask;; i = (i + 1) & exports->mask) {
+    const pwasm_exports_row_t * const row = exports->rows + i;
 
-typedef struct {
-  // module name
-  pwasm_buf_t name;
+    if (!row->used) {
+      // not found, return failure
+      return false;
+    }
 
-  // module type (internal or native)
-  pwasm_new_interp_mod_type_t type;
+    if (
+      (row->hash == hash) &&
+      (row->type == type) &&
+      (row->name.len == name.len) &&
+      !memcmp(row->name.ptr, name.ptr, name.len)
+    ) {
+      // write result, return success
+      *ret_ofs = row->ofs;
+      return true;
+    }
+  }
+}
 
-  // references to the u32s vector in the parent interpreter
-  pwasm_slice_t funcs;
-  pwasm_slice_t globals;
-  pwasm_slice_t mems;
-  pwasm_slice_t tables;
+/**
+ * Free memory used by export index.
+ */
+static void
+pwasm_exports_fini(
+  pwasm_exports_t * const exports,
+  pwasm_mem_ctx_t * const mem_ctx
+) {
+  if (exports->rows) {
+    pwasm_realloc(mem_ctx, exports->rows, 0);
+    exports->rows = NULL;
+  }
+}
 
-  union {
-    const pwasm_native_t * const native;
-    const pwasm_mod_t * const mod;
-  };
-} pwasm_new_interp_mod_t;
+//
+// function type registry: interns function types so that each distinct
+// signature has a single small integer ID within an environment.  used
+// by environments to check the type of call_indirect targets with a
+// single integer comparison.  type IDs are 1-based; 0 is never a valid
+// type ID, so it can be used to mark empty table elements.
+//
 
 typedef struct {
-  // mod offset in parent interpreter
-  uint32_t mod_ofs;
+  // hash of signature
+  uint64_t hash;
 
-  // func offset in parent mod
-  uint32_t func_ofs;
-} pwasm_new_interp_func_t;
+  // offset and length of signature in the vals vector
+  size_t ofs;
+  size_t len;
+} pwasm_func_types_row_t;
 
 typedef struct {
-  pwasm_env_mem_t * const mem; // memory pointer
-  const size_t ofs; // absolute offset, in bytes
-  const size_t size; // size, in bytes
-} pwasm_new_interp_mem_chunk_t;
+  // memory context for slots
+  pwasm_mem_ctx_t *mem_ctx;
 
-/*
- * static void
- * pwasm_new_interp_dump_mem_chunk(
- *   const pwasm_new_interp_mem_chunk_t chunk
- * ) {
- *   D("{ .mem = %p, .ofs = %zu, .size = %zu }", (void*) chunk.mem, chunk.ofs, chunk.size);
- * }
- */
+  // signatures (uint32_t): parameter count, followed by parameter
+  // value types, followed by result value types
+  pwasm_vec_t vals;
 
-typedef struct {
-  // mod offset in parent interpreter
-  uint32_t mod_ofs;
+  // interned types (pwasm_func_types_row_t), indexed by type ID - 1
+  pwasm_vec_t rows;
 
-  // table offset in parent mod
-  uint32_t table_ofs;
+  // open-addressed slots containing type IDs (0 for empty slots)
+  uint32_t *slots;
 
-  // limits from initial mod
-  const pwasm_limits_t limits;
+  // number of slots (zero or a power of two)
+  size_t num_slots;
+} pwasm_func_types_t;
 
-  // vec of u32 values
-  uint32_t *vals;
+/**
+ * Initialize function type registry.
+ *
+ * Returns false if memory allocation failed.
+ */
+static bool
+pwasm_func_types_init(
+  pwasm_func_types_t * const types,
+  pwasm_mem_ctx_t * const mem_ctx
+) {
+  memset(types, 0, sizeof(pwasm_func_types_t));
+  types->mem_ctx = mem_ctx;
 
-  // array of u64s indicating set elements
-  uint64_t *masks;
+  if (!pwasm_vec_init(mem_ctx, &(types->vals), sizeof(uint32_t))) {
+    return false;
+  }
 
-  // maximum number of elements
-  size_t max_vals;
-} pwasm_new_interp_table_t;
+  if (!pwasm_vec_init(mem_ctx, &(types->rows), sizeof(pwasm_func_types_row_t))) {
+    pwasm_vec_fini(&(types->vals));
+    return false;
+  }
 
-static pwasm_new_interp_table_t
-pwasm_new_interp_table_init(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const uint32_t table_ofs,
-  pwasm_limits_t limits
-) {
-  (void) env;
-  return (pwasm_new_interp_table_t) {
-    .mod_ofs    = mod_ofs,
-    .table_ofs  = table_ofs,
-    .limits     = limits,
-    .vals       = NULL,
-    .masks      = NULL,
-    .max_vals   = 0,
-  };
+  // return success
+  return true;
 }
 
+/**
+ * Free memory used by function type registry.
+ */
 static void
-pwasm_new_interp_table_fini(
-  pwasm_env_t * const env,
-  pwasm_new_interp_table_t * const table
+pwasm_func_types_fini(
+  pwasm_func_types_t * const types
 ) {
-  if (!table->max_vals) {
-    return;
+  if (types->slots) {
+    pwasm_realloc(types->mem_ctx, types->slots, 0);
+    types->slots = NULL;
+    types->num_slots = 0;
   }
 
-  if (table->max_vals > 0) {
-    // free memory and masks
-    pwasm_realloc(env->mem_ctx, table->vals, 0);
-    pwasm_realloc(env->mem_ctx, table->masks, 0);
-    table->vals = NULL;
-    table->masks = NULL;
-    table->max_vals = 0;
-  }
+  pwasm_vec_fini(&(types->rows));
+  pwasm_vec_fini(&(types->vals));
 }
 
+/**
+ * Double the number of slots in the function type registry and rehash
+ * the existing types.
+ *
+ * Returns false if memory allocation failed.
+ */
 static bool
-pwasm_new_interp_table_grow(
-  pwasm_env_t * const env,
-  pwasm_new_interp_table_t * const table,
-  const size_t src_new_len
+pwasm_func_types_grow(
+  pwasm_func_types_t * const types
 ) {
-  // check existing capacity
-  if (src_new_len <= table->max_vals) {
-    return true;
-  }
-
-  // clamp to minimum size
-  const size_t new_len = (table->limits.min > src_new_len) ? table->limits.min : src_new_len;
-
-  // check table maximum limit
-  if (table->limits.has_max && src_new_len > table->limits.max) {
-    D("src_new_len = %zu, max = %u", src_new_len, table->limits.max);
-    pwasm_env_fail(env, "length greater than table limit");
-    return false;
-  }
+  const size_t num_slots = types->num_slots ? (2 * types->num_slots) : 64;
+  const size_t num_bytes = num_slots * sizeof(uint32_t);
 
-  // reallocate vals, check for error
-  uint32_t *tmp_vals = pwasm_realloc(env->mem_ctx, table->vals, new_len * sizeof(uint32_t));
-  if (!tmp_vals && new_len > 0) {
-    pwasm_env_fail(env, "vals pwasm_realloc() failed");
+  // allocate and clear slots, check for error
+  uint32_t * const slots = pwasm_realloc(types->mem_ctx, NULL, num_bytes);
+  if (!slots) {
     return false;
   }
+  memset(slots, 0, num_bytes);
 
-  // reallocate masks, check for error
-  const size_t new_num_masks = (new_len / 64) + ((new_len & 0x3F) ? 1 : 0);
-  uint64_t *tmp_masks = pwasm_realloc(env->mem_ctx, table->masks, new_num_masks * sizeof(uint64_t));
-  if (!tmp_vals && new_len > 0) {
-    pwasm_env_fail(env, "masks pwasm_realloc() failed");
-    return false;
+  // rehash existing types
+  const pwasm_func_types_row_t * const rows = pwasm_vec_get_data(&(types->rows));
+  const size_t num_rows = pwasm_vec_get_size(&(types->rows));
+  for (size_t i = 0; i < num_rows; i++) {
+    size_t ofs = rows[i].hash & (num_slots - 1);
+    while (slots[ofs]) {
+      ofs = (ofs + 1) & (num_slots - 1);
+    }
+    slots[ofs] = i + 1;
   }
 
-  // clear masks
-  for (size_t i = table->max_vals; i < new_len; i++) {
-    tmp_masks[i >> 6] &= ~(((uint64_t) 1) << (i & 0x3F));
+  // free old slots
+  if (types->slots) {
+    pwasm_realloc(types->mem_ctx, types->slots, 0);
   }
 
-  // update vals, masks, and max_len
-  table->vals = tmp_vals;
-  table->masks = tmp_masks;
-  table->max_vals = new_len;
-
-  // return success
+  // save slots, return success
+  types->slots = slots;
+  types->num_slots = num_slots;
   return true;
 }
 
+/**
+ * Intern the signature at offset +ofs+ of the vals vector, which must
+ * extend to the end of the vector.
+ *
+ * If the signature was already interned, then it is removed from the
+ * vals vector and the existing type ID is written to +ret_id+.
+ * Otherwise a new type ID is written to +ret_id+.
+ *
+ * Returns false if memory allocation failed.
+ */
 static bool
-pwasm_new_interp_table_set(
-  pwasm_env_t * const env,
-  pwasm_new_interp_table_t * const table,
+pwasm_func_types_intern(
+  pwasm_func_types_t * const types,
   const size_t ofs,
-  const uint32_t * const vals,
-  const size_t num_vals
+  uint32_t * const ret_id
 ) {
-  if (!pwasm_new_interp_table_grow(env, table, ofs + num_vals)) {
+  const size_t num_rows = pwasm_vec_get_size(&(types->rows));
+  if (2 * (num_rows + 1) > types->num_slots && !pwasm_func_types_grow(types)) {
     // return failure
     return false;
   }
 
-  // copy values
-  memcpy(table->vals + ofs, vals, num_vals * sizeof(uint32_t));
+  const uint32_t * const vals = pwasm_vec_get_data(&(types->vals));
+  const size_t len = pwasm_vec_get_size(&(types->vals)) - ofs;
+  const size_t num_bytes = len * sizeof(uint32_t);
+  const uint64_t hash = pwasm_hash((const uint8_t*) (vals + ofs), num_bytes);
+  const pwasm_func_types_row_t * const rows = pwasm_vec_get_data(&(types->rows));
+  const size_t mask = types->num_slots - 1;
 
-  // set masks
-  for (size_t i = ofs; i < ofs + num_vals; i++) {
-    table->masks[i >> 6] |= ((uint64_t) 1) << (i & 0x3F);
+  // linear probe for empty or matching slot
+  size_t i = hash & mask;
+  for (; types->slots[i]; i = (i + 1) & mask) {
+    const pwasm_func_types_row_t row = rows[types->slots[i] - 1];
+
+    if (
+      (row.hash == hash) &&
+      (row.len == len) &&
+      !memcmp(vals + row.ofs, vals + ofs, num_bytes)
+    ) {
+      // drop duplicate signature, return existing type ID
+      pwasm_vec_shrink(&(types->vals), ofs);
+      *ret_id = types->slots[i];
+      return true;
+    }
   }
 
-  // return success
+  // append type, check for error
+  const pwasm_func_types_row_t row = { hash, ofs, len };
+  if (!pwasm_vec_push(&(types->rows), 1, &row, NULL)) {
+    pwasm_vec_shrink(&(types->vals), ofs);
+    return false;
+  }
+
+  // populate slot, return new type ID
+  types->slots[i] = num_rows + 1;
+  *ret_id = num_rows + 1;
   return true;
 }
 
 /**
- * Get element (u32) from table.
+ * Get the type ID of the function type +type_ofs+ of module +mod+.
  *
- * At the moment the only supported types are function references, so
- * this returns a u32 offset into the interpreters funcs table.
+ * Returns false if memory allocation failed.
  */
 static bool
-pwasm_new_interp_table_get_elem(
-  pwasm_env_t * const env,
-  pwasm_new_interp_table_t * const table,
-  const size_t ofs,
-  uint32_t * const ret_val
+pwasm_func_types_add_mod_type(
+  pwasm_func_types_t * const types,
+  const pwasm_mod_t * const mod,
+  const size_t type_ofs,
+  uint32_t * const ret_id
 ) {
-  // check element offset
-  if (ofs >= table->max_vals) {
-    D("ofs = %zu, table->max_vals = %zu", ofs, table->max_vals);
-    // log error, return failure
-    pwasm_env_fail(env, "table element offset out of bounds");
+  const pwasm_type_t type = mod->types[type_ofs];
+  const size_t len = 1 + type.params.len + type.results.len;
+
+  // append signature, check for error
+  size_t ofs;
+  if (!pwasm_vec_push_uninitialized(&(types->vals), len, &ofs)) {
     return false;
   }
 
-  // check element mask
-  const bool set = table->masks[ofs >> 6] & ((uint64_t) 1) << (ofs & 0x3F);
-  if (!set) {
-    // log error, return failure
-    pwasm_env_fail(env, "table element is not set");
+  // populate signature
+  uint32_t * const vals = ((uint32_t*) pwasm_vec_get_data(&(types->vals))) + ofs;
+  vals[0] = type.params.len;
+  memcpy(vals + 1, mod->u32s + type.params.ofs, type.params.len * sizeof(uint32_t));
+  memcpy(vals + 1 + type.params.len, mod->u32s + type.results.ofs, type.results.len * sizeof(uint32_t));
+
+  // intern signature, return result
+  return pwasm_func_types_intern(types, ofs, ret_id);
+}
+
+/**
+ * Get the type ID of the native function type +type+.
+ *
+ * Returns false if memory allocation failed.
+ */
+static bool
+pwasm_func_types_add_native_type(
+  pwasm_func_types_t * const types,
+  const pwasm_native_type_t * const type,
+  uint32_t * const ret_id
+) {
+  const size_t len = 1 + type->params.len + type->results.len;
+
+  // append signature, check for error
+  size_t ofs;
+  if (!pwasm_vec_push_uninitialized(&(types->vals), len, &ofs)) {
     return false;
   }
 
-  if (ret_val) {
-    // write value to destination
-    *ret_val = table->vals[ofs];
+  // populate signature
+  uint32_t * const vals = ((uint32_t*) pwasm_vec_get_data(&(types->vals))) + ofs;
+  vals[0] = type->params.len;
+  for (size_t i = 0; i < type->params.len; i++) {
+    vals[1 + i] = type->params.ptr[i];
+  }
+  for (size_t i = 0; i < type->results.len; i++) {
+    vals[1 + type->params.len + i] = type->results.ptr[i];
   }
 
-  // return success
-  return true;
+  // intern signature, return result
+  return pwasm_func_types_intern(types, ofs, ret_id);
 }
 
-#define PWASM_NEW_INTERP_VECS \
-  PWASM_NEW_INTERP_VEC(u32s, uint32_t) \
-  PWASM_NEW_INTERP_VEC(mods, pwasm_new_interp_mod_t) \
-  PWASM_NEW_INTERP_VEC(funcs, pwasm_new_interp_func_t) \
-  PWASM_NEW_INTERP_VEC(globals, pwasm_env_global_t) \
-  PWASM_NEW_INTERP_VEC(mems, pwasm_env_mem_t) \
-  PWASM_NEW_INTERP_VEC(tables, pwasm_new_interp_table_t)
+//
+// module instance snapshots: saved contents of the memories, globals,
+// and tables defined by a module instance (used by environments to
+// implement pwasm_env_snapshot_mod() and pwasm_env_restore_mod())
+//
 
 typedef struct {
-  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) pwasm_vec_t NAME;
-  PWASM_NEW_INTERP_VECS
-  #undef PWASM_NEW_INTERP_VEC
-  pwasm_ctrl_stack_t ctrl_stack;
-} pwasm_new_interp_t;
+  // saved values
+  uint32_t *vals;
+
+  // saved element masks
+  uint64_t *masks;
+
+  // number of values
+  size_t max_vals;
+} pwasm_snapshot_table_t;
 
 typedef struct {
-  pwasm_env_t * const env;
-  pwasm_new_interp_mod_t * const mod;
+  // module that the snapshot was taken from
+  const pwasm_mod_t *mod;
 
-  // memory for this frame
-  const uint32_t mem_id;
+  // saved memories (limits and contents), globals, and tables; one
+  // entry for each item defined by the module
+  pwasm_env_mem_t *mems;
+  pwasm_val_t *globals;
+  pwasm_snapshot_table_t *tables;
 
-  // function parameters
-  const pwasm_slice_t params;
+  // memory image file descriptors, one for each memory defined by the
+  // module (-1 if the memory contents are saved in the arena instead;
+  // see PWASM_ENV_SNAPSHOT_FLAG_MEMFD)
+  int *images;
+} pwasm_snapshot_t;
 
-  // offset and length of locals on the stack
-  // NOTE: the offset and length include function parameters
-  pwasm_slice_t locals;
-} pwasm_new_interp_frame_t;
+// get number of u64 element masks for table with +num+ values
+#define PWASM_SNAPSHOT_NUM_MASKS(num) (((num) + 63) / 64)
 
-static bool
-pwasm_new_interp_init(
-  pwasm_env_t * const env
+/**
+ * Allocate copy of +len+ bytes at +ptr+ from arena.
+ *
+ * Returns NULL on error.
+ */
+static void *
+pwasm_snapshot_copy(
+  pwasm_arena_t * const arena,
+  const void * const ptr,
+  const size_t len
 ) {
-  const size_t interp_size = sizeof(pwasm_new_interp_t);
-  pwasm_mem_ctx_t * const mem_ctx = env->mem_ctx;
-
-  // allocate interpreter data store
-  pwasm_new_interp_t *interp = pwasm_realloc(mem_ctx, NULL, interp_size);
-  if (!interp) {
-    // log error, return failure
-    D("pwasm_realloc() failed (size = %zu)", interp_size);
-    pwasm_env_fail(env, "interpreter memory allocation failed");
-    return false;
+  void * const dst = pwasm_arena_alloc(arena, len);
+  if (dst && len) {
+    memcpy(dst, ptr, len);
   }
+  return dst;
+}
 
-  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) \
-    /* allocate vector, check for error */ \
-    if (!pwasm_vec_init(mem_ctx, &(interp->NAME), sizeof(TYPE))) { \
-      /* log error, return failure */ \
-      D("pwasm_vec_init() failed (stride = %zu)", sizeof(TYPE)); \
-      pwasm_env_fail(env, "interpreter " #NAME " vector init failed"); \
-      return false; \
-    }
-  PWASM_NEW_INTERP_VECS
-  #undef PWASM_NEW_INTERP_VEC
+/**
+ * Allocate empty snapshot of an instance of module +mod+ whose defined
+ * memories and tables occupy +data_size+ bytes.
+ *
+ * Returns NULL on error.
+ */
+static pwasm_snapshot_t *
+pwasm_snapshot_alloc(
+  pwasm_env_snapshot_t * const snap,
+  pwasm_mem_ctx_t * const mem_ctx,
+  const pwasm_mod_t * const mod,
+  const size_t data_size
+) {
+  const size_t mems_size = mod->num_mems * sizeof(pwasm_env_mem_t);
+  const size_t globals_size = mod->num_globals * sizeof(pwasm_val_t);
+  const size_t tables_size = mod->num_tables * sizeof(pwasm_snapshot_table_t);
+  const size_t images_size = mod->num_mems * sizeof(int);
+
+  // size arena so that the whole snapshot fits in one block
+  const size_t size = sizeof(pwasm_snapshot_t) + mems_size + globals_size + tables_size + images_size;
+  pwasm_arena_init(&(snap->arena), mem_ctx, size + data_size + 1024);
+
+  // allocate snapshot and item arrays, check for error
+  pwasm_snapshot_t * const data = pwasm_arena_alloc(&(snap->arena), sizeof(pwasm_snapshot_t));
+  pwasm_env_mem_t * const mems = pwasm_arena_alloc(&(snap->arena), mems_size);
+  pwasm_val_t * const globals = pwasm_arena_alloc(&(snap->arena), globals_size);
+  pwasm_snapshot_table_t * const tables = pwasm_arena_alloc(&(snap->arena), tables_size);
+  int * const images = pwasm_arena_alloc(&(snap->arena), images_size);
+  if (!data || !mems || !globals || !tables || !images) {
+    pwasm_arena_fini(&(snap->arena));
+    return NULL;
+  }
 
-  // init control stack, check for error
-  if (!pwasm_ctrl_stack_init(&(interp->ctrl_stack), mem_ctx)) {
-    // return failure
-    return false;
+  // clear memory images
+  for (size_t i = 0; i < mod->num_mems; i++) {
+    images[i] = -1;
   }
 
-  // save interpreter, return success
-  env->env_data = interp;
-  return true;
+  // populate snapshot
+  *data = (pwasm_snapshot_t) {
+    .mod      = mod,
+    .mems     = mems,
+    .globals  = globals,
+    .tables   = tables,
+    .images   = images,
+  };
+
+  // save snapshot, return result
+  snap->data = data;
+  return data;
 }
 
-static void
-pwasm_new_interp_fini_tables(
-  pwasm_env_t * const env
+/**
+ * Save memory +src+ to snapshot memory +dst+.
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_snapshot_save_mem(
+  pwasm_env_snapshot_t * const snap,
+  pwasm_env_mem_t * const dst,
+  const pwasm_env_mem_t * const src
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const vec = &(interp->tables);
-  pwasm_new_interp_table_t *rows = (pwasm_new_interp_table_t*) pwasm_vec_get_data(vec);
-  const size_t num_rows = pwasm_vec_get_size(vec);
-
-  for (size_t i = 0; i < num_rows; i++) {
-    pwasm_new_interp_table_fini(env, rows + i);
+  const uint8_t * const ptr = pwasm_snapshot_copy(&(snap->arena), src->buf.ptr, src->buf.len);
+  if (!ptr) {
+    return false;
   }
+
+  *dst = (pwasm_env_mem_t) {
+    .buf    = { ptr, src->buf.len },
+    .limits = src->limits,
+  };
+
+  return true;
 }
 
-static void
-pwasm_new_interp_fini(
-  pwasm_env_t * const env
-) {
-  pwasm_mem_ctx_t * const mem_ctx = env->mem_ctx;
+/**
+ * Save memory +src+ to snapshot memory +dst+ and a new memory image
+ * (an anonymous in-memory file), and save the memory image file
+ * descriptor to +image+.
+ *
+ * Returns false on error, or if memory images are not supported on
+ * this platform.
+ */
+static bool
+pwasm_snapshot_save_mem_image(
+  pwasm_env_mem_t * const dst,
+  int * const image,
+  const pwasm_env_mem_t * const src
+) {
+#ifdef PWASM_HAVE_MEMFD
+  // create image, check for error
+  const int fd = memfd_create("pwasm-mem", MFD_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
 
-  // get interpreter data
-  pwasm_new_interp_t *data = env->env_data;
-  if (!data) {
-    return;
+  // size image, check for error
+  if (ftruncate(fd, src->buf.len)) {
+    close(fd);
+    return false;
   }
 
-  // finalize tables
-  pwasm_new_interp_fini_tables(env);
+  if (src->buf.len > 0) {
+    // map image, check for error
+    void * const ptr = mmap(NULL, src->buf.len, PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      close(fd);
+      return false;
+    }
 
-  // fini control stack, check for error
-  pwasm_ctrl_stack_fini(&(data->ctrl_stack));
+    // copy contents to image, unmap image
+    memcpy(ptr, src->buf.ptr, src->buf.len);
+    munmap(ptr, src->buf.len);
+  }
 
-  // free vectors
-  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) pwasm_vec_fini(&(data->NAME));
-  PWASM_NEW_INTERP_VECS
-  #undef PWASM_NEW_INTERP_VEC
+  *dst = (pwasm_env_mem_t) {
+    .buf    = { NULL, src->buf.len },
+    .limits = src->limits,
+  };
+  *image = fd;
 
-  // free backing data
-  pwasm_realloc(mem_ctx, data, 0);
-  env->env_data = NULL;
+  // return success
+  return true;
+#else
+  (void) dst;
+  (void) image;
+  (void) src;
+  return false;
+#endif /* PWASM_HAVE_MEMFD */
 }
 
 /**
- * Given an environment and a table handle, return a pointer to the
- * table instance.
+ * Save table values +vals+, element masks +masks+, and size +max_vals+
+ * to snapshot table +dst+.
  *
- * Returns `NULL` if the table handle is invalid.
+ * Returns false on error.
  */
-static pwasm_new_interp_table_t *
-pwasm_new_interp_get_table(
-  pwasm_env_t * const env,
-  const uint32_t table_id
+static bool
+pwasm_snapshot_save_table(
+  pwasm_env_snapshot_t * const snap,
+  pwasm_snapshot_table_t * const dst,
+  const uint32_t * const vals,
+  const uint64_t * const masks,
+  const size_t max_vals
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const vec = &(interp->tables);
-  const pwasm_new_interp_table_t * const rows = pwasm_vec_get_data(vec);
-  const size_t num_rows = pwasm_vec_get_size(vec);
-
-  // check that table_id is in bounds
-  if (!table_id || table_id > num_rows) {
-    // log error, return failure
-    D("bad table_id: %u, num_rows = %zu", table_id, num_rows);
-    pwasm_env_fail(env, "interpreter table index out of bounds");
-    return NULL;
+  const size_t num_masks = PWASM_SNAPSHOT_NUM_MASKS(max_vals);
+  uint32_t * const dst_vals = pwasm_snapshot_copy(&(snap->arena), vals, max_vals * sizeof(uint32_t));
+  uint64_t * const dst_masks = pwasm_snapshot_copy(&(snap->arena), masks, num_masks * sizeof(uint64_t));
+  if (!dst_vals || !dst_masks) {
+    return false;
   }
 
-  // return pointer to table
-  return (pwasm_new_interp_table_t*) rows + (table_id - 1);
+  *dst = (pwasm_snapshot_table_t) {
+    .vals     = dst_vals,
+    .masks    = dst_masks,
+    .max_vals = max_vals,
+  };
+
+  return true;
 }
 
+/**
+ * Restore table values, element masks, and size from snapshot table
+ * +src+, resizing the table arrays with +mem_ctx+.
+ *
+ * Returns false on error.
+ */
 static bool
-pwasm_new_interp_push_u32s(
-  pwasm_env_t * const env,
-  const size_t ofs,
-  const size_t len
-) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const u32s = &(interp->u32s);
-  const pwasm_slice_t slice = { ofs, len };
-
-  uint32_t ids[PWASM_BATCH_SIZE];
-  size_t num = 0;
-
-  for (size_t i = 0; i < slice.len; i++) {
-    ids[num++] = slice.ofs + i;
-
-    if (num == LEN(ids)) {
-      // clear count
-      num = 0;
+pwasm_snapshot_restore_table(
+  pwasm_mem_ctx_t * const mem_ctx,
+  uint32_t ** const vals,
+  uint64_t ** const masks,
+  size_t * const max_vals,
+  const pwasm_snapshot_table_t * const src
+) {
+  const size_t num_masks = PWASM_SNAPSHOT_NUM_MASKS(src->max_vals);
+
+  if (!src->max_vals) {
+    // free values and masks
+    pwasm_realloc(mem_ctx, *vals, 0);
+    pwasm_realloc(mem_ctx, *masks, 0);
+    *vals = NULL;
+    *masks = NULL;
+    *max_vals = 0;
+    return true;
+  }
 
-      // append results, check for error
-      if (!pwasm_vec_push(u32s, LEN(ids), ids, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append offsets failed");
-        return false;
-      }
+  if (*max_vals != src->max_vals) {
+    // resize values and masks, check for error
+    uint32_t * const new_vals = pwasm_realloc(mem_ctx, *vals, src->max_vals * sizeof(uint32_t));
+    if (!new_vals) {
+      return false;
     }
-  }
+    *vals = new_vals;
 
-  if (num > 0) {
-    // append results, check for error
-    if (!pwasm_vec_push(u32s, num, ids, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining offsets failed");
+    uint64_t * const new_masks = pwasm_realloc(mem_ctx, *masks, num_masks * sizeof(uint64_t));
+    if (!new_masks) {
       return false;
     }
+    *masks = new_masks;
+    *max_vals = src->max_vals;
   }
 
+  // copy values and masks
+  memcpy(*vals, src->vals, src->max_vals * sizeof(uint32_t));
+  memcpy(*masks, src->masks, num_masks * sizeof(uint64_t));
+
   // return success
   return true;
 }
 
-static bool
-pwasm_new_interp_add_native_funcs(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_native_t * const mod,
-  pwasm_slice_t * const ret
+void
+pwasm_env_snapshot_fini(
+  pwasm_env_snapshot_t * const snap
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->funcs);
-  const size_t dst_ofs = pwasm_vec_get_size(dst);
-  const size_t u32s_ofs = pwasm_vec_get_size(&(interp->u32s));
+  const pwasm_snapshot_t * const data = snap->data;
 
-  pwasm_new_interp_func_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
-
-  for (size_t i = 0; i < mod->num_funcs; i++) {
-    tmp[tmp_ofs++] = (pwasm_new_interp_func_t) {
-      .mod_ofs  = mod_ofs,
-      .func_ofs = i,
-    };
-
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
-
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append native functions failed");
-        return false;
+  if (data) {
+    // close memory images
+    for (size_t i = 0; i < data->mod->num_mems; i++) {
+      if (data->images[i] >= 0) {
+        close(data->images[i]);
       }
     }
   }
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining native functions failed");
-      return false;
-    }
-  }
+  pwasm_arena_fini(&(snap->arena));
+  memset(snap, 0, sizeof(pwasm_env_snapshot_t));
+}
 
-  // add IDs
-  if (!pwasm_new_interp_push_u32s(env, u32s_ofs, mod->num_funcs)) {
-    // return failure
-    return false;
-  }
+//
+// control stack: used by AOT JIT interpreter to manage control frames
+//
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = dst_ofs,
-    .len = mod->num_funcs,
-  };
+#define CTRL_TYPES \
+  CTRL_TYPE(BLOCK) \
+  CTRL_TYPE(LOOP) \
+  CTRL_TYPE(IF) \
+  CTRL_TYPE(ELSE)
 
-  // return success
-  return true;
-}
+typedef enum {
+#define CTRL_TYPE(a) CTRL_ ## a,
+CTRL_TYPES
+#undef CTRL_TYPE
+  CTRL_LAST,
+} pwasm_ctrl_stack_entry_type_t;
+
+typedef struct {
+  pwasm_ctrl_stack_entry_type_t type; // stack entry type
+  size_t depth; // value stack depth
+  size_t ofs; // inst ofs
+  uint32_t func_type;
+} pwasm_ctrl_stack_entry_t;
+
+typedef struct {
+  pwasm_vec_t stack;
+} pwasm_ctrl_stack_t;
 
 static bool
-pwasm_new_interp_add_native_globals(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_native_t * const mod,
-  pwasm_slice_t * const ret
+pwasm_ctrl_stack_init(
+  pwasm_ctrl_stack_t * const stack,
+  pwasm_mem_ctx_t * const mem_ctx
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->globals);
-  const size_t dst_ofs = pwasm_vec_get_size(dst);
-  const size_t u32s_ofs = pwasm_vec_get_size(&(interp->u32s));
-  (void) mod_ofs;
+  const size_t stride = sizeof(pwasm_ctrl_stack_entry_t);
+  return pwasm_vec_init(mem_ctx, &(stack->stack), stride);
+}
 
-  pwasm_env_global_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
+static void
+pwasm_ctrl_stack_fini(
+  pwasm_ctrl_stack_t * const stack
+) {
+  pwasm_vec_fini(&(stack->stack));
+}
 
-  for (size_t i = 0; i < mod->num_globals; i++) {
-    tmp[tmp_ofs++] = (pwasm_env_global_t) {
-      .type = mod->globals[i].type,
-      .val  = mod->globals[i].val,
-    };
+#if 0
+static size_t
+pwasm_ctrl_stack_get_size(
+  const pwasm_ctrl_stack_t * const stack
+) {
+  return pwasm_vec_get_size(&(stack->stack));
+}
+#endif /* 0 */
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+static const void *
+pwasm_ctrl_stack_peek_tail(
+  const pwasm_ctrl_stack_t * const stack,
+  const size_t ofs
+) {
+  return pwasm_vec_peek_tail(&(stack->stack), ofs);
+}
 
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append native globals failed");
-        return false;
-      }
-    }
-  }
+static bool
+pwasm_ctrl_stack_pop(
+  pwasm_ctrl_stack_t * const stack,
+  void * const dst
+) {
+  // pop final entry, return result
+  return pwasm_vec_pop(&(stack->stack), dst);
+}
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining native globals failed");
+static bool
+pwasm_ctrl_stack_popn(
+  pwasm_ctrl_stack_t * const stack,
+  const size_t num
+) {
+  // pop entries
+  for (size_t i = 0; i < num; i++) {
+    if (!pwasm_vec_pop(&(stack->stack), NULL)) {
       return false;
     }
   }
 
-  // add IDs
-  if (!pwasm_new_interp_push_u32s(env, u32s_ofs, mod->num_globals)) {
-    // return failure
-    return false;
-  }
-
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = dst_ofs,
-    .len = mod->num_globals,
-  };
-
   // return success
   return true;
 }
 
 static bool
-pwasm_new_interp_add_native_mems(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_native_t * const mod,
-  pwasm_slice_t * const ret
+pwasm_ctrl_stack_push(
+  pwasm_ctrl_stack_t * const stack,
+  const pwasm_ctrl_stack_entry_t entry
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->mems);
-  const size_t dst_ofs = pwasm_vec_get_size(dst);
-  (void) mod_ofs;
+  return pwasm_vec_push(&(stack->stack), 1, &entry, NULL);
+}
 
-  pwasm_env_mem_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
+//
+// v128 kernels: portable implementations of the most common v128
+// instructions, plus SSE2, SSSE3, and SSE4.1 versions which are
+// selected at environment init time based on the features of the CPU
+// (see pwasm_v128_kernels_init())
+//
 
-  for (size_t i = 0; i < mod->num_mems; i++) {
-    tmp[tmp_ofs++] = (pwasm_env_mem_t) {
-      .buf    = mod->mems[i].buf,
-      .limits = mod->mems[i].limits,
-    };
+#define PWASM_V128_KERNELS \
+  PWASM_V128_KERNEL(I8X16_EQ, i8x16_eq) \
+  PWASM_V128_KERNEL(I8X16_LT_S, i8x16_lt_s) \
+  PWASM_V128_KERNEL(I8X16_GT_S, i8x16_gt_s) \
+  PWASM_V128_KERNEL(I16X8_EQ, i16x8_eq) \
+  PWASM_V128_KERNEL(I16X8_LT_S, i16x8_lt_s) \
+  PWASM_V128_KERNEL(I16X8_GT_S, i16x8_gt_s) \
+  PWASM_V128_KERNEL(I32X4_EQ, i32x4_eq) \
+  PWASM_V128_KERNEL(I32X4_LT_S, i32x4_lt_s) \
+  PWASM_V128_KERNEL(I32X4_GT_S, i32x4_gt_s) \
+  PWASM_V128_KERNEL(I8X16_ADD, i8x16_add) \
+  PWASM_V128_KERNEL(I8X16_ADD_SATURATE_S, i8x16_add_saturate_s) \
+  PWASM_V128_KERNEL(I8X16_ADD_SATURATE_U, i8x16_add_saturate_u) \
+  PWASM_V128_KERNEL(I8X16_SUB, i8x16_sub) \
+  PWASM_V128_KERNEL(I8X16_SUB_SATURATE_S, i8x16_sub_saturate_s) \
+  PWASM_V128_KERNEL(I8X16_SUB_SATURATE_U, i8x16_sub_saturate_u) \
+  PWASM_V128_KERNEL(I8X16_MIN_S, i8x16_min_s) \
+  PWASM_V128_KERNEL(I8X16_MIN_U, i8x16_min_u) \
+  PWASM_V128_KERNEL(I8X16_MAX_S, i8x16_max_s) \
+  PWASM_V128_KERNEL(I8X16_MAX_U, i8x16_max_u) \
+  PWASM_V128_KERNEL(I16X8_ADD, i16x8_add) \
+  PWASM_V128_KERNEL(I16X8_ADD_SATURATE_S, i16x8_add_saturate_s) \
+  PWASM_V128_KERNEL(I16X8_ADD_SATURATE_U, i16x8_add_saturate_u) \
+  PWASM_V128_KERNEL(I16X8_SUB, i16x8_sub) \
+  PWASM_V128_KERNEL(I16X8_SUB_SATURATE_S, i16x8_sub_saturate_s) \
+  PWASM_V128_KERNEL(I16X8_SUB_SATURATE_U, i16x8_sub_saturate_u) \
+  PWASM_V128_KERNEL(I16X8_MUL, i16x8_mul) \
+  PWASM_V128_KERNEL(I16X8_MIN_S, i16x8_min_s) \
+  PWASM_V128_KERNEL(I16X8_MIN_U, i16x8_min_u) \
+  PWASM_V128_KERNEL(I16X8_MAX_S, i16x8_max_s) \
+  PWASM_V128_KERNEL(I16X8_MAX_U, i16x8_max_u) \
+  PWASM_V128_KERNEL(I32X4_ADD, i32x4_add) \
+  PWASM_V128_KERNEL(I32X4_SUB, i32x4_sub) \
+  PWASM_V128_KERNEL(I32X4_MUL, i32x4_mul) \
+  PWASM_V128_KERNEL(I32X4_MIN_S, i32x4_min_s) \
+  PWASM_V128_KERNEL(I32X4_MIN_U, i32x4_min_u) \
+  PWASM_V128_KERNEL(I32X4_MAX_S, i32x4_max_s) \
+  PWASM_V128_KERNEL(I32X4_MAX_U, i32x4_max_u) \
+  PWASM_V128_KERNEL(I64X2_ADD, i64x2_add) \
+  PWASM_V128_KERNEL(I64X2_SUB, i64x2_sub) \
+  PWASM_V128_KERNEL(F32X4_SQRT, f32x4_sqrt) \
+  PWASM_V128_KERNEL(F32X4_ADD, f32x4_add) \
+  PWASM_V128_KERNEL(F32X4_SUB, f32x4_sub) \
+  PWASM_V128_KERNEL(F32X4_MUL, f32x4_mul) \
+  PWASM_V128_KERNEL(F32X4_DIV, f32x4_div) \
+  PWASM_V128_KERNEL(F64X2_SQRT, f64x2_sqrt) \
+  PWASM_V128_KERNEL(F64X2_ADD, f64x2_add) \
+  PWASM_V128_KERNEL(F64X2_SUB, f64x2_sub) \
+  PWASM_V128_KERNEL(F64X2_MUL, f64x2_mul) \
+  PWASM_V128_KERNEL(F64X2_DIV, f64x2_div) \
+  PWASM_V128_KERNEL(I8X16_AVGR_U, i8x16_avgr_u) \
+  PWASM_V128_KERNEL(I16X8_AVGR_U, i16x8_avgr_u) \
+  PWASM_V128_KERNEL(I8X16_ABS, i8x16_abs) \
+  PWASM_V128_KERNEL(I16X8_ABS, i16x8_abs) \
+  PWASM_V128_KERNEL(I32X4_ABS, i32x4_abs)
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+typedef enum {
+#define PWASM_V128_KERNEL(NAME, name) PWASM_V128_KERNEL_ ## NAME,
+PWASM_V128_KERNELS
+#undef PWASM_V128_KERNEL
+  PWASM_V128_KERNEL_LAST,
+} pwasm_v128_kernel_id_t;
 
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append native mems failed");
-        return false;
-      }
-    }
-  }
+/**
+ * v128 kernel: write the result of applying an instruction to +a+ and
+ * +b+ (ignored by unary instructions) to +dst+.
+ *
+ * +dst+ may alias +a+ or +b+.
+ */
+typedef void (*pwasm_v128_kernel_t)(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const a,
+  const pwasm_v128_t * const b
+);
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining native mems failed");
-      return false;
-    }
-  }
+static void
+pwasm_v128_i8x16_eq(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = dst_ofs,
-    .len = mod->num_mems,
-  };
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    c.i8[j] = (a.i8[j] == b.i8[j]) ? 0xFF : 0;
+  }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static uint32_t
-pwasm_new_interp_add_native(
-  pwasm_env_t * const env,
-  const char * const name,
-  const pwasm_native_t * const mod
+static void
+pwasm_v128_i8x16_lt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const size_t mod_ofs = pwasm_vec_get_size(&(interp->mods));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add native functions, check for error
-  pwasm_slice_t funcs;
-  if (!pwasm_new_interp_add_native_funcs(env, mod_ofs, mod, &funcs)) {
-    // return failure
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    c.i8[j] = (av < bv) ? 0xFF : 0;
   }
 
-  // add native globals, check for error
-  pwasm_slice_t globals;
-  if (!pwasm_new_interp_add_native_globals(env, mod_ofs, mod, &globals)) {
-    // return failure
-    return 0;
-  }
+  *dst = c;
+}
 
-  // add native mems, check for error
-  pwasm_slice_t mems;
-  if (!pwasm_new_interp_add_native_mems(env, mod_ofs, mod, &mems)) {
-    // return failure
-    return 0;
+static void
+pwasm_v128_i8x16_gt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
+
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    c.i8[j] = (av > bv) ? 0xFF : 0;
   }
 
-  // build row
-  const pwasm_new_interp_mod_t interp_mod = {
-    .type     = PWASM_NEW_INTERP_MOD_TYPE_NATIVE,
-    .name     = pwasm_buf_str(name),
-    .native   = mod,
+  *dst = c;
+}
 
-    .funcs    = funcs,
-    .globals  = globals,
-    .mems     = mems,
-  };
+static void
+pwasm_v128_i16x8_eq(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // append native mod, check for error
-  if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, NULL)) {
-    // log error, return failure
-    pwasm_env_fail(env, "append native mod failed");
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    c.i16[j] = (a.i16[j] == b.i16[j]) ? 0xFFFF : 0;
   }
 
-  // convert offset to ID by adding 1
-  return mod_ofs + 1;
+  *dst = c;
 }
 
-/*
- * Resolve imports of a given type.
- *
- * On success, a slice of import IDs is stored in +ret+, and this
- * function returns true.
- *
- * Returns false on error.
- */
-static bool
-pwasm_new_interp_add_mod_imports(
-  pwasm_env_t * const env,
-  const pwasm_mod_t * const mod,
-  const pwasm_import_type_t type,
-  pwasm_slice_t * const ret
+static void
+pwasm_v128_i16x8_lt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const u32s = &(interp->u32s);
-  const size_t ret_ofs = pwasm_vec_get_size(u32s);
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  uint32_t ids[PWASM_BATCH_SIZE];
-  size_t num_ids = 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    c.i16[j] = (av < bv) ? 0xFFFF : 0;
+  }
 
-  // loop over imports and resolve each one
-  for (size_t i = 0; i < mod->num_imports; i++) {
-    // get import, check type
-    const pwasm_import_t import = mod->imports[i];
-    if (import.type != type) {
-      continue;
-    }
+  *dst = c;
+}
 
-    const pwasm_buf_t mod_buf = {
-      .ptr = mod->bytes + import.module.ofs,
-      .len = import.module.len,
-    };
+static void
+pwasm_v128_i16x8_gt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // find mod, check for error
-    const uint32_t mod_id = pwasm_env_find_mod(env, mod_buf);
-    if (!mod_id) {
-      // return failure
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    c.i16[j] = (av > bv) ? 0xFFFF : 0;
+  }
 
-    const pwasm_buf_t name_buf = {
-      .ptr = mod->bytes + import.name.ofs,
-      .len = import.name.len,
-    };
+  *dst = c;
+}
 
-    // find import ID, check for error
-    const uint32_t id = pwasm_env_find_import(env, mod_id, import.type, name_buf);
-    if (!id) {
-      // return failure
-      return false;
-    }
+static void
+pwasm_v128_i32x4_eq(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // add item to results, increment count
-    ids[num_ids++] = id;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.i32[j] = (a.i32[j] == b.i32[j]) ? 0xFFFFFFFF : 0;
+  }
 
-    if (num_ids == LEN(ids)) {
-      // clear count
-      num_ids = 0;
+  *dst = c;
+}
 
-      // append results, check for error
-      if (!pwasm_vec_push(u32s, LEN(ids), ids, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append import ids failed");
-        return false;
-      }
-    }
-  }
+static void
+pwasm_v128_i32x4_lt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  if (num_ids > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(u32s, num_ids, ids, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining native imports failed");
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const int32_t av = a.i32[j];
+    const int32_t bv = b.i32[j];
+    c.i32[j] = (av < bv) ? 0xFFFFFFFF : 0;
   }
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = ret_ofs,
-    .len = pwasm_vec_get_size(u32s) - ret_ofs,
-  };
-
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_add_mod_funcs(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_mod_t * const mod,
-  pwasm_slice_t * const ret
+static void
+pwasm_v128_i32x4_gt_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->funcs);
-  const size_t funcs_ofs = pwasm_vec_get_size(dst);
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add imported functions, check for error
-  pwasm_slice_t imports;
-  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_FUNC, &imports)) {
-    return false;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const int32_t av = a.i32[j];
+    const int32_t bv = b.i32[j];
+    c.i32[j] = (av > bv) ? 0xFFFFFFFF : 0;
   }
 
-  pwasm_new_interp_func_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
-
-  for (size_t i = 0; i < mod->num_funcs; i++) {
-    tmp[tmp_ofs++] = (pwasm_new_interp_func_t) {
-      .mod_ofs  = mod_ofs,
-      .func_ofs = i,
-    };
+  *dst = c;
+}
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+static void
+pwasm_v128_i8x16_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append functions failed");
-        return false;
-      }
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    c.i8[j] = a.i8[j] + b.i8[j];
   }
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining functions failed");
-      return false;
-    }
-  }
+  *dst = c;
+}
 
-  if (!pwasm_new_interp_push_u32s(env, funcs_ofs, mod->num_funcs)) {
-    return false;
-  }
+static void
+pwasm_v128_i8x16_add_saturate_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = imports.ofs,
-    .len = imports.len + mod->num_funcs,
-  };
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    const int32_t v = av + bv;
+    c.i8[j] = CLAMP(v, INT8_MIN, INT8_MAX);
+  }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_add_mod_globals(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_mod_t * const mod,
-  pwasm_slice_t * const ret
+static void
+pwasm_v128_i8x16_add_saturate_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->globals);
-  const size_t globals_ofs = pwasm_vec_get_size(dst);
-  (void) mod_ofs;
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add imported globals, check for error
-  pwasm_slice_t imports;
-  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_GLOBAL, &imports)) {
-    return false;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const uint8_t av = a.i8[j];
+    const uint8_t bv = b.i8[j];
+    const uint32_t v = av + bv;
+    c.i8[j] = MIN(v, UINT8_MAX);
   }
 
-  pwasm_env_global_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
-
-  for (size_t i = 0; i < mod->num_globals; i++) {
-    tmp[tmp_ofs++] = (pwasm_env_global_t) {
-      .type  = mod->globals[i].type,
-      // .val = // FIXME: uninitialized
-    };
+  *dst = c;
+}
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+static void
+pwasm_v128_i8x16_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append globals failed");
-        return false;
-      }
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    c.i8[j] = a.i8[j] - b.i8[j];
   }
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining globals failed");
-      return false;
-    }
-  }
+  *dst = c;
+}
 
-  // add IDs
-  if (!pwasm_new_interp_push_u32s(env, globals_ofs, mod->num_globals)) {
-    // return failure
-    return false;
-  }
+static void
+pwasm_v128_i8x16_sub_saturate_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = imports.ofs,
-    .len = imports.len + mod->num_globals,
-  };
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    const int32_t v = av - bv;
+    c.i8[j] = CLAMP(v, INT8_MIN, INT8_MAX);
+  }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_add_mod_mems(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_mod_t * const mod,
-  pwasm_slice_t * const ret
+static void
+pwasm_v128_i8x16_sub_saturate_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->mems);
-  const size_t mems_ofs = pwasm_vec_get_size(dst);
-  (void) mod_ofs;
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add imported mems, check for error
-  pwasm_slice_t imports;
-  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_MEM, &imports)) {
-    return false;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const uint8_t av = a.i8[j];
+    const uint8_t bv = b.i8[j];
+    c.i8[j] = (av > bv) ? (av - bv) : 0;
   }
 
-  pwasm_env_mem_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
+  *dst = c;
+}
 
-  for (size_t i = 0; i < mod->num_mems; i++) {
-    // allocate buffer
-    const size_t num_bytes = mod->mems[i].min * PWASM_PAGE_SIZE;
-    uint8_t * const ptr = pwasm_realloc(env->mem_ctx, NULL, num_bytes);
-    if (!ptr && num_bytes) {
-      // log error, return failure
-      pwasm_env_fail(env, "allocate memory buffer failed");
-      return false;
-    }
+static void
+pwasm_v128_i8x16_min_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    tmp[tmp_ofs++] = (pwasm_env_mem_t) {
-      .limits = mod->mems[i],
-      .buf = (pwasm_buf_t) {
-        .ptr = ptr,
-        .len = num_bytes,
-      },
-    };
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    c.i8[j] = MIN(av, bv);
+  }
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+  *dst = c;
+}
 
-      // append results, check for error
-      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append mems failed");
-        return false;
-      }
-    }
-  }
+static void
+pwasm_v128_i8x16_min_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  if (tmp_ofs > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining mems failed");
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const uint8_t av = a.i8[j];
+    const uint8_t bv = b.i8[j];
+    c.i8[j] = MIN(av, bv);
   }
 
-  if (!pwasm_new_interp_push_u32s(env, mems_ofs, mod->num_mems)) {
-    return false;
-  }
+  *dst = c;
+}
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = imports.ofs,
-    .len = imports.len + mod->num_mems,
-  };
+static void
+pwasm_v128_i8x16_max_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // return success
-  return true;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t av = a.i8[j];
+    const int8_t bv = b.i8[j];
+    c.i8[j] = MAX(av, bv);
+  }
+
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_add_mod_tables(
-  pwasm_env_t * const env,
-  const uint32_t mod_ofs,
-  const pwasm_mod_t * const mod,
-  pwasm_slice_t * const ret
+static void
+pwasm_v128_i8x16_max_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_vec_t * const dst = &(interp->tables);
-  pwasm_vec_t * const u32s = &(interp->u32s);
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add imported tables, check for error
-  pwasm_slice_t imports = { 0, 0 };
-  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_TABLE, &imports)) {
-    return false;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const uint8_t av = a.i8[j];
+    const uint8_t bv = b.i8[j];
+    c.i8[j] = MAX(av, bv);
   }
 
-  uint32_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
+  *dst = c;
+}
 
-  for (size_t i = 0; i < mod->num_tables; i++) {
-    // init table
-    pwasm_new_interp_table_t table = pwasm_new_interp_table_init(env, mod_ofs, i, mod->tables[i].limits);
+static void
+pwasm_v128_i16x8_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // append initialized table to interpreter, check for error
-    size_t tmp_pos;
-    if (!pwasm_vec_push(dst, 1, &table, &tmp_pos)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append tables failed");
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    c.i16[j] = a.i16[j] + b.i16[j];
+  }
 
-    // append to table offsets, increment count
-    tmp[tmp_ofs] = tmp_pos;
-    tmp_ofs++;
+  *dst = c;
+}
 
-    if (tmp_ofs == LEN(tmp)) {
-      // clear count
-      tmp_ofs = 0;
+static void
+pwasm_v128_i16x8_add_saturate_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-      // append IDs, check for error
-      if (!pwasm_vec_push(u32s, LEN(tmp), tmp, NULL)) {
-        // log error, return failure
-        pwasm_env_fail(env, "append table ids failed");
-        return false;
-      }
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    const int32_t v = av + bv;
+    c.i16[j] = CLAMP(v, INT16_MIN, INT16_MAX);
   }
 
-  if (tmp_ofs > 0) {
-    // flush IDs, check for error
-    if (!pwasm_vec_push(u32s, tmp_ofs, tmp, NULL)) {
-      // log error, return failure
-      pwasm_env_fail(env, "append remaining table IDs failed");
-      return false;
-    }
-  }
+  *dst = c;
+}
 
-  // populate result
-  *ret = (pwasm_slice_t) {
-    .ofs = imports.ofs,
-    .len = imports.len + mod->num_tables,
-  };
+static void
+pwasm_v128_i16x8_add_saturate_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // return success
-  return true;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    const uint32_t v = av + bv;
+    c.i16[j] = MIN(v, UINT16_MAX);
+  }
+
+  *dst = c;
 }
 
-// forward declarations
-static bool pwasm_new_interp_eval_expr(
-  pwasm_new_interp_frame_t frame,
-  const pwasm_slice_t
-);
+static void
+pwasm_v128_i16x8_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-static bool pwasm_new_interp_call(pwasm_env_t *, const uint32_t);
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    c.i16[j] = a.i16[j] - b.i16[j];
+  }
 
-static bool
-pwasm_new_interp_init_globals(
-  pwasm_new_interp_frame_t frame
+  *dst = c;
+}
+
+static void
+pwasm_v128_i16x8_sub_saturate_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-  pwasm_env_global_t *env_globals = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
-  pwasm_stack_t * const stack = frame.env->stack;
-  const pwasm_global_t * const mod_globals = frame.mod->mod->globals;
-  const uint32_t * interp_u32s = (uint32_t*) pwasm_vec_get_data(&(interp->u32s)) + frame.mod->globals.ofs;
-  const size_t num_globals = frame.mod->mod->num_globals;
-  const pwasm_val_t zero = { .i64 = 0 };
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  for (size_t i = 0; i < num_globals; i++) {
-    // clear stack
-    stack->pos = 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    const int32_t v = av - bv;
+    c.i16[j] = CLAMP(v, INT16_MIN, INT16_MAX);
+  }
 
-    // evaluate init
-    if (!pwasm_new_interp_eval_expr(frame, mod_globals[i].expr)) {
-      // return failure
-      return false;
-    }
+  *dst = c;
+}
 
-    // get destination offset, save value to global
-    const uint32_t ofs = interp_u32s[i];
-    env_globals[ofs].val = stack->pos ? stack->ptr[0] : zero;
+static void
+pwasm_v128_i16x8_sub_saturate_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
+
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    c.i16[j] = (av > bv) ? (av - bv) : 0;
   }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_init_elem_funcs(
-  pwasm_new_interp_frame_t frame,
-  const uint32_t ofs,
-  const pwasm_elem_t elem
+static void
+pwasm_v128_i16x8_mul(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  // get table and mod to interpreter func ID map
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-  const uint32_t *u32s = pwasm_vec_get_data(&(interp->u32s));
-  const uint32_t table_ofs = u32s[frame.mod->tables.ofs + elem.table_id];
-  D("frame.mod->tables.ofs = %zu, elem.table_id = %u, table_ofs = %u", frame.mod->tables.ofs, elem.table_id, table_ofs);
-  const uint32_t * const funcs = u32s + frame.mod->funcs.ofs;
-  pwasm_new_interp_table_t * const table = pwasm_new_interp_get_table(frame.env, table_ofs + 1);
-  if (!table) {
-    return false;
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
+
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    c.i16[j] = av * bv;
   }
 
-  uint32_t tmp[PWASM_BATCH_SIZE];
-  size_t tmp_ofs = 0;
+  *dst = c;
+}
 
-  for (size_t i = 0; i < elem.funcs.len; i++) {
-    // remap function id from module ID to interpreter ID
-    const uint32_t func_id = frame.mod->mod->u32s[elem.funcs.ofs + i];
-    tmp[tmp_ofs++] = funcs[func_id];
+static void
+pwasm_v128_i16x8_min_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    if (tmp_ofs == LEN(tmp)) {
-      // get destination offset
-      const size_t dst_ofs = ofs + i - LEN(tmp);
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    c.i16[j] = MIN(av, bv);
+  }
 
-      // set table elements, check for error
-      if (!pwasm_new_interp_table_set(frame.env, table, dst_ofs, tmp, LEN(tmp))) {
-        // return failure
-        return false;
-      }
+  *dst = c;
+}
 
-      // reset offset
-      tmp_ofs = 0;
-    }
+static void
+pwasm_v128_i16x8_min_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
+
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    c.i16[j] = MIN(av, bv);
   }
 
-  if (tmp_ofs > 0) {
-    // get destination offset
-    const size_t dst_ofs = ofs + elem.funcs.len - tmp_ofs;
+  *dst = c;
+}
 
-    // flush table elements, check for error
-    if (!pwasm_new_interp_table_set(frame.env, table, dst_ofs, tmp, tmp_ofs)) {
-      // return failure
-      return false;
-    }
+static void
+pwasm_v128_i16x8_max_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
+
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t av = a.i16[j];
+    const int16_t bv = b.i16[j];
+    c.i16[j] = MAX(av, bv);
   }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_init_elems(
-  pwasm_new_interp_frame_t frame
+static void
+pwasm_v128_i16x8_max_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  const pwasm_elem_t * const elems = frame.mod->mod->elems;
-  const size_t num_elems = frame.mod->mod->num_elems;
-  pwasm_stack_t * const stack = frame.env->stack;
-
-  // init table elements
-  for (size_t i = 0; i < num_elems; i++) {
-    const pwasm_elem_t elem = elems[i];
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // evaluate offset expression, check for error
-    stack->pos = 0;
-    if (!pwasm_new_interp_eval_expr(frame, elem.expr)) {
-      // return failure
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    c.i16[j] = MAX(av, bv);
+  }
 
-    // check that const expr has at least one result
-    // FIXME: should this be done in check()?
-    if (!stack->pos) {
-      pwasm_env_fail(frame.env, "constant expression must return table offset");
-      return false;
-    }
+  *dst = c;
+}
 
-    // get destination offset
-    const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
+static void
+pwasm_v128_i32x4_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // populate table elements, check for error
-    if (!pwasm_new_interp_init_elem_funcs(frame, ofs, elem)) {
-      // return failure
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.i32[j] = a.i32[j] + b.i32[j];
   }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-// forward reference
-static pwasm_env_mem_t *pwasm_new_interp_get_mem(pwasm_env_t * const, const uint32_t);
-
-static bool
-pwasm_new_interp_init_segments(
-  pwasm_new_interp_frame_t frame
+static void
+pwasm_v128_i32x4_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
-  const pwasm_segment_t * const segments = frame.mod->mod->segments;
-  const size_t num_segments = frame.mod->mod->num_segments;
-  pwasm_stack_t * const stack = frame.env->stack;
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // init memory elements
-  for (size_t i = 0; i < num_segments; i++) {
-    const pwasm_segment_t segment = segments[i];
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.i32[j] = a.i32[j] - b.i32[j];
+  }
 
-    // get interpreter memory ID
-    const uint32_t mem_id = u32s[frame.mod->mems.ofs + segment.mem_id];
+  *dst = c;
+}
 
-    // get memory, check for error
-    pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(frame.env, mem_id);
-    if (!mem) {
-      // return failure
-      return false;
-    }
+static void
+pwasm_v128_i32x4_mul(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // evaluate offset expression, check for error
-    stack->pos = 0;
-    if (!pwasm_new_interp_eval_expr(frame, segment.expr)) {
-      // return failure
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.i32[j] = a.i32[j] * b.i32[j];
+  }
 
-    // check that const expr has at least one result
-    if (!stack->pos) {
-      pwasm_env_fail(frame.env, "constant expression must return segment offset");
-      return false;
-    }
+  *dst = c;
+}
 
-    // get destination offset
-    const uint32_t dst_ofs = stack->ptr[stack->pos - 1].i32;
+static void
+pwasm_v128_i32x4_min_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // check destination length
-    // FIXME: should we resize here?
-    if (dst_ofs + segment.data.len > mem->buf.len) {
-      pwasm_env_fail(frame.env, "segment destination out of bounds");
-      return false;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const int32_t av = a.i32[j];
+    const int32_t bv = b.i32[j];
+    c.i32[j] = MIN(av, bv);
+  }
 
-    // D("mem = %u, ofs = %u, len = %zu", mem_id, dst_ofs, segment.data.len);
+  *dst = c;
+}
 
-    // get dst, src pointers
-    uint8_t * const dst = (uint8_t*) mem->buf.ptr + dst_ofs;
-    const uint8_t * const src = frame.mod->mod->bytes + segment.data.ofs;
+static void
+pwasm_v128_i32x4_min_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    // copy data
-    memcpy(dst, src, segment.data.len);
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const uint32_t av = a.i32[j];
+    const uint32_t bv = b.i32[j];
+    c.i32[j] = MIN(av, bv);
   }
 
-  // return success
-  return true;
+  *dst = c;
 }
 
-static bool
-pwasm_new_interp_init_start(
-  pwasm_new_interp_frame_t frame
+static void
+pwasm_v128_i32x4_max_s(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  (void) frame;
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // check for start function
-  if (!frame.mod->mod->has_start) {
-    // return success
-    return true;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const int32_t av = a.i32[j];
+    const int32_t bv = b.i32[j];
+    c.i32[j] = MAX(av, bv);
   }
 
-  // get start function ID in mod, map to interpreter func ID
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
-  const uint32_t start = frame.mod->mod->start;
-  const uint32_t func_id = u32s[frame.mod->funcs.ofs + start] + 1;
-
-  // call start function, return result
-  return pwasm_new_interp_call(frame.env, func_id);
+  *dst = c;
 }
 
-static uint32_t
-pwasm_new_interp_add_mod(
-  pwasm_env_t * const env,
-  const char * const name,
-  const pwasm_mod_t * const mod
+static void
+pwasm_v128_i32x4_max_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const size_t mod_ofs = pwasm_vec_get_size(&(interp->mods));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add mod funcs, check for error
-  pwasm_slice_t funcs;
-  if (!pwasm_new_interp_add_mod_funcs(env, mod_ofs, mod, &funcs)) {
-    // return failure
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    const uint32_t av = a.i32[j];
+    const uint32_t bv = b.i32[j];
+    c.i32[j] = MAX(av, bv);
   }
 
-  // add mod globals, check for error
-  pwasm_slice_t globals;
-  if (!pwasm_new_interp_add_mod_globals(env, mod_ofs, mod, &globals)) {
-    // return failure
-    return 0;
-  }
+  *dst = c;
+}
 
-  // add mod mems, check for error
-  pwasm_slice_t mems;
-  if (!pwasm_new_interp_add_mod_mems(env, mod_ofs, mod, &mems)) {
-    // return failure
-    return 0;
-  }
+static void
+pwasm_v128_i64x2_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // add mod tables, check for error
-  pwasm_slice_t tables;
-  if (!pwasm_new_interp_add_mod_tables(env, mod_ofs, mod, &tables)) {
-    // return failure
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.i64[j] = a.i64[j] + b.i64[j];
   }
 
-  // build mod instance
-  pwasm_new_interp_mod_t interp_mod = {
-    .type     = PWASM_NEW_INTERP_MOD_TYPE_MOD,
-    .name     = pwasm_buf_str(name),
-    .mod      = mod,
+  *dst = c;
+}
 
-    .funcs    = funcs,
-    .globals  = globals,
-    .mems     = mems,
-    .tables   = tables,
-  };
+static void
+pwasm_v128_i64x2_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // append mod, check for error
-  if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, NULL)) {
-    // log error, return failure
-    pwasm_env_fail(env, "append mod failed");
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.i64[j] = a.i64[j] - b.i64[j];
   }
 
-  // set up a temporary frame to init globals, tables, and mems
-  pwasm_new_interp_frame_t frame = {
-    .env = env,
-    .mod = &interp_mod,
-  };
+  *dst = c;
+}
 
-  // init globals, mems, tables, and start (in that order)
-  // source: https://webassembly.github.io/spec/core/exec/modules.html#exec-instantiation)
+static void
+pwasm_v128_f32x4_sqrt(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  (void) src_b;
 
-  // init globals, check for error
-  if (!pwasm_new_interp_init_globals(frame)) {
-    // return failure
-    return 0;
+  pwasm_v128_t b;
+  for (size_t j = 0; j < 4; j++) {
+    b.f32[j] = sqrtf(a.f32[j]);
   }
 
-  // init tables, check for error
-  if (!pwasm_new_interp_init_elems(frame)) {
-    // return failure
-    return 0;
-  }
+  *dst = b;
+}
 
-  // init segments, check for error
-  if (!pwasm_new_interp_init_segments(frame)) {
-    // return failure
-    return 0;
-  }
+static void
+pwasm_v128_f32x4_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // call start func, check for error
-  if (!pwasm_new_interp_init_start(frame)) {
-    // return failure
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.f32[j] = a.f32[j] + b.f32[j];
   }
 
-  // return success, convert offset to ID by adding 1
-  return mod_ofs + 1;
+  *dst = c;
 }
 
-static const pwasm_mod_t *
-pwasm_new_interp_get_mod(
-  pwasm_env_t * const env,
-  const uint32_t mod_id
+static void
+pwasm_v128_f32x4_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
-  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  const bool ok = (mod_id && mod_id <= num_rows);
-  return ok ? rows[mod_id - 1].mod : NULL;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.f32[j] = a.f32[j] - b.f32[j];
+  }
+
+  *dst = c;
 }
 
-static const pwasm_buf_t *
-pwasm_new_interp_get_mod_name(
-  pwasm_env_t * const env,
-  const uint32_t mod_id
+static void
+pwasm_v128_f32x4_mul(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
-  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  const bool ok = (mod_id && mod_id <= num_rows);
-  return ok ? &(rows[mod_id - 1].name) : NULL;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.f32[j] = a.f32[j] * b.f32[j];
+  }
+
+  *dst = c;
 }
 
-static uint32_t
-pwasm_new_interp_find_mod(
-  pwasm_env_t * const env,
-  const pwasm_buf_t name
+static void
+pwasm_v128_f32x4_div(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
-  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  for (size_t i = 0; i < num_rows; i++) {
-    if (
-      (rows[i].name.len == name.len) &&
-      !memcmp(name.ptr, rows[i].name.ptr, name.len)
-    ) {
-      // return offset + 1 (prevent zero IDs)
-      return i + 1;
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 4; j++) {
+    c.f32[j] = a.f32[j] / b.f32[j];
   }
 
-  // log error, return failure
-  pwasm_env_fail(env, "module not found");
-  return 0;
+  *dst = c;
 }
 
-static uint32_t
-pwasm_new_interp_find_func(
-  pwasm_env_t * const env,
-  const uint32_t mod_id,
-  const pwasm_buf_t name
+static void
+pwasm_v128_f64x2_sqrt(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_vec_t * const vec = &(interp->mods);
-  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(vec);
-  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const pwasm_v128_t a = *src_a;
+  (void) src_b;
 
-  // check mod_id
-  if (mod_id > pwasm_vec_get_size(&(interp->mods))) {
-    pwasm_env_fail(env, "invalid mod ID");
-    return 0;
+  pwasm_v128_t b;
+  for (size_t j = 0; j < 2; j++) {
+    b.f64[j] = sqrt(a.f64[j]);
   }
 
-  // get mod
-  const pwasm_new_interp_mod_t mod = mods[mod_id - 1];
+  *dst = b;
+}
 
-  switch (mod.type) {
-  case PWASM_NEW_INTERP_MOD_TYPE_MOD:
-    for (size_t i = 0; i < mod.mod->num_exports; i++) {
-      const pwasm_export_t row = mod.mod->exports[i];
+static void
+pwasm_v128_f64x2_add(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-      if (
-        (row.type == PWASM_IMPORT_TYPE_FUNC) &&
-        (row.name.len == name.len) &&
-        !memcmp(mod.mod->bytes + row.name.ofs, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod.funcs.ofs + row.id] + 1;
-      }
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.f64[j] = a.f64[j] + b.f64[j];
+  }
 
-    break;
-  case PWASM_NEW_INTERP_MOD_TYPE_NATIVE:
-    for (size_t i = 0; i < mod.native->num_funcs; i++) {
-      const pwasm_native_func_t row = mod.native->funcs[i];
-      const pwasm_buf_t row_buf = pwasm_buf_str(row.name);
+  *dst = c;
+}
 
-      if (
-        row_buf.ptr &&
-        (row_buf.len == name.len) &&
-        !memcmp(row_buf.ptr, name.ptr, name.len)
-      ) {
-        D("u32s = %p, mod->funcs.ofs = %zu, i = %zu", (void*) u32s, mod.funcs.ofs, i);
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod.funcs.ofs + i] + 1;
-      }
-    }
+static void
+pwasm_v128_f64x2_sub(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    break;
-  default:
-    // log error, return failure
-    pwasm_env_fail(env, "unknown module type (bug?)");
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.f64[j] = a.f64[j] - b.f64[j];
   }
 
-  // log error, return failure
-  pwasm_env_fail(env, "function not found");
-  return 0;
+  *dst = c;
 }
 
-static uint32_t
-pwasm_new_interp_find_mem(
-  pwasm_env_t * const env,
-  const uint32_t mod_id,
-  const pwasm_buf_t name
+static void
+pwasm_v128_f64x2_mul(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_vec_t * const vec = &(interp->mods);
-  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(vec);
-  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // check mod_id
-  if (mod_id > pwasm_vec_get_size(&(interp->mods))) {
-    pwasm_env_fail(env, "invalid mod ID");
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.f64[j] = a.f64[j] * b.f64[j];
   }
 
-  // get mod
-  const pwasm_new_interp_mod_t * const mod = mods + (mod_id - 1);
+  *dst = c;
+}
 
-  switch (mod->type) {
-  case PWASM_NEW_INTERP_MOD_TYPE_MOD:
-    for (size_t i = 0; i < mod->mod->num_exports; i++) {
-      const pwasm_export_t row = mod->mod->exports[i];
+static void
+pwasm_v128_f64x2_div(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-      if (
-        (row.type == PWASM_IMPORT_TYPE_MEM) &&
-        (row.name.len == name.len) &&
-        !memcmp(mod->mod->bytes + row.name.ofs, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod->mems.ofs + row.id] + 1;
-      }
-    }
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 2; j++) {
+    c.f64[j] = a.f64[j] / b.f64[j];
+  }
 
-    break;
-  case PWASM_NEW_INTERP_MOD_TYPE_NATIVE:
-    for (size_t i = 0; i < mod->native->num_funcs; i++) {
-      const pwasm_native_mem_t row = mod->native->mems[i];
-      const pwasm_buf_t row_buf = pwasm_buf_str(row.name);
+  *dst = c;
+}
 
-      if (
-        row_buf.ptr &&
-        (row_buf.len == name.len) &&
-        !memcmp(row_buf.ptr, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod->mems.ofs + i] + 1;
-      }
-    }
+static void
+pwasm_v128_i8x16_avgr_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-    break;
-  default:
-    // log error, return failure
-    pwasm_env_fail(env, "unknown module type (bug?)");
-    return 0;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 16; j++) {
+    const uint8_t av = a.i8[j];
+    const uint8_t bv = b.i8[j];
+    c.i8[j] = (av + bv + 1) / 2;
   }
 
-  // log error, return failure
-  pwasm_env_fail(env, "memory not found");
-  return 0;
+  *dst = c;
 }
 
-static pwasm_env_mem_t *
-pwasm_new_interp_get_mem(
-  pwasm_env_t * const env,
-  const uint32_t mem_id
+static void
+pwasm_v128_i16x8_avgr_u(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_env_mem_t *rows = pwasm_vec_get_data(&(interp->mems));
-  const size_t num_rows = pwasm_vec_get_size(&(interp->mems));
-  D("num mems: %zu", num_rows);
+  const pwasm_v128_t a = *src_a;
+  const pwasm_v128_t b = *src_b;
 
-  // check that mem_id is in bounds
-  if (!mem_id || mem_id > num_rows) {
-    // log error, return failure
-    D("bad mem_id: %u", mem_id);
-    pwasm_env_fail(env, "memory index out of bounds");
-    return NULL;
+  pwasm_v128_t c;
+  for (size_t j = 0; j < 8; j++) {
+    const uint16_t av = a.i16[j];
+    const uint16_t bv = b.i16[j];
+    c.i16[j] = (av + bv + 1) / 2;
   }
 
-  // return pointer to memory
-  return (pwasm_env_mem_t*) rows + (mem_id - 1);
+  *dst = c;
 }
 
-/*
- * Get the absolute memory offset from the immediate offset and the
- * offset operand.
- */
-static bool
-pwasm_new_interp_get_mem_chunk(
-  pwasm_env_t * const env,
-  const uint32_t mem_id,
-  const pwasm_inst_t in,
-  const uint32_t arg_ofs,
-  pwasm_new_interp_mem_chunk_t * const ret
+static void
+pwasm_v128_i8x16_abs(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
-  size_t ofs = in.v_mem.offset + arg_ofs;
-  size_t size = pwasm_op_get_num_bytes(in.op);
-  const bool ok = mem && size && (ofs + size < mem->buf.len);
-
-  if (!ok) {
-    // dissect error
-    if (!mem) {
-      D("mem_id = %u", mem_id);
-      pwasm_env_fail(env, "invalid memory index");
-    } else if (!size) {
-      D("op = %s", pwasm_op_get_name(in.op));
-      pwasm_env_fail(env, "invalid memory instruction");
-    } else {
-      D("ofs = %zu, size = %zu", ofs, size);
-      pwasm_env_fail(env, "invalid memory address");
-    }
+  const pwasm_v128_t a = *src_a;
+  (void) src_b;
 
-    // return failure
-    return false;
+  pwasm_v128_t b;
+  for (size_t j = 0; j < 16; j++) {
+    const int8_t v = a.i8[j];
+    b.i8[j] = (v < 0) ? -v : v;
   }
 
-  const pwasm_new_interp_mem_chunk_t tmp = {
-    .mem  = mem,
-    .ofs  = ofs,
-    .size = size,
-  };
-
-  // populate result
-  memcpy(ret, &tmp, sizeof(pwasm_new_interp_mem_chunk_t));
-
-  // return success
-  return true;
+  *dst = b;
 }
 
-static bool
-pwasm_new_interp_mem_load(
-  pwasm_env_t * const env,
-  const uint32_t mem_id,
-  const pwasm_inst_t in,
-  const uint32_t arg_ofs,
-  pwasm_val_t * const ret_val
+static void
+pwasm_v128_i16x8_abs(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
 ) {
-  // get memory chunk, check for error
-  pwasm_new_interp_mem_chunk_t chunk;
-  if (!pwasm_new_interp_get_mem_chunk(env, mem_id, in, arg_ofs, &chunk)) {
-    return false;
+  const pwasm_v128_t a = *src_a;
+  (void) src_b;
+
+  pwasm_v128_t b;
+  for (size_t j = 0; j < 8; j++) {
+    const int16_t v = a.i16[j];
+    b.i16[j] = (v < 0) ? -v : v;
   }
 
-  // pwasm_new_interp_dump_mem_chunk(chunk);
-  // D("load i32 = %u", ((pwasm_val_t*) (chunk.mem->buf.ptr + chunk.ofs))->i32);
+  *dst = b;
+}
 
-  // clear temp val
-  pwasm_val_t tmp;
-  memset(&tmp, 0, sizeof(pwasm_val_t));
+static void
+pwasm_v128_i32x4_abs(
+  pwasm_v128_t * const dst,
+  const pwasm_v128_t * const src_a,
+  const pwasm_v128_t * const src_b
+) {
+  const pwasm_v128_t a = *src_a;
+  (void) src_b;
+
+  pwasm_v128_t b;
+  for (size_t j = 0; j < 4; j++) {
+    const int32_t v = a.i32[j];
+    b.i32[j] = (v < 0) ? -v : v;
+  }
+
+  *dst = b;
+}
+
+#ifdef __SSE2__
+#define PWASM_V128_SSE2_KERNELS \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_ADD, i8x16_add, _mm_add_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_ADD_SATURATE_S, i8x16_add_saturate_s, _mm_adds_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_ADD_SATURATE_U, i8x16_add_saturate_u, _mm_adds_epu8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_SUB, i8x16_sub, _mm_sub_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_SUB_SATURATE_S, i8x16_sub_saturate_s, _mm_subs_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_SUB_SATURATE_U, i8x16_sub_saturate_u, _mm_subs_epu8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_MIN_U, i8x16_min_u, _mm_min_epu8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_MAX_U, i8x16_max_u, _mm_max_epu8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_AVGR_U, i8x16_avgr_u, _mm_avg_epu8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_EQ, i8x16_eq, _mm_cmpeq_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_LT_S, i8x16_lt_s, _mm_cmplt_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_GT_S, i8x16_gt_s, _mm_cmpgt_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_ADD, i16x8_add, _mm_add_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_ADD_SATURATE_S, i16x8_add_saturate_s, _mm_adds_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_ADD_SATURATE_U, i16x8_add_saturate_u, _mm_adds_epu16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_SUB, i16x8_sub, _mm_sub_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_SUB_SATURATE_S, i16x8_sub_saturate_s, _mm_subs_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_SUB_SATURATE_U, i16x8_sub_saturate_u, _mm_subs_epu16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_MUL, i16x8_mul, _mm_mullo_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_MIN_S, i16x8_min_s, _mm_min_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_MAX_S, i16x8_max_s, _mm_max_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_AVGR_U, i16x8_avgr_u, _mm_avg_epu16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_EQ, i16x8_eq, _mm_cmpeq_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_LT_S, i16x8_lt_s, _mm_cmplt_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_GT_S, i16x8_gt_s, _mm_cmpgt_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_ADD, i32x4_add, _mm_add_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_SUB, i32x4_sub, _mm_sub_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_EQ, i32x4_eq, _mm_cmpeq_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_LT_S, i32x4_lt_s, _mm_cmplt_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_GT_S, i32x4_gt_s, _mm_cmpgt_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I64X2_ADD, i64x2_add, _mm_add_epi64) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I64X2_SUB, i64x2_sub, _mm_sub_epi64) \
+  PWASM_V128_SSE_KERNEL(F32_BINOP, F32X4_ADD, f32x4_add, _mm_add_ps) \
+  PWASM_V128_SSE_KERNEL(F32_BINOP, F32X4_SUB, f32x4_sub, _mm_sub_ps) \
+  PWASM_V128_SSE_KERNEL(F32_BINOP, F32X4_MUL, f32x4_mul, _mm_mul_ps) \
+  PWASM_V128_SSE_KERNEL(F32_BINOP, F32X4_DIV, f32x4_div, _mm_div_ps) \
+  PWASM_V128_SSE_KERNEL(F32_UNOP, F32X4_SQRT, f32x4_sqrt, _mm_sqrt_ps) \
+  PWASM_V128_SSE_KERNEL(F64_BINOP, F64X2_ADD, f64x2_add, _mm_add_pd) \
+  PWASM_V128_SSE_KERNEL(F64_BINOP, F64X2_SUB, f64x2_sub, _mm_sub_pd) \
+  PWASM_V128_SSE_KERNEL(F64_BINOP, F64X2_MUL, f64x2_mul, _mm_mul_pd) \
+  PWASM_V128_SSE_KERNEL(F64_BINOP, F64X2_DIV, f64x2_div, _mm_div_pd) \
+  PWASM_V128_SSE_KERNEL(F64_UNOP, F64X2_SQRT, f64x2_sqrt, _mm_sqrt_pd)
+
+#define PWASM_V128_SSSE3_KERNELS \
+  PWASM_V128_SSE_KERNEL(INT_UNOP, I8X16_ABS, i8x16_abs, _mm_abs_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_UNOP, I16X8_ABS, i16x8_abs, _mm_abs_epi16) \
+  PWASM_V128_SSE_KERNEL(INT_UNOP, I32X4_ABS, i32x4_abs, _mm_abs_epi32)
+
+#define PWASM_V128_SSE41_KERNELS \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_MIN_S, i8x16_min_s, _mm_min_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I8X16_MAX_S, i8x16_max_s, _mm_max_epi8) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_MIN_U, i16x8_min_u, _mm_min_epu16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I16X8_MAX_U, i16x8_max_u, _mm_max_epu16) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_MUL, i32x4_mul, _mm_mullo_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_MIN_S, i32x4_min_s, _mm_min_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_MIN_U, i32x4_min_u, _mm_min_epu32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_MAX_S, i32x4_max_s, _mm_max_epi32) \
+  PWASM_V128_SSE_KERNEL(INT_BINOP, I32X4_MAX_U, i32x4_max_u, _mm_max_epu32)
+
+// define sse kernel pwasm_v128_sse_<name>() which applies intrinsic FN
+// to integer, f32, or f64 lanes, with the given target attribute
+#define PWASM_V128_SSE_DEF_INT_BINOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    const __m128i va = _mm_loadu_si128((const __m128i*) a); \
+    const __m128i vb = _mm_loadu_si128((const __m128i*) b); \
+    _mm_storeu_si128((__m128i*) dst, FN(va, vb)); \
+  }
 
-  // copy to temp
-  memcpy(&tmp, chunk.mem->buf.ptr + chunk.ofs, chunk.size);
+#define PWASM_V128_SSE_DEF_INT_UNOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    (void) b; \
+    const __m128i va = _mm_loadu_si128((const __m128i*) a); \
+    _mm_storeu_si128((__m128i*) dst, FN(va)); \
+  }
 
-  // copy temp to destination
-  memcpy(ret_val, &tmp, sizeof(pwasm_val_t));
+#define PWASM_V128_SSE_DEF_F32_BINOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    const __m128 va = _mm_loadu_ps(a->f32); \
+    const __m128 vb = _mm_loadu_ps(b->f32); \
+    _mm_storeu_ps(dst->f32, FN(va, vb)); \
+  }
 
-  // return success
-  return true;
-}
+#define PWASM_V128_SSE_DEF_F32_UNOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    (void) b; \
+    _mm_storeu_ps(dst->f32, FN(_mm_loadu_ps(a->f32))); \
+  }
 
-static bool
-pwasm_new_interp_mem_store(
-  pwasm_env_t * const env,
-  const uint32_t mem_id,
-  const pwasm_inst_t in,
-  const uint32_t arg_ofs,
-  const pwasm_val_t val
-) {
-  // get memory chunk, check for error
-  pwasm_new_interp_mem_chunk_t chunk;
-  if (!pwasm_new_interp_get_mem_chunk(env, mem_id, in, arg_ofs, &chunk)) {
-    return false;
+#define PWASM_V128_SSE_DEF_F64_BINOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    const __m128d va = _mm_loadu_pd(a->f64); \
+    const __m128d vb = _mm_loadu_pd(b->f64); \
+    _mm_storeu_pd(dst->f64, FN(va, vb)); \
   }
 
-  // pwasm_new_interp_dump_mem_chunk(chunk);
-  // D("chunk.size = %zu", chunk.size);
+#define PWASM_V128_SSE_DEF_F64_UNOP(name, FN, TARGET) \
+  __attribute__((target(TARGET))) static void \
+  pwasm_v128_sse_ ## name( \
+    pwasm_v128_t * const dst, \
+    const pwasm_v128_t * const a, \
+    const pwasm_v128_t * const b \
+  ) { \
+    (void) b; \
+    _mm_storeu_pd(dst->f64, FN(_mm_loadu_pd(a->f64))); \
+  }
 
-  // copy to result
-  memcpy((uint8_t*) chunk.mem->buf.ptr + chunk.ofs, &val, chunk.size);
+#define PWASM_V128_SSE_KERNEL(TYPE, NAME, name, FN) \
+  PWASM_V128_SSE_DEF_ ## TYPE(name, FN, "sse2")
+PWASM_V128_SSE2_KERNELS
+#undef PWASM_V128_SSE_KERNEL
 
-  // return success
-  return true;
-}
+#define PWASM_V128_SSE_KERNEL(TYPE, NAME, name, FN) \
+  PWASM_V128_SSE_DEF_ ## TYPE(name, FN, "ssse3")
+PWASM_V128_SSSE3_KERNELS
+#undef PWASM_V128_SSE_KERNEL
 
-static bool
-pwasm_new_interp_mem_size(
-  pwasm_env_t * const env,
-  const uint32_t mem_id,
-  uint32_t * const ret_val
+#define PWASM_V128_SSE_KERNEL(TYPE, NAME, name, FN) \
+  PWASM_V128_SSE_DEF_ ## TYPE(name, FN, "sse4.1")
+PWASM_V128_SSE41_KERNELS
+#undef PWASM_V128_SSE_KERNEL
+#endif /* __SSE2__ */
+
+/**
+ * Populate the v128 kernel table +dst+ with the fastest kernels
+ * supported by the CPU.
+ *
+ * Kernels which do not have a native version supported by the CPU use
+ * the portable version.
+ */
+static void
+pwasm_v128_kernels_init(
+  pwasm_v128_kernel_t * const dst
 ) {
-  // get memory, check for error
-  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
-  if (!mem) {
-    // return failure
-    return false;
-  }
+  // populate portable kernels
+#define PWASM_V128_KERNEL(NAME, name) dst[PWASM_V128_KERNEL_ ## NAME] = pwasm_v128_ ## name;
+PWASM_V128_KERNELS
+#undef PWASM_V128_KERNEL
 
-  if (ret_val) {
-    // save result
-    *ret_val = mem->buf.len / PWASM_PAGE_SIZE;
+#ifdef __SSE2__
+#define PWASM_V128_SSE_KERNEL(TYPE, NAME, name, FN) dst[PWASM_V128_KERNEL_ ## NAME] = pwasm_v128_sse_ ## name;
+  // sse2 is always available if the compiler targets it
+  PWASM_V128_SSE2_KERNELS
+
+  if (__builtin_cpu_supports("ssse3")) {
+    // use ssse3 kernels
+    PWASM_V128_SSSE3_KERNELS
   }
 
-  // return success
-  return true;
+  if (__builtin_cpu_supports("sse4.1")) {
+    // use sse4.1 kernels
+    PWASM_V128_SSE41_KERNELS
+  }
+#undef PWASM_V128_SSE_KERNEL
+#endif /* __SSE2__ */
 }
 
-static bool
-pwasm_new_interp_mem_grow(
-  pwasm_env_t * const env,
-  const uint32_t mem_id,
-  const uint32_t grow,
-  uint32_t * const ret_val
-) {
-  // get memory, check for error
-  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
-  if (!mem) {
-    // return failure (trap)
-    return false;
-  }
+//
+// new interpreter
+//
 
-  // get current size, in number of pages
-  const uint32_t old_size = mem->buf.len / PWASM_PAGE_SIZE;
-  const uint32_t new_size = old_size + grow;
+typedef enum {
+  PWASM_NEW_INTERP_MOD_TYPE_MOD,
+  PWASM_NEW_INTERP_MOD_TYPE_NATIVE,
+  PWASM_NEW_INTERP_MOD_TYPE_LAST,
+} pwasm_new_interp_mod_type_t;
 
-  // check upper bound
-  if (mem->limits.has_max && new_size > mem->limits.max) {
-    // at this point we save a -1 to the return value pointer to
-    // indicate failure, then return true from the function so that it
-    // doesn't trap.
-    //
-    // see https://webassembly.github.io/spec/core/exec/instructions.html#exec-memory-size
+// branch target used for branches which leave the function body
+#define PWASM_NEW_INTERP_CTRL_RETURN UINT32_MAX
 
-    if (ret_val) {
-      // return -1 to indicate failure
-      *ret_val = -1;
-    }
+// control metadata for an instruction, precomputed when a module is
+// added (see pwasm_new_interp_decode_mod())
+typedef struct {
+  // block, loop, if: number of block parameters
+  uint32_t num_params;
+
+  // block, loop, if: number of block results
+  // br, br_if: number of values carried by the branch
+  uint32_t num_results;
+
+  // br, br_if: offset (relative to the function body) of the loop
+  // instruction or end instruction that execution continues after, or
+  // PWASM_NEW_INTERP_CTRL_RETURN if the branch leaves the function
+  // br_table: offset (relative to the module) of the metadata for the
+  // first branch label (the label entries follow the instruction
+  // entries)
+  // if: offset (relative to the if) of the else or end instruction
+  // that execution continues after if the condition is false
+  // else: offset (relative to the else) of the end instruction
+  uint32_t target;
+
+  // block, loop, if: value stack height at the base of the block,
+  // relative to the end of the function locals
+  // br, br_if: value stack height at the base of the target block
+  uint32_t height;
+} pwasm_new_interp_ctrl_t;
 
-    // return "success"
-    return true;
-  }
+typedef struct {
+  // module name
+  pwasm_buf_t name;
 
-  if (new_size > 0) {
-    // get old pointer and number of bytes
-    void *old_ptr = (void*) mem->buf.ptr;
-    const size_t num_bytes = new_size * PWASM_PAGE_SIZE;
+  // module type (internal or native)
+  pwasm_new_interp_mod_type_t type;
 
-    // resize buffer, check for error
-    uint8_t * const ptr = pwasm_realloc(env->mem_ctx, old_ptr, num_bytes);
-    if (!ptr && num_bytes) {
-      // at this point we save a -1 to the return value pointer to
-      // indicate failure, then return true from the function so that it
-      // doesn't trap.
-      //
-      // see https://webassembly.github.io/spec/core/exec/instructions.html#exec-memory-size
+  // control metadata, indexed by instruction offset and followed by
+  // br_table label metadata (internal modules only)
+  pwasm_new_interp_ctrl_t *ctrls;
 
-      if (ret_val) {
-        // return -1 to indicate failure
-        *ret_val = -1;
-      }
+  // worst-case value stack usage of each function, indexed by code
+  // offset (internal modules only)
+  uint32_t *stack_sizes;
 
-      // return "success"
-      return true;
-    }
+  // array of buffers containing pointers to compiled functions, NULL
+  // until compiled (tiered JIT environments only, NULL otherwise)
+  pwasm_buf_t *fns;
 
-    // update buffer attributes
-    mem->buf.ptr = ptr;
-    mem->buf.len = num_bytes;
-  }
+  // array of direct call entry points of compiled functions
+  // (tiered JIT environments only, NULL otherwise)
+  void **calls;
 
-  if (ret_val) {
-    // update return value
-    *ret_val = old_size;
-  }
+  // array of call and loop counters for each function
+  // (tiered JIT environments only, NULL otherwise)
+  uint32_t *hits;
 
-  // return success
-  return true;
-}
+  // references to the u32s vector in the parent interpreter
+  pwasm_slice_t funcs;
+  pwasm_slice_t globals;
+  pwasm_slice_t mems;
+  pwasm_slice_t tables;
 
-static bool
-pwasm_new_interp_get_elem(
+  // reference to the u32s vector in the parent interpreter which maps
+  // module type indices to type IDs (internal modules only)
+  pwasm_slice_t types;
+
+  // export index
+  pwasm_exports_t exports;
+
+  union {
+    const pwasm_native_t * const native;
+    const pwasm_mod_t * const mod;
+  };
+} pwasm_new_interp_mod_t;
+
+typedef struct {
+  // mod offset in parent interpreter
+  uint32_t mod_ofs;
+
+  // func offset in parent mod
+  uint32_t func_ofs;
+
+  // function type ID (see pwasm_func_types_t)
+  uint32_t type_id;
+} pwasm_new_interp_func_t;
+
+typedef struct {
+  pwasm_env_mem_t * const mem; // memory pointer
+  const size_t ofs; // absolute offset, in bytes
+  const size_t size; // size, in bytes
+} pwasm_new_interp_mem_chunk_t;
+
+/*
+ * static void
+ * pwasm_new_interp_dump_mem_chunk(
+ *   const pwasm_new_interp_mem_chunk_t chunk
+ * ) {
+ *   D("{ .mem = %p, .ofs = %zu, .size = %zu }", (void*) chunk.mem, chunk.ofs, chunk.size);
+ * }
+ */
+
+typedef struct {
+  // mod offset in parent interpreter
+  uint32_t mod_ofs;
+
+  // table offset in parent mod
+  uint32_t table_ofs;
+
+  // limits from initial mod
+  const pwasm_limits_t limits;
+
+  // vec of u32 values
+  uint32_t *vals;
+
+  // array of u64s indicating set elements
+  uint64_t *masks;
+
+  // array of function type IDs, or 0 for elements which are not set
+  // (used by call_indirect to check bounds and type in one step)
+  uint32_t *types;
+
+  // maximum number of elements
+  size_t max_vals;
+} pwasm_new_interp_table_t;
+
+static pwasm_new_interp_table_t
+pwasm_new_interp_table_init(
   pwasm_env_t * const env,
-  const uint32_t table_id,
-  const uint32_t elem_ofs,
-  uint32_t * const ret_val
+  const uint32_t mod_ofs,
+  const uint32_t table_ofs,
+  pwasm_limits_t limits
 ) {
-  pwasm_new_interp_table_t * const table = pwasm_new_interp_get_table(env, table_id);
-  if (!table) {
-    return false;
-  }
-  return pwasm_new_interp_table_get_elem(env, table, elem_ofs, ret_val);
+  (void) env;
+  return (pwasm_new_interp_table_t) {
+    .mod_ofs    = mod_ofs,
+    .table_ofs  = table_ofs,
+    .limits     = limits,
+    .vals       = NULL,
+    .masks      = NULL,
+    .types      = NULL,
+    .max_vals   = 0,
+  };
 }
 
-static uint32_t
-pwasm_new_interp_find_import(
+static void
+pwasm_new_interp_table_fini(
   pwasm_env_t * const env,
-  const uint32_t mod_id,
-  const pwasm_import_type_t type,
-  const pwasm_buf_t name
+  pwasm_new_interp_table_t * const table
 ) {
-  switch (type) {
-  case PWASM_IMPORT_TYPE_FUNC:
-    return pwasm_env_find_func(env, mod_id, name);
-  case PWASM_IMPORT_TYPE_MEM:
-    return pwasm_env_find_mem(env, mod_id, name);
-  case PWASM_IMPORT_TYPE_GLOBAL:
-    return pwasm_env_find_global(env, mod_id, name);
-  case PWASM_IMPORT_TYPE_TABLE:
-    return pwasm_env_find_table(env, mod_id, name);
-  default:
-    // log error, return failure
-    pwasm_env_fail(env, "invalid import type");
-    return 0;
+  if (!table->max_vals) {
+    return;
+  }
+
+  if (table->max_vals > 0) {
+    // free memory, masks, and types
+    pwasm_realloc(env->mem_ctx, table->vals, 0);
+    pwasm_realloc(env->mem_ctx, table->masks, 0);
+    pwasm_realloc(env->mem_ctx, table->types, 0);
+    table->vals = NULL;
+    table->masks = NULL;
+    table->types = NULL;
+    table->max_vals = 0;
   }
 }
 
-static inline bool
-pwasm_new_interp_check_global(
+static bool
+pwasm_new_interp_table_grow(
   pwasm_env_t * const env,
-  const uint32_t id
+  pwasm_new_interp_table_t * const table,
+  const size_t src_new_len
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const size_t num_rows = pwasm_vec_get_size(&(interp->globals));
+  // check existing capacity
+  if (src_new_len <= table->max_vals) {
+    return true;
+  }
 
-  if (!id || id > num_rows) {
-    // log error, return failure
-    D("global index = %u", id);
-    pwasm_env_fail(env, "global index out of bounds");
+  // clamp to minimum size
+  const size_t new_len = (table->limits.min > src_new_len) ? table->limits.min : src_new_len;
+
+  // check table maximum limit
+  if (table->limits.has_max && src_new_len > table->limits.max) {
+    D("src_new_len = %zu, max = %u", src_new_len, table->limits.max);
+    pwasm_env_fail(env, "length greater than table limit");
+    return false;
+  }
+
+  // reallocate vals, check for error
+  uint32_t *tmp_vals = pwasm_realloc(env->mem_ctx, table->vals, new_len * sizeof(uint32_t));
+  if (!tmp_vals && new_len > 0) {
+    pwasm_env_fail(env, "vals pwasm_realloc() failed");
+    return false;
+  }
+
+  // reallocate masks, check for error
+  const size_t new_num_masks = (new_len / 64) + ((new_len & 0x3F) ? 1 : 0);
+  uint64_t *tmp_masks = pwasm_realloc(env->mem_ctx, table->masks, new_num_masks * sizeof(uint64_t));
+  if (!tmp_vals && new_len > 0) {
+    pwasm_env_fail(env, "masks pwasm_realloc() failed");
+    return false;
+  }
+
+  // clear masks
+  for (size_t i = table->max_vals; i < new_len; i++) {
+    tmp_masks[i >> 6] &= ~(((uint64_t) 1) << (i & 0x3F));
+  }
+
+  // update vals and masks
+  table->vals = tmp_vals;
+  table->masks = tmp_masks;
+
+  // reallocate types, check for error
+  uint32_t *tmp_types = pwasm_realloc(env->mem_ctx, table->types, new_len * sizeof(uint32_t));
+  if (!tmp_types && new_len > 0) {
+    pwasm_env_fail(env, "types pwasm_realloc() failed");
     return false;
   }
 
+  // clear types
+  memset(tmp_types + table->max_vals, 0, (new_len - table->max_vals) * sizeof(uint32_t));
+
+  // update types and max_len
+  table->types = tmp_types;
+  table->max_vals = new_len;
+
   // return success
   return true;
 }
 
+/**
+ * Set +num_vals+ elements of a table, starting at element +ofs+, to
+ * the function offsets in +vals+.  The element types are read from the
+ * functions in +funcs+.
+ */
 static bool
-pwasm_new_interp_get_global(
+pwasm_new_interp_table_set(
   pwasm_env_t * const env,
-  const uint32_t id,
-  pwasm_val_t * const ret_val
+  pwasm_new_interp_table_t * const table,
+  const pwasm_new_interp_func_t * const funcs,
+  const size_t ofs,
+  const uint32_t * const vals,
+  const size_t num_vals
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_env_global_t *rows = pwasm_vec_get_data(&(interp->globals));
-
-  if (!pwasm_new_interp_check_global(env, id)) {
+  if (!pwasm_new_interp_table_grow(env, table, ofs + num_vals)) {
+    // return failure
     return false;
   }
 
-  if (ret_val) {
-    // copy value to destination
-    *ret_val = rows[id - 1].val;
+  // copy values
+  memcpy(table->vals + ofs, vals, num_vals * sizeof(uint32_t));
+
+  // set masks and types
+  for (size_t i = ofs; i < ofs + num_vals; i++) {
+    table->masks[i >> 6] |= ((uint64_t) 1) << (i & 0x3F);
+    table->types[i] = funcs[table->vals[i]].type_id;
   }
 
   // return success
   return true;
 }
 
+/**
+ * Rebuild the type IDs of the elements of a table from the table
+ * values and masks and the functions in +funcs+ (e.g., after the
+ * values and masks were restored from a snapshot).
+ *
+ * Returns false on error.
+ */
 static bool
-pwasm_new_interp_set_global(
+pwasm_new_interp_table_sync_types(
   pwasm_env_t * const env,
-  const uint32_t id,
-  const pwasm_val_t val
+  pwasm_new_interp_table_t * const table,
+  const pwasm_new_interp_func_t * const funcs
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  pwasm_env_global_t *rows = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
-
-  if (!pwasm_new_interp_check_global(env, id)) {
+  // resize types, check for error
+  uint32_t * const types = pwasm_realloc(env->mem_ctx, table->types, table->max_vals * sizeof(uint32_t));
+  if (!types && table->max_vals > 0) {
+    pwasm_env_fail(env, "types pwasm_realloc() failed");
     return false;
   }
+  table->types = types;
 
-  if (!rows[id - 1].type.mutable) {
-    pwasm_env_fail(env, "write to immutable global");
-    return false;
+  // populate types
+  for (size_t i = 0; i < table->max_vals; i++) {
+    const bool set = table->masks[i >> 6] & ((uint64_t) 1) << (i & 0x3F);
+    types[i] = set ? funcs[table->vals[i]].type_id : 0;
   }
 
-  // set global value
-  rows[id - 1].val = val;
-
   // return success
   return true;
 }
 
-/*
- * Convert an internal global ID to an externally visible global handle.
+/**
+ * Get element (u32) from table.
  *
- * Returns 0 on error.
+ * At the moment the only supported types are function references, so
+ * this returns a u32 offset into the interpreters funcs table.
  */
-static uint32_t
-pwasm_new_interp_mod_get_global_index(
+static bool
+pwasm_new_interp_table_get_elem(
   pwasm_env_t * const env,
-  pwasm_new_interp_mod_t * const mod,
-  uint32_t id
+  pwasm_new_interp_table_t * const table,
+  const size_t ofs,
+  uint32_t * const ret_val
 ) {
-  pwasm_new_interp_t * const interp = env->env_data;
-  const pwasm_vec_t * const vec = &(interp->u32s);
-  const uint32_t * const u32s = ((uint32_t*) pwasm_vec_get_data(vec)) + mod->globals.ofs;
-  return (id < mod->globals.len) ? u32s[id] + 1 : 0;
-}
+  // check element offset
+  if (ofs >= table->max_vals) {
+    D("ofs = %zu, table->max_vals = %zu", ofs, table->max_vals);
+    // log error, return failure
+    pwasm_env_fail(env, "table element offset out of bounds");
+    return false;
+  }
 
-// forward references
-static bool pwasm_new_interp_call_func(pwasm_env_t *, pwasm_new_interp_mod_t *, uint32_t);
-static bool pwasm_new_interp_call_indirect(pwasm_new_interp_frame_t, pwasm_inst_t, uint32_t);
+  // check element mask
+  const bool set = table->masks[ofs >> 6] & ((uint64_t) 1) << (ofs & 0x3F);
+  if (!set) {
+    // log error, return failure
+    pwasm_env_fail(env, "table element is not set");
+    return false;
+  }
 
-static bool
-pwasm_new_interp_eval_expr(
-  pwasm_new_interp_frame_t frame,
-  const pwasm_slice_t expr
-) {
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-  pwasm_ctrl_stack_t * const ctrl_stack = &(interp->ctrl_stack);
-  pwasm_stack_t * const stack = frame.env->stack;
-  const pwasm_inst_t * const insts = frame.mod->mod->insts + expr.ofs;
+  if (ret_val) {
+    // write value to destination
+    *ret_val = table->vals[ofs];
+  }
 
-  size_t ctrl_depth = 0;
+  // return success
+  return true;
+}
 
-  // D("expr = { .ofs = %zu, .len = %zu }, num_insts = %zu", expr.ofs, expr.len, frame.mod->num_insts);
+/**
+ * Memory which is backed by a reserved address range instead of a
+ * pwasm_realloc() buffer (see pwasm_new_interp_map_mem_image()).
+ */
+typedef struct {
+  // memory offset in parent interpreter
+  size_t mem_ofs;
 
-  for (size_t i = 0; i < expr.len; i++) {
-    const pwasm_inst_t in = insts[i];
-    // D("0x%02X %s", in.op, pwasm_op_get_name(in.op));
+  // size of reserved address range, in bytes
+  size_t size;
+} pwasm_new_interp_mem_map_t;
 
-    switch (in.op) {
-    case PWASM_OP_UNREACHABLE:
-      // FIXME: raise trap?
-      pwasm_env_fail(frame.env, "unreachable instruction reached");
-      return false;
-    case PWASM_OP_NOP:
-      // do nothing
-      break;
-    case PWASM_OP_BLOCK:
-      {
-        // get block.params.size, check for error
-        size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "block: get num block params failed");
-          return false;
-        }
+typedef struct {
+  pwasm_env_t *env;
+  pwasm_new_interp_mod_t *mod;
 
-        // create control stack entry
-        const pwasm_ctrl_stack_entry_t ctrl_entry = {
-          .type   = CTRL_BLOCK,
-          .depth  = stack->pos - num_params,
-          .ofs    = i,
-        };
+  // memory for this frame
+  uint32_t mem_id;
 
-        // push control stack entry, check for error
-        if (!pwasm_ctrl_stack_push(ctrl_stack, ctrl_entry)) {
-          pwasm_env_fail(frame.env, "block: ctrl_stack_push failed");
-          return false;
-        }
+  // function parameters
+  pwasm_slice_t params;
 
-        // increment control depth
-        ctrl_depth++;
-      }
+  // function results
+  pwasm_slice_t results;
 
-      break;
-    case PWASM_OP_LOOP:
-      {
-        // get block.params.size, check for error
-        size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "block: get num block params failed");
-          return false;
-        }
+  // offset and length of locals on the stack
+  // NOTE: the offset and length include function parameters
+  pwasm_slice_t locals;
 
-        // create control stack entry
-        const pwasm_ctrl_stack_entry_t ctrl_entry = {
-          .type   = CTRL_LOOP,
-          .depth  = stack->pos - num_params,
-          .ofs    = i,
-        };
+  // call and loop counter for this function
+  // (tiered JIT environments only, NULL otherwise)
+  uint32_t *hits;
+} pwasm_new_interp_frame_t;
 
-        // push control stack entry, check for error
-        if (!pwasm_ctrl_stack_push(ctrl_stack, ctrl_entry)) {
-          pwasm_env_fail(frame.env, "block: ctrl_stack_push failed");
-          return false;
-        }
+/**
+ * Entry in the interpreter call stack.
+ *
+ * Calls between interpreted functions do not recurse in C; instead
+ * pwasm_new_interp_eval_expr() pushes the state of the caller, switches
+ * to the callee, and pops the state of the caller when the callee
+ * returns.
+ *
+ * Calls which enter the interpreter from C (see
+ * pwasm_new_interp_call_func()) push an entry with a NULL frame mod,
+ * which is never resumed.
+ */
+typedef struct {
+  // caller frame
+  pwasm_new_interp_frame_t frame;
 
-        // increment control depth
-        ctrl_depth++;
-      }
+  // caller function body
+  pwasm_slice_t expr;
 
-      break;
-    case PWASM_OP_IF:
-      {
-        // pop last value from value stack
-        const uint32_t tail = stack->ptr[--stack->pos].i32;
+  // offset of call instruction in caller function body
+  size_t pc;
+} pwasm_new_interp_call_t;
 
-        // get else/end offset
-        const size_t else_ofs = in.v_block.else_ofs ? in.v_block.else_ofs : in.v_block.end_ofs;
+#define PWASM_NEW_INTERP_VECS \
+  PWASM_NEW_INTERP_VEC(u32s, uint32_t) \
+  PWASM_NEW_INTERP_VEC(mods, pwasm_new_interp_mod_t) \
+  PWASM_NEW_INTERP_VEC(funcs, pwasm_new_interp_func_t) \
+  PWASM_NEW_INTERP_VEC(globals, pwasm_env_global_t) \
+  PWASM_NEW_INTERP_VEC(mems, pwasm_env_mem_t) \
+  PWASM_NEW_INTERP_VEC(tables, pwasm_new_interp_table_t) \
+  PWASM_NEW_INTERP_VEC(maps, pwasm_new_interp_mem_map_t) \
+  PWASM_NEW_INTERP_VEC(calls, pwasm_new_interp_call_t)
 
-        // get block.params.size, check for error
-        size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "block: get num block params failed");
-          return false;
-        }
+typedef struct {
+  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) pwasm_vec_t NAME;
+  PWASM_NEW_INTERP_VECS
+  #undef PWASM_NEW_INTERP_VEC
 
-        // create control stack entry
-        const pwasm_ctrl_stack_entry_t ctrl_entry = {
-          .type   = CTRL_IF,
-          .depth  = stack->pos - num_params,
-          .ofs    = i,
-        };
+  // v128 kernels, selected at init time
+  pwasm_v128_kernel_t v128[PWASM_V128_KERNEL_LAST];
 
-        // push control stack entry, check for error
-        if (!pwasm_ctrl_stack_push(ctrl_stack, ctrl_entry)) {
-          pwasm_env_fail(frame.env, "block: ctrl_stack_push failed");
-          return false;
-        }
+  // function type registry
+  pwasm_func_types_t types;
 
-        // increment control depth
-        ctrl_depth++;
+  // maximum number of entries in the call stack
+  size_t max_depth;
+} pwasm_new_interp_t;
 
-        // increment instruction pointer
-        i += tail ? 0 : else_ofs;
-      }
+static bool
+pwasm_new_interp_init(
+  pwasm_env_t * const env
+) {
+  const size_t interp_size = sizeof(pwasm_new_interp_t);
+  pwasm_mem_ctx_t * const mem_ctx = env->mem_ctx;
 
-      break;
-    case PWASM_OP_ELSE:
-      // skip to end inst
-      i += insts[i].v_block.end_ofs - 1;
+  // allocate interpreter data store
+  pwasm_new_interp_t *interp = pwasm_realloc(mem_ctx, NULL, interp_size);
+  if (!interp) {
+    // log error, return failure
+    D("pwasm_realloc() failed (size = %zu)", interp_size);
+    pwasm_env_fail(env, "interpreter memory allocation failed");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_END:
-      if (ctrl_depth) {
-        // pop control stack, check for error
-        pwasm_ctrl_stack_entry_t ctrl_tail;
-        if (!pwasm_ctrl_stack_pop(ctrl_stack, &ctrl_tail)) {
-          pwasm_env_fail(frame.env, "end: ctrl_stack pop failed");
-          return false;
-        }
+  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) \
+    /* allocate vector, check for error */ \
+    if (!pwasm_vec_init(mem_ctx, &(interp->NAME), sizeof(TYPE))) { \
+      /* log error, return failure */ \
+      D("pwasm_vec_init() failed (stride = %zu)", sizeof(TYPE)); \
+      pwasm_env_fail(env, "interpreter " #NAME " vector init failed"); \
+      return false; \
+    }
+  PWASM_NEW_INTERP_VECS
+  #undef PWASM_NEW_INTERP_VEC
 
-        // decriment control stack depth
-        ctrl_depth--;
+  // select v128 kernels
+  pwasm_v128_kernels_init(interp->v128);
 
-        // get mod, block type
-        const pwasm_mod_t * const mod = frame.mod->mod;
-        const int32_t block_type = insts[ctrl_tail.ofs].v_block.block_type;
+  // get maximum call depth
+  interp->max_depth = pwasm_env_get_max_call_depth(env);
 
-        // get block type result count, check for error
-        size_t num_results;
-        if (!pwasm_block_type_results_get_size(mod, block_type, &num_results)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "end: get block num_results failed");
-          return false;
-        }
+  // init function type registry, check for error
+  if (!pwasm_func_types_init(&(interp->types), mem_ctx)) {
+    // log error, return failure
+    pwasm_env_fail(env, "interpreter function type registry init failed");
+    return false;
+  }
 
-        // pop results
-        for (size_t j = 0; j < num_results; j++) {
-          // calculate stack source and destination offsets
-          const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-          const size_t dst_ofs = ctrl_tail.depth + j;
-          stack->ptr[dst_ofs] = stack->ptr[src_ofs];
-        }
+  // save interpreter, return success
+  env->env_data = interp;
+  return true;
+}
 
-        // reset value stack
-        stack->pos = ctrl_tail.depth + num_results;
-      } else {
-        // return success
-        // FIXME: is this correct?
-        return true;
-      }
+static void
+pwasm_new_interp_fini_tables(
+  pwasm_env_t * const env
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const vec = &(interp->tables);
+  pwasm_new_interp_table_t *rows = (pwasm_new_interp_table_t*) pwasm_vec_get_data(vec);
+  const size_t num_rows = pwasm_vec_get_size(vec);
 
-      break;
-    case PWASM_OP_BR:
-      {
-        // pop control stack, check for error
-        if (!pwasm_ctrl_stack_popn(ctrl_stack, in.v_index)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "br: ctrl_stack_popn failed");
-          return false;
-        }
+  for (size_t i = 0; i < num_rows; i++) {
+    pwasm_new_interp_table_fini(env, rows + i);
+  }
+}
 
-        // decriment control stack depth
-        ctrl_depth -= in.v_index;
-        if (!ctrl_depth) {
-          // return success
-          // FIXME: is this correct?
-          return true;
-        }
+static void
+pwasm_new_interp_fini_maps(
+  pwasm_env_t * const env
+) {
+#ifdef PWASM_HAVE_MEMFD
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_env_mem_t * const mems = pwasm_vec_get_data(&(interp->mems));
+  const pwasm_new_interp_mem_map_t * const rows = pwasm_vec_get_data(&(interp->maps));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->maps));
 
-        // get control stack tail, check for error
-        const pwasm_ctrl_stack_entry_t *ctrl_tail = pwasm_ctrl_stack_peek_tail(ctrl_stack, 0);
-        if (!ctrl_tail) {
-          pwasm_env_fail(frame.env, "br: ctrl_stack_peek_tail failed");
-          return false;
-        }
+  // release reserved address ranges
+  for (size_t i = 0; i < num_rows; i++) {
+    munmap((void*) mems[rows[i].mem_ofs].buf.ptr, rows[i].size);
+  }
+#else
+  (void) env;
+#endif /* PWASM_HAVE_MEMFD */
+}
 
-        if (ctrl_tail->type == CTRL_LOOP) {
-          // reset control stack
-          i = ctrl_tail->ofs;
-          stack->pos = ctrl_tail->depth;
-        } else {
-          // get mod, block type
-          const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
-
-          // get block type result count, check for error
-          size_t num_results;
-          if (!pwasm_block_type_results_get_size(mod, block_type, &num_results)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br: get block num_results failed");
-            return false;
-          }
-
-          // pop results
-          for (size_t j = 0; j < num_results; j++) {
-            // calculate stack source and destination offsets
-            const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
-            stack->ptr[dst_ofs] = stack->ptr[src_ofs];
-          }
-
-          // reset value stack
-          stack->pos = ctrl_tail->depth + num_results;
-
-          // pop control stack, check for error
-          if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br: ctrl_stack_pop failed");
-            return false;
-          }
+static void
+pwasm_new_interp_fini_mems(
+  pwasm_env_t * const env
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_jit_t * const jit = env->cbs->jit;
+  pwasm_env_mem_t *rows = (pwasm_env_mem_t*) pwasm_vec_get_data(&(interp->mems));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mems));
 
-          // decriment control stack depth
-          ctrl_depth--;
-        }
-      }
+  if (!jit || !jit->cbs || !jit->cbs->mem_resize) {
+    // memory was not allocated by jit compiler, return
+    return;
+  }
 
-      break;
-    case PWASM_OP_BR_IF:
-      if (stack->ptr[--stack->pos].i32) {
-        // pop control stack, check for error
-        if (!pwasm_ctrl_stack_popn(ctrl_stack, in.v_index)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "br_if: ctrl_stack_popn failed");
-          return false;
-        }
+  // release memory allocated by jit compiler (the jit compiler ignores
+  // memory which it did not allocate, such as native memory)
+  for (size_t i = 0; i < num_rows; i++) {
+    if (rows[i].buf.ptr) {
+      jit->cbs->mem_resize(jit, rows + i, 0);
+    }
+  }
+}
 
-        // decriment control stack depth
-        ctrl_depth -= in.v_index;
-        if (!ctrl_depth) {
-          // return success
-          // FIXME: is this correct?
-          return true;
-        }
+/**
+ * Free the compiled function list, direct call slots, and call and
+ * loop counters of a module in a tiered JIT environment.
+ */
+static void
+pwasm_new_interp_fini_jit(
+  pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_new_interp_mod_t * const interp_mod
+) {
+  if (interp_mod->fns) {
+    pwasm_realloc(mem_ctx, interp_mod->fns, 0);
+    interp_mod->fns = NULL;
+  }
 
-        // get control stack tail, check for error
-        const pwasm_ctrl_stack_entry_t *ctrl_tail = pwasm_ctrl_stack_peek_tail(ctrl_stack, 0);
-        if (!ctrl_tail) {
-          pwasm_env_fail(frame.env, "br_if: ctrl_stack_peek_tail failed");
-          return false;
-        }
+  if (interp_mod->calls) {
+    pwasm_realloc(mem_ctx, interp_mod->calls, 0);
+    interp_mod->calls = NULL;
+  }
 
-        if (ctrl_tail->type == CTRL_LOOP) {
-          i = ctrl_tail->ofs;
-          stack->pos = ctrl_tail->depth;
-        } else {
-          // get mod, block type
-          const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
+  if (interp_mod->hits) {
+    pwasm_realloc(mem_ctx, interp_mod->hits, 0);
+    interp_mod->hits = NULL;
+  }
+}
 
-          // get block type result count, check for error
-          size_t num_results;
-          if (!pwasm_block_type_results_get_size(mod, block_type, &num_results)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br_if: get block num_results failed");
-            return false;
-          }
+static void
+pwasm_new_interp_fini(
+  pwasm_env_t * const env
+) {
+  pwasm_mem_ctx_t * const mem_ctx = env->mem_ctx;
 
-          // pop results
-          for (size_t j = 0; j < num_results; j++) {
-            // calculate stack source and destination offsets
-            const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
-            stack->ptr[dst_ofs] = stack->ptr[src_ofs];
-          }
+  // get interpreter data
+  pwasm_new_interp_t *data = env->env_data;
+  if (!data) {
+    return;
+  }
 
-          // reset value stack
-          stack->pos = ctrl_tail->depth + num_results;
+  // finalize tables, mapped memories, and jit memories
+  pwasm_new_interp_fini_tables(env);
+  pwasm_new_interp_fini_maps(env);
+  pwasm_new_interp_fini_mems(env);
+
+  // free control metadata
+  pwasm_new_interp_mod_t * const mods = (pwasm_new_interp_mod_t*) pwasm_vec_get_data(&(data->mods));
+  const size_t num_mods = pwasm_vec_get_size(&(data->mods));
+  for (size_t i = 0; i < num_mods; i++) {
+    if (mods[i].ctrls) {
+      pwasm_realloc(mem_ctx, mods[i].ctrls, 0);
+    }
 
-          // pop control stack, check for error
-          if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br: ctrl_stack_pop failed");
-            return false;
-          }
+    // free stack sizes
+    if (mods[i].stack_sizes) {
+      pwasm_realloc(mem_ctx, mods[i].stack_sizes, 0);
+    }
 
-          // decriment control stack depth
-          ctrl_depth--;
-        }
-      }
+    // free compiled function list, call slots, and counters
+    pwasm_new_interp_fini_jit(mem_ctx, mods + i);
 
-      break;
-    case PWASM_OP_BR_TABLE:
-      {
-        // get value from stack, branch labels, label offset, and then index
-        const uint32_t val = stack->ptr[--stack->pos].i32;
-        const pwasm_slice_t labels = in.v_br_table;
-        const size_t labels_ofs = labels.ofs + MIN(val, labels.len - 1);
-        const uint32_t id = frame.mod->mod->u32s[labels_ofs];
+    // free export index
+    pwasm_exports_fini(&(mods[i].exports), mem_ctx);
+  }
 
-        // pop control stack, check for error
-        if (!pwasm_ctrl_stack_popn(ctrl_stack, id)) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "br_if: ctrl_stack_popn failed");
-          return false;
-        }
+  // free vectors
+  #define PWASM_NEW_INTERP_VEC(NAME, TYPE) pwasm_vec_fini(&(data->NAME));
+  PWASM_NEW_INTERP_VECS
+  #undef PWASM_NEW_INTERP_VEC
 
-        // decriment control stack depth
-        ctrl_depth -= id;
-        if (!ctrl_depth) {
-          // return success
-          // FIXME: is this correct?
-          return true;
-        }
+  // free function type registry
+  pwasm_func_types_fini(&(data->types));
 
-        // get control stack tail, check for error
-        const pwasm_ctrl_stack_entry_t *ctrl_tail = pwasm_ctrl_stack_peek_tail(ctrl_stack, 0);
-        if (!ctrl_tail) {
-          pwasm_env_fail(frame.env, "br_if: ctrl_stack_peek_tail failed");
-          return false;
-        }
+  // free backing data
+  pwasm_realloc(mem_ctx, data, 0);
+  env->env_data = NULL;
+}
 
-        if (ctrl_tail->type == CTRL_LOOP) {
-          i = ctrl_tail->ofs;
-          stack->pos = ctrl_tail->depth;
-        } else {
-          // skip past end inst
-          i += in.v_block.end_ofs + 1;
+/**
+ * Given an environment and a table handle, return a pointer to the
+ * table instance.
+ *
+ * Returns `NULL` if the table handle is invalid.
+ */
+static pwasm_new_interp_table_t *
+pwasm_new_interp_get_table(
+  pwasm_env_t * const env,
+  const uint32_t table_id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const vec = &(interp->tables);
+  const pwasm_new_interp_table_t * const rows = pwasm_vec_get_data(vec);
+  const size_t num_rows = pwasm_vec_get_size(vec);
 
-          // get mod, block type
-          const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
+  // check that table_id is in bounds
+  if (!table_id || table_id > num_rows) {
+    // log error, return failure
+    D("bad table_id: %u, num_rows = %zu", table_id, num_rows);
+    pwasm_env_fail(env, "interpreter table index out of bounds");
+    return NULL;
+  }
 
-          // get block type result count, check for error
-          size_t num_results;
-          if (!pwasm_block_type_results_get_size(mod, block_type, &num_results)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br_if: get block num_results failed");
-            return false;
-          }
+  // return pointer to table
+  return (pwasm_new_interp_table_t*) rows + (table_id - 1);
+}
 
-          // pop results
-          for (size_t j = 0; j < num_results; j++) {
-            // calculate stack source and destination offsets
-            const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
-            stack->ptr[dst_ofs] = stack->ptr[src_ofs];
-          }
+static bool
+pwasm_new_interp_push_u32s(
+  pwasm_env_t * const env,
+  const size_t ofs,
+  const size_t len
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const u32s = &(interp->u32s);
+  const pwasm_slice_t slice = { ofs, len };
 
-          // reset value stack
-          stack->pos = ctrl_tail->depth + num_results;
+  uint32_t ids[PWASM_BATCH_SIZE];
+  size_t num = 0;
 
-          // pop control stack, check for error
-          if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
-            // log error, return failure
-            pwasm_env_fail(frame.env, "br: ctrl_stack_pop failed");
-            return false;
-          }
+  for (size_t i = 0; i < slice.len; i++) {
+    ids[num++] = slice.ofs + i;
 
-          // decriment control stack depth
-          ctrl_depth--;
-        }
-      }
+    if (num == LEN(ids)) {
+      // clear count
+      num = 0;
 
-      break;
-    case PWASM_OP_RETURN:
-      // return success
-      // FIXME: is this correct?
-      return true;
-    case PWASM_OP_CALL:
-      // call function, check for error
-      if (!pwasm_new_interp_call_func(frame.env, frame.mod, in.v_index)) {
-        // return failure
+      // append results, check for error
+      if (!pwasm_vec_push(u32s, LEN(ids), ids, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append offsets failed");
         return false;
       }
+    }
+  }
 
-      break;
-    case PWASM_OP_CALL_INDIRECT:
-      {
-        // pop element index from value stack
-        const uint32_t elem_ofs = stack->ptr[--stack->pos].i32;
-
-        // call function, check for error
-        if (!pwasm_new_interp_call_indirect(frame, in, elem_ofs)) {
-          // return failure
-          return false;
-        }
-      }
+  if (num > 0) {
+    // append results, check for error
+    if (!pwasm_vec_push(u32s, num, ids, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining offsets failed");
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_DROP:
-      stack->pos--;
-
-      break;
-    case PWASM_OP_SELECT:
-      {
-        const size_t ofs = stack->ptr[stack->pos - 1].i32 ? 3 : 2;
-        stack->ptr[stack->pos - 3] = stack->ptr[stack->pos - ofs];
-        stack->pos -= 2;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_LOCAL_GET:
-      {
-        // get local index
-        // (note: checked in pwasm_checker_get_local_type())
-        const uint32_t id = in.v_index;
+static bool
+pwasm_new_interp_add_native_funcs(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_native_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->funcs);
+  const size_t dst_ofs = pwasm_vec_get_size(dst);
+  const size_t u32s_ofs = pwasm_vec_get_size(&(interp->u32s));
 
-        // push local value
-        stack->ptr[stack->pos++] = stack->ptr[frame.locals.ofs + id];
-      }
+  pwasm_new_interp_func_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
 
-      break;
-    case PWASM_OP_LOCAL_SET:
-      {
-        // get local index
-        // (note: checked in pwasm_checker_get_local_type())
-        const uint32_t id = in.v_index;
+  for (size_t i = 0; i < mod->num_funcs; i++) {
+    // get function type ID, check for error
+    uint32_t type_id;
+    if (!pwasm_func_types_add_native_type(&(interp->types), &(mod->funcs[i].type), &type_id)) {
+      // log error, return failure
+      pwasm_env_fail(env, "add native function type failed");
+      return false;
+    }
 
-        // set local value, pop stack
-        stack->ptr[frame.locals.ofs + id] = stack->ptr[stack->pos - 1];
-        stack->pos--;
-      }
+    tmp[tmp_ofs++] = (pwasm_new_interp_func_t) {
+      .mod_ofs  = mod_ofs,
+      .func_ofs = i,
+      .type_id  = type_id,
+    };
 
-      break;
-    case PWASM_OP_LOCAL_TEE:
-      {
-        // get local index
-        // (note: checked in pwasm_checker_get_local_type())
-        const uint32_t id = in.v_index;
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
 
-        // set local value, keep stack (tee)
-        stack->ptr[frame.locals.ofs + id] = stack->ptr[stack->pos - 1];
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append native functions failed");
+        return false;
       }
+    }
+  }
 
-      break;
-    case PWASM_OP_GLOBAL_GET:
-      {
-        // get global index
-        const uint32_t id = pwasm_new_interp_mod_get_global_index(frame.env, frame.mod, in.v_index);
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining native functions failed");
+      return false;
+    }
+  }
 
-        // get global value, check for error
-        pwasm_val_t val;
-        if (!pwasm_env_get_global(frame.env, id, &val)) {
-          // return failure
-          return false;
-        }
+  // add IDs
+  if (!pwasm_new_interp_push_u32s(env, u32s_ofs, mod->num_funcs)) {
+    // return failure
+    return false;
+  }
 
-        // push global value
-        stack->ptr[stack->pos++] = val;
-      }
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = dst_ofs,
+    .len = mod->num_funcs,
+  };
 
-      break;
-    case PWASM_OP_GLOBAL_SET:
-      {
-        // get global index
-        const uint32_t id = pwasm_new_interp_mod_get_global_index(frame.env, frame.mod, in.v_index);
+  // return success
+  return true;
+}
 
-        // set global value, check for error
-        if (!pwasm_env_set_global(frame.env, id, PWASM_PEEK(stack, 0))) {
-          // return failure
-          return false;
-        }
+static bool
+pwasm_new_interp_add_native_globals(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_native_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->globals);
+  const size_t dst_ofs = pwasm_vec_get_size(dst);
+  const size_t u32s_ofs = pwasm_vec_get_size(&(interp->u32s));
+  (void) mod_ofs;
 
-        // pop stack
-        stack->pos--;
-      }
+  pwasm_env_global_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
 
-      break;
-    case PWASM_OP_I32_LOAD:
-    case PWASM_OP_I64_LOAD:
-    case PWASM_OP_F32_LOAD:
-    case PWASM_OP_F64_LOAD:
-    case PWASM_OP_I32_LOAD8_S:
-    case PWASM_OP_I32_LOAD8_U:
-    case PWASM_OP_I32_LOAD16_S:
-    case PWASM_OP_I32_LOAD16_U:
-    case PWASM_OP_I64_LOAD8_S:
-    case PWASM_OP_I64_LOAD8_U:
-    case PWASM_OP_I64_LOAD16_S:
-    case PWASM_OP_I64_LOAD16_U:
-    case PWASM_OP_I64_LOAD32_S:
-    case PWASM_OP_I64_LOAD32_U:
-    case PWASM_OP_V128_LOAD:
-      {
-        // get offset operand
-        const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
+  for (size_t i = 0; i < mod->num_globals; i++) {
+    tmp[tmp_ofs++] = (pwasm_env_global_t) {
+      .type = mod->globals[i].type,
+      .val  = mod->globals[i].val,
+    };
 
-        // load value, check for error
-        pwasm_val_t val;
-        if (!pwasm_env_mem_load(frame.env, frame.mem_id, in, ofs, &val)) {
-          return false;
-        }
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
 
-        // pop ofs operand, push val
-        stack->ptr[stack->pos - 1] = val;
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append native globals failed");
+        return false;
       }
+    }
+  }
 
-      break;
-    case PWASM_OP_I32_STORE:
-    case PWASM_OP_I64_STORE:
-    case PWASM_OP_F32_STORE:
-    case PWASM_OP_F64_STORE:
-    case PWASM_OP_I32_STORE8:
-    case PWASM_OP_I32_STORE16:
-    case PWASM_OP_I64_STORE8:
-    case PWASM_OP_I64_STORE16:
-    case PWASM_OP_I64_STORE32:
-    case PWASM_OP_V128_STORE:
-      {
-        // get offset operand and value
-        const uint32_t ofs = stack->ptr[stack->pos - 2].i32;
-        const pwasm_val_t val = stack->ptr[stack->pos - 1];
-        stack->pos -= 2;
-
-        // store value, check for error
-        if (!pwasm_env_mem_store(frame.env, frame.mem_id, in, ofs, val)) {
-          return false;
-        }
-      }
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining native globals failed");
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_MEMORY_SIZE:
-      {
-        // get memory size, check for error
-        uint32_t size;
-        if (!pwasm_env_mem_size(frame.env, frame.mem_id, &size)) {
-          return false;
-        }
+  // add IDs
+  if (!pwasm_new_interp_push_u32s(env, u32s_ofs, mod->num_globals)) {
+    // return failure
+    return false;
+  }
 
-        // push size to stack
-        stack->ptr[stack->pos++].i32 = size;
-      }
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = dst_ofs,
+    .len = mod->num_globals,
+  };
 
-      break;
-    case PWASM_OP_MEMORY_GROW:
-      {
-        // get grow operand
-        const uint32_t grow = stack->ptr[stack->pos - 1].i32;
+  // return success
+  return true;
+}
 
-        // grow memory, check for error
-        uint32_t size;
-        if (!pwasm_env_mem_grow(frame.env, frame.mem_id, grow, &size)) {
-          return false;
-        }
+static bool
+pwasm_new_interp_add_native_mems(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_native_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->mems);
+  const size_t dst_ofs = pwasm_vec_get_size(dst);
+  (void) mod_ofs;
 
-        // pop operand, push result
-        stack->ptr[stack->pos - 1].i32 = size;
-      }
+  pwasm_env_mem_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
 
-      break;
-    case PWASM_OP_I32_CONST:
-      stack->ptr[stack->pos++].i32 = in.v_i32;
+  for (size_t i = 0; i < mod->num_mems; i++) {
+    tmp[tmp_ofs++] = (pwasm_env_mem_t) {
+      .buf    = mod->mems[i].buf,
+      .limits = mod->mems[i].limits,
+    };
 
-      break;
-    case PWASM_OP_I64_CONST:
-      stack->ptr[stack->pos++].i64 = in.v_i64;
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
 
-      break;
-    case PWASM_OP_F32_CONST:
-      stack->ptr[stack->pos++].f32 = in.v_f32;
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append native mems failed");
+        return false;
+      }
+    }
+  }
 
-      break;
-    case PWASM_OP_F64_CONST:
-      stack->ptr[stack->pos++].f64 = in.v_f64;
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining native mems failed");
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_I32_EQZ:
-      stack->ptr[stack->pos - 1].i32 = (stack->ptr[stack->pos - 1].i32 == 0);
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = dst_ofs,
+    .len = mod->num_mems,
+  };
 
-      break;
-    case PWASM_OP_I32_EQ:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a == b);
-        stack->pos--;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_NE:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a != b);
-        stack->pos--;
-      }
+static uint32_t
+pwasm_new_interp_add_native(
+  pwasm_env_t * const env,
+  const char * const name,
+  const pwasm_native_t * const mod
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const size_t mod_ofs = pwasm_vec_get_size(&(interp->mods));
 
-      break;
-    case PWASM_OP_I32_LT_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
+  // add native functions, check for error
+  pwasm_slice_t funcs;
+  if (!pwasm_new_interp_add_native_funcs(env, mod_ofs, mod, &funcs)) {
+    // return failure
+    return 0;
+  }
+
+  // add native globals, check for error
+  pwasm_slice_t globals;
+  if (!pwasm_new_interp_add_native_globals(env, mod_ofs, mod, &globals)) {
+    // return failure
+    return 0;
+  }
+
+  // add native mems, check for error
+  pwasm_slice_t mems;
+  if (!pwasm_new_interp_add_native_mems(env, mod_ofs, mod, &mems)) {
+    // return failure
+    return 0;
+  }
+
+  // build export index, check for error
+  pwasm_exports_t exports;
+  if (!pwasm_exports_init_native(&exports, env->mem_ctx, mod)) {
+    // log error, return failure
+    pwasm_env_fail(env, "build native export index failed");
+    return 0;
+  }
+
+  // build row
+  const pwasm_new_interp_mod_t interp_mod = {
+    .type     = PWASM_NEW_INTERP_MOD_TYPE_NATIVE,
+    .name     = pwasm_buf_str(name),
+    .native   = mod,
+
+    .funcs    = funcs,
+    .globals  = globals,
+    .mems     = mems,
+    .exports  = exports,
+  };
+
+  // append native mod, check for error
+  if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, NULL)) {
+    // log error, return failure
+    pwasm_exports_fini(&exports, env->mem_ctx);
+    pwasm_env_fail(env, "append native mod failed");
+    return 0;
+  }
+
+  // convert offset to ID by adding 1
+  return mod_ofs + 1;
+}
+
+/*
+ * Resolve imports of a given type.
+ *
+ * On success, a slice of import IDs is stored in +ret+, and this
+ * function returns true.
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_new_interp_add_mod_imports(
+  pwasm_env_t * const env,
+  const pwasm_mod_t * const mod,
+  const pwasm_import_type_t type,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const u32s = &(interp->u32s);
+  const size_t ret_ofs = pwasm_vec_get_size(u32s);
+
+  uint32_t ids[PWASM_BATCH_SIZE];
+  size_t num_ids = 0;
+
+  // loop over imports and resolve each one
+  for (size_t i = 0; i < mod->num_imports; i++) {
+    // get import, check type
+    const pwasm_import_t import = mod->imports[i];
+    if (import.type != type) {
+      continue;
+    }
+
+    const pwasm_buf_t mod_buf = {
+      .ptr = mod->bytes + import.module.ofs,
+      .len = import.module.len,
+    };
+
+    // find mod, check for error
+    const uint32_t mod_id = pwasm_env_find_mod(env, mod_buf);
+    if (!mod_id) {
+      // return failure
+      return false;
+    }
+
+    const pwasm_buf_t name_buf = {
+      .ptr = mod->bytes + import.name.ofs,
+      .len = import.name.len,
+    };
+
+    // find import ID, check for error
+    const uint32_t id = pwasm_env_find_import(env, mod_id, import.type, name_buf);
+    if (!id) {
+      // return failure
+      return false;
+    }
+
+    // add item to results, increment count
+    ids[num_ids++] = id;
+
+    if (num_ids == LEN(ids)) {
+      // clear count
+      num_ids = 0;
+
+      // append results, check for error
+      if (!pwasm_vec_push(u32s, LEN(ids), ids, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append import ids failed");
+        return false;
       }
+    }
+  }
+
+  if (num_ids > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(u32s, num_ids, ids, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining native imports failed");
+      return false;
+    }
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = ret_ofs,
+    .len = pwasm_vec_get_size(u32s) - ret_ofs,
+  };
+
+  // return success
+  return true;
+}
+
+/*
+ * Map the function types of a module to type IDs.
+ *
+ * On success, a slice of type IDs is stored in +ret+, and this
+ * function returns true.
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_new_interp_add_mod_types(
+  pwasm_env_t * const env,
+  const pwasm_mod_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const size_t dst_ofs = pwasm_vec_get_size(&(interp->u32s));
+
+  for (size_t i = 0; i < mod->num_types; i++) {
+    // get type ID, check for error
+    uint32_t type_id;
+    if (!pwasm_func_types_add_mod_type(&(interp->types), mod, i, &type_id)) {
+      // log error, return failure
+      pwasm_env_fail(env, "add function type failed");
+      return false;
+    }
+
+    // append type ID, check for error
+    if (!pwasm_vec_push(&(interp->u32s), 1, &type_id, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append function type ID failed");
+      return false;
+    }
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = dst_ofs,
+    .len = mod->num_types,
+  };
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_add_mod_funcs(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_mod_t * const mod,
+  const pwasm_slice_t types,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->funcs);
+  const size_t funcs_ofs = pwasm_vec_get_size(dst);
+
+  // add imported functions, check for error
+  pwasm_slice_t imports;
+  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_FUNC, &imports)) {
+    return false;
+  }
+
+  // get type IDs
+  const uint32_t * const type_ids = ((uint32_t*) pwasm_vec_get_data(&(interp->u32s))) + types.ofs;
+
+  pwasm_new_interp_func_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
+
+  for (size_t i = 0; i < mod->num_funcs; i++) {
+    tmp[tmp_ofs++] = (pwasm_new_interp_func_t) {
+      .mod_ofs  = mod_ofs,
+      .func_ofs = i,
+      .type_id  = type_ids[mod->funcs[i]],
+    };
+
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
+
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append functions failed");
+        return false;
+      }
+    }
+  }
+
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining functions failed");
+      return false;
+    }
+  }
+
+  if (!pwasm_new_interp_push_u32s(env, funcs_ofs, mod->num_funcs)) {
+    return false;
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = imports.ofs,
+    .len = imports.len + mod->num_funcs,
+  };
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_add_mod_globals(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_mod_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->globals);
+  const size_t globals_ofs = pwasm_vec_get_size(dst);
+  (void) mod_ofs;
+
+  // add imported globals, check for error
+  pwasm_slice_t imports;
+  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_GLOBAL, &imports)) {
+    return false;
+  }
+
+  pwasm_env_global_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
+
+  for (size_t i = 0; i < mod->num_globals; i++) {
+    tmp[tmp_ofs++] = (pwasm_env_global_t) {
+      .type  = mod->globals[i].type,
+      // .val = // FIXME: uninitialized
+    };
+
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
+
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append globals failed");
+        return false;
+      }
+    }
+  }
+
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining globals failed");
+      return false;
+    }
+  }
+
+  // add IDs
+  if (!pwasm_new_interp_push_u32s(env, globals_ofs, mod->num_globals)) {
+    // return failure
+    return false;
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = imports.ofs,
+    .len = imports.len + mod->num_globals,
+  };
+
+  // return success
+  return true;
+}
+
+/**
+ * Resize the buffer of memory +mem+ to +num_bytes+ bytes.
+ *
+ * Uses the `mem_resize` callback of the JIT compiler if the
+ * environment has one, or `pwasm_realloc()` otherwise.
+ */
+static bool
+pwasm_new_interp_resize_buf(
+  pwasm_env_t * const env,
+  pwasm_env_mem_t * const mem,
+  const size_t num_bytes
+) {
+  pwasm_jit_t * const jit = env->cbs->jit;
+  if (jit && jit->cbs && jit->cbs->mem_resize) {
+    // use jit compiler memory callback
+    return jit->cbs->mem_resize(jit, mem, num_bytes);
+  }
+
+  // resize buffer, check for error
+  uint8_t * const ptr = pwasm_realloc(env->mem_ctx, (void*) mem->buf.ptr, num_bytes);
+  if (!ptr && num_bytes) {
+    // return failure
+    return false;
+  }
+
+  // update buffer attributes
+  mem->buf.ptr = ptr;
+  mem->buf.len = num_bytes;
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_add_mod_mems(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_mod_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->mems);
+  const size_t mems_ofs = pwasm_vec_get_size(dst);
+  (void) mod_ofs;
+
+  // add imported mems, check for error
+  pwasm_slice_t imports;
+  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_MEM, &imports)) {
+    return false;
+  }
+
+  pwasm_env_mem_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
+
+  for (size_t i = 0; i < mod->num_mems; i++) {
+    tmp[tmp_ofs] = (pwasm_env_mem_t) {
+      .limits = mod->mems[i],
+    };
+
+    // allocate buffer, check for error
+    const size_t num_bytes = mod->mems[i].min * PWASM_PAGE_SIZE;
+    if (!pwasm_new_interp_resize_buf(env, tmp + tmp_ofs, num_bytes)) {
+      // log error, return failure
+      pwasm_env_fail(env, "allocate memory buffer failed");
+      return false;
+    }
+    tmp_ofs++;
+
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
+
+      // append results, check for error
+      if (!pwasm_vec_push(dst, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append mems failed");
+        return false;
+      }
+    }
+  }
+
+  if (tmp_ofs > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(dst, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining mems failed");
+      return false;
+    }
+  }
+
+  if (!pwasm_new_interp_push_u32s(env, mems_ofs, mod->num_mems)) {
+    return false;
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = imports.ofs,
+    .len = imports.len + mod->num_mems,
+  };
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_add_mod_tables(
+  pwasm_env_t * const env,
+  const uint32_t mod_ofs,
+  const pwasm_mod_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_vec_t * const dst = &(interp->tables);
+  pwasm_vec_t * const u32s = &(interp->u32s);
+
+  // add imported tables, check for error
+  pwasm_slice_t imports = { 0, 0 };
+  if (!pwasm_new_interp_add_mod_imports(env, mod, PWASM_IMPORT_TYPE_TABLE, &imports)) {
+    return false;
+  }
+
+  uint32_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
+
+  for (size_t i = 0; i < mod->num_tables; i++) {
+    // init table
+    pwasm_new_interp_table_t table = pwasm_new_interp_table_init(env, mod_ofs, i, mod->tables[i].limits);
+
+    // append initialized table to interpreter, check for error
+    size_t tmp_pos;
+    if (!pwasm_vec_push(dst, 1, &table, &tmp_pos)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append tables failed");
+      return false;
+    }
+
+    // append to table offsets, increment count
+    tmp[tmp_ofs] = tmp_pos;
+    tmp_ofs++;
+
+    if (tmp_ofs == LEN(tmp)) {
+      // clear count
+      tmp_ofs = 0;
+
+      // append IDs, check for error
+      if (!pwasm_vec_push(u32s, LEN(tmp), tmp, NULL)) {
+        // log error, return failure
+        pwasm_env_fail(env, "append table ids failed");
+        return false;
+      }
+    }
+  }
+
+  if (tmp_ofs > 0) {
+    // flush IDs, check for error
+    if (!pwasm_vec_push(u32s, tmp_ofs, tmp, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining table IDs failed");
+      return false;
+    }
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = imports.ofs,
+    .len = imports.len + mod->num_tables,
+  };
+
+  // return success
+  return true;
+}
+
+// forward declarations
+static bool pwasm_new_interp_eval_expr(
+  pwasm_new_interp_frame_t frame,
+  const pwasm_slice_t
+);
+
+static bool pwasm_new_interp_call(pwasm_env_t *, const uint32_t);
+
+static bool
+pwasm_new_interp_init_globals(
+  pwasm_new_interp_frame_t frame
+) {
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+  pwasm_env_global_t *env_globals = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
+  pwasm_stack_t * const stack = frame.env->stack;
+  const pwasm_global_t * const mod_globals = frame.mod->mod->globals;
+  const uint32_t * interp_u32s = (uint32_t*) pwasm_vec_get_data(&(interp->u32s)) + frame.mod->globals.ofs;
+  const size_t num_globals = frame.mod->mod->num_globals;
+  const pwasm_val_t zero = { .i64 = 0 };
+
+  for (size_t i = 0; i < num_globals; i++) {
+    // clear stack
+    stack->pos = 0;
+
+    // evaluate init
+    if (!pwasm_new_interp_eval_expr(frame, mod_globals[i].expr)) {
+      // return failure
+      return false;
+    }
+
+    // get destination offset, save value to global
+    const uint32_t ofs = interp_u32s[i];
+    env_globals[ofs].val = stack->pos ? stack->ptr[0] : zero;
+  }
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_init_elem_funcs(
+  pwasm_new_interp_frame_t frame,
+  const uint32_t ofs,
+  const pwasm_elem_t elem
+) {
+  // get table and mod to interpreter func ID map
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+  const uint32_t *u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t table_ofs = u32s[frame.mod->tables.ofs + elem.table_id];
+  D("frame.mod->tables.ofs = %zu, elem.table_id = %u, table_ofs = %u", frame.mod->tables.ofs, elem.table_id, table_ofs);
+  const uint32_t * const funcs = u32s + frame.mod->funcs.ofs;
+  const pwasm_new_interp_func_t * const interp_funcs = pwasm_vec_get_data(&(interp->funcs));
+  pwasm_new_interp_table_t * const table = pwasm_new_interp_get_table(frame.env, table_ofs + 1);
+  if (!table) {
+    return false;
+  }
+
+  uint32_t tmp[PWASM_BATCH_SIZE];
+  size_t tmp_ofs = 0;
+
+  for (size_t i = 0; i < elem.funcs.len; i++) {
+    // remap function id from module ID to interpreter ID
+    const uint32_t func_id = frame.mod->mod->u32s[elem.funcs.ofs + i];
+    tmp[tmp_ofs++] = funcs[func_id];
+
+    if (tmp_ofs == LEN(tmp)) {
+      // get destination offset
+      const size_t dst_ofs = ofs + i + 1 - LEN(tmp);
+
+      // set table elements, check for error
+      if (!pwasm_new_interp_table_set(frame.env, table, interp_funcs, dst_ofs, tmp, LEN(tmp))) {
+        // return failure
+        return false;
+      }
+
+      // reset offset
+      tmp_ofs = 0;
+    }
+  }
+
+  if (tmp_ofs > 0) {
+    // get destination offset
+    const size_t dst_ofs = ofs + elem.funcs.len - tmp_ofs;
+
+    // flush table elements, check for error
+    if (!pwasm_new_interp_table_set(frame.env, table, interp_funcs, dst_ofs, tmp, tmp_ofs)) {
+      // return failure
+      return false;
+    }
+  }
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_init_elems(
+  pwasm_new_interp_frame_t frame
+) {
+  const pwasm_elem_t * const elems = frame.mod->mod->elems;
+  const size_t num_elems = frame.mod->mod->num_elems;
+  pwasm_stack_t * const stack = frame.env->stack;
+
+  // init table elements
+  for (size_t i = 0; i < num_elems; i++) {
+    const pwasm_elem_t elem = elems[i];
+
+    // evaluate offset expression, check for error
+    stack->pos = 0;
+    if (!pwasm_new_interp_eval_expr(frame, elem.expr)) {
+      // return failure
+      return false;
+    }
+
+    // check that const expr has at least one result
+    // FIXME: should this be done in check()?
+    if (!stack->pos) {
+      pwasm_env_fail(frame.env, "constant expression must return table offset");
+      return false;
+    }
+
+    // get destination offset
+    const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
+
+    // populate table elements, check for error
+    if (!pwasm_new_interp_init_elem_funcs(frame, ofs, elem)) {
+      // return failure
+      return false;
+    }
+  }
+
+  // return success
+  return true;
+}
+
+// forward reference
+static pwasm_env_mem_t *pwasm_new_interp_get_mem(pwasm_env_t * const, const uint32_t);
+
+static bool
+pwasm_new_interp_init_segments(
+  pwasm_new_interp_frame_t frame
+) {
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const pwasm_segment_t * const segments = frame.mod->mod->segments;
+  const size_t num_segments = frame.mod->mod->num_segments;
+  pwasm_stack_t * const stack = frame.env->stack;
+
+  // init memory elements
+  for (size_t i = 0; i < num_segments; i++) {
+    const pwasm_segment_t segment = segments[i];
+
+    // get interpreter memory ID (convert offset to ID by adding 1)
+    const uint32_t mem_id = u32s[frame.mod->mems.ofs + segment.mem_id] + 1;
+
+    // get memory, check for error
+    pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(frame.env, mem_id);
+    if (!mem) {
+      // return failure
+      return false;
+    }
+
+    // evaluate offset expression, check for error
+    stack->pos = 0;
+    if (!pwasm_new_interp_eval_expr(frame, segment.expr)) {
+      // return failure
+      return false;
+    }
+
+    // check that const expr has at least one result
+    if (!stack->pos) {
+      pwasm_env_fail(frame.env, "constant expression must return segment offset");
+      return false;
+    }
+
+    // get destination offset
+    const uint32_t dst_ofs = stack->ptr[stack->pos - 1].i32;
+
+    // check destination length
+    // FIXME: should we resize here?
+    if (dst_ofs + segment.data.len > mem->buf.len) {
+      pwasm_env_fail(frame.env, "segment destination out of bounds");
+      return false;
+    }
+
+    // D("mem = %u, ofs = %u, len = %zu", mem_id, dst_ofs, segment.data.len);
+
+    // get dst, src pointers
+    uint8_t * const dst = (uint8_t*) mem->buf.ptr + dst_ofs;
+    const uint8_t * const src = frame.mod->mod->bytes + segment.data.ofs;
+
+    // copy data
+    memcpy(dst, src, segment.data.len);
+  }
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_init_start(
+  pwasm_new_interp_frame_t frame
+) {
+  (void) frame;
+
+  // check for start function
+  if (!frame.mod->mod->has_start) {
+    // return success
+    return true;
+  }
+
+  // get start function ID in mod, map to interpreter func ID
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t start = frame.mod->mod->start;
+  const uint32_t func_id = u32s[frame.mod->funcs.ofs + start] + 1;
+
+  // call start function, return result
+  return pwasm_new_interp_call(frame.env, func_id);
+}
+
+/**
+ * Get branch metadata for a branch to the given label.
+ *
+ * The `blocks` parameter is the stack of open block offsets, and `ctrls`
+ * is the control metadata for the current function.
+ */
+static pwasm_new_interp_ctrl_t
+pwasm_new_interp_decode_branch(
+  const pwasm_mod_t * const mod,
+  const pwasm_inst_t * const insts,
+  const pwasm_new_interp_ctrl_t * const ctrls,
+  const pwasm_vec_t * const blocks,
+  const uint32_t id
+) {
+  // get target block offset
+  const uint32_t * const tail = pwasm_vec_peek_tail(blocks, id);
+  if (!tail) {
+    // branch to function body
+    return (pwasm_new_interp_ctrl_t) {
+      .target = PWASM_NEW_INTERP_CTRL_RETURN,
+    };
+  }
+
+  // branches to a loop continue at the start of the loop and carry
+  // the loop parameters; all other branches continue after the end of
+  // the block and carry the block results
+  const bool is_loop = (insts[*tail].op == PWASM_OP_LOOP);
+  return (pwasm_new_interp_ctrl_t) {
+    .num_results  = is_loop ? ctrls[*tail].num_params : ctrls[*tail].num_results,
+    .target       = is_loop ? *tail : *tail + mod->blocks[insts[*tail].v_block].end_ofs,
+    .height       = ctrls[*tail].height,
+  };
+}
+
+/**
+ * Precompute control metadata for the functions in the given module.
+ *
+ * Populates `ret` with an array of control metadata entries which is
+ * indexed by instruction offset, followed by one entry for each
+ * br_table label.  The entries contain the arity and static value
+ * stack height of each block, loop, and if instruction, the skip
+ * offsets of each if and else instruction, and the arity, target, and
+ * target height of each branch, so the interpreter does not need a
+ * control stack to execute branches.
+ *
+ * The block heights are read from the value stack heights which the
+ * module checker recorded when the module was loaded (see the
+ * `heights` member of `pwasm_mod_t`).  Modules which were parsed with
+ * pwasm_mod_init_unsafe() have no recorded heights, so they are
+ * checked here instead.
+ *
+ * Also populates `ret_stack_sizes` with the worst-case value stack
+ * usage (locals plus maximum operand stack height) of each function,
+ * so calls can check for value stack overflow before entering a
+ * function.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static bool
+pwasm_new_interp_decode_mod(
+  pwasm_env_t * const env,
+  const pwasm_mod_t * const mod,
+  pwasm_new_interp_ctrl_t ** const ret,
+  uint32_t ** const ret_stack_sizes
+) {
+  // count br_table labels
+  size_t num_labels = 0;
+  for (size_t i = 0; i < mod->num_insts; i++) {
+    if (mod->insts[i].op == PWASM_OP_BR_TABLE) {
+      num_labels += mod->insts[i].v_br_table.len;
+    }
+  }
+
+  // get recorded value stack heights, or check module to collect
+  // them, check for error
+  pwasm_mod_heights_t checked = { 0 };
+  if (!mod->heights && mod->num_codes && !pwasm_mod_check_heights(mod, env->mem_ctx, 1, &checked)) {
+    // log error, return failure
+    pwasm_env_fail(env, "decode: get value stack heights failed");
+    return false;
+  }
+  const uint32_t * const heights = mod->heights ? mod->heights : checked.rows;
+
+  // allocate control metadata and stack sizes, check for error
+  const size_t num_ctrls = mod->num_insts + num_labels;
+  const size_t num_bytes = sizeof(pwasm_new_interp_ctrl_t) * num_ctrls;
+  pwasm_new_interp_ctrl_t * const ctrls = num_bytes ? pwasm_realloc(env->mem_ctx, NULL, num_bytes) : NULL;
+  const size_t sizes_size = sizeof(uint32_t) * mod->num_codes;
+  uint32_t * const sizes = sizes_size ? pwasm_realloc(env->mem_ctx, NULL, sizes_size) : NULL;
+  if ((num_bytes && !ctrls) || (sizes_size && !sizes)) {
+    // free metadata, log error, return failure
+    if (ctrls) {
+      pwasm_realloc(env->mem_ctx, ctrls, 0);
+    }
+    if (sizes) {
+      pwasm_realloc(env->mem_ctx, sizes, 0);
+    }
+    pwasm_mod_heights_fini(&checked);
+    pwasm_env_fail(env, "allocate control metadata failed");
+    return false;
+  }
+
+  if (num_bytes) {
+    // clear control metadata
+    memset(ctrls, 0, num_bytes);
+  }
+
+  // init stack of open blocks, check for error
+  pwasm_vec_t blocks;
+  if (!pwasm_vec_init(env->mem_ctx, &blocks, sizeof(uint32_t))) {
+    // free metadata, log error, return failure
+    if (ctrls) {
+      pwasm_realloc(env->mem_ctx, ctrls, 0);
+    }
+    if (sizes) {
+      pwasm_realloc(env->mem_ctx, sizes, 0);
+    }
+    pwasm_mod_heights_fini(&checked);
+    pwasm_env_fail(env, "init block stack failed");
+    return false;
+  }
+
+  bool ok = true;
+  size_t labels_ofs = mod->num_insts;
+  for (size_t f = 0; ok && f < mod->num_codes; f++) {
+    const pwasm_slice_t expr = mod->codes[f].expr;
+    const pwasm_inst_t * const insts = mod->insts + expr.ofs;
+    pwasm_new_interp_ctrl_t * const dst = ctrls + expr.ofs;
+
+    // save worst-case value stack usage
+    sizes[f] = mod->codes[f].max_locals + heights[mod->num_blocks + f];
+
+    // clear block stack
+    pwasm_vec_clear(&blocks);
+
+    for (size_t i = 0; ok && i < expr.len; i++) {
+      const pwasm_inst_t in = insts[i];
+
+      switch (in.op) {
+      case PWASM_OP_BLOCK:
+      case PWASM_OP_LOOP:
+      case PWASM_OP_IF:
+        {
+          // get block metadata and arity, check for error
+          const pwasm_block_t block = mod->blocks[in.v_block];
+          size_t num_params, num_results;
+          if (
+            !pwasm_block_type_params_get_size(mod, block.block_type, &num_params) ||
+            !pwasm_block_type_results_get_size(mod, block.block_type, &num_results)
+          ) {
+            // log error, return failure
+            pwasm_env_fail(env, "decode: get block arity failed");
+            ok = false;
+            break;
+          }
+
+          // save block arity and height
+          dst[i].num_params = num_params;
+          dst[i].num_results = num_results;
+          dst[i].height = heights[in.v_block];
+
+          if (in.op == PWASM_OP_IF) {
+            // save offset of else or end inst
+            dst[i].target = block.else_ofs ? block.else_ofs : block.end_ofs;
+          }
+
+          // push block offset, check for error
+          const uint32_t ofs = i;
+          if (!pwasm_vec_push(&blocks, 1, &ofs, NULL)) {
+            // log error, return failure
+            pwasm_env_fail(env, "decode: push block failed");
+            ok = false;
+          }
+        }
+
+        break;
+      case PWASM_OP_ELSE:
+        {
+          // save offset of end inst
+          const pwasm_block_t block = mod->blocks[in.v_block];
+          dst[i].target = block.end_ofs - block.else_ofs;
+        }
+
+        break;
+      case PWASM_OP_END:
+        // pop block (the final end has no block)
+        pwasm_vec_pop(&blocks, NULL);
+
+        break;
+      case PWASM_OP_BR:
+      case PWASM_OP_BR_IF:
+        // save branch arity, target, and height
+        dst[i] = pwasm_new_interp_decode_branch(mod, insts, dst, &blocks, in.v_index);
+
+        break;
+      case PWASM_OP_BR_TABLE:
+        // save offset of label metadata
+        dst[i].target = labels_ofs;
+
+        // save arity, target, and height of each label
+        for (size_t j = 0; j < in.v_br_table.len; j++) {
+          const uint32_t id = mod->u32s[in.v_br_table.ofs + j];
+          ctrls[labels_ofs++] = pwasm_new_interp_decode_branch(mod, insts, dst, &blocks, id);
+        }
+
+        break;
+      default:
+        // do nothing
+        break;
+      }
+    }
+  }
+
+  // free block stack and collected value stack heights
+  pwasm_vec_fini(&blocks);
+  pwasm_mod_heights_fini(&checked);
+
+  if (!ok) {
+    // free control metadata and stack sizes, return failure
+    if (ctrls) {
+      pwasm_realloc(env->mem_ctx, ctrls, 0);
+    }
+    if (sizes) {
+      pwasm_realloc(env->mem_ctx, sizes, 0);
+    }
+    return false;
+  }
+
+  // populate results, return success
+  *ret = ctrls;
+  *ret_stack_sizes = sizes;
+  return true;
+}
+
+/**
+ * Allocate empty compiled function list, direct call slots, and call
+ * and loop counters for a module in a tiered JIT environment.
+ *
+ * Functions are compiled by pwasm_new_interp_jit_count() once their
+ * counter reaches the tier-up threshold.
+ */
+static bool
+pwasm_new_interp_init_jit(
+  pwasm_env_t * const env,
+  pwasm_new_interp_mod_t * const interp_mod
+) {
+  const size_t num_codes = interp_mod->mod->num_codes;
+  if (!num_codes) {
+    // no functions, return success
+    return true;
+  }
+
+  // allocate function pointers, call slots, and counters
+  const size_t fns_size = num_codes * sizeof(pwasm_buf_t);
+  const size_t calls_size = num_codes * sizeof(void*);
+  const size_t hits_size = num_codes * sizeof(uint32_t);
+  interp_mod->fns = pwasm_realloc(env->mem_ctx, NULL, fns_size);
+  interp_mod->calls = pwasm_realloc(env->mem_ctx, NULL, calls_size);
+  interp_mod->hits = pwasm_realloc(env->mem_ctx, NULL, hits_size);
+
+  // check for error
+  if (!interp_mod->fns || !interp_mod->calls || !interp_mod->hits) {
+    // log error, return failure
+    pwasm_new_interp_fini_jit(env->mem_ctx, interp_mod);
+    pwasm_env_fail(env, "allocate compiled function list failed");
+    return false;
+  }
+
+  // clear function pointers, call slots, and counters
+  memset(interp_mod->fns, 0, fns_size);
+  memset(interp_mod->calls, 0, calls_size);
+  memset(interp_mod->hits, 0, hits_size);
+
+  // return success
+  return true;
+}
+
+static uint32_t
+pwasm_new_interp_add_mod(
+  pwasm_env_t * const env,
+  const char * const name,
+  const pwasm_mod_t * const mod
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const size_t mod_ofs = pwasm_vec_get_size(&(interp->mods));
+
+  // map mod types to type IDs, check for error
+  pwasm_slice_t types;
+  if (!pwasm_new_interp_add_mod_types(env, mod, &types)) {
+    // return failure
+    return 0;
+  }
+
+  // add mod funcs, check for error
+  pwasm_slice_t funcs;
+  if (!pwasm_new_interp_add_mod_funcs(env, mod_ofs, mod, types, &funcs)) {
+    // return failure
+    return 0;
+  }
+
+  // add mod globals, check for error
+  pwasm_slice_t globals;
+  if (!pwasm_new_interp_add_mod_globals(env, mod_ofs, mod, &globals)) {
+    // return failure
+    return 0;
+  }
+
+  // add mod mems, check for error
+  pwasm_slice_t mems;
+  if (!pwasm_new_interp_add_mod_mems(env, mod_ofs, mod, &mems)) {
+    // return failure
+    return 0;
+  }
+
+  // add mod tables, check for error
+  pwasm_slice_t tables;
+  if (!pwasm_new_interp_add_mod_tables(env, mod_ofs, mod, &tables)) {
+    // return failure
+    return 0;
+  }
+
+  // precompute control metadata, check for error
+  pwasm_new_interp_ctrl_t *ctrls = NULL;
+  uint32_t *stack_sizes = NULL;
+  if (!pwasm_new_interp_decode_mod(env, mod, &ctrls, &stack_sizes)) {
+    // return failure
+    return 0;
+  }
+
+  // build export index, check for error
+  pwasm_exports_t exports;
+  if (!pwasm_exports_init_mod(&exports, env->mem_ctx, mod)) {
+    // log error, return failure
+    pwasm_realloc(env->mem_ctx, ctrls, 0);
+    pwasm_realloc(env->mem_ctx, stack_sizes, 0);
+    pwasm_env_fail(env, "build export index failed");
+    return 0;
+  }
+
+  // build mod instance
+  pwasm_new_interp_mod_t interp_mod = {
+    .type     = PWASM_NEW_INTERP_MOD_TYPE_MOD,
+    .name     = pwasm_buf_str(name),
+    .mod      = mod,
+    .ctrls    = ctrls,
+    .stack_sizes = stack_sizes,
+
+    .funcs    = funcs,
+    .globals  = globals,
+    .mems     = mems,
+    .tables   = tables,
+    .types    = types,
+    .exports  = exports,
+  };
+
+  // allocate compiled function list (tiered JIT environments only),
+  // check for error
+  if (env->cbs->jit && env->cbs->jit_threshold && !pwasm_new_interp_init_jit(env, &interp_mod)) {
+    // return failure
+    pwasm_realloc(env->mem_ctx, ctrls, 0);
+    pwasm_realloc(env->mem_ctx, stack_sizes, 0);
+    pwasm_exports_fini(&exports, env->mem_ctx);
+    return 0;
+  }
+
+  // append mod, check for error
+  if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, NULL)) {
+    // log error, return failure
+    pwasm_realloc(env->mem_ctx, ctrls, 0);
+    pwasm_realloc(env->mem_ctx, stack_sizes, 0);
+    pwasm_exports_fini(&exports, env->mem_ctx);
+    pwasm_new_interp_fini_jit(env->mem_ctx, &interp_mod);
+    pwasm_env_fail(env, "append mod failed");
+    return 0;
+  }
+
+  // set up a temporary frame to init globals, tables, and mems
+  pwasm_new_interp_frame_t frame = {
+    .env = env,
+    .mod = &interp_mod,
+  };
+
+  // init globals, mems, tables, and start (in that order)
+  // source: https://webassembly.github.io/spec/core/exec/modules.html#exec-instantiation)
+
+  // init globals, check for error
+  if (!pwasm_new_interp_init_globals(frame)) {
+    // return failure
+    return 0;
+  }
+
+  // init tables, check for error
+  if (!pwasm_new_interp_init_elems(frame)) {
+    // return failure
+    return 0;
+  }
+
+  // init segments, check for error
+  if (!pwasm_new_interp_init_segments(frame)) {
+    // return failure
+    return 0;
+  }
+
+  // call start func, check for error
+  if (!pwasm_new_interp_init_start(frame)) {
+    // return failure
+    return 0;
+  }
+
+  // return success, convert offset to ID by adding 1
+  return mod_ofs + 1;
+}
+
+static const pwasm_mod_t *
+pwasm_new_interp_get_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  const bool ok = (mod_id && mod_id <= num_rows);
+  return ok ? rows[mod_id - 1].mod : NULL;
+}
+
+static const pwasm_buf_t *
+pwasm_new_interp_get_mod_name(
+  pwasm_env_t * const env,
+  const uint32_t mod_id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  const bool ok = (mod_id && mod_id <= num_rows);
+  return ok ? &(rows[mod_id - 1].name) : NULL;
+}
+
+static uint32_t
+pwasm_new_interp_find_mod(
+  pwasm_env_t * const env,
+  const pwasm_buf_t name
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  for (size_t i = 0; i < num_rows; i++) {
+    if (
+      (rows[i].name.len == name.len) &&
+      !memcmp(name.ptr, rows[i].name.ptr, name.len)
+    ) {
+      // return offset + 1 (prevent zero IDs)
+      return i + 1;
+    }
+  }
+
+  // log error, return failure
+  pwasm_env_fail(env, "module not found");
+  return 0;
+}
+
+static uint32_t
+pwasm_new_interp_find_func(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_buf_t name
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_vec_t * const vec = &(interp->mods);
+  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(vec);
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+
+  // check mod_id
+  if (mod_id > pwasm_vec_get_size(&(interp->mods))) {
+    pwasm_env_fail(env, "invalid mod ID");
+    return 0;
+  }
+
+  // get mod
+  const pwasm_new_interp_mod_t * const mod = mods + (mod_id - 1);
+
+  // find function in export index, check for error
+  uint32_t ofs;
+  if (!pwasm_exports_find(&(mod->exports), PWASM_IMPORT_TYPE_FUNC, name, &ofs)) {
+    // log error, return failure
+    pwasm_env_fail(env, "function not found");
+    return 0;
+  }
+
+  // return offset + 1 (prevent zero IDs)
+  return u32s[mod->funcs.ofs + ofs] + 1;
+}
+
+static uint32_t
+pwasm_new_interp_find_mem(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_buf_t name
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_vec_t * const vec = &(interp->mods);
+  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(vec);
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+
+  // check mod_id
+  if (mod_id > pwasm_vec_get_size(&(interp->mods))) {
+    pwasm_env_fail(env, "invalid mod ID");
+    return 0;
+  }
+
+  // get mod
+  const pwasm_new_interp_mod_t * const mod = mods + (mod_id - 1);
+
+  // find memory in export index, check for error
+  uint32_t ofs;
+  if (!pwasm_exports_find(&(mod->exports), PWASM_IMPORT_TYPE_MEM, name, &ofs)) {
+    // log error, return failure
+    pwasm_env_fail(env, "memory not found");
+    return 0;
+  }
+
+  // return offset + 1 (prevent zero IDs)
+  return u32s[mod->mems.ofs + ofs] + 1;
+}
+
+static pwasm_env_mem_t *
+pwasm_new_interp_get_mem(
+  pwasm_env_t * const env,
+  const uint32_t mem_id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_env_mem_t *rows = pwasm_vec_get_data(&(interp->mems));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mems));
+  D("num mems: %zu", num_rows);
+
+  // check that mem_id is in bounds
+  if (!mem_id || mem_id > num_rows) {
+    // log error, return failure
+    D("bad mem_id: %u", mem_id);
+    pwasm_env_fail(env, "memory index out of bounds");
+    return NULL;
+  }
+
+  // return pointer to memory
+  return (pwasm_env_mem_t*) rows + (mem_id - 1);
+}
+
+/*
+ * Get the absolute memory offset from the immediate offset and the
+ * offset operand.
+ */
+static bool
+pwasm_new_interp_get_mem_chunk(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  const pwasm_inst_t in,
+  const uint32_t arg_ofs,
+  pwasm_new_interp_mem_chunk_t * const ret
+) {
+  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
+  size_t ofs = in.v_mem.offset + arg_ofs;
+  size_t size = pwasm_op_get_num_bytes(in.op);
+  const bool ok = mem && size && (ofs + size < mem->buf.len);
+
+  if (!ok) {
+    // dissect error
+    if (!mem) {
+      D("mem_id = %u", mem_id);
+      pwasm_env_fail(env, "invalid memory index");
+    } else if (!size) {
+      D("op = %s", pwasm_op_get_name(in.op));
+      pwasm_env_fail(env, "invalid memory instruction");
+    } else {
+      D("ofs = %zu, size = %zu", ofs, size);
+      pwasm_env_fail(env, "invalid memory address");
+    }
+
+    // return failure
+    return false;
+  }
+
+  const pwasm_new_interp_mem_chunk_t tmp = {
+    .mem  = mem,
+    .ofs  = ofs,
+    .size = size,
+  };
+
+  // populate result
+  memcpy(ret, &tmp, sizeof(pwasm_new_interp_mem_chunk_t));
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_mem_load(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  const pwasm_inst_t in,
+  const uint32_t arg_ofs,
+  pwasm_val_t * const ret_val
+) {
+  // get memory chunk, check for error
+  pwasm_new_interp_mem_chunk_t chunk;
+  if (!pwasm_new_interp_get_mem_chunk(env, mem_id, in, arg_ofs, &chunk)) {
+    return false;
+  }
+
+  // pwasm_new_interp_dump_mem_chunk(chunk);
+  // D("load i32 = %u", ((pwasm_val_t*) (chunk.mem->buf.ptr + chunk.ofs))->i32);
+
+  // clear temp val
+  pwasm_val_t tmp;
+  memset(&tmp, 0, sizeof(pwasm_val_t));
+
+  // copy to temp
+  memcpy(&tmp, chunk.mem->buf.ptr + chunk.ofs, chunk.size);
+
+  // copy temp to destination
+  memcpy(ret_val, &tmp, sizeof(pwasm_val_t));
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_new_interp_mem_store(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  const pwasm_inst_t in,
+  const uint32_t arg_ofs,
+  const pwasm_val_t val
+) {
+  // get memory chunk, check for error
+  pwasm_new_interp_mem_chunk_t chunk;
+  if (!pwasm_new_interp_get_mem_chunk(env, mem_id, in, arg_ofs, &chunk)) {
+    return false;
+  }
+
+  // pwasm_new_interp_dump_mem_chunk(chunk);
+  // D("chunk.size = %zu", chunk.size);
+
+  // copy to result
+  memcpy((uint8_t*) chunk.mem->buf.ptr + chunk.ofs, &val, chunk.size);
+
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_LT_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
-      }
+static bool
+pwasm_new_interp_mem_size(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  uint32_t * const ret_val
+) {
+  // get memory, check for error
+  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
+  if (!mem) {
+    // return failure
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I32_GT_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
-      }
+  if (ret_val) {
+    // save result
+    *ret_val = mem->buf.len / PWASM_PAGE_SIZE;
+  }
 
-      break;
-    case PWASM_OP_I32_GT_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_LE_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+/**
+ * Get the mapped memory entry for the memory at offset +mem_ofs+.
+ *
+ * Returns NULL if the memory is a pwasm_realloc() buffer.
+ */
+static pwasm_new_interp_mem_map_t *
+pwasm_new_interp_find_mem_map(
+  pwasm_env_t * const env,
+  const size_t mem_ofs
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_new_interp_mem_map_t * const rows = (pwasm_new_interp_mem_map_t*) pwasm_vec_get_data(&(interp->maps));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->maps));
 
-      break;
-    case PWASM_OP_I32_LE_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+  for (size_t i = 0; i < num_rows; i++) {
+    if (rows[i].mem_ofs == mem_ofs) {
+      return rows + i;
+    }
+  }
 
-      break;
-    case PWASM_OP_I32_GE_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+  // return failure
+  return NULL;
+}
 
-      break;
-    case PWASM_OP_I32_GE_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+/**
+ * Resize the backing buffer of the memory at offset +mem_ofs+ to
+ * +num_bytes+ bytes.
+ *
+ * Mapped memories are resized in place within their reserved address
+ * range; other memories are resized with pwasm_new_interp_resize_buf().
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_new_interp_resize_mem(
+  pwasm_env_t * const env,
+  const size_t mem_ofs,
+  const size_t num_bytes
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_env_mem_t * const mem = (pwasm_env_mem_t*) pwasm_vec_get_data(&(interp->mems)) + mem_ofs;
 
-      break;
-    case PWASM_OP_I64_EQZ:
-      stack->ptr[stack->pos - 1].i32 = (stack->ptr[stack->pos - 1].i64 == 0);
+#ifdef PWASM_HAVE_MEMFD
+  const pwasm_new_interp_mem_map_t * const map = pwasm_new_interp_find_mem_map(env, mem_ofs);
+  if (map) {
+    uint8_t * const ptr = (uint8_t*) mem->buf.ptr;
+    const size_t len = mem->buf.len;
 
-      break;
-    case PWASM_OP_I64_EQ:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a == b);
-        stack->pos--;
-      }
+    // check reserved size
+    if (num_bytes > map->size) {
+      // return failure
+      return false;
+    }
 
-      break;
-    case PWASM_OP_I64_NE:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a != b);
-        stack->pos--;
+    if (num_bytes > len) {
+      // make new pages accessible, check for error
+      if (mprotect(ptr + len, num_bytes - len, PROT_READ | PROT_WRITE)) {
+        return false;
       }
-
-      break;
-    case PWASM_OP_I64_LT_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
+    } else if (num_bytes < len) {
+      // replace truncated pages with inaccessible zero pages, check for
+      // error
+      const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_NORESERVE;
+      if (mmap(ptr + num_bytes, len - num_bytes, PROT_NONE, flags, -1, 0) == MAP_FAILED) {
+        return false;
       }
+    }
 
-      break;
-    case PWASM_OP_I64_LT_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
-      }
+    // update size, return success
+    mem->buf.len = num_bytes;
+    return true;
+  }
+#endif /* PWASM_HAVE_MEMFD */
 
-      break;
-    case PWASM_OP_I64_GT_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
-      }
+  // resize buffer, return result
+  return pwasm_new_interp_resize_buf(env, mem, num_bytes);
+}
 
-      break;
-    case PWASM_OP_I64_GT_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
-      }
+/**
+ * Reset the memory at offset +mem_ofs+ to the first +num_bytes+ bytes
+ * of the memory image +image+ (see pwasm_snapshot_save_mem_image()).
+ *
+ * The image is mapped with a private, copy-on-write mapping, so pages
+ * are only copied when they are written.  The first time this is called
+ * for a memory, the pwasm_realloc() buffer of the memory is replaced
+ * with a reserved address range for the largest possible memory.
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_new_interp_map_mem_image(
+  pwasm_env_t * const env,
+  const size_t mem_ofs,
+  const int image,
+  const size_t num_bytes
+) {
+#ifdef PWASM_HAVE_MEMFD
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_env_mem_t * const mem = (pwasm_env_mem_t*) pwasm_vec_get_data(&(interp->mems)) + mem_ofs;
 
-      break;
-    case PWASM_OP_I64_LE_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+  if (!pwasm_new_interp_find_mem_map(env, mem_ofs)) {
+    if (env->cbs->jit) {
+      // compiled code refers to the address of guarded memories, so
+      // the memories of tiered JIT environments cannot be moved
+      pwasm_env_fail(env, "memory images not supported with JIT");
+      return false;
+    }
 
-      break;
-    case PWASM_OP_I64_LE_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+    // get maximum size, in bytes
+    const uint64_t max_pages = mem->limits.has_max ? mem->limits.max : (1 << 16);
+    const uint64_t max_bytes = max_pages * PWASM_PAGE_SIZE;
+    if (max_bytes > SIZE_MAX || max_bytes < num_bytes) {
+      // log error, return failure
+      pwasm_env_fail(env, "memory image larger than memory");
+      return false;
+    }
 
-      break;
-    case PWASM_OP_I64_GE_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+    // reserve address space, check for error
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+    uint8_t * const ptr = mmap(NULL, max_bytes, PROT_NONE, flags, -1, 0);
+    if (ptr == MAP_FAILED) {
+      // log error, return failure
+      pwasm_env_fail(env, "reserve memory failed");
+      return false;
+    }
 
-      break;
-    case PWASM_OP_I64_GE_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+    // add map entry, check for error
+    const pwasm_new_interp_mem_map_t map = { mem_ofs, max_bytes };
+    if (!pwasm_vec_push(&(interp->maps), 1, &map, NULL)) {
+      munmap(ptr, max_bytes);
+      pwasm_env_fail(env, "append memory map failed");
+      return false;
+    }
 
-      break;
-    case PWASM_OP_F32_EQ:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a == b);
-        stack->pos--;
-      }
+    // free old buffer, switch to reserved address range
+    pwasm_realloc(env->mem_ctx, (void*) mem->buf.ptr, 0);
+    mem->buf = (pwasm_buf_t) { ptr, 0 };
+  }
 
-      break;
-    case PWASM_OP_F32_NE:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a != b);
-        stack->pos--;
-      }
+  // drop pages past the end of the image, check for error
+  if (mem->buf.len > num_bytes && !pwasm_new_interp_resize_mem(env, mem_ofs, num_bytes)) {
+    pwasm_env_fail(env, "resize memory buffer failed");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_F32_LT:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
-      }
+  if (num_bytes > 0) {
+    // map image over memory (discards private copies of written
+    // pages), check for error
+    void * const ptr = (void*) mem->buf.ptr;
+    const int flags = MAP_PRIVATE | MAP_FIXED;
+    if (mmap(ptr, num_bytes, PROT_READ | PROT_WRITE, flags, image, 0) == MAP_FAILED) {
+      pwasm_env_fail(env, "map memory image failed");
+      return false;
+    }
+  }
+
+  // update size, return success
+  mem->buf.len = num_bytes;
+  return true;
+#else
+  (void) mem_ofs;
+  (void) image;
+  (void) num_bytes;
+  pwasm_env_fail(env, "memory images not supported");
+  return false;
+#endif /* PWASM_HAVE_MEMFD */
+}
+
+static bool
+pwasm_new_interp_mem_grow(
+  pwasm_env_t * const env,
+  const uint32_t mem_id,
+  const uint32_t grow,
+  uint32_t * const ret_val
+) {
+  // get memory, check for error
+  pwasm_env_mem_t * const mem = pwasm_new_interp_get_mem(env, mem_id);
+  if (!mem) {
+    // return failure (trap)
+    return false;
+  }
 
-      break;
-    case PWASM_OP_F32_GT:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
-      }
+  // get current size, in number of pages
+  const uint32_t old_size = mem->buf.len / PWASM_PAGE_SIZE;
+  const uint32_t new_size = old_size + grow;
 
-      break;
-    case PWASM_OP_F32_LE:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+  // check upper bound
+  if (mem->limits.has_max && new_size > mem->limits.max) {
+    // at this point we save a -1 to the return value pointer to
+    // indicate failure, then return true from the function so that it
+    // doesn't trap.
+    //
+    // see https://webassembly.github.io/spec/core/exec/instructions.html#exec-memory-size
 
-      break;
-    case PWASM_OP_F32_GE:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+    if (ret_val) {
+      // return -1 to indicate failure
+      *ret_val = -1;
+    }
 
-      break;
-    case PWASM_OP_F64_EQ:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a == b);
-        stack->pos--;
-      }
+    // return "success"
+    return true;
+  }
 
-      break;
-    case PWASM_OP_F64_NE:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a != b);
-        stack->pos--;
-      }
+  if (new_size > 0) {
+    // get number of bytes
+    const size_t num_bytes = new_size * PWASM_PAGE_SIZE;
 
-      break;
-    case PWASM_OP_F64_LT:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a < b);
-        stack->pos--;
-      }
+    // resize buffer, check for error
+    if (!pwasm_new_interp_resize_mem(env, mem_id - 1, num_bytes)) {
+      // at this point we save a -1 to the return value pointer to
+      // indicate failure, then return true from the function so that it
+      // doesn't trap.
+      //
+      // see https://webassembly.github.io/spec/core/exec/instructions.html#exec-memory-size
 
-      break;
-    case PWASM_OP_F64_GT:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a > b);
-        stack->pos--;
+      if (ret_val) {
+        // return -1 to indicate failure
+        *ret_val = -1;
       }
 
-      break;
-    case PWASM_OP_F64_LE:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a <= b);
-        stack->pos--;
-      }
+      // return "success"
+      return true;
+    }
+  }
 
-      break;
-    case PWASM_OP_F64_GE:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].i32 = (a >= b);
-        stack->pos--;
-      }
+  if (ret_val) {
+    // update return value
+    *ret_val = old_size;
+  }
 
-      break;
-    case PWASM_OP_I32_CLZ:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i32 = a ? __builtin_clz(a) : 32;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_CTZ:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i32 = a ? __builtin_ctz(a) : 32;
-      }
+static bool
+pwasm_new_interp_get_elem(
+  pwasm_env_t * const env,
+  const uint32_t table_id,
+  const uint32_t elem_ofs,
+  uint32_t * const ret_val
+) {
+  pwasm_new_interp_table_t * const table = pwasm_new_interp_get_table(env, table_id);
+  if (!table) {
+    return false;
+  }
+  return pwasm_new_interp_table_get_elem(env, table, elem_ofs, ret_val);
+}
 
-      break;
-    case PWASM_OP_I32_POPCNT:
-      {
-        const int val = __builtin_popcount(stack->ptr[stack->pos - 1].i32);
-        stack->ptr[stack->pos - 1].i32 = val;
-      }
+static uint32_t
+pwasm_new_interp_find_import(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_import_type_t type,
+  const pwasm_buf_t name
+) {
+  switch (type) {
+  case PWASM_IMPORT_TYPE_FUNC:
+    return pwasm_env_find_func(env, mod_id, name);
+  case PWASM_IMPORT_TYPE_MEM:
+    return pwasm_env_find_mem(env, mod_id, name);
+  case PWASM_IMPORT_TYPE_GLOBAL:
+    return pwasm_env_find_global(env, mod_id, name);
+  case PWASM_IMPORT_TYPE_TABLE:
+    return pwasm_env_find_table(env, mod_id, name);
+  default:
+    // log error, return failure
+    pwasm_env_fail(env, "invalid import type");
+    return 0;
+  }
+}
 
-      break;
-    case PWASM_OP_I32_ADD:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a + b;
-        stack->pos--;
-      }
+static inline bool
+pwasm_new_interp_check_global(
+  pwasm_env_t * const env,
+  const uint32_t id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const size_t num_rows = pwasm_vec_get_size(&(interp->globals));
 
-      break;
-    case PWASM_OP_I32_SUB:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a - b;
-        stack->pos--;
-      }
+  if (!id || id > num_rows) {
+    // log error, return failure
+    D("global index = %u", id);
+    pwasm_env_fail(env, "global index out of bounds");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I32_MUL:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a * b;
-        stack->pos--;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_DIV_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+static bool
+pwasm_new_interp_get_global(
+  pwasm_env_t * const env,
+  const uint32_t id,
+  pwasm_val_t * const ret_val
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_env_global_t *rows = pwasm_vec_get_data(&(interp->globals));
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i32.div_s: division by zero");
-          return false;
-        }
+  if (!pwasm_new_interp_check_global(env, id)) {
+    return false;
+  }
 
-        stack->ptr[stack->pos - 2].i32 = a / b;
-        stack->pos--;
-      }
+  if (ret_val) {
+    // copy value to destination
+    *ret_val = rows[id - 1].val;
+  }
 
-      break;
-    case PWASM_OP_I32_DIV_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+  // return success
+  return true;
+}
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i32.div_u: division by zero");
-          return false;
-        }
+static bool
+pwasm_new_interp_set_global(
+  pwasm_env_t * const env,
+  const uint32_t id,
+  const pwasm_val_t val
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_env_global_t *rows = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
 
-        stack->ptr[stack->pos - 2].i32 = a / b;
-        stack->pos--;
-      }
+  if (!pwasm_new_interp_check_global(env, id)) {
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I32_REM_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+  if (!rows[id - 1].type.mutable) {
+    pwasm_env_fail(env, "write to immutable global");
+    return false;
+  }
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i32.rem_s: division by zero");
-          return false;
-        }
+  // set global value
+  rows[id - 1].val = val;
 
-        stack->ptr[stack->pos - 2].i32 = a % b;
-        stack->pos--;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I32_REM_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+/**
+ * Get the internal module with ID +mod_id+ for a snapshot operation.
+ *
+ * Returns NULL on error.
+ */
+static const pwasm_new_interp_mod_t *
+pwasm_new_interp_get_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i32.rem_u: division by zero");
-          return false;
-        }
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "invalid module ID");
+    return NULL;
+  }
 
-        stack->ptr[stack->pos - 2].i32 = a % b;
-        stack->pos--;
-      }
+  // check module type
+  if (rows[mod_id - 1].type != PWASM_NEW_INTERP_MOD_TYPE_MOD) {
+    // log error, return failure
+    pwasm_env_fail(env, "cannot snapshot native module");
+    return NULL;
+  }
 
-      break;
-    case PWASM_OP_I32_AND:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a & b;
-        stack->pos--;
-      }
+  // return module
+  return rows + (mod_id - 1);
+}
 
-      break;
-    case PWASM_OP_I32_OR:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a | b;
-        stack->pos--;
-      }
+static bool
+pwasm_new_interp_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
 
-      break;
-    case PWASM_OP_I32_XOR:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].i32 = a ^ b;
-        stack->pos--;
-      }
+  // get module, check for error
+  const pwasm_new_interp_mod_t * const mod = pwasm_new_interp_get_snapshot_mod(env, mod_id);
+  if (!mod) {
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I32_SHL:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
-        stack->ptr[stack->pos - 2].i32 = a << b;
-        stack->pos--;
-      }
+  // get defined memory, global, and table offsets (skip imports)
+  const pwasm_mod_t * const src = mod->mod;
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t * const mem_ids = u32s + mod->mems.ofs + src->num_import_types[PWASM_IMPORT_TYPE_MEM];
+  const uint32_t * const global_ids = u32s + mod->globals.ofs + src->num_import_types[PWASM_IMPORT_TYPE_GLOBAL];
+  const uint32_t * const table_ids = u32s + mod->tables.ofs + src->num_import_types[PWASM_IMPORT_TYPE_TABLE];
 
-      break;
-    case PWASM_OP_I32_SHR_S:
-      {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
-        stack->ptr[stack->pos - 2].i32 = a >> b;
-        stack->pos--;
-      }
+  // get memories, globals, and tables
+  const pwasm_env_mem_t * const mems = pwasm_vec_get_data(&(interp->mems));
+  const pwasm_env_global_t * const globals = pwasm_vec_get_data(&(interp->globals));
+  const pwasm_new_interp_table_t * const tables = pwasm_vec_get_data(&(interp->tables));
 
-      break;
-    case PWASM_OP_I32_SHR_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
-        stack->ptr[stack->pos - 2].i32 = a >> b;
-        stack->pos--;
-      }
+  // save memories to memory images?  (not in tiered JIT environments,
+  // because compiled code refers to the address of guarded memories,
+  // and mapping an image would move the memory)
+  const bool use_images = (snap->flags & PWASM_ENV_SNAPSHOT_FLAG_MEMFD) && !env->cbs->jit;
 
-      break;
-    case PWASM_OP_I32_ROTL:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
-        stack->ptr[stack->pos - 2].i32 = (a << b) | (a >> (32 - b));
-        stack->pos--;
-      }
+  // sum size of memory and table contents
+  size_t data_size = 0;
+  for (size_t i = 0; i < src->num_mems && !use_images; i++) {
+    data_size += mems[mem_ids[i]].buf.len;
+  }
+  for (size_t i = 0; i < src->num_tables; i++) {
+    const size_t max_vals = tables[table_ids[i]].max_vals;
+    data_size += max_vals * sizeof(uint32_t) + PWASM_SNAPSHOT_NUM_MASKS(max_vals) * sizeof(uint64_t);
+  }
 
-      break;
-    case PWASM_OP_I32_ROTR:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 2].i32;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
-        stack->ptr[stack->pos - 2].i32 = (a << (32 - b)) | (a >> b);
-        stack->pos--;
-      }
+  // allocate snapshot, check for error
+  pwasm_snapshot_t * const data = pwasm_snapshot_alloc(snap, env->mem_ctx, src, data_size);
+  if (!data) {
+    // log error, return failure
+    pwasm_env_fail(env, "allocate snapshot failed");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I64_CLZ:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i64 = a ? __builtin_clzl(a) : 64;
-      }
+  // save memories (fall back to the arena if memory images are not
+  // supported)
+  for (size_t i = 0; i < src->num_mems; i++) {
+    if (use_images && pwasm_snapshot_save_mem_image(data->mems + i, data->images + i, mems + mem_ids[i])) {
+      continue;
+    }
 
-      break;
-    case PWASM_OP_I64_CTZ:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i64 = a ? __builtin_ctzl(a) : 64;
-      }
+    if (!pwasm_snapshot_save_mem(snap, data->mems + i, mems + mem_ids[i])) {
+      // log error, return failure
+      pwasm_env_snapshot_fini(snap);
+      pwasm_env_fail(env, "save memory failed");
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_I64_POPCNT:
-      {
-        const int val = __builtin_popcountl(stack->ptr[stack->pos - 1].i64);
-        stack->ptr[stack->pos - 1].i64 = val;
-      }
+  // save globals
+  for (size_t i = 0; i < src->num_globals; i++) {
+    data->globals[i] = globals[global_ids[i]].val;
+  }
 
-      break;
-    case PWASM_OP_I64_ADD:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a + b;
-        stack->pos--;
-      }
+  // save tables
+  for (size_t i = 0; i < src->num_tables; i++) {
+    const pwasm_new_interp_table_t * const table = tables + table_ids[i];
+    if (!pwasm_snapshot_save_table(snap, data->tables + i, table->vals, table->masks, table->max_vals)) {
+      // log error, return failure
+      pwasm_env_snapshot_fini(snap);
+      pwasm_env_fail(env, "save table failed");
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_I64_SUB:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a - b;
-        stack->pos--;
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_I64_MUL:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a * b;
-        stack->pos--;
-      }
+static bool
+pwasm_new_interp_restore_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_env_snapshot_t * const snap
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_snapshot_t * const data = snap->data;
 
-      break;
-    case PWASM_OP_I64_DIV_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+  // get module, check for error
+  const pwasm_new_interp_mod_t * const mod = pwasm_new_interp_get_snapshot_mod(env, mod_id);
+  if (!mod) {
+    return false;
+  }
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i64.div_s: division by zero");
-          return false;
-        }
+  // check snapshot
+  const pwasm_mod_t * const src = mod->mod;
+  if (!data || data->mod != src) {
+    // log error, return failure
+    pwasm_env_fail(env, "snapshot does not match module");
+    return false;
+  }
 
-        stack->ptr[stack->pos - 2].i64 = a / b;
-        stack->pos--;
+  // get defined memory, global, and table offsets (skip imports)
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t * const mem_ids = u32s + mod->mems.ofs + src->num_import_types[PWASM_IMPORT_TYPE_MEM];
+  const uint32_t * const global_ids = u32s + mod->globals.ofs + src->num_import_types[PWASM_IMPORT_TYPE_GLOBAL];
+  const uint32_t * const table_ids = u32s + mod->tables.ofs + src->num_import_types[PWASM_IMPORT_TYPE_TABLE];
+
+  // get memories, globals, and tables
+  pwasm_env_mem_t * const mems = (pwasm_env_mem_t*) pwasm_vec_get_data(&(interp->mems));
+  pwasm_env_global_t * const globals = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
+  pwasm_new_interp_table_t * const tables = (pwasm_new_interp_table_t*) pwasm_vec_get_data(&(interp->tables));
+  const pwasm_new_interp_func_t * const funcs = pwasm_vec_get_data(&(interp->funcs));
+
+  // restore memories
+  for (size_t i = 0; i < src->num_mems; i++) {
+    pwasm_env_mem_t * const mem = mems + mem_ids[i];
+    const pwasm_buf_t buf = data->mems[i].buf;
+
+    if (data->images[i] >= 0) {
+      // map memory image, check for error
+      if (!pwasm_new_interp_map_mem_image(env, mem_ids[i], data->images[i], buf.len)) {
+        return false;
       }
 
-      break;
-    case PWASM_OP_I64_DIV_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i64.div_u: division by zero");
-          return false;
-        }
+      continue;
+    }
 
-        stack->ptr[stack->pos - 2].i64 = a / b;
-        stack->pos--;
+    if (mem->buf.len != buf.len) {
+      // resize buffer, check for error
+      if (!pwasm_new_interp_resize_mem(env, mem_ids[i], buf.len)) {
+        // log error, return failure
+        pwasm_env_fail(env, "resize memory buffer failed");
+        return false;
       }
+    }
 
-      break;
-    case PWASM_OP_I64_REM_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+    if (buf.len > 0) {
+      // copy contents
+      memcpy((uint8_t*) mem->buf.ptr, buf.ptr, buf.len);
+    }
+  }
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i64.rem_s: division by zero");
-          return false;
-        }
+  // restore globals
+  for (size_t i = 0; i < src->num_globals; i++) {
+    globals[global_ids[i]].val = data->globals[i];
+  }
 
-        stack->ptr[stack->pos - 2].i64 = a % b;
-        stack->pos--;
-      }
+  // restore tables
+  for (size_t i = 0; i < src->num_tables; i++) {
+    pwasm_new_interp_table_t * const table = tables + table_ids[i];
+    if (!pwasm_snapshot_restore_table(env->mem_ctx, &(table->vals), &(table->masks), &(table->max_vals), data->tables + i)) {
+      // log error, return failure
+      pwasm_env_fail(env, "restore table failed");
+      return false;
+    }
+
+    // rebuild element types, check for error
+    if (!pwasm_new_interp_table_sync_types(env, table, funcs)) {
+      // return failure
+      return false;
+    }
+  }
 
-      break;
-    case PWASM_OP_I64_REM_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+  // return success
+  return true;
+}
 
-        if (!b) {
-          // log error, return failure
-          pwasm_env_fail(frame.env, "i64.rem_u: division by zero");
-          return false;
-        }
+/*
+ * Convert an internal global ID to an externally visible global handle.
+ *
+ * Returns 0 on error.
+ */
+static uint32_t
+pwasm_new_interp_mod_get_global_index(
+  pwasm_env_t * const env,
+  pwasm_new_interp_mod_t * const mod,
+  uint32_t id
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_vec_t * const vec = &(interp->u32s);
+  const uint32_t * const u32s = ((uint32_t*) pwasm_vec_get_data(vec)) + mod->globals.ofs;
+  return (id < mod->globals.len) ? u32s[id] + 1 : 0;
+}
 
-        stack->ptr[stack->pos - 2].i64 = a % b;
-        stack->pos--;
-      }
+/**
+ * Count a call of function +func_ofs+ of module +interp_mod+ in a
+ * tiered JIT environment, and compile the function with the JIT
+ * compiler once its call and loop counter reaches the tier-up
+ * threshold.
+ *
+ * Returns false if the function could not be compiled.
+ */
+static bool
+pwasm_new_interp_jit_count(
+  pwasm_env_t * const env,
+  pwasm_new_interp_mod_t * const interp_mod,
+  const uint32_t func_ofs
+) {
+  if (interp_mod->fns[func_ofs].ptr) {
+    // already compiled, return success
+    return true;
+  }
 
-      break;
-    case PWASM_OP_I64_AND:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a & b;
-        stack->pos--;
-      }
+  // count call
+  uint32_t * const hits = interp_mod->hits + func_ofs;
+  if (*hits < UINT32_MAX) {
+    (*hits)++;
+  }
 
-      break;
-    case PWASM_OP_I64_OR:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a | b;
-        stack->pos--;
-      }
+  if (*hits < env->cbs->jit_threshold) {
+    // function is not hot yet, return success
+    return true;
+  }
 
-      break;
-    case PWASM_OP_I64_XOR:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].i64 = a ^ b;
-        stack->pos--;
-      }
+  // get mod ID
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t * const rows = pwasm_vec_get_data(&(interp->mods));
+  const uint32_t mod_id = (interp_mod - rows) + 1;
 
-      break;
-    case PWASM_OP_I64_SHL:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
-        stack->ptr[stack->pos - 2].i64 = a << b;
-        stack->pos--;
-      }
+  // compile function, return result
+  D("tier up: mod_id = %u, func_ofs = %u, hits = %u", mod_id, func_ofs, *hits);
+  return pwasm_jit_compile(env->cbs->jit, interp_mod->fns + func_ofs, env, mod_id, func_ofs);
+}
 
-      break;
-    case PWASM_OP_I64_SHR_S:
-      {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
-        stack->ptr[stack->pos - 2].i64 = a >> b;
-        stack->pos--;
-      }
+/**
+ * Call compiled function +func_ofs+ of module +interp_mod+ with the
+ * parameters at the top of the value stack.
+ *
+ * Uses the same value stack layout as interpreted functions: the
+ * locals are cleared and placed after the parameters, and the results
+ * are moved to the position of the first parameter when the function
+ * returns.
+ */
+static bool
+pwasm_new_interp_jit_call(
+  pwasm_env_t * const env,
+  pwasm_new_interp_mod_t * const interp_mod,
+  const uint32_t func_ofs
+) {
+  pwasm_stack_t * const stack = env->stack;
+  const pwasm_mod_t * const mod = interp_mod->mod;
+  const pwasm_type_t type = mod->types[mod->funcs[func_ofs]];
 
-      break;
-    case PWASM_OP_I64_SHR_U:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
-        stack->ptr[stack->pos - 2].i64 = a >> b;
-        stack->pos--;
-      }
+  // check stack position (e.g. missing parameters)
+  if (stack->pos < type.params.len) {
+    // log error, return failure
+    pwasm_env_fail(env, "missing function parameters");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I64_ROTL:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
-        stack->ptr[stack->pos - 2].i64 = (a << b) | (a >> (64 - b));
-        stack->pos--;
-      }
+  // check value stack space for locals and operands
+  if (stack->pos + interp_mod->stack_sizes[func_ofs] > stack->len) {
+    // log error, return failure
+    pwasm_env_fail(env, "value stack overflow");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_I64_ROTR:
-      {
-        const uint64_t a = stack->ptr[stack->pos - 2].i64;
-        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
-        stack->ptr[stack->pos - 2].i64 = (a << (64 - b)) | (a >> b);
-        stack->pos--;
-      }
+  // check call depth (compiled code recurses on the host stack)
+  if (env->call_depth >= pwasm_env_get_max_call_depth(env)) {
+    // log error, return failure
+    pwasm_env_fail(env, "call stack exhausted");
+    return false;
+  }
 
-      break;
-    case PWASM_OP_F32_ABS:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = fabsf(a);
-      }
+  // get number of local slots and total frame size
+  const size_t max_locals = mod->codes[func_ofs].max_locals;
+  const size_t frame_size = mod->codes[func_ofs].frame_size;
+  if (max_locals > 0) {
+    // clear local slots
+    memset(stack->ptr + stack->pos, 0, sizeof(pwasm_val_t) * max_locals);
+  }
 
-      break;
-    case PWASM_OP_F32_NEG:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = -a;
-      }
+  // skip past locals, get base of frame
+  stack->pos += max_locals;
+  const size_t dst_pos = stack->pos - frame_size;
 
-      break;
-    case PWASM_OP_F32_CEIL:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = ceilf(a);
-      }
+  union {
+    const void *ptr_void;
+    bool (*ptr_func)(pwasm_env_t *, const pwasm_mod_t *, uint32_t);
+  } pun = { .ptr_void = interp_mod->fns[func_ofs].ptr };
 
-      break;
-    case PWASM_OP_F32_FLOOR:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = floorf(a);
-      }
+  // call compiled function, check for error
+  env->call_depth++;
+  const bool ok = pun.ptr_func(env, mod, func_ofs);
+  env->call_depth--;
+  if (!ok) {
+    // return failure
+    return false;
+  }
 
-      break;
-    case PWASM_OP_F32_TRUNC:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = truncf(a);
-      }
+  // copy results, update stack position
+  const size_t src_pos = stack->pos - type.results.len;
+  memmove(stack->ptr + dst_pos, stack->ptr + src_pos, sizeof(pwasm_val_t) * type.results.len);
+  stack->pos = dst_pos + type.results.len;
 
-      break;
-    case PWASM_OP_F32_NEAREST:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = roundf(a);
-      }
+  // return success
+  return true;
+}
 
-      break;
-    case PWASM_OP_F32_SQRT:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f32 = sqrtf(a);
-      }
+// forward references
+static bool pwasm_new_interp_enter_func(pwasm_env_t *, pwasm_new_interp_mod_t *, uint32_t, pwasm_new_interp_frame_t *, pwasm_slice_t *);
+static bool pwasm_new_interp_get_indirect_func(pwasm_new_interp_frame_t, pwasm_inst_t, uint32_t, uint32_t *);
 
-      break;
-    case PWASM_OP_F32_ADD:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = a + b;
-        stack->pos--;
-      }
+//
+// threaded dispatch: when compiled with GCC or Clang, the interpreter
+// jumps from the end of each instruction handler directly to the
+// handler for the next instruction (computed goto) instead of going
+// back through the loop and switch.  define PWASM_NO_THREADED_DISPATCH
+// to use plain switch dispatch instead.
+//
+#if defined(__GNUC__) && !defined(PWASM_NO_THREADED_DISPATCH)
+#define PWASM_NEW_INTERP_THREADED
+#endif /* __GNUC__ && !PWASM_NO_THREADED_DISPATCH */
+
+#ifdef PWASM_NEW_INTERP_THREADED
+// instruction handler: case label and dispatch label
+#define PWASM_NEW_INTERP_OP(name) case PWASM_OP_ ## name: op_ ## name
+
+// dispatch next instruction
+#define PWASM_NEW_INTERP_NEXT() do { \
+  if (++i >= expr.len) { \
+    goto done; \
+  } \
+  in = insts[i]; \
+  goto *PWASM_NEW_INTERP_OPS[in.op]; \
+} while (0)
+
+// handler labels, in opcode order (used to build the dispatch table)
+#define PWASM_NEW_INTERP_OP_LABELS \
+  PWASM_NEW_INTERP_OP_LABEL(UNREACHABLE) \
+  PWASM_NEW_INTERP_OP_LABEL(NOP) \
+  PWASM_NEW_INTERP_OP_LABEL(BLOCK) \
+  PWASM_NEW_INTERP_OP_LABEL(LOOP) \
+  PWASM_NEW_INTERP_OP_LABEL(IF) \
+  PWASM_NEW_INTERP_OP_LABEL(ELSE) \
+  PWASM_NEW_INTERP_OP_LABEL(END) \
+  PWASM_NEW_INTERP_OP_LABEL(BR) \
+  PWASM_NEW_INTERP_OP_LABEL(BR_IF) \
+  PWASM_NEW_INTERP_OP_LABEL(BR_TABLE) \
+  PWASM_NEW_INTERP_OP_LABEL(RETURN) \
+  PWASM_NEW_INTERP_OP_LABEL(CALL) \
+  PWASM_NEW_INTERP_OP_LABEL(CALL_INDIRECT) \
+  PWASM_NEW_INTERP_OP_LABEL(DROP) \
+  PWASM_NEW_INTERP_OP_LABEL(SELECT) \
+  PWASM_NEW_INTERP_OP_LABEL(LOCAL_GET) \
+  PWASM_NEW_INTERP_OP_LABEL(LOCAL_SET) \
+  PWASM_NEW_INTERP_OP_LABEL(LOCAL_TEE) \
+  PWASM_NEW_INTERP_OP_LABEL(GLOBAL_GET) \
+  PWASM_NEW_INTERP_OP_LABEL(GLOBAL_SET) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LOAD) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_LOAD) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_LOAD) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LOAD8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LOAD8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LOAD16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LOAD16_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD16_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LOAD32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_STORE) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_STORE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_STORE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_STORE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_STORE8) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_STORE16) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_STORE8) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_STORE16) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_STORE32) \
+  PWASM_NEW_INTERP_OP_LABEL(MEMORY_SIZE) \
+  PWASM_NEW_INTERP_OP_LABEL(MEMORY_GROW) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_CONST) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_CONST) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CONST) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CONST) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_EQZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_GT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_GT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_LE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_GE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_GE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EQZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_GT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_GT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_LE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_GE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_GE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_LT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_GT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_LE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_GE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_LT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_GT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_LE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_GE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_CLZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_CTZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_POPCNT) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_DIV_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_DIV_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_REM_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_REM_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_AND) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_OR) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_XOR) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_ROTL) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_ROTR) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_CLZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_CTZ) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_POPCNT) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_DIV_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_DIV_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_REM_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_REM_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_AND) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_OR) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_XOR) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_ROTL) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_ROTR) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CEIL) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_FLOOR) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_TRUNC) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_NEAREST) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_SQRT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_DIV) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_MIN) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_MAX) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_COPYSIGN) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CEIL) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_FLOOR) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_TRUNC) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_NEAREST) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_SQRT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_DIV) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_MIN) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_MAX) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_COPYSIGN) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_WRAP_I64) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_F32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_F32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_F64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_F64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EXTEND_I32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EXTEND_I32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_F32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_F32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_F64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_F64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CONVERT_I32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CONVERT_I32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CONVERT_I64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_CONVERT_I64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_DEMOTE_F64) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CONVERT_I32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CONVERT_I32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CONVERT_I64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_CONVERT_I64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_PROMOTE_F32) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_REINTERPRET_F32) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_REINTERPRET_F64) \
+  PWASM_NEW_INTERP_OP_LABEL(F32_REINTERPRET_I32) \
+  PWASM_NEW_INTERP_OP_LABEL(F64_REINTERPRET_I64) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_EXTEND8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_EXTEND16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EXTEND8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EXTEND16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_EXTEND32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_SAT_F32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_SAT_F32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_SAT_F64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32_TRUNC_SAT_F64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_SAT_F32_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_SAT_F32_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_SAT_F64_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64_TRUNC_SAT_F64_U) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_LOAD) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LOAD8X8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LOAD8X8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LOAD16X4_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LOAD16X4_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_LOAD32X2_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_LOAD32X2_U) \
+  PWASM_NEW_INTERP_OP_LABEL(V8X16_LOAD_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(V16X8_LOAD_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(V32X4_LOAD_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(V64X2_LOAD_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_STORE) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_CONST) \
+  PWASM_NEW_INTERP_OP_LABEL(V8X16_SHUFFLE) \
+  PWASM_NEW_INTERP_OP_LABEL(V8X16_SWIZZLE) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_SPLAT) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_EXTRACT_LANE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_EXTRACT_LANE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_EXTRACT_LANE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_EXTRACT_LANE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_EXTRACT_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_EXTRACT_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_EXTRACT_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_EXTRACT_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_REPLACE_LANE) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_LT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_LT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_GT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_GT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_LE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_LE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_GE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_GE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_GT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_GT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_LE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_GE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_GE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_GT_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_GT_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_LE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_GE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_GE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_LT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_GT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_LE) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_GE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_EQ) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_NE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_LT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_GT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_LE) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_GE) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_NOT) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_AND) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_ANDNOT) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_OR) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_XOR) \
+  PWASM_NEW_INTERP_OP_LABEL(V128_BITSELECT) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ANY_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ALL_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_NARROW_I16X8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_NARROW_I16X8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ADD_SATURATE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_ADD_SATURATE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SUB_SATURATE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_SUB_SATURATE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_MIN_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_MIN_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_MAX_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_MAX_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I8X16_AVGR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ANY_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ALL_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_NARROW_I32X4_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_NARROW_I32X4_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_WIDEN_LOW_I8X16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_WIDEN_HIGH_I8X16_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_WIDEN_LOW_I8X16_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_WIDEN_HIGH_I8X16_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ADD_SATURATE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_ADD_SATURATE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SUB_SATURATE_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_SUB_SATURATE_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_MIN_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_MIN_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_MAX_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_MAX_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I16X8_AVGR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_ANY_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_ALL_TRUE) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_WIDEN_LOW_I16X8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_WIDEN_HIGH_I16X8_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_WIDEN_LOW_I16X8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_WIDEN_HIGH_I16X8_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_MIN_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_MIN_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_MAX_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_MAX_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_SHL) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_SHR_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_SHR_U) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(I64X2_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_SQRT) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_DIV) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_MIN) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_MAX) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_ABS) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_NEG) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_SQRT) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_ADD) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_SUB) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_MUL) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_DIV) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_MIN) \
+  PWASM_NEW_INTERP_OP_LABEL(F64X2_MAX) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_TRUNC_SAT_F32X4_S) \
+  PWASM_NEW_INTERP_OP_LABEL(I32X4_TRUNC_SAT_F32X4_U) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_CONVERT_I32X4_S) \
+  PWASM_NEW_INTERP_OP_LABEL(F32X4_CONVERT_I32X4_U)
+
+// labels as values and computed goto are GNU extensions
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#else
+// instruction handler: case label
+#define PWASM_NEW_INTERP_OP(name) case PWASM_OP_ ## name
+
+// dispatch next instruction (via loop and switch)
+#define PWASM_NEW_INTERP_NEXT() break
+#endif /* PWASM_NEW_INTERP_THREADED */
+
+// apply v128 kernel to the top two values of the stack
+#define PWASM_NEW_INTERP_V128_BINOP(name) do { \
+  pwasm_v128_t * const vals = &(stack->ptr[stack->pos - 2].v128); \
+  v128[PWASM_V128_KERNEL_ ## name](vals, vals, &(stack->ptr[stack->pos - 1].v128)); \
+  stack->pos--; \
+} while (0)
+
+// apply v128 kernel to the top value of the stack
+#define PWASM_NEW_INTERP_V128_UNOP(name) do { \
+  pwasm_v128_t * const val = &(stack->ptr[stack->pos - 1].v128); \
+  v128[PWASM_V128_KERNEL_ ## name](val, val, val); \
+} while (0)
 
-      break;
-    case PWASM_OP_F32_SUB:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = a - b;
-        stack->pos--;
-      }
+/**
+ * Evaluate the expression +expr+ in the given frame.
+ *
+ * Calls to interpreted functions do not recurse: the state of the
+ * caller is pushed to the interpreter call stack, execution continues
+ * at the first instruction of the callee, and the state of the caller
+ * is popped when the callee returns.  Calls to native functions are
+ * made directly.
+ *
+ * Returns `true` on success or `false` on error.  On error the call
+ * stack may contain entries pushed by this function; the caller is
+ * responsible for truncating it (see pwasm_new_interp_call_func()).
+ */
+static bool
+pwasm_new_interp_eval_expr(
+  pwasm_new_interp_frame_t frame,
+  pwasm_slice_t expr
+) {
+  pwasm_stack_t * const stack = frame.env->stack;
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+  const pwasm_inst_t *insts = frame.mod->mod->insts + expr.ofs;
+  const pwasm_new_interp_ctrl_t *ctrls = frame.mod->ctrls + expr.ofs;
+  const pwasm_v128_kernel_t * const v128 = interp->v128;
+
+  // base of value stack (block heights are relative to this position)
+  size_t base = frame.locals.ofs + frame.locals.len;
+
+  // call stack depth on entry (entries above this depth belong to
+  // callers in this invocation)
+  const size_t entry_depth = pwasm_vec_get_size(&(interp->calls));
+
+  // metadata for the branch being taken
+  pwasm_new_interp_ctrl_t br;
+
+  // callee module and function offset of the call being made
+  pwasm_new_interp_mod_t *call_mod = NULL;
+  uint32_t call_ofs = 0;
+
+#ifdef PWASM_NEW_INTERP_THREADED
+  // instruction handlers, indexed by opcode
+  static const void * const PWASM_NEW_INTERP_OPS[] = {
+#define PWASM_NEW_INTERP_OP_LABEL(name) [PWASM_OP_ ## name] = &&op_ ## name,
+PWASM_NEW_INTERP_OP_LABELS
+#undef PWASM_NEW_INTERP_OP_LABEL
+  };
+#endif /* PWASM_NEW_INTERP_THREADED */
 
-      break;
-    case PWASM_OP_F32_MUL:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = a * b;
-        stack->pos--;
-      }
+  // D("expr = { .ofs = %zu, .len = %zu }, num_insts = %zu", expr.ofs, expr.len, frame.mod->num_insts);
 
-      break;
-    case PWASM_OP_F32_DIV:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = a / b;
-        stack->pos--;
-      }
+  size_t i = 0;
+  pwasm_inst_t in;
+  for (i = 0; i < expr.len; i++) {
+    in = insts[i];
+    // D("0x%02X %s", in.op, pwasm_op_get_name(in.op));
 
-      break;
-    case PWASM_OP_F32_MIN:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = fminf(a, b);
-        stack->pos--;
-      }
+  #ifdef PWASM_NEW_INTERP_THREADED
+    // dispatch first instruction (and instructions after a handler
+    // which leaves the switch early)
+    goto *PWASM_NEW_INTERP_OPS[in.op];
+  #endif /* PWASM_NEW_INTERP_THREADED */
+
+    switch (in.op) {
+    PWASM_NEW_INTERP_OP(UNREACHABLE):
+      // FIXME: raise trap?
+      pwasm_env_fail(frame.env, "unreachable instruction reached");
+      return false;
+    PWASM_NEW_INTERP_OP(NOP):
+    PWASM_NEW_INTERP_OP(BLOCK):
+    PWASM_NEW_INTERP_OP(LOOP):
+    PWASM_NEW_INTERP_OP(END):
+      // do nothing (the operands of a validated block are already at
+      // the top of the value stack, so entering or leaving a block
+      // does not need to move any values)
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(IF):
+      // pop condition, skip to else/end if condition is false
+      if (!stack->ptr[--stack->pos].i32) {
+        i += ctrls[i].target;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(ELSE):
+      // skip past end inst
+      i += ctrls[i].target;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(BR_IF):
+      if (!stack->ptr[--stack->pos].i32) {
+        // branch not taken
+        PWASM_NEW_INTERP_NEXT();
+      }
+
+      // branch taken
+      br = ctrls[i];
+      goto branch;
+    PWASM_NEW_INTERP_OP(BR):
+      // get precomputed branch target, arity, and height
+      br = ctrls[i];
+      goto branch;
+    PWASM_NEW_INTERP_OP(BR_TABLE):
+      {
+        // get value from stack and branch labels
+        const uint32_t val = stack->ptr[--stack->pos].i32;
+        const pwasm_inst_slice_t labels = in.v_br_table;
 
-      break;
-    case PWASM_OP_F32_MAX:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = fmaxf(a, b);
-        stack->pos--;
+        // get precomputed label target, arity, and height
+        br = frame.mod->ctrls[ctrls[i].target + MIN(val, labels.len - 1)];
       }
 
-      break;
-    case PWASM_OP_F32_COPYSIGN:
-      {
-        const float a = stack->ptr[stack->pos - 2].f32;
-        const float b = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].f32 = copysignf(a, b);
-        stack->pos--;
+    branch:
+      if (br.target == PWASM_NEW_INTERP_CTRL_RETURN) {
+        // branch to function body, return success
+        goto done;
       }
 
-      break;
-    case PWASM_OP_F64_ABS:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = fabs(a);
+      if (br.target < i && frame.hits && *frame.hits < UINT32_MAX) {
+        // count loop back-edge (tiered JIT environments only)
+        (*frame.hits)++;
       }
 
-      break;
-    case PWASM_OP_F64_NEG:
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = -a;
-      }
+        // move branch values to base of target block
+        const size_t dst = base + br.height;
+        for (size_t j = 0; j < br.num_results; j++) {
+          stack->ptr[dst + j] = stack->ptr[stack->pos - br.num_results + j];
+        }
 
-      break;
-    case PWASM_OP_F64_CEIL:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = ceil(a);
+        // reset value stack
+        stack->pos = dst + br.num_results;
+
+        // jump to target (loop start or block end)
+        i = br.target;
       }
 
-      break;
-    case PWASM_OP_F64_FLOOR:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(RETURN):
+      // return success
+      goto done;
+    PWASM_NEW_INTERP_OP(CALL):
+      // get callee module and function offset
+      call_mod = frame.mod;
+      call_ofs = in.v_index;
+      goto enter;
+    PWASM_NEW_INTERP_OP(CALL_INDIRECT):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = floor(a);
+        // pop element index from value stack
+        const uint32_t elem_ofs = stack->ptr[--stack->pos].i32;
+
+        // check element and get interpreter function offset, check for error
+        uint32_t func_ofs;
+        if (!pwasm_new_interp_get_indirect_func(frame, in, elem_ofs, &func_ofs)) {
+          // return failure
+          return false;
+        }
+
+        // get function and module
+        const pwasm_new_interp_func_t func = ((pwasm_new_interp_func_t*) pwasm_vec_get_data(&(interp->funcs)))[func_ofs];
+        pwasm_new_interp_mod_t * const mod = ((pwasm_new_interp_mod_t*) pwasm_vec_get_data(&(interp->mods))) + func.mod_ofs;
+
+        if (mod->type != PWASM_NEW_INTERP_MOD_TYPE_MOD) {
+          // call native function, check for error
+          if (!pwasm_new_interp_call(frame.env, func_ofs + 1)) {
+            // return failure
+            return false;
+          }
+
+          PWASM_NEW_INTERP_NEXT();
+        }
+
+        // get callee module and function offset
+        call_mod = mod;
+        call_ofs = func.func_ofs;
       }
 
-      break;
-    case PWASM_OP_F64_TRUNC:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = trunc(a);
+    enter:
+      if (call_mod->fns) {
+        // count call and compile hot function (tiered JIT environments
+        // only), check for error
+        if (!pwasm_new_interp_jit_count(frame.env, call_mod, call_ofs)) {
+          // return failure
+          return false;
+        }
+
+        if (call_mod->fns[call_ofs].ptr) {
+          // call compiled function, check for error
+          if (!pwasm_new_interp_jit_call(frame.env, call_mod, call_ofs)) {
+            // return failure
+            return false;
+          }
+
+          PWASM_NEW_INTERP_NEXT();
+        }
       }
 
-      break;
-    case PWASM_OP_F64_NEAREST:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = round(a);
+      // check call depth
+      if (pwasm_vec_get_size(&(interp->calls)) >= interp->max_depth) {
+        // log error, return failure
+        pwasm_env_fail(frame.env, "call stack exhausted");
+        return false;
       }
 
-      break;
-    case PWASM_OP_F64_SQRT:
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f64 = sqrt(a);
+        // push caller state, check for error
+        const pwasm_new_interp_call_t call = { frame, expr, i };
+        if (!pwasm_vec_push(&(interp->calls), 1, &call, NULL)) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "push call stack entry failed");
+          return false;
+        }
       }
 
-      break;
-    case PWASM_OP_F64_ADD:
-      {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = a + b;
-        stack->pos--;
+      // enter callee, check for error
+      if (!pwasm_new_interp_enter_func(frame.env, call_mod, call_ofs, &frame, &expr)) {
+        // return failure
+        return false;
       }
 
-      break;
-    case PWASM_OP_F64_SUB:
+      // switch to callee body, start at first instruction (the
+      // dispatch increments i before fetching the next instruction)
+      insts = frame.mod->mod->insts + expr.ofs;
+      ctrls = frame.mod->ctrls + expr.ofs;
+      base = frame.locals.ofs + frame.locals.len;
+      i = SIZE_MAX;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(DROP):
+      stack->pos--;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(SELECT):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = a - b;
-        stack->pos--;
+        const size_t ofs = stack->ptr[stack->pos - 1].i32 ? 3 : 2;
+        stack->ptr[stack->pos - 3] = stack->ptr[stack->pos - ofs];
+        stack->pos -= 2;
       }
 
-      break;
-    case PWASM_OP_F64_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(LOCAL_GET):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = a * b;
-        stack->pos--;
+        // get local index
+        // (note: checked in pwasm_checker_get_local_type())
+        const uint32_t id = in.v_index;
+
+        // push local value
+        stack->ptr[stack->pos++] = stack->ptr[frame.locals.ofs + id];
       }
 
-      break;
-    case PWASM_OP_F64_DIV:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(LOCAL_SET):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = a / b;
+        // get local index
+        // (note: checked in pwasm_checker_get_local_type())
+        const uint32_t id = in.v_index;
+
+        // set local value, pop stack
+        stack->ptr[frame.locals.ofs + id] = stack->ptr[stack->pos - 1];
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_MIN:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(LOCAL_TEE):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = fmin(a, b);
-        stack->pos--;
+        // get local index
+        // (note: checked in pwasm_checker_get_local_type())
+        const uint32_t id = in.v_index;
+
+        // set local value, keep stack (tee)
+        stack->ptr[frame.locals.ofs + id] = stack->ptr[stack->pos - 1];
       }
 
-      break;
-    case PWASM_OP_F64_MAX:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(GLOBAL_GET):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = fmax(a, b);
-        stack->pos--;
+        // get global index
+        const uint32_t id = pwasm_new_interp_mod_get_global_index(frame.env, frame.mod, in.v_index);
+
+        // get global value, check for error
+        pwasm_val_t val;
+        if (!pwasm_env_get_global(frame.env, id, &val)) {
+          // return failure
+          return false;
+        }
+
+        // push global value
+        stack->ptr[stack->pos++] = val;
       }
 
-      break;
-    case PWASM_OP_F64_COPYSIGN:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(GLOBAL_SET):
       {
-        const double a = stack->ptr[stack->pos - 2].f64;
-        const double b = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].f64 = copysign(a, b);
+        // get global index
+        const uint32_t id = pwasm_new_interp_mod_get_global_index(frame.env, frame.mod, in.v_index);
+
+        // set global value, check for error
+        if (!pwasm_env_set_global(frame.env, id, PWASM_PEEK(stack, 0))) {
+          // return failure
+          return false;
+        }
+
+        // pop stack
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_WRAP_I64:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_LOAD):
+    PWASM_NEW_INTERP_OP(I64_LOAD):
+    PWASM_NEW_INTERP_OP(F32_LOAD):
+    PWASM_NEW_INTERP_OP(F64_LOAD):
+    PWASM_NEW_INTERP_OP(I32_LOAD8_S):
+    PWASM_NEW_INTERP_OP(I32_LOAD8_U):
+    PWASM_NEW_INTERP_OP(I32_LOAD16_S):
+    PWASM_NEW_INTERP_OP(I32_LOAD16_U):
+    PWASM_NEW_INTERP_OP(I64_LOAD8_S):
+    PWASM_NEW_INTERP_OP(I64_LOAD8_U):
+    PWASM_NEW_INTERP_OP(I64_LOAD16_S):
+    PWASM_NEW_INTERP_OP(I64_LOAD16_U):
+    PWASM_NEW_INTERP_OP(I64_LOAD32_S):
+    PWASM_NEW_INTERP_OP(I64_LOAD32_U):
+    PWASM_NEW_INTERP_OP(V128_LOAD):
       {
-        const uint64_t a = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
-      }
+        // get offset operand
+        const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
 
-      break;
-    case PWASM_OP_I32_TRUNC_F32_S:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i32 = (int32_t) a;
-      }
+        // load value, check for error
+        pwasm_val_t val;
+        if (!pwasm_env_mem_load(frame.env, frame.mem_id, in, ofs, &val)) {
+          return false;
+        }
 
-      break;
-    case PWASM_OP_I32_TRUNC_F32_U:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
+        // pop ofs operand, push val
+        stack->ptr[stack->pos - 1] = val;
       }
 
-      break;
-    case PWASM_OP_I32_TRUNC_F64_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_STORE):
+    PWASM_NEW_INTERP_OP(I64_STORE):
+    PWASM_NEW_INTERP_OP(F32_STORE):
+    PWASM_NEW_INTERP_OP(F64_STORE):
+    PWASM_NEW_INTERP_OP(I32_STORE8):
+    PWASM_NEW_INTERP_OP(I32_STORE16):
+    PWASM_NEW_INTERP_OP(I64_STORE8):
+    PWASM_NEW_INTERP_OP(I64_STORE16):
+    PWASM_NEW_INTERP_OP(I64_STORE32):
+    PWASM_NEW_INTERP_OP(V128_STORE):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i32 = (int32_t) a;
-      }
+        // get offset operand and value
+        const uint32_t ofs = stack->ptr[stack->pos - 2].i32;
+        const pwasm_val_t val = stack->ptr[stack->pos - 1];
+        stack->pos -= 2;
 
-      break;
-    case PWASM_OP_I32_TRUNC_F64_U:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
+        // store value, check for error
+        if (!pwasm_env_mem_store(frame.env, frame.mem_id, in, ofs, val)) {
+          return false;
+        }
       }
 
-      break;
-    case PWASM_OP_I64_EXTEND_I32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(MEMORY_SIZE):
       {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
-      }
+        // get memory size, check for error
+        uint32_t size;
+        if (!pwasm_env_mem_size(frame.env, frame.mem_id, &size)) {
+          return false;
+        }
 
-      break;
-    case PWASM_OP_I64_EXTEND_I32_U:
-      {
-        const uint32_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
+        // push size to stack
+        stack->ptr[stack->pos++].i32 = size;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_F32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(MEMORY_GROW):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
-      }
+        // get grow operand
+        const uint32_t grow = stack->ptr[stack->pos - 1].i32;
 
-      break;
-    case PWASM_OP_I64_TRUNC_F32_U:
-      {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
+        // grow memory, check for error
+        uint32_t size;
+        if (!pwasm_env_mem_grow(frame.env, frame.mem_id, grow, &size)) {
+          return false;
+        }
+
+        // pop operand, push result
+        stack->ptr[stack->pos - 1].i32 = size;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_F64_S:
-      {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
-      }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_CONST):
+      stack->ptr[stack->pos++].i32 = in.v_i32;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_CONST):
+      stack->ptr[stack->pos++].i64 = in.v_i64;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CONST):
+      stack->ptr[stack->pos++].f32 = in.v_f32;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CONST):
+      stack->ptr[stack->pos++].f64 = in.v_f64;
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_EQZ):
+      stack->ptr[stack->pos - 1].i32 = (stack->ptr[stack->pos - 1].i32 == 0);
 
-      break;
-    case PWASM_OP_I64_TRUNC_F64_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_EQ):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a == b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_CONVERT_I32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_NE):
       {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].f32 = (float) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a != b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_CONVERT_I32_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_LT_S):
       {
-        const uint32_t a = (uint32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].f32 = (float) a;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_CONVERT_I64_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_LT_U):
       {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].f32 = (float) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_CONVERT_I64_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_GT_S):
       {
-        const uint64_t a = (uint64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].f32 = (float) a;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_DEMOTE_F64:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_GT_U):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].f32 = (float) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_CONVERT_I32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_LE_S):
       {
-        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].f64 = (double) a;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_CONVERT_I32_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_LE_U):
       {
-        const uint32_t a = (uint32_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].f64 = (double) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_CONVERT_I64_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_GE_S):
       {
-        const int64_t a = (int64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].f64 = (double) a;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_CONVERT_I64_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_GE_U):
       {
-        const uint64_t a = (uint64_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].f64 = (double) a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_PROMOTE_F32:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EQZ):
+      stack->ptr[stack->pos - 1].i32 = (stack->ptr[stack->pos - 1].i64 == 0);
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EQ):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].f64 = a;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a == b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_REINTERPRET_F32:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_NE):
       {
-        const union {
-          uint32_t i32;
-          float f32;
-        } v = { .f32 = stack->ptr[stack->pos - 1].f32 };
-        stack->ptr[stack->pos - 1].i32 = v.i32;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a != b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_REINTERPRET_F64:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_LT_S):
       {
-        const union {
-          uint64_t i64;
-          double f64;
-        } v = { .f64 = stack->ptr[stack->pos - 1].f64 };
-        stack->ptr[stack->pos - 1].i64 = v.i64;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32_REINTERPRET_I32:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_LT_U):
       {
-        const union {
-          uint32_t i32;
-          float f32;
-        } v = { .i32 = stack->ptr[stack->pos - 1].i32 };
-        stack->ptr[stack->pos - 1].f32 = v.f32;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64_REINTERPRET_I64:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_GT_S):
       {
-        const union {
-          uint64_t i64;
-          double f64;
-        } v = { .i64 = stack->ptr[stack->pos - 1].i64 };
-        stack->ptr[stack->pos - 1].f64 = v.f64;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_EXTEND8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_GT_U):
       {
-        const int32_t val = (int8_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) val;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_EXTEND16_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_LE_S):
       {
-        const int32_t val = (int16_t) stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) val;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_EXTEND8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_LE_U):
       {
-        const int64_t val = (int8_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_EXTEND16_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_GE_S):
       {
-        const int64_t val = (int16_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_EXTEND32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_GE_U):
       {
-        const int64_t val = (int32_t) stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_TRUNC_SAT_F32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_EQ):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i32 = (int32_t) CLAMP(a, INT32_MIN, INT32_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a == b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_TRUNC_SAT_F32_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_NE):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) CLAMP(a, 0, UINT32_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a != b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_TRUNC_SAT_F64_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_LT):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i32 = (int32_t) CLAMP(a, INT32_MIN, INT32_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32_TRUNC_SAT_F64_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_GT):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i32 = (uint32_t) CLAMP(a, 0, UINT32_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_SAT_F32_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_LE):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i64 = (int64_t) CLAMP(a, INT64_MIN, INT64_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_SAT_F32_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_GE):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) CLAMP(a, 0, UINT64_MAX);
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_SAT_F64_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_EQ):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i64 = (int64_t) CLAMP(a, INT64_MIN, INT64_MAX);
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a == b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64_TRUNC_SAT_F64_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_NE):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].i64 = (uint64_t) CLAMP(a, 0, UINT64_MAX);
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a != b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_V128_CONST:
-      stack->ptr[stack->pos++].v128 = in.v_v128;
-
-      break;
-    case PWASM_OP_I8X16_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_LT):
       {
-        const uint8_t a = stack->ptr[stack->pos - 1].i32;
-        memset(stack->ptr[stack->pos - 1].v128.i8, a, 16);
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a < b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_EXTRACT_LANE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_GT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i32 = (int8_t) a.i8[in.v_index];
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a > b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_EXTRACT_LANE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_LE):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i32 = a.i8[in.v_index];
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a <= b);
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_GE):
       {
-        const uint8_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].v128.i8[in.v_index] = a;
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].i32 = (a >= b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_CLZ):
       {
-        const uint16_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].v128.i16[0] = a;
-        stack->ptr[stack->pos - 1].v128.i16[1] = a;
-        stack->ptr[stack->pos - 1].v128.i16[2] = a;
-        stack->ptr[stack->pos - 1].v128.i16[3] = a;
-        stack->ptr[stack->pos - 1].v128.i16[4] = a;
-        stack->ptr[stack->pos - 1].v128.i16[5] = a;
-        stack->ptr[stack->pos - 1].v128.i16[6] = a;
-        stack->ptr[stack->pos - 1].v128.i16[7] = a;
+        const uint32_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i32 = a ? __builtin_clz(a) : 32;
       }
 
-      break;
-    case PWASM_OP_I16X8_EXTRACT_LANE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_CTZ):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i32 = (int16_t) a.i16[in.v_index];
+        const uint32_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i32 = a ? __builtin_ctz(a) : 32;
       }
 
-      break;
-    case PWASM_OP_I16X8_EXTRACT_LANE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_POPCNT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i32 = a.i16[in.v_index];
+        const int val = __builtin_popcount(stack->ptr[stack->pos - 1].i32);
+        stack->ptr[stack->pos - 1].i32 = val;
       }
 
-      break;
-    case PWASM_OP_I16X8_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_ADD):
       {
-        const uint16_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].v128.i16[in.v_index] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a + b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_SUB):
       {
-        const uint32_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 1].v128.i32[0] = a;
-        stack->ptr[stack->pos - 1].v128.i32[1] = a;
-        stack->ptr[stack->pos - 1].v128.i32[2] = a;
-        stack->ptr[stack->pos - 1].v128.i32[3] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a - b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_EXTRACT_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_MUL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i32 = a.i32[in.v_index];
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a * b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_DIV_S):
       {
-        const uint32_t a = stack->ptr[stack->pos - 1].i32;
-        stack->ptr[stack->pos - 2].v128.i32[in.v_index] = a;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i32.div_s: division by zero");
+          return false;
+        }
+
+        stack->ptr[stack->pos - 2].i32 = a / b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_DIV_U):
       {
-        const uint64_t a = stack->ptr[stack->pos - 1].i64;
-        D("a = 0x%016lx", a);
-        stack->ptr[stack->pos - 1].v128.i64[0] = a;
-        stack->ptr[stack->pos - 1].v128.i64[1] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i32.div_u: division by zero");
+          return false;
+        }
+
+        stack->ptr[stack->pos - 2].i32 = a / b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_EXTRACT_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_REM_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].i64 = a.i64[in.v_index];
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const int32_t b = (int32_t) stack->ptr[stack->pos - 1].i32;
+
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i32.rem_s: division by zero");
+          return false;
+        }
+
+        stack->ptr[stack->pos - 2].i32 = a % b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_REM_U):
       {
-        const uint64_t a = stack->ptr[stack->pos - 1].i64;
-        stack->ptr[stack->pos - 2].v128.i64[in.v_index] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i32.rem_u: division by zero");
+          return false;
+        }
+
+        stack->ptr[stack->pos - 2].i32 = a % b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_AND):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 1].v128.f32[0] = a;
-        stack->ptr[stack->pos - 1].v128.f32[1] = a;
-        stack->ptr[stack->pos - 1].v128.f32[2] = a;
-        stack->ptr[stack->pos - 1].v128.f32[3] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a & b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_EXTRACT_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_OR):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].f32 = a.f32[in.v_index];
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a | b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_XOR):
       {
-        const float a = stack->ptr[stack->pos - 1].f32;
-        stack->ptr[stack->pos - 2].v128.f32[in.v_index] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].i32 = a ^ b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_SHL):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 1].v128.f64[0] = a;
-        stack->ptr[stack->pos - 1].v128.f64[1] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        stack->ptr[stack->pos - 2].i32 = a << b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_EXTRACT_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_SHR_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-        stack->ptr[stack->pos - 1].f64 = a.f64[in.v_index];
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        stack->ptr[stack->pos - 2].i32 = a >> b;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_REPLACE_LANE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_SHR_U):
       {
-        const double a = stack->ptr[stack->pos - 1].f64;
-        stack->ptr[stack->pos - 2].v128.f64[in.v_index] = a;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        stack->ptr[stack->pos - 2].i32 = a >> b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_EQ:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_ROTL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          c.i8[j] = (a.i8[j] == b.i8[j]) ? 0xFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        stack->ptr[stack->pos - 2].i32 = (a << b) | (a >> (32 - b));
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_NE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_ROTR):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          c.i8[j] = (a.i8[j] != b.i8[j]) ? 0xFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint32_t a = stack->ptr[stack->pos - 2].i32;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        stack->ptr[stack->pos - 2].i32 = (a << (32 - b)) | (a >> b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_LT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_CLZ):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          c.i8[j] = (av < bv) ? 0xFF : 0;
-        }
+        const uint64_t a = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i64 = a ? __builtin_clzl(a) : 64;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_CTZ):
+      {
+        const uint64_t a = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i64 = a ? __builtin_ctzl(a) : 64;
       }
 
-      break;
-    case PWASM_OP_I8X16_LT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_POPCNT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int val = __builtin_popcountl(stack->ptr[stack->pos - 1].i64);
+        stack->ptr[stack->pos - 1].i64 = val;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = (av < bv) ? 0xFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_ADD):
+      {
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a + b;
+        stack->pos--;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_SUB):
+      {
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a - b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_GT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_MUL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          c.i8[j] = (av > bv) ? 0xFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a * b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_GT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_DIV_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = (av > bv) ? 0xFF : 0;
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i64.div_s: division by zero");
+          return false;
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+        stack->ptr[stack->pos - 2].i64 = a / b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_LE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_DIV_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          c.i8[j] = (av <= bv) ? 0xFF : 0;
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i64.div_u: division by zero");
+          return false;
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+        stack->ptr[stack->pos - 2].i64 = a / b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_LE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_REM_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const int64_t b = (int64_t) stack->ptr[stack->pos - 1].i64;
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = (av <= bv) ? 0xFF : 0;
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i64.rem_s: division by zero");
+          return false;
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+        stack->ptr[stack->pos - 2].i64 = a % b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_GE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_REM_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          c.i8[j] = (av >= bv) ? 0xFF : 0;
+        if (!b) {
+          // log error, return failure
+          pwasm_env_fail(frame.env, "i64.rem_u: division by zero");
+          return false;
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+        stack->ptr[stack->pos - 2].i64 = a % b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_GE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_AND):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = (av >= bv) ? 0xFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a & b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_EQ:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_OR):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          c.i16[j] = (a.i16[j] == b.i16[j]) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a | b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_NE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_XOR):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          c.i16[j] = (a.i16[j] != b.i16[j]) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].i64 = a ^ b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_LT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_SHL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = (av < bv) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
+        stack->ptr[stack->pos - 2].i64 = a << b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_LT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_SHR_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av < bv) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
+        stack->ptr[stack->pos - 2].i64 = a >> b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_GT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_SHR_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = (av > bv) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
+        stack->ptr[stack->pos - 2].i64 = a >> b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_GT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_ROTL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av > bv) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
+        stack->ptr[stack->pos - 2].i64 = (a << b) | (a >> (64 - b));
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_LE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_ROTR):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint64_t a = stack->ptr[stack->pos - 2].i64;
+        const uint64_t b = stack->ptr[stack->pos - 1].i64 & 0x3F;
+        stack->ptr[stack->pos - 2].i64 = (a << (64 - b)) | (a >> b);
+        stack->pos--;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = (av <= bv) ? 0xFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_ABS):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = fabsf(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_NEG):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = -a;
       }
 
-      break;
-    case PWASM_OP_I16X8_LE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CEIL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = ceilf(a);
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av <= bv) ? 0xFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_FLOOR):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = floorf(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_TRUNC):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = truncf(a);
       }
 
-      break;
-    case PWASM_OP_I16X8_GE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_NEAREST):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = roundf(a);
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = (av >= bv) ? 0xFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_SQRT):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f32 = sqrtf(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_ADD):
+      {
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = a + b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_GE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_SUB):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av >= bv) ? 0xFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = a - b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_EQ:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_MUL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.i32[j] == b.i32[j]) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = a * b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_NE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_DIV):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.i32[j] != b.i32[j]) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = a / b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_LT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_MIN):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = (av < bv) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = fminf(a, b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_LT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_MAX):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = (av < bv) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = fmaxf(a, b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_GT_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_COPYSIGN):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = (av > bv) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const float a = stack->ptr[stack->pos - 2].f32;
+        const float b = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].f32 = copysignf(a, b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_GT_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_ABS):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = (av > bv) ? 0xFFFFFFFF : 0;
-        }
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = fabs(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_NEG):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = -a;
       }
 
-      break;
-    case PWASM_OP_I32X4_LE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CEIL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = ceil(a);
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = (av <= bv) ? 0xFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_FLOOR):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = floor(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_TRUNC):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = trunc(a);
       }
 
-      break;
-    case PWASM_OP_I32X4_LE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_NEAREST):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = round(a);
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = (av <= bv) ? 0xFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_SQRT):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f64 = sqrt(a);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_ADD):
+      {
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = a + b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_GE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_SUB):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = (av >= bv) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = a - b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_GE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_MUL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = (av >= bv) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = a * b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_EQ:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_DIV):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] == b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = a / b;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_NE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_MIN):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] != b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = fmin(a, b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_LT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_MAX):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] < b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = fmax(a, b);
+        stack->pos--;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_COPYSIGN):
+      {
+        const double a = stack->ptr[stack->pos - 2].f64;
+        const double b = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].f64 = copysign(a, b);
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_GT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_WRAP_I64):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint64_t a = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] > b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_F32_S):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i32 = (int32_t) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_F32_U):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
       }
 
-      break;
-    case PWASM_OP_F32X4_LE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_F64_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] <= b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i32 = (int32_t) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_F64_U):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) a;
       }
 
-      break;
-    case PWASM_OP_F32X4_GE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EXTEND_I32_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.f32[j] >= b.f32[j]) ? 0xFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EXTEND_I32_U):
+      {
+        const uint32_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_F32_S):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
       }
 
-      break;
-    case PWASM_OP_F64X2_EQ:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_F32_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] == b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_F64_S):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i64 = (int64_t) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_F64_U):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) a;
       }
 
-      break;
-    case PWASM_OP_F64X2_NE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CONVERT_I32_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].f32 = (float) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] != b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CONVERT_I32_U):
+      {
+        const uint32_t a = (uint32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].f32 = (float) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CONVERT_I64_S):
+      {
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].f32 = (float) a;
       }
 
-      break;
-    case PWASM_OP_F64X2_LT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_CONVERT_I64_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint64_t a = (uint64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].f32 = (float) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] < b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_DEMOTE_F64):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].f32 = (float) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CONVERT_I32_S):
+      {
+        const int32_t a = (int32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].f64 = (double) a;
       }
 
-      break;
-    case PWASM_OP_F64X2_GT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CONVERT_I32_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t a = (uint32_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].f64 = (double) a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] > b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CONVERT_I64_S):
+      {
+        const int64_t a = (int64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].f64 = (double) a;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_CONVERT_I64_U):
+      {
+        const uint64_t a = (uint64_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].f64 = (double) a;
       }
 
-      break;
-    case PWASM_OP_F64X2_LE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_PROMOTE_F32):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].f64 = a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] <= b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_REINTERPRET_F32):
+      {
+        const union {
+          uint32_t i32;
+          float f32;
+        } v = { .f32 = stack->ptr[stack->pos - 1].f32 };
+        stack->ptr[stack->pos - 1].i32 = v.i32;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_REINTERPRET_F64):
+      {
+        const union {
+          uint64_t i64;
+          double f64;
+        } v = { .f64 = stack->ptr[stack->pos - 1].f64 };
+        stack->ptr[stack->pos - 1].i64 = v.i64;
       }
 
-      break;
-    case PWASM_OP_F64X2_GE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32_REINTERPRET_I32):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const union {
+          uint32_t i32;
+          float f32;
+        } v = { .i32 = stack->ptr[stack->pos - 1].i32 };
+        stack->ptr[stack->pos - 1].f32 = v.f32;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.f64[j] >= b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64_REINTERPRET_I64):
+      {
+        const union {
+          uint64_t i64;
+          double f64;
+        } v = { .i64 = stack->ptr[stack->pos - 1].i64 };
+        stack->ptr[stack->pos - 1].f64 = v.f64;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_EXTEND8_S):
+      {
+        const int32_t val = (int8_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) val;
       }
 
-      break;
-    case PWASM_OP_V128_NOT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_EXTEND16_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        const int32_t val = (int16_t) stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) val;
+      }
 
-        pwasm_v128_t b;
-        b.i64[0] = ~a.i64[0];
-        b.i64[1] = ~a.i64[1];
-        stack->ptr[stack->pos - 1].v128 = b;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EXTEND8_S):
+      {
+        const int64_t val = (int8_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
       }
 
-      break;
-    case PWASM_OP_V128_AND:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EXTEND16_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const int64_t val = (int16_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
+      }
 
-        pwasm_v128_t c;
-        c.i64[0] = a.i64[0] & b.i64[0];
-        c.i64[1] = a.i64[1] & b.i64[1];
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_EXTEND32_S):
+      {
+        const int64_t val = (int32_t) stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) val;
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_SAT_F32_S):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i32 = (int32_t) CLAMP(a, INT32_MIN, INT32_MAX);
       }
 
-      break;
-    case PWASM_OP_V128_OR:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_SAT_F32_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) CLAMP(a, 0, UINT32_MAX);
+      }
 
-        pwasm_v128_t c;
-        c.i64[0] = a.i64[0] | b.i64[0];
-        c.i64[1] = a.i64[1] | b.i64[1];
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_SAT_F64_S):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i32 = (int32_t) CLAMP(a, INT32_MIN, INT32_MAX);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32_TRUNC_SAT_F64_U):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i32 = (uint32_t) CLAMP(a, 0, UINT32_MAX);
       }
 
-      break;
-    case PWASM_OP_V128_XOR:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_SAT_F32_S):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i64 = (int64_t) CLAMP(a, INT64_MIN, INT64_MAX);
+      }
 
-        pwasm_v128_t c;
-        c.i64[0] = a.i64[0] ^ b.i64[0];
-        c.i64[1] = a.i64[1] ^ b.i64[1];
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_SAT_F32_U):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) CLAMP(a, 0, UINT64_MAX);
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_SAT_F64_S):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i64 = (int64_t) CLAMP(a, INT64_MIN, INT64_MAX);
       }
 
-      break;
-    case PWASM_OP_V128_BITSELECT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64_TRUNC_SAT_F64_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 3].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t m = stack->ptr[stack->pos - 1].v128;
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].i64 = (uint64_t) CLAMP(a, 0, UINT64_MAX);
+      }
 
-        pwasm_v128_t c;
-        c.i64[0] = (a.i64[0] & m.i64[0]) | (b.i64[0] & ~m.i64[0]);
-        c.i64[1] = (a.i64[1] & m.i64[1]) | (b.i64[1] & ~m.i64[1]);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_CONST):
+      stack->ptr[stack->pos++].v128 = frame.mod->mod->v128s[in.v_v128];
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SPLAT):
+      {
+        const uint8_t a = stack->ptr[stack->pos - 1].i32;
+        memset(stack->ptr[stack->pos - 1].v128.i8, a, 16);
+      }
 
-        stack->ptr[stack->pos - 3].v128 = c;
-        stack->pos -= 2;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_EXTRACT_LANE_S):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].i32 = (int8_t) a.i8[in.v_index];
       }
 
-      break;
-    case PWASM_OP_I8X16_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_EXTRACT_LANE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].i32 = a.i8[in.v_index];
+      }
 
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 16; j++) {
-          b.i8[j] = -a.i8[j];
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_REPLACE_LANE):
+      {
+        const uint8_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].v128.i8[in.v_index] = a;
+        stack->pos--;
+      }
 
-        stack->ptr[stack->pos - 1].v128 = b;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SPLAT):
+      {
+        const uint16_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].v128.i16[0] = a;
+        stack->ptr[stack->pos - 1].v128.i16[1] = a;
+        stack->ptr[stack->pos - 1].v128.i16[2] = a;
+        stack->ptr[stack->pos - 1].v128.i16[3] = a;
+        stack->ptr[stack->pos - 1].v128.i16[4] = a;
+        stack->ptr[stack->pos - 1].v128.i16[5] = a;
+        stack->ptr[stack->pos - 1].v128.i16[6] = a;
+        stack->ptr[stack->pos - 1].v128.i16[7] = a;
       }
 
-      break;
-    case PWASM_OP_I8X16_ANY_TRUE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_EXTRACT_LANE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i8[0] ||  a.i8[1] ||  a.i8[2] ||  a.i8[3] ||
-          a.i8[4] ||  a.i8[5] ||  a.i8[6] ||  a.i8[7] ||
-          a.i8[8] ||  a.i8[9] ||  a.i8[10] || a.i8[11] ||
-          a.i8[12] || a.i8[13] || a.i8[14] || a.i8[15]
-        ) ? 1 : 0;
+        stack->ptr[stack->pos - 1].i32 = (int16_t) a.i16[in.v_index];
       }
 
-      break;
-    case PWASM_OP_I8X16_ALL_TRUE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_EXTRACT_LANE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].i32 = a.i16[in.v_index];
+      }
 
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i8[0] &&  a.i8[1] &&  a.i8[2] &&  a.i8[3] &&
-          a.i8[4] &&  a.i8[5] &&  a.i8[6] &&  a.i8[7] &&
-          a.i8[8] &&  a.i8[9] &&  a.i8[10] && a.i8[11] &&
-          a.i8[12] && a.i8[13] && a.i8[14] && a.i8[15]
-        ) ? 1 : 0;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_REPLACE_LANE):
+      {
+        const uint16_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].v128.i16[in.v_index] = a;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SHL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_SPLAT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
+        const uint32_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 1].v128.i32[0] = a;
+        stack->ptr[stack->pos - 1].v128.i32[1] = a;
+        stack->ptr[stack->pos - 1].v128.i32[2] = a;
+        stack->ptr[stack->pos - 1].v128.i32[3] = a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          c.i8[j] = (a.i8[j] << b);
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_EXTRACT_LANE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].i32 = a.i32[in.v_index];
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_REPLACE_LANE):
+      {
+        const uint32_t a = stack->ptr[stack->pos - 1].i32;
+        stack->ptr[stack->pos - 2].v128.i32[in.v_index] = a;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SHR_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_SPLAT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
+        const uint64_t a = stack->ptr[stack->pos - 1].i64;
+        D("a = 0x%016lx", a);
+        stack->ptr[stack->pos - 1].v128.i64[0] = a;
+        stack->ptr[stack->pos - 1].v128.i64[1] = a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          int8_t av = a.i8[j];
-          c.i8[j] = (av >> b);
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_EXTRACT_LANE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].i64 = a.i64[in.v_index];
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_REPLACE_LANE):
+      {
+        const uint64_t a = stack->ptr[stack->pos - 1].i64;
+        stack->ptr[stack->pos - 2].v128.i64[in.v_index] = a;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SHR_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_SPLAT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 1].v128.f32[0] = a;
+        stack->ptr[stack->pos - 1].v128.f32[1] = a;
+        stack->ptr[stack->pos - 1].v128.f32[2] = a;
+        stack->ptr[stack->pos - 1].v128.f32[3] = a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          uint8_t av = a.i8[j];
-          c.i8[j] = (av >> b);
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_EXTRACT_LANE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].f32 = a.f32[in.v_index];
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_REPLACE_LANE):
+      {
+        const float a = stack->ptr[stack->pos - 1].f32;
+        stack->ptr[stack->pos - 2].v128.f32[in.v_index] = a;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_SPLAT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 1].v128.f64[0] = a;
+        stack->ptr[stack->pos - 1].v128.f64[1] = a;
+      }
 
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          c.i8[j] = a.i8[j] + b.i8[j];
-        }
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_EXTRACT_LANE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        stack->ptr[stack->pos - 1].f64 = a.f64[in.v_index];
+      }
 
-        stack->ptr[stack->pos - 2].v128 = c;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_REPLACE_LANE):
+      {
+        const double a = stack->ptr[stack->pos - 1].f64;
+        stack->ptr[stack->pos - 2].v128.f64[in.v_index] = a;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_ADD_SATURATE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_EQ):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_EQ);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_NE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          const int32_t v = av + bv;
-          c.i8[j] = CLAMP(v, INT8_MIN, INT8_MAX);
+          c.i8[j] = (a.i8[j] != b.i8[j]) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_ADD_SATURATE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_LT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_LT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_LT_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -16928,31 +21423,35 @@ pwasm_new_interp_eval_expr(
         for (size_t j = 0; j < 16; j++) {
           const uint8_t av = a.i8[j];
           const uint8_t bv = b.i8[j];
-          const uint32_t v = av + bv;
-          c.i8[j] = MIN(v, UINT8_MAX);
+          c.i8[j] = (av < bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_GT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_GT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_GT_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 16; j++) {
-          c.i8[j] = a.i8[j] - b.i8[j];
+          const uint8_t av = a.i8[j];
+          const uint8_t bv = b.i8[j];
+          c.i8[j] = (av > bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SUB_SATURATE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_LE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -16961,16 +21460,15 @@ pwasm_new_interp_eval_expr(
         for (size_t j = 0; j < 16; j++) {
           const int8_t av = a.i8[j];
           const int8_t bv = b.i8[j];
-          const int32_t v = av - bv;
-          c.i8[j] = CLAMP(v, INT8_MIN, INT8_MAX);
+          c.i8[j] = (av <= bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_SUB_SATURATE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_LE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -16979,15 +21477,15 @@ pwasm_new_interp_eval_expr(
         for (size_t j = 0; j < 16; j++) {
           const uint8_t av = a.i8[j];
           const uint8_t bv = b.i8[j];
-          c.i8[j] = (av > bv) ? (av - bv) : 0;
+          c.i8[j] = (av <= bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_MIN_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_GE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -16996,15 +21494,15 @@ pwasm_new_interp_eval_expr(
         for (size_t j = 0; j < 16; j++) {
           const int8_t av = a.i8[j];
           const int8_t bv = b.i8[j];
-          c.i8[j] = MIN(av, bv);
+          c.i8[j] = (av >= bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_MIN_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_GE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -17013,843 +21511,1040 @@ pwasm_new_interp_eval_expr(
         for (size_t j = 0; j < 16; j++) {
           const uint8_t av = a.i8[j];
           const uint8_t bv = b.i8[j];
-          c.i8[j] = MIN(av, bv);
+          c.i8[j] = (av >= bv) ? 0xFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_MAX_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_EQ):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_EQ);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_NE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t av = a.i8[j];
-          const int8_t bv = b.i8[j];
-          c.i8[j] = MAX(av, bv);
+        for (size_t j = 0; j < 8; j++) {
+          c.i16[j] = (a.i16[j] != b.i16[j]) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_MAX_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_LT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LT_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = MAX(av, bv);
+        for (size_t j = 0; j < 8; j++) {
+          const uint16_t av = a.i16[j];
+          const uint16_t bv = b.i16[j];
+          c.i16[j] = (av < bv) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_GT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_GT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_GT_U):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t b;
+        pwasm_v128_t c;
         for (size_t j = 0; j < 8; j++) {
-          b.i16[j] = -a.i16[j];
+          const uint16_t av = a.i16[j];
+          const uint16_t bv = b.i16[j];
+          c.i16[j] = (av > bv) ? 0xFFFF : 0;
         }
 
-        stack->ptr[stack->pos - 1].v128 = b;
-      }
-
-      break;
-    case PWASM_OP_I16X8_ANY_TRUE:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i16[0] || a.i16[1] || a.i16[2] || a.i16[3] ||
-          a.i16[4] || a.i16[5] || a.i16[6] || a.i16[7]
-        ) ? 1 : 0;
-      }
-
-      break;
-    case PWASM_OP_I16X8_ALL_TRUE:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i16[0] && a.i16[1] && a.i16[2] && a.i16[3] &&
-          a.i16[4] && a.i16[5] && a.i16[6] && a.i16[7]
-        ) ? 1 : 0;
+        stack->ptr[stack->pos - 2].v128 = c;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SHL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 8; j++) {
-          c.i16[j] = (a.i16[j] << b);
+          const int16_t av = a.i16[j];
+          const int16_t bv = b.i16[j];
+          c.i16[j] = (av <= bv) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SHR_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 8; j++) {
-          int16_t av = a.i16[j];
-          c.i16[j] = (av >> b);
+          const uint16_t av = a.i16[j];
+          const uint16_t bv = b.i16[j];
+          c.i16[j] = (av <= bv) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SHR_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_GE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 8; j++) {
-          uint16_t av = a.i16[j];
-          c.i16[j] = (av >> b);
+          const int16_t av = a.i16[j];
+          const int16_t bv = b.i16[j];
+          c.i16[j] = (av >= bv) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_GE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 8; j++) {
-          c.i16[j] = a.i16[j] + b.i16[j];
+          const uint16_t av = a.i16[j];
+          const uint16_t bv = b.i16[j];
+          c.i16[j] = (av >= bv) ? 0xFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_ADD_SATURATE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_EQ):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_EQ);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_NE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          const int32_t v = av + bv;
-          c.i16[j] = CLAMP(v, INT16_MIN, INT16_MAX);
+        for (size_t j = 0; j < 4; j++) {
+          c.i32[j] = (a.i32[j] != b.i32[j]) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_ADD_SATURATE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_LT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LT_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          const uint32_t v = av + bv;
-          c.i16[j] = MIN(v, UINT16_MAX);
+        for (size_t j = 0; j < 4; j++) {
+          const uint32_t av = a.i32[j];
+          const uint32_t bv = b.i32[j];
+          c.i32[j] = (av < bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_GT_S):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_GT_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_GT_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          c.i16[j] = a.i16[j] - b.i16[j];
+        for (size_t j = 0; j < 4; j++) {
+          const uint32_t av = a.i32[j];
+          const uint32_t bv = b.i32[j];
+          c.i32[j] = (av > bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SUB_SATURATE_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          const int32_t v = av - bv;
-          c.i16[j] = CLAMP(v, INT16_MIN, INT16_MAX);
+        for (size_t j = 0; j < 4; j++) {
+          const int32_t av = a.i32[j];
+          const int32_t bv = b.i32[j];
+          c.i32[j] = (av <= bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_SUB_SATURATE_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av > bv) ? (av - bv) : 0;
+        for (size_t j = 0; j < 4; j++) {
+          const uint32_t av = a.i32[j];
+          const uint32_t bv = b.i32[j];
+          c.i32[j] = (av <= bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_GE_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = av * bv;
+        for (size_t j = 0; j < 4; j++) {
+          const int32_t av = a.i32[j];
+          const int32_t bv = b.i32[j];
+          c.i32[j] = (av >= bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_MIN_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_GE_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = MIN(av, bv);
+        for (size_t j = 0; j < 4; j++) {
+          const uint32_t av = a.i32[j];
+          const uint32_t bv = b.i32[j];
+          c.i32[j] = (av >= bv) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_MIN_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_EQ):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = MIN(av, bv);
+        for (size_t j = 0; j < 4; j++) {
+          c.i32[j] = (a.f32[j] == b.f32[j]) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_MAX_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_NE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t av = a.i16[j];
-          const int16_t bv = b.i16[j];
-          c.i16[j] = MAX(av, bv);
+        for (size_t j = 0; j < 4; j++) {
+          c.i32[j] = (a.f32[j] != b.f32[j]) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_MAX_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_LT):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = MAX(av, bv);
+        for (size_t j = 0; j < 4; j++) {
+          c.i32[j] = (a.f32[j] < b.f32[j]) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_GT):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t b;
+        pwasm_v128_t c;
         for (size_t j = 0; j < 4; j++) {
-          b.i32[j] = -a.i32[j];
+          c.i32[j] = (a.f32[j] > b.f32[j]) ? 0xFFFFFFFF : 0;
         }
 
-        stack->ptr[stack->pos - 1].v128 = b;
+        stack->ptr[stack->pos - 2].v128 = c;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_ANY_TRUE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_LE):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i32[0] || a.i32[1] || a.i32[2] || a.i32[3]
-        ) ? 1 : 0;
-      }
+        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
-      break;
-    case PWASM_OP_I32X4_ALL_TRUE:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        pwasm_v128_t c;
+        for (size_t j = 0; j < 4; j++) {
+          c.i32[j] = (a.f32[j] <= b.f32[j]) ? 0xFFFFFFFF : 0;
+        }
 
-        stack->ptr[stack->pos - 1].i32 = (
-          a.i32[0] && a.i32[1] && a.i32[2] && a.i32[3]
-        ) ? 1 : 0;
+        stack->ptr[stack->pos - 2].v128 = c;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_SHL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_GE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = (a.i32[j] << b);
+          c.i32[j] = (a.f32[j] >= b.f32[j]) ? 0xFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_SHR_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_EQ):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          int32_t av = a.i32[j];
-          c.i32[j] = (av >> b);
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] == b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_SHR_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_NE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          uint32_t av = a.i32[j];
-          c.i32[j] = (av >> b);
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] != b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_LT):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = a.i32[j] + b.i32[j];
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] < b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_GT):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = a.i32[j] - b.i32[j];
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] > b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_LE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.i32[j] = a.i32[j] * b.i32[j];
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] <= b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_MIN_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_GE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = MIN(av, bv);
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.f64[j] >= b.f64[j]) ? 0xFFFFFFFFFFFFFFFF : 0;
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_MIN_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_NOT):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        pwasm_v128_t b;
+        b.i64[0] = ~a.i64[0];
+        b.i64[1] = ~a.i64[1];
+        stack->ptr[stack->pos - 1].v128 = b;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_AND):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = MIN(av, bv);
-        }
+        c.i64[0] = a.i64[0] & b.i64[0];
+        c.i64[1] = a.i64[1] & b.i64[1];
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_MAX_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_OR):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t av = a.i32[j];
-          const int32_t bv = b.i32[j];
-          c.i32[j] = MAX(av, bv);
-        }
+        c.i64[0] = a.i64[0] | b.i64[0];
+        c.i64[1] = a.i64[1] | b.i64[1];
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_MAX_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_XOR):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          const uint32_t av = a.i32[j];
-          const uint32_t bv = b.i32[j];
-          c.i32[j] = MAX(av, bv);
-        }
+        c.i64[0] = a.i64[0] ^ b.i64[0];
+        c.i64[1] = a.i64[1] ^ b.i64[1];
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_BITSELECT):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 3].v128;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 2].v128;
+        const pwasm_v128_t m = stack->ptr[stack->pos - 1].v128;
+
+        pwasm_v128_t c;
+        c.i64[0] = (a.i64[0] & m.i64[0]) | (b.i64[0] & ~m.i64[0]);
+        c.i64[1] = (a.i64[1] & m.i64[1]) | (b.i64[1] & ~m.i64[1]);
+
+        stack->ptr[stack->pos - 3].v128 = c;
+        stack->pos -= 2;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_NEG):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t b;
-        for (size_t j = 0; j < 2; j++) {
-          b.i64[j] = -a.i64[j];
+        for (size_t j = 0; j < 16; j++) {
+          b.i8[j] = -a.i8[j];
         }
 
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I64X2_SHL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ANY_TRUE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i8[0] ||  a.i8[1] ||  a.i8[2] ||  a.i8[3] ||
+          a.i8[4] ||  a.i8[5] ||  a.i8[6] ||  a.i8[7] ||
+          a.i8[8] ||  a.i8[9] ||  a.i8[10] || a.i8[11] ||
+          a.i8[12] || a.i8[13] || a.i8[14] || a.i8[15]
+        ) ? 1 : 0;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ALL_TRUE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i8[0] &&  a.i8[1] &&  a.i8[2] &&  a.i8[3] &&
+          a.i8[4] &&  a.i8[5] &&  a.i8[6] &&  a.i8[7] &&
+          a.i8[8] &&  a.i8[9] &&  a.i8[10] && a.i8[11] &&
+          a.i8[12] && a.i8[13] && a.i8[14] && a.i8[15]
+        ) ? 1 : 0;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SHL):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = (a.i64[j] << b);
+        for (size_t j = 0; j < 16; j++) {
+          c.i8[j] = (a.i8[j] << b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_SHR_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SHR_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          int64_t av = a.i64[j];
-          c.i64[j] = (av >> b);
+        for (size_t j = 0; j < 16; j++) {
+          int8_t av = a.i8[j];
+          c.i8[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_SHR_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SHR_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x7;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          uint64_t av = a.i64[j];
-          c.i64[j] = (av >> b);
+        for (size_t j = 0; j < 16; j++) {
+          uint8_t av = a.i8[j];
+          c.i8[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ADD_SATURATE_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_ADD_SATURATE_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ADD_SATURATE_U):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_ADD_SATURATE_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SUB_SATURATE_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_SUB_SATURATE_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_SUB_SATURATE_U):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_SUB_SATURATE_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_MIN_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_MIN_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_MIN_U):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_MIN_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_MAX_S):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_MAX_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_MAX_U):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_MAX_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_NEG):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        pwasm_v128_t b;
+        for (size_t j = 0; j < 8; j++) {
+          b.i16[j] = -a.i16[j];
+        }
+
+        stack->ptr[stack->pos - 1].v128 = b;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ANY_TRUE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i16[0] || a.i16[1] || a.i16[2] || a.i16[3] ||
+          a.i16[4] || a.i16[5] || a.i16[6] || a.i16[7]
+        ) ? 1 : 0;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ALL_TRUE):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i16[0] && a.i16[1] && a.i16[2] && a.i16[3] &&
+          a.i16[4] && a.i16[5] && a.i16[6] && a.i16[7]
+        ) ? 1 : 0;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SHL):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = a.i64[j] + b.i64[j];
+        for (size_t j = 0; j < 8; j++) {
+          c.i16[j] = (a.i16[j] << b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SHR_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = a.i64[j] - b.i64[j];
+        for (size_t j = 0; j < 8; j++) {
+          int16_t av = a.i16[j];
+          c.i16[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I64X2_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SHR_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0xF;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.i64[j] = a.i64[j] * b.i64[j];
+        for (size_t j = 0; j < 8; j++) {
+          uint16_t av = a.i16[j];
+          c.i16[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_ABS:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ADD_SATURATE_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_ADD_SATURATE_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ADD_SATURATE_U):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_ADD_SATURATE_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SUB_SATURATE_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_SUB_SATURATE_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_SUB_SATURATE_U):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_SUB_SATURATE_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_MUL):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_MUL);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_MIN_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_MIN_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_MIN_U):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_MIN_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_MAX_S):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_MAX_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_MAX_U):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_MAX_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_NEG):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t b;
         for (size_t j = 0; j < 4; j++) {
-          b.f32[j] = fabsf(a.f32[j]);
+          b.i32[j] = -a.i32[j];
         }
 
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F32X4_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_ANY_TRUE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 4; j++) {
-          b.f32[j] = -a.f32[j];
-        }
-
-        stack->ptr[stack->pos - 1].v128 = b;
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i32[0] || a.i32[1] || a.i32[2] || a.i32[3]
+        ) ? 1 : 0;
       }
 
-      break;
-    case PWASM_OP_F32X4_SQRT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_ALL_TRUE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 4; j++) {
-          b.f32[j] = sqrtf(a.f32[j]);
-        }
-
-        stack->ptr[stack->pos - 1].v128 = b;
+        stack->ptr[stack->pos - 1].i32 = (
+          a.i32[0] && a.i32[1] && a.i32[2] && a.i32[3]
+        ) ? 1 : 0;
       }
 
-      break;
-    case PWASM_OP_F32X4_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_SHL):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = a.f32[j] + b.f32[j];
+          c.i32[j] = (a.i32[j] << b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_SHR_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = a.f32[j] - b.f32[j];
+          int32_t av = a.i32[j];
+          c.i32[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_SHR_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x1F;
 
         pwasm_v128_t c;
         for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = a.f32[j] * b.f32[j];
+          uint32_t av = a.i32[j];
+          c.i32[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_DIV:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_MUL):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_MUL);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_MIN_S):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_MIN_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_MIN_U):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_MIN_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_MAX_S):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_MAX_S);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_MAX_U):
+      PWASM_NEW_INTERP_V128_BINOP(I32X4_MAX_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_NEG):
+      {
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+
+        pwasm_v128_t b;
+        for (size_t j = 0; j < 2; j++) {
+          b.i64[j] = -a.i64[j];
+        }
+
+        stack->ptr[stack->pos - 1].v128 = b;
+      }
+
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_SHL):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = a.f32[j] / b.f32[j];
+        for (size_t j = 0; j < 2; j++) {
+          c.i64[j] = (a.i64[j] << b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_MIN:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_SHR_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = fminf(a.f32[j], b.f32[j]);
+        for (size_t j = 0; j < 2; j++) {
+          int64_t av = a.i64[j];
+          c.i64[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F32X4_MAX:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_SHR_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const uint32_t b = stack->ptr[stack->pos - 1].i32 & 0x3F;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 4; j++) {
-          c.f32[j] = fmaxf(a.f32[j], b.f32[j]);
+        for (size_t j = 0; j < 2; j++) {
+          uint64_t av = a.i64[j];
+          c.i64[j] = (av >> b);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_ABS:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(I64X2_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(I64X2_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_MUL):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
+        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
+        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t b;
+        pwasm_v128_t c;
         for (size_t j = 0; j < 2; j++) {
-          b.f64[j] = fabs(a.f64[j]);
+          c.i64[j] = a.i64[j] * b.i64[j];
         }
 
-        stack->ptr[stack->pos - 1].v128 = b;
+        stack->ptr[stack->pos - 2].v128 = c;
+        stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_NEG:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_ABS):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t b;
-        for (size_t j = 0; j < 2; j++) {
-          b.f64[j] = -a.f64[j];
+        for (size_t j = 0; j < 4; j++) {
+          b.f32[j] = fabsf(a.f32[j]);
         }
 
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F64X2_SQRT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_NEG):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t b;
-        for (size_t j = 0; j < 2; j++) {
-          b.f64[j] = sqrt(a.f64[j]);
+        for (size_t j = 0; j < 4; j++) {
+          b.f32[j] = -a.f32[j];
         }
 
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F64X2_ADD:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_SQRT):
+      PWASM_NEW_INTERP_V128_UNOP(F32X4_SQRT);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(F32X4_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(F32X4_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_MUL):
+      PWASM_NEW_INTERP_V128_BINOP(F32X4_MUL);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_DIV):
+      PWASM_NEW_INTERP_V128_BINOP(F32X4_DIV);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_MIN):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.f64[j] = a.f64[j] + b.f64[j];
+        for (size_t j = 0; j < 4; j++) {
+          c.f32[j] = fminf(a.f32[j], b.f32[j]);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_SUB:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_MAX):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
         pwasm_v128_t c;
-        for (size_t j = 0; j < 2; j++) {
-          c.f64[j] = a.f64[j] - b.f64[j];
+        for (size_t j = 0; j < 4; j++) {
+          c.f32[j] = fmaxf(a.f32[j], b.f32[j]);
         }
 
         stack->ptr[stack->pos - 2].v128 = c;
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_MUL:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_ABS):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t c;
+        pwasm_v128_t b;
         for (size_t j = 0; j < 2; j++) {
-          c.f64[j] = a.f64[j] * b.f64[j];
+          b.f64[j] = fabs(a.f64[j]);
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+        stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F64X2_DIV:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_NEG):
       {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
+        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
-        pwasm_v128_t c;
+        pwasm_v128_t b;
         for (size_t j = 0; j < 2; j++) {
-          c.f64[j] = a.f64[j] / b.f64[j];
+          b.f64[j] = -a.f64[j];
         }
 
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
+        stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F64X2_MIN:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_SQRT):
+      PWASM_NEW_INTERP_V128_UNOP(F64X2_SQRT);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_ADD):
+      PWASM_NEW_INTERP_V128_BINOP(F64X2_ADD);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_SUB):
+      PWASM_NEW_INTERP_V128_BINOP(F64X2_SUB);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_MUL):
+      PWASM_NEW_INTERP_V128_BINOP(F64X2_MUL);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_DIV):
+      PWASM_NEW_INTERP_V128_BINOP(F64X2_DIV);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_MIN):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -17863,8 +22558,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_F64X2_MAX:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F64X2_MAX):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -17878,8 +22573,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I32X4_TRUNC_SAT_F32X4_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_TRUNC_SAT_F32X4_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -17892,8 +22587,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_TRUNC_SAT_F32X4_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_TRUNC_SAT_F32X4_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -17905,8 +22600,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F32X4_CONVERT_I32X4_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_CONVERT_I32X4_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -17919,8 +22614,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_F32X4_CONVERT_I32X4_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(F32X4_CONVERT_I32X4_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -17933,8 +22628,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_V8X16_SWIZZLE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V8X16_SWIZZLE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -17949,15 +22644,17 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_V8X16_SHUFFLE:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V8X16_SHUFFLE):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
+        const pwasm_v128_t lanes = frame.mod->mod->v128s[in.v_v128];
+
         pwasm_v128_t c;
         for (size_t j = 0; j < 16; j++) {
-          const uint8_t ofs = in.v_v128.i8[j] & 0x1F;
+          const uint8_t ofs = lanes.i8[j] & 0x1F;
           c.i8[j] = (ofs < 16) ? a.i8[ofs] : b.i8[ofs - 16];
         }
 
@@ -17965,8 +22662,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_V8X16_LOAD_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V8X16_LOAD_SPLAT):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -17987,8 +22684,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_V16X8_LOAD_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V16X8_LOAD_SPLAT):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18009,8 +22706,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_V32X4_LOAD_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V32X4_LOAD_SPLAT):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18031,8 +22728,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_V64X2_LOAD_SPLAT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V64X2_LOAD_SPLAT):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18053,8 +22750,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I8X16_NARROW_I16X8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_NARROW_I16X8_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -18074,8 +22771,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_NARROW_I16X8_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_NARROW_I16X8_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -18095,8 +22792,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_NARROW_I32X4_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_NARROW_I32X4_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -18116,8 +22813,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_NARROW_I32X4_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_NARROW_I32X4_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -18137,8 +22834,8 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I16X8_WIDEN_LOW_I8X16_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_WIDEN_LOW_I8X16_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18151,8 +22848,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I16X8_WIDEN_HIGH_I8X16_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_WIDEN_HIGH_I8X16_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18165,8 +22862,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I16X8_WIDEN_LOW_I8X16_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_WIDEN_LOW_I8X16_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18178,8 +22875,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I16X8_WIDEN_HIGH_I8X16_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_WIDEN_HIGH_I8X16_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18191,8 +22888,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_WIDEN_LOW_I16X8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_WIDEN_LOW_I16X8_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18205,8 +22902,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_WIDEN_HIGH_I16X8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_WIDEN_HIGH_I16X8_S):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18219,8 +22916,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_WIDEN_LOW_I16X8_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_WIDEN_LOW_I16X8_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18232,8 +22929,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_WIDEN_HIGH_I16X8_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_WIDEN_HIGH_I16X8_U):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
 
@@ -18245,8 +22942,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I16X8_LOAD8X8_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LOAD8X8_S):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18268,8 +22965,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I16X8_LOAD8X8_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_LOAD8X8_U):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18290,8 +22987,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_LOAD16X4_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LOAD16X4_S):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18313,8 +23010,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I32X4_LOAD16X4_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_LOAD16X4_U):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18335,8 +23032,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I64X2_LOAD32X2_S:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_LOAD32X2_S):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18358,8 +23055,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_I64X2_LOAD32X2_U:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I64X2_LOAD32X2_U):
       {
         // get offset operand
         const uint32_t ofs = stack->ptr[stack->pos - 1].i32;
@@ -18380,8 +23077,8 @@ pwasm_new_interp_eval_expr(
         stack->ptr[stack->pos - 1].v128 = b;
       }
 
-      break;
-    case PWASM_OP_V128_ANDNOT:
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(V128_ANDNOT):
       {
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
@@ -18394,108 +23091,88 @@ pwasm_new_interp_eval_expr(
         stack->pos--;
       }
 
-      break;
-    case PWASM_OP_I8X16_AVGR_U:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 16; j++) {
-          const uint8_t av = a.i8[j];
-          const uint8_t bv = b.i8[j];
-          c.i8[j] = (av + bv + 1) / 2;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
-      }
-
-      break;
-    case PWASM_OP_I16X8_AVGR_U:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
-        const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t c;
-        for (size_t j = 0; j < 8; j++) {
-          const uint16_t av = a.i16[j];
-          const uint16_t bv = b.i16[j];
-          c.i16[j] = (av + bv + 1) / 2;
-        }
-
-        stack->ptr[stack->pos - 2].v128 = c;
-        stack->pos--;
-      }
-
-      break;
-    case PWASM_OP_I8X16_ABS:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 16; j++) {
-          const int8_t v = a.i8[j];
-          b.i8[j] = (v < 0) ? -v : v;
-        }
-
-        stack->ptr[stack->pos - 1].v128 = b;
-      }
-
-      break;
-    case PWASM_OP_I16X8_ABS:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 8; j++) {
-          const int16_t v = a.i16[j];
-          b.i16[j] = (v < 0) ? -v : v;
-        }
-
-        stack->ptr[stack->pos - 1].v128 = b;
-      }
-
-      break;
-    case PWASM_OP_I32X4_ABS:
-      {
-        const pwasm_v128_t a = stack->ptr[stack->pos - 1].v128;
-
-        pwasm_v128_t b;
-        for (size_t j = 0; j < 4; j++) {
-          const int32_t v = a.i32[j];
-          b.i32[j] = (v < 0) ? -v : v;
-        }
-
-        stack->ptr[stack->pos - 1].v128 = b;
-      }
-
-      break;
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_AVGR_U):
+      PWASM_NEW_INTERP_V128_BINOP(I8X16_AVGR_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_AVGR_U):
+      PWASM_NEW_INTERP_V128_BINOP(I16X8_AVGR_U);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I8X16_ABS):
+      PWASM_NEW_INTERP_V128_UNOP(I8X16_ABS);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I16X8_ABS):
+      PWASM_NEW_INTERP_V128_UNOP(I16X8_ABS);
+      PWASM_NEW_INTERP_NEXT();
+    PWASM_NEW_INTERP_OP(I32X4_ABS):
+      PWASM_NEW_INTERP_V128_UNOP(I32X4_ABS);
+      PWASM_NEW_INTERP_NEXT();
     default:
       // log error, return failure
       pwasm_env_fail(frame.env, "unknown instruction");
       return false;
     }
+
+  next:
+    // continue with next instruction
+    ;
   }
 
-  // return success (i think?)
+done:
+  if (pwasm_vec_get_size(&(interp->calls)) > entry_depth) {
+    // return from callee: move results to base of callee frame
+    const size_t dst_pos = frame.locals.ofs;
+    const size_t src_pos = stack->pos - frame.results.len;
+    memmove(stack->ptr + dst_pos, stack->ptr + src_pos, sizeof(pwasm_val_t) * frame.results.len);
+    stack->pos = dst_pos + frame.results.len;
+
+    // pop caller state
+    pwasm_new_interp_call_t call;
+    pwasm_vec_pop(&(interp->calls), &call);
+
+    // switch back to caller body, continue after call instruction
+    frame = call.frame;
+    expr = call.expr;
+    insts = frame.mod->mod->insts + expr.ofs;
+    ctrls = frame.mod->ctrls + expr.ofs;
+    base = frame.locals.ofs + frame.locals.len;
+    i = call.pc;
+
+    goto next;
+  }
+
+  // return success
   return true;
 }
 
-/*
- * world's second shittiest initial interpreter
+#ifdef PWASM_NEW_INTERP_THREADED
+#pragma GCC diagnostic pop
+#endif /* PWASM_NEW_INTERP_THREADED */
+#undef PWASM_NEW_INTERP_OP
+#undef PWASM_NEW_INTERP_NEXT
+#undef PWASM_NEW_INTERP_OP_LABELS
+
+/**
+ * Enter function +func_ofs+ of module +interp_mod+ with the parameters
+ * at the top of the value stack.
+ *
+ * Checks that the value stack has room for the locals and operands of
+ * the function, clears the locals, and populates +ret_frame+ and
+ * +ret_expr+ with the frame and body of the function.
+ *
+ * Returns `true` on success or `false` on error.
  */
 static bool
-pwasm_new_interp_call_func(
+pwasm_new_interp_enter_func(
   pwasm_env_t * const env,
   pwasm_new_interp_mod_t * const interp_mod,
-  uint32_t func_ofs
+  const uint32_t func_ofs,
+  pwasm_new_interp_frame_t * const ret_frame,
+  pwasm_slice_t * const ret_expr
 ) {
   pwasm_new_interp_t * const interp = env->env_data;
   pwasm_stack_t * const stack = env->stack;
   const pwasm_mod_t * const mod = interp_mod->mod;
-  // will be used for CALL and CALL_INDIRECT
-  // const size_t stack_pos = env->stack->pos;
 
   // get func parameters and results
   const pwasm_slice_t params = mod->types[mod->funcs[func_ofs]].params;
@@ -18510,6 +23187,14 @@ pwasm_new_interp_call_func(
     return false;
   }
 
+  // check value stack space for locals and operands
+  if (stack->pos + interp_mod->stack_sizes[func_ofs] > stack->len) {
+    // log error, return failure
+    D("value stack overflow: stack->pos = %zu, stack_size = %u, stack->len = %zu", stack->pos, interp_mod->stack_sizes[func_ofs], stack->len);
+    pwasm_env_fail(env, "value stack overflow");
+    return false;
+  }
+
   // get number of local slots and total frame size
   const size_t max_locals = mod->codes[func_ofs].max_locals;
   const size_t frame_size = mod->codes[func_ofs].frame_size;
@@ -18525,43 +23210,97 @@ pwasm_new_interp_call_func(
   const size_t num_mems = interp_mod->mems.len;
   const uint32_t * const mems = ((uint32_t*) pwasm_vec_get_data(&(interp->u32s))) + interp_mod->mems.ofs;
 
-  // D("mems slice = { %zu, %zu }, len = %zu, mems[0] = %u", interp_mod->mems.ofs, interp_mod->mems.len, num_mems, num_mems ? mems[0] : 0);
-  // build interpreter frame
-  pwasm_new_interp_frame_t frame = {
+  // populate interpreter frame
+  *ret_frame = (pwasm_new_interp_frame_t) {
     .env = env,
     .mod = interp_mod,
-    // FIXME: is this right?
-    .mem_id = num_mems ? mems[0] : 0,
+    // convert memory offset to ID by adding 1
+    .mem_id = num_mems ? mems[0] + 1 : 0,
     .params = params,
+    .results = results,
     .locals = {
       .ofs = stack->pos - frame_size,
       .len = frame_size,
     },
+    .hits = interp_mod->hits ? interp_mod->hits + func_ofs : NULL,
   };
 
-  // get expr instructions slice
-  const pwasm_slice_t expr = mod->codes[func_ofs].expr;
+  // populate expr instructions slice, return success
+  *ret_expr = mod->codes[func_ofs].expr;
+  return true;
+}
+
+/*
+ * world's second shittiest initial interpreter
+ */
+static bool
+pwasm_new_interp_call_func(
+  pwasm_env_t * const env,
+  pwasm_new_interp_mod_t * const interp_mod,
+  uint32_t func_ofs
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_stack_t * const stack = env->stack;
+
+  if (interp_mod->fns) {
+    // count call and compile hot function (tiered JIT environments
+    // only), check for error
+    if (!pwasm_new_interp_jit_count(env, interp_mod, func_ofs)) {
+      // return failure
+      return false;
+    }
+
+    if (interp_mod->fns[func_ofs].ptr) {
+      // call compiled function, return result
+      return pwasm_new_interp_jit_call(env, interp_mod, func_ofs);
+    }
+  }
+
+  // check call depth
+  const size_t depth = pwasm_vec_get_size(&(interp->calls));
+  if (depth >= interp->max_depth) {
+    // log error, return failure
+    pwasm_env_fail(env, "call stack exhausted");
+    return false;
+  }
+
+  // push entry marker, check for error
+  const pwasm_new_interp_call_t call = { 0 };
+  if (!pwasm_vec_push(&(interp->calls), 1, &call, NULL)) {
+    // log error, return failure
+    pwasm_env_fail(env, "push call stack entry failed");
+    return false;
+  }
+
+  // enter function, check for error
+  pwasm_new_interp_frame_t frame;
+  pwasm_slice_t expr;
+  if (!pwasm_new_interp_enter_func(env, interp_mod, func_ofs, &frame, &expr)) {
+    // pop entry marker, return failure
+    pwasm_vec_shrink(&(interp->calls), depth);
+    return false;
+  }
 
   // evaluate expr, check for error
   const bool ok = pwasm_new_interp_eval_expr(frame, expr);
+
+  // pop entry marker (and the callers of any failed call)
+  pwasm_vec_shrink(&(interp->calls), depth);
+
   if (!ok) {
     D("eval_expr() failed, func_ofs = %u", func_ofs);
     // return failure
     return false;
   }
 
-  // get func results
-  if (frame_size > 0) {
-    // calc dst and src stack positions
-    const size_t dst_pos = frame.locals.ofs;
-    const size_t src_pos = stack->pos - results.len;
-    const size_t num_bytes = sizeof(pwasm_val_t) * results.len;
+  // calc dst and src stack positions
+  const size_t dst_pos = frame.locals.ofs;
+  const size_t src_pos = stack->pos - frame.results.len;
+  const size_t num_bytes = sizeof(pwasm_val_t) * frame.results.len;
 
-    // D("stack->pos: old = %zu, new = %zu", stack->pos, dst_pos + results.len);
-    // copy results, update stack position
-    memmove(stack->ptr + dst_pos, stack->ptr + src_pos, num_bytes);
-    stack->pos = dst_pos + results.len;
-  }
+  // copy results, update stack position
+  memmove(stack->ptr + dst_pos, stack->ptr + src_pos, num_bytes);
+  stack->pos = dst_pos + frame.results.len;
 
   // return success
   return true;
@@ -18645,111 +23384,247 @@ pwasm_new_interp_get_mod_table_ofs(
     return false;
   }
 
-  // map local index to table interpreter offset
-  *ret_ofs = u32s[frame.mod->tables.ofs + mod_table_id];
+  // map local index to table interpreter offset
+  *ret_ofs = u32s[frame.mod->tables.ofs + mod_table_id];
+
+  // return success
+  return true;
+}
+
+/**
+ * Check a call_indirect target which failed the fast path type check
+ * and log the appropriate error.
+ *
+ * Always returns `false`.
+ */
+static bool
+pwasm_new_interp_call_indirect_fail(
+  pwasm_env_t * const env,
+  const pwasm_new_interp_table_t * const table,
+  const uint32_t elem_ofs
+) {
+  if (elem_ofs >= table->max_vals) {
+    D("elem_ofs = %u, table->max_vals = %zu", elem_ofs, table->max_vals);
+    pwasm_env_fail(env, "table element offset out of bounds");
+  } else if (!table->types[elem_ofs]) {
+    pwasm_env_fail(env, "table element is not set");
+  } else {
+    pwasm_env_fail(env, "call_indirect type mismatch");
+  }
+
+  // return failure
+  return false;
+}
+
+/**
+ * Get the interpreter function offset of element +elem_ofs+ of a table
+ * and check that it has the function type +type_id+.
+ *
+ * Empty table elements have a type ID of 0, which is never a valid
+ * type ID, so the bounds check and a single type ID comparison are
+ * the only checks needed before the call.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static inline bool
+pwasm_new_interp_get_table_elem(
+  pwasm_env_t * const env,
+  const pwasm_new_interp_table_t * const table,
+  const uint32_t type_id,
+  const uint32_t elem_ofs,
+  uint32_t * const ret_func_ofs
+) {
+  if (elem_ofs < table->max_vals && table->types[elem_ofs] == type_id) {
+    // populate result, return success
+    *ret_func_ofs = table->vals[elem_ofs];
+    return true;
+  }
+
+  // log error, return failure
+  pwasm_new_interp_call_indirect_fail(env, table, elem_ofs);
+  return false;
+}
+
+/**
+ * Call element +elem_ofs+ of a table with the function type +type_id+.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static inline bool
+pwasm_new_interp_call_table_elem(
+  pwasm_env_t * const env,
+  const pwasm_new_interp_table_t * const table,
+  const uint32_t type_id,
+  const uint32_t elem_ofs
+) {
+  // check element, get function offset
+  uint32_t func_ofs;
+  if (!pwasm_new_interp_get_table_elem(env, table, type_id, elem_ofs, &func_ofs)) {
+    // return failure
+    return false;
+  }
+
+  // call function, return result
+  return pwasm_new_interp_call(env, func_ofs + 1);
+}
+
+/**
+ * Get the interpreter function offset of the target of a call_indirect
+ * instruction +in+ in the given frame.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static bool
+pwasm_new_interp_get_indirect_func(
+  const pwasm_new_interp_frame_t frame,
+  const pwasm_inst_t in,
+  const uint32_t elem_ofs,
+  uint32_t * const ret_func_ofs
+) {
+  pwasm_new_interp_t * const interp = frame.env->env_data;
+
+  // get module-relative table index from instruction
+  // TODO: hard-coded for now, get from instruction eventually
+  const uint32_t mod_table_id = 0;
+
+  // get interpreter table offset
+  uint32_t table_ofs;
+  if (!pwasm_new_interp_get_mod_table_ofs(frame, mod_table_id, &table_ofs)) {
+    return false;
+  }
+
+  // get table and instruction type ID
+  const pwasm_new_interp_table_t * const tables = pwasm_vec_get_data(&(interp->tables));
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t type_id = u32s[frame.mod->types.ofs + in.v_index];
 
-  // return success
-  return true;
+  // check element and get function offset, return result
+  return pwasm_new_interp_get_table_elem(frame.env, tables + table_ofs, type_id, elem_ofs, ret_func_ofs);
 }
 
 /**
- * Given a frame and a call_indirect instruction, and a target function
- * offset in the interpreter, compare the following types:
- *
- *  * in the index immediate of the call_indirect instruction, and
- *  * the type of the target function and
- *
- * The comparison verifies all of the following:
- *
- *   * parameter count
- *   * result count
- *   * parameter value types
- *   * result value types
+ * Call element +elem_ofs+ of table +table_id+, checking that the type
+ * of the element matches function type +type_ofs+ of module +mod_id+.
  *
  * Returns `true` on success or `false` on error.
  */
 static bool
-pwasm_new_interp_call_indirect_check_type(
-  const pwasm_new_interp_frame_t frame,
-  const pwasm_inst_t in,
-  const uint32_t func_ofs
+pwasm_new_interp_call_indirect_elem(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_id,
+  const uint32_t type_ofs,
+  const uint32_t elem_ofs
 ) {
-  pwasm_new_interp_t * const interp = frame.env->env_data;
-
-  // get instruction immediate type
-  const uint32_t * const in_u32s = frame.mod->mod->u32s;
-  const pwasm_type_t in_type = frame.mod->mod->types[in.v_index];
-
-  // get function type
-  const pwasm_vec_t * const fn_vec = &(interp->funcs);
-  const pwasm_new_interp_func_t * const fns = pwasm_vec_get_data(fn_vec);
-  const pwasm_new_interp_func_t fn = fns[func_ofs];
-  const pwasm_vec_t * const mod_vec = &(interp->mods);
-  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(mod_vec);
-  const pwasm_mod_t * const fn_mod = mods[fn.mod_ofs].mod;
-  const uint32_t * const fn_u32s = fn_mod->u32s;
-  const pwasm_type_t fn_type = fn_mod->types[fn_mod->funcs[fn.func_ofs]];
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t * const mods = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_mods = pwasm_vec_get_size(&(interp->mods));
 
-  // check parameter count
-  if (in_type.params.len != fn_type.params.len) {
-    pwasm_env_fail(frame.env, "call_indirect parameter count mismatch");
+  // check mod ID
+  if (!mod_id || mod_id > num_mods || mods[mod_id - 1].type != PWASM_NEW_INTERP_MOD_TYPE_MOD) {
+    D("bad mod_id: %u", mod_id);
+    pwasm_env_fail(env, "call_indirect: invalid module ID");
     return false;
   }
+  const pwasm_new_interp_mod_t * const mod = mods + (mod_id - 1);
 
-  // check result count
-  if (in_type.results.len != fn_type.results.len) {
-    pwasm_env_fail(frame.env, "call_indirect result count mismatch");
+  // check type offset
+  if (type_ofs >= mod->types.len) {
+    D("type_ofs (%u) >= num_types (%zu)", type_ofs, mod->types.len);
+    pwasm_env_fail(env, "call_indirect: invalid type index");
     return false;
   }
 
-  // check parameters
-  for (size_t i = 0 ; i < in_type.params.len; i++) {
-    const uint32_t in_param_type = in_u32s[in_type.params.ofs + i];
-    const uint32_t fn_param_type = fn_u32s[fn_type.params.ofs + i];
-
-    if (in_param_type != fn_param_type) {
-      pwasm_env_fail(frame.env, "call_indirect parameter type mismatch");
-      return false;
-    }
+  // get table, check for error
+  const pwasm_new_interp_table_t * const table = pwasm_new_interp_get_table(env, table_id);
+  if (!table) {
+    return false;
   }
 
-  // return success
-  return true;
+  // get type ID
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t type_id = u32s[mod->types.ofs + type_ofs];
+
+  // check element and call function, return result
+  return pwasm_new_interp_call_table_elem(env, table, type_id, elem_ofs);
 }
 
-static bool
-pwasm_new_interp_call_indirect(
-  const pwasm_new_interp_frame_t frame,
-  const pwasm_inst_t in,
-  const uint32_t elem_ofs
+/*
+ * Convert the offset of a global, memory, or table in a module to an
+ * externally visible handle.
+ *
+ * Returns 0 on error.
+ */
+static uint32_t
+pwasm_new_interp_get_mod_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_import_type_t type,
+  const uint32_t ofs
 ) {
-  // get module-relative table index from instruction
-  // TODO: hard-coded for now, get from instruction eventually
-  const uint32_t mod_table_id = 0;
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t * const rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
 
-  // get interpreter table offset
-  uint32_t table_ofs;
-  if (!pwasm_new_interp_get_mod_table_ofs(frame, mod_table_id, &table_ofs)) {
-    return false;
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_mod_index: invalid mod ID");
+    return 0;
   }
 
-  // convert table offset to ID
-  const uint32_t table_id = table_ofs + 1;
-  D("mod_table_id = %u, table_id (interp) = %u", mod_table_id, table_id);
+  // get slice
+  const pwasm_new_interp_mod_t * const mod = rows + (mod_id - 1);
+  const pwasm_slice_t slice = (type == PWASM_IMPORT_TYPE_GLOBAL) ? mod->globals :
+                              (type == PWASM_IMPORT_TYPE_MEM) ? mod->mems :
+                              mod->tables;
 
-  // get interpreter function offset, check for error
-  uint32_t func_ofs;
-  if (!pwasm_new_interp_get_elem(frame.env, table_id, elem_ofs, &func_ofs)) {
-    return false;
+  // check offset
+  if (ofs >= slice.len) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_mod_index: invalid index");
+    return 0;
   }
 
-  // check instruction type index against function type
-  if (!pwasm_new_interp_call_indirect_check_type(frame, in, func_ofs)) {
-    return false;
+  // get u32s
+  const uint32_t * const u32s = ((uint32_t*) pwasm_vec_get_data(&(interp->u32s))) + slice.ofs;
+
+  // return handle
+  return u32s[ofs] + 1;
+}
+
+/*
+ * Get pointer to the direct call slot of a module function.
+ *
+ * Returns NULL on error.
+ */
+static void **
+pwasm_new_interp_get_call_slot(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  const pwasm_new_interp_mod_t * const rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_call_slot: invalid mod ID");
+    return NULL;
   }
 
-  // call function, return result
-  return pwasm_new_interp_call(frame.env, func_ofs + 1);
+  // get mod, check function offset
+  const pwasm_new_interp_mod_t * const mod = rows + (mod_id - 1);
+  if (mod->type != PWASM_NEW_INTERP_MOD_TYPE_MOD || !mod->calls || func_ofs >= mod->mod->num_codes) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_call_slot: invalid function offset");
+    return NULL;
+  }
+
+  // return pointer to slot
+  return mod->calls + func_ofs;
 }
 
 //
@@ -18936,6 +23811,91 @@ pwasm_new_interp_on_call(
   return pwasm_new_interp_call(env, func_id);
 }
 
+static bool
+pwasm_new_interp_on_call_func(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  pwasm_new_interp_t * const interp = env->env_data;
+  pwasm_new_interp_mod_t *rows = (pwasm_new_interp_mod_t*) pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod_id and function offset
+  if (!mod_id || mod_id > num_rows || rows[mod_id - 1].type != PWASM_NEW_INTERP_MOD_TYPE_MOD || func_ofs >= rows[mod_id - 1].mod->num_codes) {
+    // log error, return failure
+    pwasm_env_fail(env, "call_func: invalid function");
+    return false;
+  }
+
+  return pwasm_new_interp_call_func(env, rows + (mod_id - 1), func_ofs);
+}
+
+static uint32_t
+pwasm_new_interp_on_get_global_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t global_ofs
+) {
+  return pwasm_new_interp_get_mod_index(env, mod_id, PWASM_IMPORT_TYPE_GLOBAL, global_ofs);
+}
+
+static uint32_t
+pwasm_new_interp_on_get_table_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_ofs
+) {
+  return pwasm_new_interp_get_mod_index(env, mod_id, PWASM_IMPORT_TYPE_TABLE, table_ofs);
+}
+
+static uint32_t
+pwasm_new_interp_on_get_mem_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t mem_ofs
+) {
+  return pwasm_new_interp_get_mod_index(env, mod_id, PWASM_IMPORT_TYPE_MEM, mem_ofs);
+}
+
+static void **
+pwasm_new_interp_on_get_call_slot(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  return pwasm_new_interp_get_call_slot(env, mod_id, func_ofs);
+}
+
+static bool
+pwasm_new_interp_on_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap
+) {
+  return pwasm_new_interp_snapshot_mod(env, mod_id, snap);
+}
+
+static bool
+pwasm_new_interp_on_restore_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_env_snapshot_t * const snap
+) {
+  return pwasm_new_interp_restore_mod(env, mod_id, snap);
+}
+
+static bool
+pwasm_new_interp_on_call_indirect(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_id,
+  const uint32_t type_ofs,
+  const uint32_t elem_ofs
+) {
+  return pwasm_new_interp_call_indirect_elem(env, mod_id, table_id, type_ofs, elem_ofs);
+}
+
 /*
  * Interpreter environment callbacks.
  */
@@ -18961,6 +23921,14 @@ NEW_PWASM_INTERP_CBS = {
   .get_global   = pwasm_new_interp_on_get_global,
   .set_global   = pwasm_new_interp_on_set_global,
   .call         = pwasm_new_interp_on_call,
+  .call_func    = pwasm_new_interp_on_call_func,
+  .get_global_index = pwasm_new_interp_on_get_global_index,
+  .get_table_index = pwasm_new_interp_on_get_table_index,
+  .get_mem_index = pwasm_new_interp_on_get_mem_index,
+  .get_call_slot = pwasm_new_interp_on_get_call_slot,
+  .snapshot_mod = pwasm_new_interp_on_snapshot_mod,
+  .restore_mod  = pwasm_new_interp_on_restore_mod,
+  .call_indirect = pwasm_new_interp_on_call_indirect,
 };
 
 /*
@@ -18971,6 +23939,18 @@ pwasm_new_interpreter_get_cbs(void) {
   return &NEW_PWASM_INTERP_CBS;
 }
 
+/*
+ * Get new interpreter environment callbacks with a maximum call depth.
+ */
+void
+pwasm_new_interpreter_get_cbs_with_max_depth(
+  pwasm_env_cbs_t * const cbs,
+  const size_t max_depth
+) {
+  *cbs = NEW_PWASM_INTERP_CBS;
+  cbs->max_call_depth = max_depth;
+}
+
 //
 // aot jit
 //
@@ -18994,9 +23974,20 @@ typedef struct {
   pwasm_slice_t mems;
   pwasm_slice_t tables;
 
+  // reference to the u32s vector in the parent environment which maps
+  // module type indices to type IDs (internal modules only)
+  pwasm_slice_t types;
+
   // array of buffers containing pointers to compiled functions
   pwasm_buf_t *fns;
 
+  // array of direct call entry points of compiled functions
+  // (populated by the jit compiler, NULL until compiled)
+  void **calls;
+
+  // export index
+  pwasm_exports_t exports;
+
   union {
     const pwasm_native_t * const native;
     const pwasm_mod_t * const mod;
@@ -19009,6 +24000,9 @@ typedef struct {
 
   // func offset in parent mod
   uint32_t func_ofs;
+
+  // function type ID (see pwasm_func_types_t)
+  uint32_t type_id;
 } pwasm_aot_jit_func_t;
 
 typedef struct {
@@ -19042,6 +24036,10 @@ typedef struct {
   // array of u64s indicating set elements
   uint64_t *masks;
 
+  // array of function type IDs, or 0 for elements which are not set
+  // (used by call_indirect to check bounds and type in one step)
+  uint32_t *types;
+
   // maximum number of elements
   size_t max_vals;
 } pwasm_aot_jit_table_t;
@@ -19060,6 +24058,7 @@ pwasm_aot_jit_table_init(
     .limits     = limits,
     .vals       = NULL,
     .masks      = NULL,
+    .types      = NULL,
     .max_vals   = 0,
   };
 }
@@ -19074,11 +24073,13 @@ pwasm_aot_jit_table_fini(
   }
 
   if (table->max_vals > 0) {
-    // free memory and masks
+    // free memory, masks, and types
     pwasm_realloc(env->mem_ctx, table->vals, 0);
     pwasm_realloc(env->mem_ctx, table->masks, 0);
+    pwasm_realloc(env->mem_ctx, table->types, 0);
     table->vals = NULL;
     table->masks = NULL;
+    table->types = NULL;
     table->max_vals = 0;
   }
 }
@@ -19124,19 +24125,38 @@ pwasm_aot_jit_table_grow(
     tmp_masks[i >> 6] &= ~(((uint64_t) 1) << (i & 0x3F));
   }
 
-  // update vals, masks, and max_len
+  // update vals and masks
   table->vals = tmp_vals;
   table->masks = tmp_masks;
+
+  // reallocate types, check for error
+  uint32_t *tmp_types = pwasm_realloc(env->mem_ctx, table->types, new_len * sizeof(uint32_t));
+  if (!tmp_types && new_len > 0) {
+    pwasm_env_fail(env, "types pwasm_realloc() failed");
+    return false;
+  }
+
+  // clear types
+  memset(tmp_types + table->max_vals, 0, (new_len - table->max_vals) * sizeof(uint32_t));
+
+  // update types and max_len
+  table->types = tmp_types;
   table->max_vals = new_len;
 
   // return success
   return true;
 }
 
+/**
+ * Set +num_vals+ elements of a table, starting at element +ofs+, to
+ * the function offsets in +vals+.  The element types are read from the
+ * functions in +funcs+.
+ */
 static bool
 pwasm_aot_jit_table_set(
   pwasm_env_t * const env,
   pwasm_aot_jit_table_t * const table,
+  const pwasm_aot_jit_func_t * const funcs,
   const size_t ofs,
   const uint32_t * const vals,
   const size_t num_vals
@@ -19149,9 +24169,41 @@ pwasm_aot_jit_table_set(
   // copy values
   memcpy(table->vals + ofs, vals, num_vals * sizeof(uint32_t));
 
-  // set masks
+  // set masks and types
   for (size_t i = ofs; i < ofs + num_vals; i++) {
     table->masks[i >> 6] |= ((uint64_t) 1) << (i & 0x3F);
+    table->types[i] = funcs[table->vals[i]].type_id;
+  }
+
+  // return success
+  return true;
+}
+
+/**
+ * Rebuild the type IDs of the elements of a table from the table
+ * values and masks and the functions in +funcs+ (e.g., after the
+ * values and masks were restored from a snapshot).
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_aot_jit_table_sync_types(
+  pwasm_env_t * const env,
+  pwasm_aot_jit_table_t * const table,
+  const pwasm_aot_jit_func_t * const funcs
+) {
+  // resize types, check for error
+  uint32_t * const types = pwasm_realloc(env->mem_ctx, table->types, table->max_vals * sizeof(uint32_t));
+  if (!types && table->max_vals > 0) {
+    pwasm_env_fail(env, "types pwasm_realloc() failed");
+    return false;
+  }
+  table->types = types;
+
+  // populate types
+  for (size_t i = 0; i < table->max_vals; i++) {
+    const bool set = table->masks[i >> 6] & ((uint64_t) 1) << (i & 0x3F);
+    types[i] = set ? funcs[table->vals[i]].type_id : 0;
   }
 
   // return success
@@ -19209,6 +24261,9 @@ typedef struct {
   PWASM_AOT_JIT_VECS
   #undef PWASM_AOT_JIT_VEC
   pwasm_ctrl_stack_t ctrl_stack;
+
+  // function type registry
+  pwasm_func_types_t types;
 } pwasm_aot_jit_t;
 
 typedef struct {
@@ -19259,6 +24314,13 @@ pwasm_aot_jit_init(
     return false;
   }
 
+  // init function type registry, check for error
+  if (!pwasm_func_types_init(&(interp->types), mem_ctx)) {
+    // log error, return failure
+    pwasm_env_fail(env, "function type registry init failed");
+    return false;
+  }
+
   // save interpreter, return success
   env->env_data = interp;
   return true;
@@ -19278,6 +24340,51 @@ pwasm_aot_jit_fini_tables(
   }
 }
 
+static void
+pwasm_aot_jit_fini_mems(
+  pwasm_env_t * const env
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  pwasm_jit_t * const jit = env->cbs->jit;
+  pwasm_vec_t * const vec = &(interp->mems);
+  pwasm_env_mem_t *rows = (pwasm_env_mem_t*) pwasm_vec_get_data(vec);
+  const size_t num_rows = pwasm_vec_get_size(vec);
+
+  if (!jit || !jit->cbs || !jit->cbs->mem_resize) {
+    // memory was not allocated by jit compiler, return
+    return;
+  }
+
+  // release memory allocated by jit compiler (the jit compiler ignores
+  // memory which it did not allocate, such as native memory)
+  for (size_t i = 0; i < num_rows; i++) {
+    if (rows[i].buf.ptr) {
+      jit->cbs->mem_resize(jit, rows + i, 0);
+    }
+  }
+}
+
+static void
+pwasm_aot_jit_fini_mods(
+  pwasm_env_t * const env
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  pwasm_vec_t * const vec = &(interp->mods);
+  pwasm_aot_jit_mod_t *rows = (pwasm_aot_jit_mod_t*) pwasm_vec_get_data(vec);
+  const size_t num_rows = pwasm_vec_get_size(vec);
+
+  for (size_t i = 0; i < num_rows; i++) {
+    if (rows[i].calls) {
+      // free direct call slots
+      pwasm_realloc(env->mem_ctx, rows[i].calls, 0);
+      rows[i].calls = NULL;
+    }
+
+    // free export index
+    pwasm_exports_fini(&(rows[i].exports), env->mem_ctx);
+  }
+}
+
 static void
 pwasm_aot_jit_fini(
   pwasm_env_t * const env
@@ -19290,8 +24397,10 @@ pwasm_aot_jit_fini(
     return;
   }
 
-  // finalize tables
+  // finalize tables and memories
   pwasm_aot_jit_fini_tables(env);
+  pwasm_aot_jit_fini_mems(env);
+  pwasm_aot_jit_fini_mods(env);
 
   // fini control stack, check for error
   pwasm_ctrl_stack_fini(&(data->ctrl_stack));
@@ -19301,6 +24410,9 @@ pwasm_aot_jit_fini(
   PWASM_AOT_JIT_VECS
   #undef PWASM_AOT_JIT_VEC
 
+  // free function type registry
+  pwasm_func_types_fini(&(data->types));
+
   // free backing data
   pwasm_realloc(mem_ctx, data, 0);
   env->env_data = NULL;
@@ -19392,9 +24504,18 @@ pwasm_aot_jit_add_native_funcs(
   size_t tmp_ofs = 0;
 
   for (size_t i = 0; i < mod->num_funcs; i++) {
+    // get function type ID, check for error
+    uint32_t type_id;
+    if (!pwasm_func_types_add_native_type(&(interp->types), &(mod->funcs[i].type), &type_id)) {
+      // log error, return failure
+      pwasm_env_fail(env, "add native function type failed");
+      return false;
+    }
+
     tmp[tmp_ofs++] = (pwasm_aot_jit_func_t) {
       .mod_ofs  = mod_ofs,
       .func_ofs = i,
+      .type_id  = type_id,
     };
 
     if (tmp_ofs == LEN(tmp)) {
@@ -19578,6 +24699,14 @@ pwasm_aot_jit_add_native(
     return 0;
   }
 
+  // build export index, check for error
+  pwasm_exports_t exports;
+  if (!pwasm_exports_init_native(&exports, env->mem_ctx, mod)) {
+    // log error, return failure
+    pwasm_env_fail(env, "build native export index failed");
+    return 0;
+  }
+
   // build row
   const pwasm_aot_jit_mod_t interp_mod = {
     .type     = PWASM_AOT_JIT_MOD_TYPE_NATIVE,
@@ -19587,11 +24716,13 @@ pwasm_aot_jit_add_native(
     .funcs    = funcs,
     .globals  = globals,
     .mems     = mems,
+    .exports  = exports,
   };
 
   // append native mod, check for error
   if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, NULL)) {
     // log error, return failure
+    pwasm_exports_fini(&exports, env->mem_ctx);
     pwasm_env_fail(env, "append native mod failed");
     return 0;
   }
@@ -19668,21 +24799,65 @@ pwasm_aot_jit_add_mod_imports(
         return false;
       }
     }
-  }
+  }
+
+  if (num_ids > 0) {
+    // append remaining results
+    if (!pwasm_vec_push(u32s, num_ids, ids, NULL)) {
+      // log error, return failure
+      pwasm_env_fail(env, "append remaining native imports failed");
+      return false;
+    }
+  }
+
+  // populate result
+  *ret = (pwasm_slice_t) {
+    .ofs = ret_ofs,
+    .len = pwasm_vec_get_size(u32s) - ret_ofs,
+  };
+
+  // return success
+  return true;
+}
+
+/*
+ * Map the function types of a module to type IDs.
+ *
+ * On success, a slice of type IDs is stored in +ret+, and this
+ * function returns true.
+ *
+ * Returns false on error.
+ */
+static bool
+pwasm_aot_jit_add_mod_types(
+  pwasm_env_t * const env,
+  const pwasm_mod_t * const mod,
+  pwasm_slice_t * const ret
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const size_t dst_ofs = pwasm_vec_get_size(&(interp->u32s));
+
+  for (size_t i = 0; i < mod->num_types; i++) {
+    // get type ID, check for error
+    uint32_t type_id;
+    if (!pwasm_func_types_add_mod_type(&(interp->types), mod, i, &type_id)) {
+      // log error, return failure
+      pwasm_env_fail(env, "add function type failed");
+      return false;
+    }
 
-  if (num_ids > 0) {
-    // append remaining results
-    if (!pwasm_vec_push(u32s, num_ids, ids, NULL)) {
+    // append type ID, check for error
+    if (!pwasm_vec_push(&(interp->u32s), 1, &type_id, NULL)) {
       // log error, return failure
-      pwasm_env_fail(env, "append remaining native imports failed");
+      pwasm_env_fail(env, "append function type ID failed");
       return false;
     }
   }
 
   // populate result
   *ret = (pwasm_slice_t) {
-    .ofs = ret_ofs,
-    .len = pwasm_vec_get_size(u32s) - ret_ofs,
+    .ofs = dst_ofs,
+    .len = mod->num_types,
   };
 
   // return success
@@ -19694,6 +24869,7 @@ pwasm_aot_jit_add_mod_funcs(
   pwasm_env_t * const env,
   const uint32_t mod_ofs,
   const pwasm_mod_t * const mod,
+  const pwasm_slice_t types,
   pwasm_slice_t * const ret
 ) {
   pwasm_aot_jit_t * const interp = env->env_data;
@@ -19706,6 +24882,9 @@ pwasm_aot_jit_add_mod_funcs(
     return false;
   }
 
+  // get type IDs
+  const uint32_t * const type_ids = ((uint32_t*) pwasm_vec_get_data(&(interp->u32s))) + types.ofs;
+
   pwasm_aot_jit_func_t tmp[PWASM_BATCH_SIZE];
   size_t tmp_ofs = 0;
 
@@ -19713,6 +24892,7 @@ pwasm_aot_jit_add_mod_funcs(
     tmp[tmp_ofs++] = (pwasm_aot_jit_func_t) {
       .mod_ofs  = mod_ofs,
       .func_ofs = i,
+      .type_id  = type_ids[mod->funcs[i]],
     };
 
     if (tmp_ofs == LEN(tmp)) {
@@ -19816,6 +24996,39 @@ pwasm_aot_jit_add_mod_globals(
   return true;
 }
 
+/**
+ * Resize the backing buffer of a memory instance.
+ *
+ * Uses the `mem_resize` callback of the JIT compiler if it has one,
+ * or `pwasm_realloc()` otherwise.
+ */
+static bool
+pwasm_aot_jit_resize_mem(
+  pwasm_env_t * const env,
+  pwasm_env_mem_t * const mem,
+  const size_t num_bytes
+) {
+  pwasm_jit_t * const jit = env->cbs->jit;
+  if (jit && jit->cbs && jit->cbs->mem_resize) {
+    // use jit compiler memory callback
+    return jit->cbs->mem_resize(jit, mem, num_bytes);
+  }
+
+  // resize buffer, check for error
+  uint8_t * const ptr = pwasm_realloc(env->mem_ctx, (void*) mem->buf.ptr, num_bytes);
+  if (!ptr && num_bytes) {
+    // return failure
+    return false;
+  }
+
+  // update buffer attributes
+  mem->buf.ptr = ptr;
+  mem->buf.len = num_bytes;
+
+  // return success
+  return true;
+}
+
 static bool
 pwasm_aot_jit_add_mod_mems(
   pwasm_env_t * const env,
@@ -19838,23 +25051,19 @@ pwasm_aot_jit_add_mod_mems(
   size_t tmp_ofs = 0;
 
   for (size_t i = 0; i < mod->num_mems; i++) {
-    // allocate buffer
+    pwasm_env_mem_t * const mem = tmp + tmp_ofs++;
+    *mem = (pwasm_env_mem_t) {
+      .limits = mod->mems[i],
+    };
+
+    // allocate buffer, check for error
     const size_t num_bytes = mod->mems[i].min * PWASM_PAGE_SIZE;
-    uint8_t * const ptr = pwasm_realloc(env->mem_ctx, NULL, num_bytes);
-    if (!ptr && num_bytes) {
+    if (!pwasm_aot_jit_resize_mem(env, mem, num_bytes)) {
       // log error, return failure
       pwasm_env_fail(env, "allocate memory buffer failed");
       return false;
     }
 
-    tmp[tmp_ofs++] = (pwasm_env_mem_t) {
-      .limits = mod->mems[i],
-      .buf = (pwasm_buf_t) {
-        .ptr = ptr,
-        .len = num_bytes,
-      },
-    };
-
     if (tmp_ofs == LEN(tmp)) {
       // clear count
       tmp_ofs = 0;
@@ -20010,6 +25219,7 @@ pwasm_aot_jit_init_elem_funcs(
   const uint32_t table_ofs = u32s[frame.mod->tables.ofs + elem.table_id];
   D("frame.mod->tables.ofs = %zu, elem.table_id = %u, table_ofs = %u", frame.mod->tables.ofs, elem.table_id, table_ofs);
   const uint32_t * const funcs = u32s + frame.mod->funcs.ofs;
+  const pwasm_aot_jit_func_t * const interp_funcs = pwasm_vec_get_data(&(interp->funcs));
   pwasm_aot_jit_table_t * const table = pwasm_aot_jit_get_table(frame.env, table_ofs + 1);
   if (!table) {
     return false;
@@ -20025,10 +25235,10 @@ pwasm_aot_jit_init_elem_funcs(
 
     if (tmp_ofs == LEN(tmp)) {
       // get destination offset
-      const size_t dst_ofs = ofs + i - LEN(tmp);
+      const size_t dst_ofs = ofs + i + 1 - LEN(tmp);
 
       // set table elements, check for error
-      if (!pwasm_aot_jit_table_set(frame.env, table, dst_ofs, tmp, LEN(tmp))) {
+      if (!pwasm_aot_jit_table_set(frame.env, table, interp_funcs, dst_ofs, tmp, LEN(tmp))) {
         // return failure
         return false;
       }
@@ -20043,7 +25253,7 @@ pwasm_aot_jit_init_elem_funcs(
     const size_t dst_ofs = ofs + elem.funcs.len - tmp_ofs;
 
     // flush table elements, check for error
-    if (!pwasm_aot_jit_table_set(frame.env, table, dst_ofs, tmp, tmp_ofs)) {
+    if (!pwasm_aot_jit_table_set(frame.env, table, interp_funcs, dst_ofs, tmp, tmp_ofs)) {
       // return failure
       return false;
     }
@@ -20180,6 +25390,140 @@ pwasm_aot_jit_compile_func(
   return pwasm_jit_compile(jit, dst, env, mod_id, func_ofs);
 }
 
+/**
+ * Parallel function compilation worker data.
+ */
+typedef struct {
+  pwasm_env_t env; // copy of env which reports errors to this worker
+  pwasm_mem_ctx_t mem_ctx; // memory context of env copy
+  pwasm_mem_ctx_t *parent_mem_ctx; // memory context of original env
+  uint32_t mod_id; // module instance handle
+  pwasm_buf_t *fns; // compiled functions
+  char text[256]; // first error message for current function
+  size_t fail_ofs; // offset of first failed function, or SIZE_MAX
+  char fail_text[256]; // first error message for first failed function
+} pwasm_aot_jit_compile_worker_t;
+
+/**
+ * Forward allocations to the memory context of the original env.
+ */
+static void *
+pwasm_aot_jit_compile_worker_on_realloc(
+  void *ptr,
+  size_t len,
+  void *cb_data
+) {
+  pwasm_aot_jit_compile_worker_t * const worker = cb_data;
+  return pwasm_realloc(worker->parent_mem_ctx, ptr, len);
+}
+
+/**
+ * Save the first error message for the current function.
+ */
+static void
+pwasm_aot_jit_compile_worker_on_error(
+  const char * const text,
+  void *cb_data
+) {
+  pwasm_aot_jit_compile_worker_t * const worker = cb_data;
+
+  if (!worker->text[0]) {
+    snprintf(worker->text, sizeof(worker->text), "%s", text);
+  }
+}
+
+static const pwasm_mem_cbs_t
+PWASM_AOT_JIT_COMPILE_WORKER_MEM_CBS = {
+  .on_realloc = pwasm_aot_jit_compile_worker_on_realloc,
+  .on_error   = pwasm_aot_jit_compile_worker_on_error,
+};
+
+/**
+ * Compile function (worker pool job callback).
+ */
+static bool
+pwasm_aot_jit_compile_worker_on_job(
+  void *data,
+  const size_t ofs
+) {
+  pwasm_aot_jit_compile_worker_t * const worker = data;
+
+  // clear error message
+  worker->text[0] = '\0';
+
+  // compile function
+  if (pwasm_aot_jit_compile_func(worker->fns + ofs, &(worker->env), worker->mod_id, ofs)) {
+    // return success
+    return true;
+  }
+
+  if (ofs < worker->fail_ofs) {
+    // save failed function offset and error message
+    worker->fail_ofs = ofs;
+    memcpy(worker->fail_text, worker->text, sizeof(worker->text));
+  }
+
+  // return failure
+  return false;
+}
+
+/**
+ * Compile the functions of a module on `num_threads` threads.
+ *
+ * Each worker compiles with a copy of `env` whose memory context
+ * captures error messages, so that only the error for the first failed
+ * function is reported, as in the single-threaded case.
+ */
+static bool
+pwasm_aot_jit_compile_funcs_parallel(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const size_t num_codes,
+  pwasm_buf_t * const fns,
+  const size_t num_threads
+) {
+  pwasm_aot_jit_compile_worker_t workers[PWASM_POOL_MAX_THREADS];
+  void *worker_data[PWASM_POOL_MAX_THREADS];
+  const size_t num_workers = MIN(num_threads, LEN(workers));
+
+  // init workers
+  for (size_t i = 0; i < num_workers; i++) {
+    pwasm_aot_jit_compile_worker_t * const worker = workers + i;
+    worker->env = *env;
+    worker->env.mem_ctx = &(worker->mem_ctx);
+    worker->mem_ctx = (pwasm_mem_ctx_t) {
+      .cbs      = &PWASM_AOT_JIT_COMPILE_WORKER_MEM_CBS,
+      .cb_data  = worker,
+    };
+    worker->parent_mem_ctx = env->mem_ctx;
+    worker->mod_id = mod_id;
+    worker->fns = fns;
+    worker->text[0] = '\0';
+    worker->fail_ofs = SIZE_MAX;
+    worker->fail_text[0] = '\0';
+
+    worker_data[i] = worker;
+  }
+
+  // compile functions
+  const size_t fail_ofs = pwasm_pool_run(worker_data, num_workers, num_codes, pwasm_aot_jit_compile_worker_on_job);
+
+  if (fail_ofs != SIZE_MAX) {
+    // report error for first failed function
+    const char *text = "compile function failed";
+    for (size_t i = 0; i < num_workers; i++) {
+      if (workers[i].fail_ofs == fail_ofs && workers[i].fail_text[0]) {
+        text = workers[i].fail_text;
+      }
+    }
+
+    pwasm_env_fail(env, text);
+  }
+
+  // return result
+  return fail_ofs == SIZE_MAX;
+}
+
 static bool
 pwasm_aot_jit_compile_funcs(
   pwasm_env_t * const env,
@@ -20199,13 +25543,29 @@ pwasm_aot_jit_compile_funcs(
       return NULL;
     }
 
-    // walk/compile functions
-    for (size_t i = 0; i < num_codes; i++) {
-      // compile function, check for error
-      if (!pwasm_aot_jit_compile_func(fns + i, env, mod_id, i)) {
-        // return failure
-        return false;
+    // load functions from code cache
+    pwasm_jit_t * const jit = env->cbs->jit;
+    const size_t num_threads = MIN(env->cbs->jit_threads, num_codes);
+    if (!pwasm_jit_load_mod(jit, fns, env, mod_id)) {
+      if (num_threads > 1) {
+        // compile functions in parallel, check for error
+        if (!pwasm_aot_jit_compile_funcs_parallel(env, mod_id, num_codes, fns, num_threads)) {
+          // return failure
+          return false;
+        }
+      } else {
+        // walk/compile functions
+        for (size_t i = 0; i < num_codes; i++) {
+          // compile function, check for error
+          if (!pwasm_aot_jit_compile_func(fns + i, env, mod_id, i)) {
+            // return failure
+            return false;
+          }
+        }
       }
+
+      // save compiled functions to code cache
+      pwasm_jit_save_mod(jit, fns, env, mod_id);
     }
 
     // save compiled function pointers (hack)
@@ -20248,9 +25608,16 @@ pwasm_aot_jit_add_mod(
   pwasm_aot_jit_t * const interp = env->env_data;
   const size_t mod_ofs = pwasm_vec_get_size(&(interp->mods));
 
+  // map mod types to type IDs, check for error
+  pwasm_slice_t types;
+  if (!pwasm_aot_jit_add_mod_types(env, mod, &types)) {
+    // return failure
+    return 0;
+  }
+
   // add mod funcs, check for error
   pwasm_slice_t funcs;
-  if (!pwasm_aot_jit_add_mod_funcs(env, mod_ofs, mod, &funcs)) {
+  if (!pwasm_aot_jit_add_mod_funcs(env, mod_ofs, mod, types, &funcs)) {
     // return failure
     return 0;
   }
@@ -20276,6 +25643,14 @@ pwasm_aot_jit_add_mod(
     return 0;
   }
 
+  // build export index, check for error
+  pwasm_exports_t exports;
+  if (!pwasm_exports_init_mod(&exports, env->mem_ctx, mod)) {
+    // log error, return failure
+    pwasm_env_fail(env, "build export index failed");
+    return 0;
+  }
+
   // build mod instance
   pwasm_aot_jit_mod_t interp_mod = {
     .type     = PWASM_AOT_JIT_MOD_TYPE_MOD,
@@ -20286,12 +25661,15 @@ pwasm_aot_jit_add_mod(
     .globals  = globals,
     .mems     = mems,
     .tables   = tables,
+    .types    = types,
+    .exports  = exports,
   };
 
   // append mod, check for error
   size_t interp_mod_ofs;
   if (!pwasm_vec_push(&(interp->mods), 1, &interp_mod, &interp_mod_ofs)) {
     // log error, return failure
+    pwasm_exports_fini(&exports, env->mem_ctx);
     pwasm_env_fail(env, "append mod failed");
     return 0;
   }
@@ -20328,6 +25706,21 @@ pwasm_aot_jit_add_mod(
     return 0;
   }
 
+  if (mod->num_codes > 0) {
+    // allocate direct call slots, check for error
+    const size_t num_bytes = mod->num_codes * sizeof(void*);
+    void **calls = pwasm_realloc(env->mem_ctx, NULL, num_bytes);
+    if (!calls) {
+      // log error, return failure
+      pwasm_env_fail(env, "allocate direct call slots failed");
+      return 0;
+    }
+
+    // clear slots, save slots
+    memset(calls, 0, num_bytes);
+    dst_interp_mod->calls = calls;
+  }
+
   // compile funcs, check for error
   pwasm_buf_t *fns = NULL;
   if (!pwasm_aot_jit_compile_funcs(env, ret_mod_id, mod, &fns)) {
@@ -20416,50 +25809,18 @@ pwasm_aot_jit_find_func(
   }
 
   // get mod
-  const pwasm_aot_jit_mod_t mod = mods[mod_id - 1];
-
-  switch (mod.type) {
-  case PWASM_AOT_JIT_MOD_TYPE_MOD:
-    for (size_t i = 0; i < mod.mod->num_exports; i++) {
-      const pwasm_export_t row = mod.mod->exports[i];
-
-      if (
-        (row.type == PWASM_IMPORT_TYPE_FUNC) &&
-        (row.name.len == name.len) &&
-        !memcmp(mod.mod->bytes + row.name.ofs, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod.funcs.ofs + row.id] + 1;
-      }
-    }
-
-    break;
-  case PWASM_AOT_JIT_MOD_TYPE_NATIVE:
-    for (size_t i = 0; i < mod.native->num_funcs; i++) {
-      const pwasm_native_func_t row = mod.native->funcs[i];
-      const pwasm_buf_t row_buf = pwasm_buf_str(row.name);
-
-      if (
-        row_buf.ptr &&
-        (row_buf.len == name.len) &&
-        !memcmp(row_buf.ptr, name.ptr, name.len)
-      ) {
-        D("u32s = %p, mod->funcs.ofs = %zu, i = %zu", (void*) u32s, mod.funcs.ofs, i);
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod.funcs.ofs + i] + 1;
-      }
-    }
+  const pwasm_aot_jit_mod_t * const mod = mods + (mod_id - 1);
 
-    break;
-  default:
+  // find function in export index, check for error
+  uint32_t ofs;
+  if (!pwasm_exports_find(&(mod->exports), PWASM_IMPORT_TYPE_FUNC, name, &ofs)) {
     // log error, return failure
-    pwasm_env_fail(env, "unknown module type (bug?)");
+    pwasm_env_fail(env, "function not found");
     return 0;
   }
 
-  // log error, return failure
-  pwasm_env_fail(env, "function not found");
-  return 0;
+  // return offset + 1 (prevent zero IDs)
+  return u32s[mod->funcs.ofs + ofs] + 1;
 }
 
 static uint32_t
@@ -20482,47 +25843,16 @@ pwasm_aot_jit_find_mem(
   // get mod
   const pwasm_aot_jit_mod_t * const mod = mods + (mod_id - 1);
 
-  switch (mod->type) {
-  case PWASM_AOT_JIT_MOD_TYPE_MOD:
-    for (size_t i = 0; i < mod->mod->num_exports; i++) {
-      const pwasm_export_t row = mod->mod->exports[i];
-
-      if (
-        (row.type == PWASM_IMPORT_TYPE_MEM) &&
-        (row.name.len == name.len) &&
-        !memcmp(mod->mod->bytes + row.name.ofs, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod->mems.ofs + row.id] + 1;
-      }
-    }
-
-    break;
-  case PWASM_AOT_JIT_MOD_TYPE_NATIVE:
-    for (size_t i = 0; i < mod->native->num_funcs; i++) {
-      const pwasm_native_mem_t row = mod->native->mems[i];
-      const pwasm_buf_t row_buf = pwasm_buf_str(row.name);
-
-      if (
-        row_buf.ptr &&
-        (row_buf.len == name.len) &&
-        !memcmp(row_buf.ptr, name.ptr, name.len)
-      ) {
-        // return offset + 1 (prevent zero IDs)
-        return u32s[mod->mems.ofs + i] + 1;
-      }
-    }
-
-    break;
-  default:
+  // find memory in export index, check for error
+  uint32_t ofs;
+  if (!pwasm_exports_find(&(mod->exports), PWASM_IMPORT_TYPE_MEM, name, &ofs)) {
     // log error, return failure
-    pwasm_env_fail(env, "unknown module type (bug?)");
+    pwasm_env_fail(env, "memory not found");
     return 0;
   }
 
-  // log error, return failure
-  pwasm_env_fail(env, "memory not found");
-  return 0;
+  // return offset + 1 (prevent zero IDs)
+  return u32s[mod->mems.ofs + ofs] + 1;
 }
 
 static pwasm_env_mem_t *
@@ -20707,13 +26037,9 @@ pwasm_aot_jit_mem_grow(
   }
 
   if (new_size > 0) {
-    // get old pointer and number of bytes
-    void *old_ptr = (void*) mem->buf.ptr;
-    const size_t num_bytes = new_size * PWASM_PAGE_SIZE;
-
     // resize buffer, check for error
-    uint8_t * const ptr = pwasm_realloc(env->mem_ctx, old_ptr, num_bytes);
-    if (!ptr && num_bytes) {
+    const size_t num_bytes = new_size * PWASM_PAGE_SIZE;
+    if (!pwasm_aot_jit_resize_mem(env, mem, num_bytes)) {
       // at this point we save a -1 to the return value pointer to
       // indicate failure, then return true from the function so that it
       // doesn't trap.
@@ -20728,10 +26054,6 @@ pwasm_aot_jit_mem_grow(
       // return "success"
       return true;
     }
-
-    // update buffer attributes
-    mem->buf.ptr = ptr;
-    mem->buf.len = num_bytes;
   }
 
   if (ret_val) {
@@ -20788,33 +26110,164 @@ pwasm_aot_jit_check_global(
   pwasm_aot_jit_t * const interp = env->env_data;
   const size_t num_rows = pwasm_vec_get_size(&(interp->globals));
 
-  if (!id || id > num_rows) {
+  if (!id || id > num_rows) {
+    // log error, return failure
+    D("global index = %u", id);
+    pwasm_env_fail(env, "global index out of bounds");
+    return false;
+  }
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_aot_jit_get_global(
+  pwasm_env_t * const env,
+  const uint32_t id,
+  pwasm_val_t * const ret_val
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const pwasm_env_global_t *rows = pwasm_vec_get_data(&(interp->globals));
+
+  if (!pwasm_aot_jit_check_global(env, id)) {
+    return false;
+  }
+
+  if (ret_val) {
+    // copy value to destination
+    *ret_val = rows[id - 1].val;
+  }
+
+  // return success
+  return true;
+}
+
+static bool
+pwasm_aot_jit_set_global(
+  pwasm_env_t * const env,
+  const uint32_t id,
+  const pwasm_val_t val
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  pwasm_env_global_t *rows = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
+
+  if (!pwasm_aot_jit_check_global(env, id)) {
+    return false;
+  }
+
+  if (!rows[id - 1].type.mutable) {
+    pwasm_env_fail(env, "write to immutable global");
+    return false;
+  }
+
+  // set global value
+  rows[id - 1].val = val;
+
+  // return success
+  return true;
+}
+
+/**
+ * Get the internal module with ID +mod_id+ for a snapshot operation.
+ *
+ * Returns NULL on error.
+ */
+static const pwasm_aot_jit_mod_t *
+pwasm_aot_jit_get_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const pwasm_aot_jit_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "invalid module ID");
+    return NULL;
+  }
+
+  // check module type
+  if (rows[mod_id - 1].type != PWASM_AOT_JIT_MOD_TYPE_MOD) {
+    // log error, return failure
+    pwasm_env_fail(env, "cannot snapshot native module");
+    return NULL;
+  }
+
+  // return module
+  return rows + (mod_id - 1);
+}
+
+static bool
+pwasm_aot_jit_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+
+  // get module, check for error
+  const pwasm_aot_jit_mod_t * const mod = pwasm_aot_jit_get_snapshot_mod(env, mod_id);
+  if (!mod) {
+    return false;
+  }
+
+  // get defined memory, global, and table offsets (skip imports)
+  const pwasm_mod_t * const src = mod->mod;
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t * const mem_ids = u32s + mod->mems.ofs + src->num_import_types[PWASM_IMPORT_TYPE_MEM];
+  const uint32_t * const global_ids = u32s + mod->globals.ofs + src->num_import_types[PWASM_IMPORT_TYPE_GLOBAL];
+  const uint32_t * const table_ids = u32s + mod->tables.ofs + src->num_import_types[PWASM_IMPORT_TYPE_TABLE];
+
+  // get memories, globals, and tables
+  const pwasm_env_mem_t * const mems = pwasm_vec_get_data(&(interp->mems));
+  const pwasm_env_global_t * const globals = pwasm_vec_get_data(&(interp->globals));
+  const pwasm_aot_jit_table_t * const tables = pwasm_vec_get_data(&(interp->tables));
+
+  // sum size of memory and table contents
+  size_t data_size = 0;
+  for (size_t i = 0; i < src->num_mems; i++) {
+    data_size += mems[mem_ids[i]].buf.len;
+  }
+  for (size_t i = 0; i < src->num_tables; i++) {
+    const size_t max_vals = tables[table_ids[i]].max_vals;
+    data_size += max_vals * sizeof(uint32_t) + PWASM_SNAPSHOT_NUM_MASKS(max_vals) * sizeof(uint64_t);
+  }
+
+  // allocate snapshot, check for error
+  pwasm_snapshot_t * const data = pwasm_snapshot_alloc(snap, env->mem_ctx, src, data_size);
+  if (!data) {
     // log error, return failure
-    D("global index = %u", id);
-    pwasm_env_fail(env, "global index out of bounds");
+    pwasm_env_fail(env, "allocate snapshot failed");
     return false;
   }
 
-  // return success
-  return true;
-}
-
-static bool
-pwasm_aot_jit_get_global(
-  pwasm_env_t * const env,
-  const uint32_t id,
-  pwasm_val_t * const ret_val
-) {
-  pwasm_aot_jit_t * const interp = env->env_data;
-  const pwasm_env_global_t *rows = pwasm_vec_get_data(&(interp->globals));
+  // save memories
+  for (size_t i = 0; i < src->num_mems; i++) {
+    if (!pwasm_snapshot_save_mem(snap, data->mems + i, mems + mem_ids[i])) {
+      // log error, return failure
+      pwasm_env_snapshot_fini(snap);
+      pwasm_env_fail(env, "save memory failed");
+      return false;
+    }
+  }
 
-  if (!pwasm_aot_jit_check_global(env, id)) {
-    return false;
+  // save globals
+  for (size_t i = 0; i < src->num_globals; i++) {
+    data->globals[i] = globals[global_ids[i]].val;
   }
 
-  if (ret_val) {
-    // copy value to destination
-    *ret_val = rows[id - 1].val;
+  // save tables
+  for (size_t i = 0; i < src->num_tables; i++) {
+    const pwasm_aot_jit_table_t * const table = tables + table_ids[i];
+    if (!pwasm_snapshot_save_table(snap, data->tables + i, table->vals, table->masks, table->max_vals)) {
+      // log error, return failure
+      pwasm_env_snapshot_fini(snap);
+      pwasm_env_fail(env, "save table failed");
+      return false;
+    }
   }
 
   // return success
@@ -20822,25 +26275,88 @@ pwasm_aot_jit_get_global(
 }
 
 static bool
-pwasm_aot_jit_set_global(
+pwasm_aot_jit_restore_mod(
   pwasm_env_t * const env,
-  const uint32_t id,
-  const pwasm_val_t val
+  const uint32_t mod_id,
+  const pwasm_env_snapshot_t * const snap
 ) {
   pwasm_aot_jit_t * const interp = env->env_data;
-  pwasm_env_global_t *rows = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
+  const pwasm_snapshot_t * const data = snap->data;
 
-  if (!pwasm_aot_jit_check_global(env, id)) {
+  // get module, check for error
+  const pwasm_aot_jit_mod_t * const mod = pwasm_aot_jit_get_snapshot_mod(env, mod_id);
+  if (!mod) {
     return false;
   }
 
-  if (!rows[id - 1].type.mutable) {
-    pwasm_env_fail(env, "write to immutable global");
+  // check snapshot
+  const pwasm_mod_t * const src = mod->mod;
+  if (!data || data->mod != src) {
+    // log error, return failure
+    pwasm_env_fail(env, "snapshot does not match module");
     return false;
   }
 
-  // set global value
-  rows[id - 1].val = val;
+  // get defined memory, global, and table offsets (skip imports)
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t * const mem_ids = u32s + mod->mems.ofs + src->num_import_types[PWASM_IMPORT_TYPE_MEM];
+  const uint32_t * const global_ids = u32s + mod->globals.ofs + src->num_import_types[PWASM_IMPORT_TYPE_GLOBAL];
+  const uint32_t * const table_ids = u32s + mod->tables.ofs + src->num_import_types[PWASM_IMPORT_TYPE_TABLE];
+
+  // get memories, globals, and tables
+  pwasm_env_mem_t * const mems = (pwasm_env_mem_t*) pwasm_vec_get_data(&(interp->mems));
+  pwasm_env_global_t * const globals = (pwasm_env_global_t*) pwasm_vec_get_data(&(interp->globals));
+  pwasm_aot_jit_table_t * const tables = (pwasm_aot_jit_table_t*) pwasm_vec_get_data(&(interp->tables));
+  const pwasm_aot_jit_func_t * const funcs = pwasm_vec_get_data(&(interp->funcs));
+
+  // restore memories
+  for (size_t i = 0; i < src->num_mems; i++) {
+    pwasm_env_mem_t * const mem = mems + mem_ids[i];
+    const pwasm_buf_t buf = data->mems[i].buf;
+
+    if (mem->buf.len != buf.len) {
+      // check size (resizing to zero bytes releases guarded memory,
+      // which compiled code still refers to)
+      if (!buf.len) {
+        // log error, return failure
+        pwasm_env_fail(env, "cannot restore empty memory");
+        return false;
+      }
+
+      // resize buffer, check for error
+      if (!pwasm_aot_jit_resize_mem(env, mem, buf.len)) {
+        // log error, return failure
+        pwasm_env_fail(env, "resize memory buffer failed");
+        return false;
+      }
+    }
+
+    if (buf.len > 0) {
+      // copy contents
+      memcpy((uint8_t*) mem->buf.ptr, buf.ptr, buf.len);
+    }
+  }
+
+  // restore globals
+  for (size_t i = 0; i < src->num_globals; i++) {
+    globals[global_ids[i]].val = data->globals[i];
+  }
+
+  // restore tables
+  for (size_t i = 0; i < src->num_tables; i++) {
+    pwasm_aot_jit_table_t * const table = tables + table_ids[i];
+    if (!pwasm_snapshot_restore_table(env->mem_ctx, &(table->vals), &(table->masks), &(table->max_vals), data->tables + i)) {
+      // log error, return failure
+      pwasm_env_fail(env, "restore table failed");
+      return false;
+    }
+
+    // rebuild element types, check for error
+    if (!pwasm_aot_jit_table_sync_types(env, table, funcs)) {
+      // return failure
+      return false;
+    }
+  }
 
   // return success
   return true;
@@ -20876,6 +26392,7 @@ pwasm_aot_jit_eval_expr(
   pwasm_ctrl_stack_t * const ctrl_stack = &(interp->ctrl_stack);
   pwasm_stack_t * const stack = frame.env->stack;
   const pwasm_inst_t * const insts = frame.mod->mod->insts + expr.ofs;
+  const pwasm_block_t * const blocks = frame.mod->mod->blocks;
 
   size_t ctrl_depth = 0;
 
@@ -20897,7 +26414,7 @@ pwasm_aot_jit_eval_expr(
       {
         // get block.params.size, check for error
         size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
+        if (!pwasm_block_type_params_get_size(frame.mod->mod, blocks[in.v_block].block_type, &num_params)) {
           // log error, return failure
           pwasm_env_fail(frame.env, "block: get num block params failed");
           return false;
@@ -20925,7 +26442,7 @@ pwasm_aot_jit_eval_expr(
       {
         // get block.params.size, check for error
         size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
+        if (!pwasm_block_type_params_get_size(frame.mod->mod, blocks[in.v_block].block_type, &num_params)) {
           // log error, return failure
           pwasm_env_fail(frame.env, "block: get num block params failed");
           return false;
@@ -20955,11 +26472,11 @@ pwasm_aot_jit_eval_expr(
         const uint32_t tail = stack->ptr[--stack->pos].i32;
 
         // get else/end offset
-        const size_t else_ofs = in.v_block.else_ofs ? in.v_block.else_ofs : in.v_block.end_ofs;
+        const size_t else_ofs = blocks[in.v_block].else_ofs ? blocks[in.v_block].else_ofs : blocks[in.v_block].end_ofs;
 
         // get block.params.size, check for error
         size_t num_params;
-        if (!pwasm_block_type_params_get_size(frame.mod->mod, in.v_block.block_type, &num_params)) {
+        if (!pwasm_block_type_params_get_size(frame.mod->mod, blocks[in.v_block].block_type, &num_params)) {
           // log error, return failure
           pwasm_env_fail(frame.env, "block: get num block params failed");
           return false;
@@ -20988,7 +26505,7 @@ pwasm_aot_jit_eval_expr(
       break;
     case PWASM_OP_ELSE:
       // skip to end inst
-      i += insts[i].v_block.end_ofs - 1;
+      i += blocks[in.v_block].end_ofs - blocks[in.v_block].else_ofs - 1;
 
       break;
     case PWASM_OP_END:
@@ -21005,7 +26522,7 @@ pwasm_aot_jit_eval_expr(
 
         // get mod, block type
         const pwasm_mod_t * const mod = frame.mod->mod;
-        const int32_t block_type = insts[ctrl_tail.ofs].v_block.block_type;
+        const int32_t block_type = blocks[insts[ctrl_tail.ofs].v_block].block_type;
 
         // get block type result count, check for error
         size_t num_results;
@@ -21063,7 +26580,7 @@ pwasm_aot_jit_eval_expr(
         } else {
           // get mod, block type
           const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
+          const int32_t block_type = blocks[insts[ctrl_tail->ofs].v_block].block_type;
 
           // get block type result count, check for error
           size_t num_results;
@@ -21077,13 +26594,18 @@ pwasm_aot_jit_eval_expr(
           for (size_t j = 0; j < num_results; j++) {
             // calculate stack source and destination offsets
             const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
+            const size_t dst_ofs = ctrl_tail->depth + j;
             stack->ptr[dst_ofs] = stack->ptr[src_ofs];
           }
 
           // reset value stack
           stack->pos = ctrl_tail->depth + num_results;
 
+          // skip to end inst of target block (the end inst is skipped
+          // by the loop increment, because the control stack entry is
+          // popped below)
+          i = ctrl_tail->ofs + blocks[insts[ctrl_tail->ofs].v_block].end_ofs;
+
           // pop control stack, check for error
           if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
             // log error, return failure
@@ -21127,7 +26649,7 @@ pwasm_aot_jit_eval_expr(
         } else {
           // get mod, block type
           const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
+          const int32_t block_type = blocks[insts[ctrl_tail->ofs].v_block].block_type;
 
           // get block type result count, check for error
           size_t num_results;
@@ -21141,13 +26663,18 @@ pwasm_aot_jit_eval_expr(
           for (size_t j = 0; j < num_results; j++) {
             // calculate stack source and destination offsets
             const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
+            const size_t dst_ofs = ctrl_tail->depth + j;
             stack->ptr[dst_ofs] = stack->ptr[src_ofs];
           }
 
           // reset value stack
           stack->pos = ctrl_tail->depth + num_results;
 
+          // skip to end inst of target block (the end inst is skipped
+          // by the loop increment, because the control stack entry is
+          // popped below)
+          i = ctrl_tail->ofs + blocks[insts[ctrl_tail->ofs].v_block].end_ofs;
+
           // pop control stack, check for error
           if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
             // log error, return failure
@@ -21165,7 +26692,7 @@ pwasm_aot_jit_eval_expr(
       {
         // get value from stack, branch labels, label offset, and then index
         const uint32_t val = stack->ptr[--stack->pos].i32;
-        const pwasm_slice_t labels = in.v_br_table;
+        const pwasm_inst_slice_t labels = in.v_br_table;
         const size_t labels_ofs = labels.ofs + MIN(val, labels.len - 1);
         const uint32_t id = frame.mod->mod->u32s[labels_ofs];
 
@@ -21195,12 +26722,9 @@ pwasm_aot_jit_eval_expr(
           i = ctrl_tail->ofs;
           stack->pos = ctrl_tail->depth;
         } else {
-          // skip past end inst
-          i += in.v_block.end_ofs + 1;
-
           // get mod, block type
           const pwasm_mod_t * const mod = frame.mod->mod;
-          const int32_t block_type = insts[ctrl_tail->ofs].v_block.block_type;
+          const int32_t block_type = blocks[insts[ctrl_tail->ofs].v_block].block_type;
 
           // get block type result count, check for error
           size_t num_results;
@@ -21214,13 +26738,18 @@ pwasm_aot_jit_eval_expr(
           for (size_t j = 0; j < num_results; j++) {
             // calculate stack source and destination offsets
             const size_t src_ofs = stack->pos - 1 - (num_results - 1 - j);
-            const size_t dst_ofs = ctrl_tail->depth + 1 + j;
+            const size_t dst_ofs = ctrl_tail->depth + j;
             stack->ptr[dst_ofs] = stack->ptr[src_ofs];
           }
 
           // reset value stack
           stack->pos = ctrl_tail->depth + num_results;
 
+          // skip to end inst of target block (the end inst is skipped
+          // by the loop increment, because the control stack entry is
+          // popped below)
+          i = ctrl_tail->ofs + blocks[insts[ctrl_tail->ofs].v_block].end_ofs;
+
           // pop control stack, check for error
           if (!pwasm_ctrl_stack_pop(ctrl_stack, NULL)) {
             // log error, return failure
@@ -22603,7 +28132,7 @@ pwasm_aot_jit_eval_expr(
 
       break;
     case PWASM_OP_V128_CONST:
-      stack->ptr[stack->pos++].v128 = in.v_v128;
+      stack->ptr[stack->pos++].v128 = frame.mod->mod->v128s[in.v_v128];
 
       break;
     case PWASM_OP_I8X16_SPLAT:
@@ -24669,9 +30198,11 @@ pwasm_aot_jit_eval_expr(
         const pwasm_v128_t a = stack->ptr[stack->pos - 2].v128;
         const pwasm_v128_t b = stack->ptr[stack->pos - 1].v128;
 
+        const pwasm_v128_t lanes = frame.mod->mod->v128s[in.v_v128];
+
         pwasm_v128_t c;
         for (size_t j = 0; j < 16; j++) {
-          const uint8_t ofs = in.v_v128.i8[j] & 0x1F;
+          const uint8_t ofs = lanes.i8[j] & 0x1F;
           c.i8[j] = (ofs < 16) ? a.i8[ofs] : b.i8[ofs - 16];
         }
 
@@ -25234,6 +30765,24 @@ pwasm_aot_jit_call_func(
     return false;
   }
 
+  // check value stack space for locals and operands (the heights are
+  // only available for checked modules)
+  if (mod->heights) {
+    const size_t stack_size = mod->codes[func_ofs].max_locals + mod->heights[mod->num_blocks + func_ofs];
+    if (stack->pos + stack_size > stack->len) {
+      // log error, return failure
+      pwasm_env_fail(env, "value stack overflow");
+      return false;
+    }
+  }
+
+  // check call depth (compiled code recurses on the host stack)
+  if (env->call_depth >= pwasm_env_get_max_call_depth(env)) {
+    // log error, return failure
+    pwasm_env_fail(env, "call stack exhausted");
+    return false;
+  }
+
   // get number of local slots and total frame size
   const size_t max_locals = mod->codes[func_ofs].max_locals;
   const size_t frame_size = mod->codes[func_ofs].frame_size;
@@ -25254,8 +30803,8 @@ pwasm_aot_jit_call_func(
   pwasm_aot_jit_frame_t frame = {
     .env = env,
     .mod = interp_mod,
-    // FIXME: is this right?
-    .mem_id = num_mems ? mems[0] : 0,
+    // map memory offset to memory handle by adding 1
+    .mem_id = num_mems ? mems[0] + 1 : 0,
     .params = params,
     .locals = {
       .ofs = stack->pos - frame_size,
@@ -25263,10 +30812,6 @@ pwasm_aot_jit_call_func(
     },
   };
 
-  // get expr instructions slice
-  // const pwasm_slice_t expr = mod->codes[func_ofs].expr;
-  // (void) expr;
-
   D("func_ofs = %u", func_ofs);
   D("fns = %p", (void*) interp_mod->fns);
   D("fns[%u] = { %p, %zu }", func_ofs, (void*) interp_mod->fns[func_ofs].ptr, interp_mod->fns[func_ofs].len);
@@ -25278,9 +30823,10 @@ pwasm_aot_jit_call_func(
   // pwasm_aot_jit_dump_stack(env, "before");
 
   // D("calling func (%p)", (void*) pun.ptr_void);
+  env->call_depth++;
   const bool ok = pun.ptr_func(env, interp_mod->mod, func_ofs);
+  env->call_depth--;
   D("call done, ok == %d", ok);
-  // const bool ok = pwasm_aot_jit_eval_expr(frame, expr);
   if (!ok) {
     D("eval_expr() failed, func_ofs = %u", func_ofs);
     // return failure
@@ -25392,68 +30938,53 @@ pwasm_aot_jit_get_mod_table_ofs(
 }
 
 /**
- * Given a frame and a call_indirect instruction, and a target function
- * offset in the interpreter, compare the following types:
- *
- *  * in the index immediate of the call_indirect instruction, and
- *  * the type of the target function and
- *
- * The comparison verifies all of the following:
- *
- *   * parameter count
- *   * result count
- *   * parameter value types
- *   * result value types
+ * Check a call_indirect target which failed the fast path type check
+ * and log the appropriate error.
  *
- * Returns `true` on success or `false` on error.
+ * Always returns `false`.
  */
 static bool
-pwasm_aot_jit_call_indirect_check_type(
-  const pwasm_aot_jit_frame_t frame,
-  const pwasm_inst_t in,
-  const uint32_t func_ofs
+pwasm_aot_jit_call_indirect_fail(
+  pwasm_env_t * const env,
+  const pwasm_aot_jit_table_t * const table,
+  const uint32_t elem_ofs
 ) {
-  pwasm_aot_jit_t * const interp = frame.env->env_data;
-
-  // get instruction immediate type
-  const uint32_t * const in_u32s = frame.mod->mod->u32s;
-  const pwasm_type_t in_type = frame.mod->mod->types[in.v_index];
-
-  // get function type
-  const pwasm_vec_t * const fn_vec = &(interp->funcs);
-  const pwasm_aot_jit_func_t * const fns = pwasm_vec_get_data(fn_vec);
-  const pwasm_aot_jit_func_t fn = fns[func_ofs];
-  const pwasm_vec_t * const mod_vec = &(interp->mods);
-  const pwasm_aot_jit_mod_t * const mods = pwasm_vec_get_data(mod_vec);
-  const pwasm_mod_t * const fn_mod = mods[fn.mod_ofs].mod;
-  const uint32_t * const fn_u32s = fn_mod->u32s;
-  const pwasm_type_t fn_type = fn_mod->types[fn_mod->funcs[fn.func_ofs]];
-
-  // check parameter count
-  if (in_type.params.len != fn_type.params.len) {
-    pwasm_env_fail(frame.env, "call_indirect parameter count mismatch");
-    return false;
-  }
-
-  // check result count
-  if (in_type.results.len != fn_type.results.len) {
-    pwasm_env_fail(frame.env, "call_indirect result count mismatch");
-    return false;
+  if (elem_ofs >= table->max_vals) {
+    D("elem_ofs = %u, table->max_vals = %zu", elem_ofs, table->max_vals);
+    pwasm_env_fail(env, "table element offset out of bounds");
+  } else if (!table->types[elem_ofs]) {
+    pwasm_env_fail(env, "table element is not set");
+  } else {
+    pwasm_env_fail(env, "call_indirect type mismatch");
   }
 
-  // check parameters
-  for (size_t i = 0 ; i < in_type.params.len; i++) {
-    const uint32_t in_param_type = in_u32s[in_type.params.ofs + i];
-    const uint32_t fn_param_type = fn_u32s[fn_type.params.ofs + i];
+  // return failure
+  return false;
+}
 
-    if (in_param_type != fn_param_type) {
-      pwasm_env_fail(frame.env, "call_indirect parameter type mismatch");
-      return false;
-    }
+/**
+ * Call element +elem_ofs+ of a table with the function type +type_id+.
+ *
+ * Empty table elements have a type ID of 0, which is never a valid
+ * type ID, so the bounds check and a single type ID comparison are
+ * the only checks needed before the call.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static inline bool
+pwasm_aot_jit_call_table_elem(
+  pwasm_env_t * const env,
+  const pwasm_aot_jit_table_t * const table,
+  const uint32_t type_id,
+  const uint32_t elem_ofs
+) {
+  if (elem_ofs < table->max_vals && table->types[elem_ofs] == type_id) {
+    // call function, return result
+    return pwasm_aot_jit_call(env, table->vals[elem_ofs] + 1);
   }
 
-  // return success
-  return true;
+  // log error, return failure
+  return pwasm_aot_jit_call_indirect_fail(env, table, elem_ofs);
 }
 
 static bool
@@ -25462,6 +30993,8 @@ pwasm_aot_jit_call_indirect(
   const pwasm_inst_t in,
   const uint32_t elem_ofs
 ) {
+  pwasm_aot_jit_t * const interp = frame.env->env_data;
+
   // get module-relative table index from instruction
   // TODO: hard-coded for now, get from instruction eventually
   const uint32_t mod_table_id = 0;
@@ -25472,23 +31005,60 @@ pwasm_aot_jit_call_indirect(
     return false;
   }
 
-  // convert table offset to ID
-  const uint32_t table_id = table_ofs + 1;
-  D("mod_table_id = %u, table_id (interp) = %u", mod_table_id, table_id);
+  // get table and instruction type ID
+  const pwasm_aot_jit_table_t * const tables = pwasm_vec_get_data(&(interp->tables));
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t type_id = u32s[frame.mod->types.ofs + in.v_index];
 
-  // get interpreter function offset, check for error
-  uint32_t func_ofs;
-  if (!pwasm_aot_jit_get_elem(frame.env, table_id, elem_ofs, &func_ofs)) {
+  // check element and call function, return result
+  return pwasm_aot_jit_call_table_elem(frame.env, tables + table_ofs, type_id, elem_ofs);
+}
+
+/**
+ * Call element +elem_ofs+ of table +table_id+, checking that the type
+ * of the element matches function type +type_ofs+ of module +mod_id+.
+ *
+ * Returns `true` on success or `false` on error.
+ */
+static bool
+pwasm_aot_jit_call_indirect_elem(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_id,
+  const uint32_t type_ofs,
+  const uint32_t elem_ofs
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const pwasm_aot_jit_mod_t * const mods = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_mods = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod ID
+  if (!mod_id || mod_id > num_mods || mods[mod_id - 1].type != PWASM_AOT_JIT_MOD_TYPE_MOD) {
+    D("bad mod_id: %u", mod_id);
+    pwasm_env_fail(env, "call_indirect: invalid module ID");
     return false;
   }
+  const pwasm_aot_jit_mod_t * const mod = mods + (mod_id - 1);
 
-  // check instruction type index against function type
-  if (!pwasm_aot_jit_call_indirect_check_type(frame, in, func_ofs)) {
+  // check type offset
+  if (type_ofs >= mod->types.len) {
+    D("type_ofs (%u) >= num_types (%zu)", type_ofs, mod->types.len);
+    pwasm_env_fail(env, "call_indirect: invalid type index");
     return false;
   }
 
-  // call function, return result
-  return pwasm_aot_jit_call(frame.env, func_ofs + 1);
+  // get table, check for error
+  const pwasm_aot_jit_table_t * const table = pwasm_aot_jit_get_table(env, table_id);
+  if (!table) {
+    return false;
+  }
+
+  // get type ID
+  const uint32_t * const u32s = pwasm_vec_get_data(&(interp->u32s));
+  const uint32_t type_id = u32s[mod->types.ofs + type_ofs];
+
+  // check element and call function, return result
+  return pwasm_aot_jit_call_table_elem(env, table, type_id, elem_ofs);
 }
 
 /*
@@ -25503,7 +31073,7 @@ pwasm_aot_jit_get_global_index(
   const uint32_t global_ofs
 ) {
   pwasm_aot_jit_t * const interp = env->env_data;
-  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const pwasm_aot_jit_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
   const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
 
   // check mod_id
@@ -25543,7 +31113,7 @@ pwasm_aot_jit_get_table_index(
   const uint32_t table_ofs
 ) {
   pwasm_aot_jit_t * const interp = env->env_data;
-  const pwasm_new_interp_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const pwasm_aot_jit_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
   const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
 
   // check mod_id
@@ -25571,6 +31141,80 @@ pwasm_aot_jit_get_table_index(
   return u32s[table_ofs] + 1;
 }
 
+/*
+ * Convert a module memory index to an externally visible memory handle.
+ *
+ * Returns 0 on error.
+ */
+static uint32_t
+pwasm_aot_jit_get_mem_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t mem_ofs
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const pwasm_aot_jit_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_mem_index: invalid mod ID");
+    return 0;
+  }
+
+  // get slice
+  const pwasm_slice_t mems = rows[mod_id - 1].mems;
+
+  // check memory offset
+  if (mem_ofs >= mems.len) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_mem_index: invalid memory index");
+    return 0;
+  }
+
+  // get u32s
+  const pwasm_vec_t * const vec = &(interp->u32s);
+  const uint32_t * const u32s = ((uint32_t*) pwasm_vec_get_data(vec)) + mems.ofs;
+
+  // return memory handle
+  return u32s[mem_ofs] + 1;
+}
+
+/*
+ * Get pointer to the direct call slot of a module function.
+ *
+ * Returns NULL on error.
+ */
+static void **
+pwasm_aot_jit_get_call_slot(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  pwasm_aot_jit_t * const interp = env->env_data;
+  const pwasm_aot_jit_mod_t *rows = pwasm_vec_get_data(&(interp->mods));
+  const size_t num_rows = pwasm_vec_get_size(&(interp->mods));
+
+  // check mod_id
+  if (!mod_id || mod_id > num_rows) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_call_slot: invalid mod ID");
+    return NULL;
+  }
+
+  // get mod, check function offset
+  const pwasm_aot_jit_mod_t * const mod = rows + (mod_id - 1);
+  if (mod->type != PWASM_AOT_JIT_MOD_TYPE_MOD || !mod->calls || func_ofs >= mod->mod->num_codes) {
+    // log error, return failure
+    pwasm_env_fail(env, "get_call_slot: invalid function offset");
+    return NULL;
+  }
+
+  // return pointer to slot
+  return mod->calls + func_ofs;
+}
+
 //
 // aot jit callbacks
 //
@@ -25785,6 +31429,53 @@ pwasm_aot_jit_on_get_table_index(
   return pwasm_aot_jit_get_table_index(env, mod_id, table_ofs);
 }
 
+static uint32_t
+pwasm_aot_jit_on_get_mem_index(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t mem_ofs
+) {
+  return pwasm_aot_jit_get_mem_index(env, mod_id, mem_ofs);
+}
+
+static void **
+pwasm_aot_jit_on_get_call_slot(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t func_ofs
+) {
+  return pwasm_aot_jit_get_call_slot(env, mod_id, func_ofs);
+}
+
+static bool
+pwasm_aot_jit_on_snapshot_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  pwasm_env_snapshot_t * const snap
+) {
+  return pwasm_aot_jit_snapshot_mod(env, mod_id, snap);
+}
+
+static bool
+pwasm_aot_jit_on_restore_mod(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const pwasm_env_snapshot_t * const snap
+) {
+  return pwasm_aot_jit_restore_mod(env, mod_id, snap);
+}
+
+static bool
+pwasm_aot_jit_on_call_indirect(
+  pwasm_env_t * const env,
+  const uint32_t mod_id,
+  const uint32_t table_id,
+  const uint32_t type_ofs,
+  const uint32_t elem_ofs
+) {
+  return pwasm_aot_jit_call_indirect_elem(env, mod_id, table_id, type_ofs, elem_ofs);
+}
+
 /*
  * AOT JIT environment callbacks.
  */
@@ -25813,6 +31504,11 @@ PWASM_AOT_JIT_CBS = {
   .call_func    = pwasm_aot_jit_on_call_func,
   .get_global_index = pwasm_aot_jit_on_get_global_index,
   .get_table_index = pwasm_aot_jit_on_get_table_index,
+  .get_mem_index = pwasm_aot_jit_on_get_mem_index,
+  .get_call_slot = pwasm_aot_jit_on_get_call_slot,
+  .snapshot_mod = pwasm_aot_jit_on_snapshot_mod,
+  .restore_mod  = pwasm_aot_jit_on_restore_mod,
+  .call_indirect = pwasm_aot_jit_on_call_indirect,
 };
 
 /*
@@ -25826,3 +31522,46 @@ pwasm_aot_jit_get_cbs(
   *cbs = PWASM_AOT_JIT_CBS;
   cbs->jit = jit;
 }
+
+/*
+ * Get tiered JIT environment callbacks.
+ *
+ * Tiered environments are interpreter environments which compile hot
+ * functions with the JIT compiler (see pwasm_new_interp_jit_count()).
+ */
+void
+pwasm_tiered_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit,
+  const uint32_t threshold
+) {
+  *cbs = NEW_PWASM_INTERP_CBS;
+  cbs->jit = jit;
+  cbs->jit_threshold = threshold ? threshold : PWASM_TIERED_JIT_DEFAULT_THRESHOLD;
+}
+
+/*
+ * Get lazy JIT environment callbacks.
+ */
+void
+pwasm_lazy_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit
+) {
+  // compile functions on first call
+  pwasm_tiered_jit_get_cbs(cbs, jit, 1);
+}
+
+/*
+ * Get parallel AOT JIT environment callbacks.
+ */
+void
+pwasm_parallel_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit,
+  const size_t num_threads
+) {
+  *cbs = PWASM_AOT_JIT_CBS;
+  cbs->jit = jit;
+  cbs->jit_threads = num_threads ? num_threads : pwasm_pool_get_default_num_threads();
+}
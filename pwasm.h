@@ -709,8 +709,38 @@ typedef struct {
   uint32_t offset; ///< offset immediate
 } pwasm_mem_imm_t;
 
+/**
+ * Block metadata for `block`, `loop`, and `if` instructions.
+ *
+ * Stored in the `blocks` table of the parent module rather than in the
+ * instruction itself (see `pwasm_inst_t`).
+ */
+typedef struct {
+  /// block result type
+  int32_t block_type;
+
+  /// offset from the block instruction to the `else` instruction (`if` only).
+  uint32_t else_ofs;
+
+  /// offset from the block instruction to the `end` instruction.
+  uint32_t end_ofs;
+} pwasm_block_t;
+
+/**
+ * Compact slice, used by instruction immediates.
+ */
+typedef struct {
+  uint32_t ofs; ///< offset
+  uint32_t len; ///< length
+} pwasm_inst_slice_t;
+
 /**
  * Decoded instruction.
+ *
+ * Immediates which are wider than 8 bytes (block metadata and `v128`
+ * constants) are stored in the `blocks` and `v128s` tables of the
+ * parent module and referenced by offset, so that each instruction
+ * only needs 16 bytes.
  */
 typedef struct {
   /** Instruction opcode */
@@ -718,25 +748,20 @@ typedef struct {
 
   union {
     /**
-     * Data for `block`, `loop`, and `if` instructions.
+     * Offset of block metadata in the `blocks` table of the parent
+     * module for `block`, `loop`, `if`, and `else` instructions.
+     *
+     * @note `else` instructions share the metadata of their `if`
+     * instruction.
      */
-    struct {
-      /// block result type
-      int32_t block_type;
-
-      /// offset to `else` instruction (`if` only).
-      size_t else_ofs;
-
-      /// Offset to `end` instruction.
-      size_t end_ofs;
-    } v_block;
+    uint32_t v_block;
 
     /**
      * Data for `br_table` instruction.
      *
      * Slice of `u32s` containing branch targets.
      */
-    pwasm_slice_t v_br_table;
+    pwasm_inst_slice_t v_br_table;
 
     /**
      * Index immediate for `br`, `br_if`, `call`, `call_indirect`,
@@ -774,9 +799,10 @@ typedef struct {
     double v_f64;
 
     /**
-     * Immediate for `v128.const` and `v8x16` instructions.
+     * Offset of immediate in the `v128s` table of the parent module
+     * for `v128.const` and `v8x16` instructions.
      */
-    pwasm_v128_t v_v128;
+    uint32_t v_v128;
   };
 } pwasm_inst_t;
 
@@ -869,6 +895,69 @@ void pwasm_fail(
   const char * const text
 );
 
+/**
+ * Arena allocator.
+ *
+ * Bump allocator which carves allocations out of large blocks obtained
+ * from a backing memory context.  Use `pwasm_arena_get_mem_ctx()` to
+ * get a memory context which allocates from the arena.
+ *
+ * Growing or freeing the most recent allocation is done in place.
+ * Other frees are ignored, and other resizes copy the allocation.
+ * All memory is released at once by `pwasm_arena_fini()`.
+ *
+ * @ingroup mem
+ *
+ * @see pwasm_arena_init()
+ */
+typedef struct {
+  pwasm_mem_ctx_t *mem_ctx; ///< backing memory context
+  size_t block_size; ///< size of next block, in bytes
+  void *tail; ///< current block (internal)
+  void *last; ///< most recent allocation (internal)
+} pwasm_arena_t;
+
+/**
+ * Create arena allocator.
+ *
+ * No memory is allocated until the first allocation.  Blocks double in
+ * size as the arena grows.
+ *
+ * @ingroup mem
+ *
+ * @param[out]  arena       Arena
+ * @param[in]   mem_ctx     Backing memory context
+ * @param[in]   block_size  Size of first block, in bytes, or `0` for
+ *                          the default size.
+ */
+void pwasm_arena_init(
+  pwasm_arena_t *arena,
+  pwasm_mem_ctx_t *mem_ctx,
+  const size_t block_size
+);
+
+/**
+ * Get a memory context which allocates from the given arena.
+ *
+ * Errors are reported to the backing memory context of the arena.
+ *
+ * @ingroup mem
+ *
+ * @param[in] arena Arena
+ *
+ * @return Memory context.
+ */
+pwasm_mem_ctx_t pwasm_arena_get_mem_ctx(pwasm_arena_t *arena);
+
+/**
+ * Release all memory allocated from the given arena.
+ *
+ * @ingroup mem
+ *
+ * @param[in] arena Arena
+ */
+void pwasm_arena_fini(pwasm_arena_t *arena);
+
 /**
  * @defgroup vec Vectors
  */
@@ -987,6 +1076,25 @@ _Bool pwasm_vec_push(
   size_t *ret_ofs
 );
 
+/**
+ * Reserve space for entries in this vector.
+ *
+ * Ensures that the vector can hold at least `num_entries` entries
+ * without being resized.
+ *
+ * @ingroup vec
+ *
+ * @param[in] vec         Vector.
+ * @param[in] num_entries Number of entries.
+ *
+ * @return `true` on success, and `false` if memory could not be
+ * allocated from the backing memory context.
+ */
+_Bool pwasm_vec_reserve(
+  pwasm_vec_t * const vec,
+  const size_t num_entries
+);
+
 /**
  * Pop last element of vector.
  *
@@ -1288,6 +1396,25 @@ typedef struct {
    */
   pwasm_slice_t (*on_labels)(const uint32_t *, const size_t, void *);
 
+  /**
+   * Called when module parser encounters block metadata for the
+   * `block`, `loop`, and `if` instructions.
+   *
+   * Callback should append block metadata to internal `blocks` buffer
+   * and return a slice indicating the offset and length within the
+   * `blocks` vector.
+   */
+  pwasm_slice_t (*on_blocks)(const pwasm_block_t *, const size_t, void *);
+
+  /**
+   * Called when module parser encounters `v128` immediates.
+   *
+   * Callback should append values to internal `v128s` buffer and
+   * return a slice indicating the offset and length within the `v128s`
+   * vector.
+   */
+  pwasm_slice_t (*on_v128s)(const pwasm_v128_t *, const size_t, void *);
+
   /**
    * Called when module parser encounters function bodies.
    *
@@ -1341,6 +1468,94 @@ size_t pwasm_mod_parse(
   void *data
 );
 
+/**
+ * Streaming module parser.
+ *
+ * Accepts module source in chunks of any size, and parses each section
+ * with the module parser callbacks as soon as the section is complete.
+ * Only the current section header or section body is buffered.
+ *
+ * @ingroup mod
+ *
+ * @see pwasm_mod_parser_init()
+ * @see pwasm_mod_parser_feed()
+ * @see pwasm_mod_parser_finish()
+ */
+typedef struct {
+  const pwasm_mod_parse_cbs_t *cbs; ///< module parser callbacks
+  void *cb_data; ///< callback data
+
+  pwasm_vec_t buf; ///< pending bytes of current header or section
+  uint32_t state; ///< parser state (internal)
+  pwasm_header_t head; ///< current section header
+
+  /** type of last non-custom section header */
+  pwasm_section_type_t max_type;
+
+  /** type of last completely parsed non-custom section */
+  pwasm_section_type_t done_type;
+
+  size_t num_bytes; ///< number of bytes fed so far
+} pwasm_mod_parser_t;
+
+/**
+ * Create streaming module parser.
+ *
+ * @ingroup mod
+ *
+ * @param[out]  parser  Streaming module parser
+ * @param[in]   mem_ctx Memory context (used to buffer partial sections)
+ * @param[in]   cbs     Module parser callbacks
+ * @param[in]   cb_data User callback data
+ *
+ * @return `true` on success or `false` on error.
+ */
+_Bool pwasm_mod_parser_init(
+  pwasm_mod_parser_t *parser,
+  pwasm_mem_ctx_t *mem_ctx,
+  const pwasm_mod_parse_cbs_t *cbs,
+  void *cb_data
+);
+
+/**
+ * Feed source bytes to streaming module parser.
+ *
+ * Parses every section completed by the bytes in `src`.  The bytes in
+ * `src` are not referenced after this function returns.
+ *
+ * @ingroup mod
+ *
+ * @param parser  Streaming module parser
+ * @param src     Source bytes
+ *
+ * @return `true` on success or `false` on error.
+ */
+_Bool pwasm_mod_parser_feed(
+  pwasm_mod_parser_t *parser,
+  const pwasm_buf_t src
+);
+
+/**
+ * Signal the end of the source to streaming module parser.
+ *
+ * @ingroup mod
+ *
+ * @param parser  Streaming module parser
+ *
+ * @return The number of bytes consumed, or `0` on error (including a
+ * truncated module).
+ */
+size_t pwasm_mod_parser_finish(pwasm_mod_parser_t *parser);
+
+/**
+ * Finalize streaming module parser.
+ *
+ * @ingroup mod
+ *
+ * @param parser  Streaming module parser
+ */
+void pwasm_mod_parser_fini(pwasm_mod_parser_t *parser);
+
 /**
  * Parsed module.
  * @ingroup mod
@@ -1385,6 +1600,12 @@ typedef struct {
   const pwasm_inst_t * const insts; ///< instructions
   const size_t num_insts; ///< instruction count
 
+  const pwasm_v128_t * const v128s; ///< v128 immediates
+  const size_t num_v128s; ///< v128 immediate count
+
+  const pwasm_block_t * const blocks; ///< block metadata
+  const size_t num_blocks; ///< block metadata count
+
   const pwasm_global_t * const globals; ///< global variables
   const size_t num_globals; ///< global variable count
 
@@ -1415,6 +1636,15 @@ typedef struct {
   const uint8_t * const bytes; ///< bytes
   const size_t num_bytes; ///< byte count
 
+  /**
+   * value stack heights recorded by the module checker: the height at
+   * the base of each block (indexed like `blocks`), followed by the
+   * maximum height of each function body (indexed like `codes`).
+   *
+   * `NULL` if the module was parsed with `pwasm_mod_init_unsafe()`.
+   */
+  const uint32_t * const heights;
+
   const _Bool has_start; ///< does this module have a start function?
   const uint32_t start; ///< start function index
 } pwasm_mod_t;
@@ -1444,6 +1674,49 @@ size_t pwasm_mod_init(
   pwasm_buf_t src
 );
 
+/**
+ * Module init flag: do not copy names, custom sections, and data
+ * segments from the source buffer.
+ *
+ * When this flag is set, the `bytes` member of the parsed module
+ * points into the source buffer instead of a private copy.  The
+ * source buffer must be left unchanged and must remain valid until the
+ * module is finalized with `pwasm_mod_fini()`.  This is intended for
+ * read-only memory-mapped files, where it avoids a second copy of the
+ * file and allows processes to share the pages of the mapped file.
+ *
+ * @ingroup mod
+ *
+ * @see pwasm_mod_init_with_flags()
+ */
+#define PWASM_MOD_INIT_FLAG_NO_COPY (1 << 0)
+
+/**
+ * Parse a module from source `src` into the module `mod` with the
+ * given init flags.
+ *
+ * Behaves like `pwasm_mod_init()`, except that the module init flags
+ * `flags` are applied.
+ *
+ * @ingroup mod
+ *
+ * @param[in]  mem_ctx  Memory context
+ * @param[out] mod      Module
+ * @param[in]  src      Source buffer
+ * @param[in]  flags    Module init flags
+ *
+ * @return Number of bytes consumed, or `0` on error.
+ *
+ * @see pwasm_mod_init()
+ * @see PWASM_MOD_INIT_FLAG_NO_COPY
+ */
+size_t pwasm_mod_init_with_flags(
+  pwasm_mem_ctx_t * const mem_ctx,
+  pwasm_mod_t * const mod,
+  pwasm_buf_t src,
+  const uint64_t flags
+);
+
 /**
  * Finalize a module and free any memory associated with it.
  *
@@ -1606,6 +1879,9 @@ typedef struct {
    */
   pwasm_vec_t insts;
 
+  pwasm_vec_t v128s; ///< v128 immediates
+  pwasm_vec_t blocks; ///< block metadata
+
   pwasm_vec_t tables; ///< Tables
   pwasm_vec_t mems; ///< Memories
   pwasm_vec_t funcs; ///< pwasm_func_ts
@@ -1619,6 +1895,12 @@ typedef struct {
 
   _Bool has_start; ///< does this module have a start function?
   uint32_t start; ///< start function ID
+
+  /**
+   * Source buffer referenced by byte slices instead of the `bytes`
+   * vector (see `PWASM_MOD_INIT_FLAG_NO_COPY`), or an empty buffer.
+   */
+  pwasm_buf_t src;
 } pwasm_builder_t;
 
 /**
@@ -1639,6 +1921,29 @@ _Bool pwasm_builder_init(
   pwasm_builder_t *builder
 );
 
+/**
+ * Reserve space in module builder for module source.
+ *
+ * Sizes the builder vectors from the section headers and the vector
+ * counts of the module in the source buffer `src`, so that parsing the
+ * module does not need to grow them one step at a time.  Sizes are
+ * estimates; the vectors still grow if they are too small.
+ *
+ * @ingroup mod
+ *
+ * @param[in]   builder Builder
+ * @param[in]   src     Module source
+ *
+ * @return `true` on success or `false` on error.
+ *
+ * @note The `pwasm_builder_*` functions are used internally by
+ * `pwasm_mod_init_unsafe()`; you shouldn't need to call them directly.
+ */
+_Bool pwasm_builder_reserve(
+  pwasm_builder_t *builder,
+  const pwasm_buf_t src
+);
+
 /**
  * Finalize a module builder.
  *
@@ -1693,6 +1998,26 @@ typedef struct {
    * used.
    */
   void (*on_error)(const char *, void *);
+
+  /**
+   * Called by `pwasm_mod_check()` with the value stack height at the
+   * base of each `block`, `loop`, and `if` instruction (optional).
+   *
+   * The first parameter is the offset of the block metadata in the
+   * `blocks` table of the module, and the second parameter is the
+   * height.  Called from worker threads by `pwasm_mod_check_parallel()`.
+   */
+  void (*on_block)(size_t, size_t, void *);
+
+  /**
+   * Called by `pwasm_mod_check()` with the maximum value stack height
+   * of each valid function body (optional).
+   *
+   * The first parameter is the offset of the function body in the
+   * `codes` table of the module, and the second parameter is the
+   * height.  Called from worker threads by `pwasm_mod_check_parallel()`.
+   */
+  void (*on_code)(size_t, size_t, void *);
 } pwasm_mod_check_cbs_t;
 
 /**
@@ -1723,6 +2048,125 @@ _Bool pwasm_mod_check(
   void *cb_data
 );
 
+/**
+ * Verify that a parsed module is valid, validating function bodies in
+ * parallel.
+ *
+ * Behaves like `pwasm_mod_check()`, except that function bodies are
+ * validated by a pool of `num_threads` threads, each with its own code
+ * checker.  Errors are reported for the first invalid function body
+ * in the module, so the reported error does not depend on thread
+ * scheduling.
+ *
+ * @note The memory context callbacks of the module must be
+ * thread-safe.
+ *
+ * @ingroup mod
+ *
+ * @param mod         Module
+ * @param cbs         Module validation callbacks (optional, may be NULL).
+ * @param cb_data     Validation callback user data (optional, may be NULL).
+ * @param num_threads Number of threads, or `0` to use one thread per
+ *                    online processor.
+ *
+ * @return `true` if the module validates, and `false` otherwise.
+ *
+ * @see pwasm_mod_check()
+ */
+_Bool pwasm_mod_check_parallel(
+  const pwasm_mod_t * const mod,
+  const pwasm_mod_check_cbs_t * const cbs,
+  void *cb_data,
+  const size_t num_threads
+);
+
+/**
+ * Streaming module loader.
+ *
+ * Streaming equivalent of `pwasm_mod_init()`.  Source bytes are parsed
+ * section by section as they are fed to the loader.  Once the code
+ * section has been parsed, function bodies are validated on a
+ * background thread while the remaining sections are fed.
+ *
+ * @ingroup mod
+ *
+ * @see pwasm_mod_stream_init()
+ * @see pwasm_mod_stream_feed()
+ * @see pwasm_mod_stream_finish()
+ */
+typedef struct {
+  pwasm_mem_ctx_t *mem_ctx; ///< memory context
+  void *data; ///< internal loader data
+} pwasm_mod_stream_t;
+
+/**
+ * Create streaming module loader.
+ *
+ * @note The memory context allocation callback must be thread-safe.
+ * Errors are always reported on the thread which calls
+ * `pwasm_mod_stream_feed()` or `pwasm_mod_stream_finish()`.
+ *
+ * @ingroup mod
+ *
+ * @param[out]  stream      Streaming module loader
+ * @param[in]   mem_ctx     Memory context
+ * @param[in]   num_threads Number of threads used to validate function
+ *                          bodies, or `0` to use one thread per online
+ *                          processor.
+ *
+ * @return `true` on success or `false` on error.
+ */
+_Bool pwasm_mod_stream_init(
+  pwasm_mod_stream_t *stream,
+  pwasm_mem_ctx_t *mem_ctx,
+  const size_t num_threads
+);
+
+/**
+ * Feed source bytes to streaming module loader.
+ *
+ * @ingroup mod
+ *
+ * @param stream  Streaming module loader
+ * @param src     Source bytes
+ *
+ * @return `true` on success or `false` on error.
+ */
+_Bool pwasm_mod_stream_feed(
+  pwasm_mod_stream_t *stream,
+  const pwasm_buf_t src
+);
+
+/**
+ * Finish streaming module loader and build module.
+ *
+ * Waits for function body validation, builds the module, and
+ * validates the remaining sections.  On success the module must be
+ * freed with `pwasm_mod_fini()`.
+ *
+ * @ingroup mod
+ *
+ * @param[in]   stream  Streaming module loader
+ * @param[out]  mod     Module
+ *
+ * @return Number of bytes consumed, or `0` on error.
+ *
+ * @see pwasm_mod_init()
+ */
+size_t pwasm_mod_stream_finish(
+  pwasm_mod_stream_t *stream,
+  pwasm_mod_t *mod
+);
+
+/**
+ * Finalize streaming module loader.
+ *
+ * @ingroup mod
+ *
+ * @param stream  Streaming module loader
+ */
+void pwasm_mod_stream_fini(pwasm_mod_stream_t *stream);
+
 /**
  * @defgroup env Execution Environment
  */
@@ -1833,6 +2277,68 @@ typedef struct {
   void (*fini)(
     pwasm_jit_t *jit // compiler
   );
+
+  /**
+   * Resize the backing buffer of a linear memory instance (optional).
+   *
+   * Called by execution environments to allocate (when the buffer
+   * pointer is `NULL`), grow, or free (when the buffer pointer is not
+   * `NULL` and `num_bytes` is zero) linear memory.  JIT compilers can use this callback to place linear
+   * memory at a stable address (e.g., a reservation with guard
+   * pages).
+   *
+   * If this callback is `NULL`, then execution environments allocate
+   * linear memory with `pwasm_realloc()`.
+   *
+   * @param[in]     jit       JIT compiler
+   * @param[in,out] mem       Memory instance
+   * @param[in]     num_bytes New size, in bytes.
+   *
+   * @return `true` on success or `false` on error.
+   */
+  _Bool (*mem_resize)(
+    pwasm_jit_t *jit, // compiler
+    pwasm_env_mem_t *mem, // memory instance
+    const size_t num_bytes // new size, in bytes
+  );
+
+  /**
+   * Load all compiled functions of a module from a code cache
+   * (optional).
+   *
+   * On success, `dst` is populated with one buffer for each function
+   * body in the module.
+   *
+   * @param[in]   jit       JIT compiler
+   * @param[out]  dst       Destination buffers
+   * @param[in]   env       Execution environment
+   * @param[in]   mod_id    Module instance handle
+   *
+   * @return `true` if the module was loaded from the cache, or `false`
+   * if the module was not found in the cache.
+   */
+  _Bool (*load_mod)(
+    pwasm_jit_t *jit, // compiler
+    pwasm_buf_t *dst, // destination buffers
+    pwasm_env_t *env, // env
+    const uint32_t mod_id // module instance handle
+  );
+
+  /**
+   * Save all compiled functions of a module to a code cache
+   * (optional).
+   *
+   * @param[in]   jit       JIT compiler
+   * @param[in]   fns       Compiled functions
+   * @param[in]   env       Execution environment
+   * @param[in]   mod_id    Module instance handle
+   */
+  void (*save_mod)(
+    pwasm_jit_t *jit, // compiler
+    const pwasm_buf_t *fns, // compiled functions
+    pwasm_env_t *env, // env
+    const uint32_t mod_id // module instance handle
+  );
 } pwasm_jit_cbs_t;
 
 /**
@@ -1846,26 +2352,67 @@ struct pwasm_jit_t {
 };
 
 /**
- * Compile function at offset `func_ofs` in module instance `mod_id` in
- * environment `env` using JIT compiler `cc`, and write the result to
- * destination buffer `dst`.
+ * Compile function at offset `func_ofs` in module instance `mod_id` in
+ * environment `env` using JIT compiler `cc`, and write the result to
+ * destination buffer `dst`.
+ *
+ * @param[in]   jit       JIT compiler
+ * @param[out]  dst       Destination buffer
+ * @param[in]   env       Execution environment
+ * @param[in]   mod_id    Module instance handle
+ * @param[in]   func_ofs  Function offset in module
+ *
+ * @return `true` on success or `false` on error.
+ *
+ * @ingroup jit
+ */
+_Bool pwasm_jit_compile(
+  pwasm_jit_t *jit, // JIT compiler
+  pwasm_buf_t *dst, // destination buffer
+  pwasm_env_t *env, // env
+  const uint32_t mod_id, // module instance handle
+  const size_t func_ofs // function offset
+);
+
+/**
+ * Load all compiled functions of module instance `mod_id` in
+ * environment `env` from the code cache of JIT compiler `jit`.
+ *
+ * @param[in]   jit       JIT compiler
+ * @param[out]  dst       Destination buffers (one per function body)
+ * @param[in]   env       Execution environment
+ * @param[in]   mod_id    Module instance handle
+ *
+ * @return `true` if the module was loaded from the cache, or `false`
+ * if the compiler has no code cache or the module was not found.
+ *
+ * @ingroup jit
+ */
+_Bool pwasm_jit_load_mod(
+  pwasm_jit_t *jit, // JIT compiler
+  pwasm_buf_t *dst, // destination buffers
+  pwasm_env_t *env, // env
+  const uint32_t mod_id // module instance handle
+);
+
+/**
+ * Save all compiled functions of module instance `mod_id` in
+ * environment `env` to the code cache of JIT compiler `jit`.
+ *
+ * Does nothing if the compiler does not have a code cache.
  *
  * @param[in]   jit       JIT compiler
- * @param[out]  dst       Destination buffer
+ * @param[in]   fns       Compiled functions (one per function body)
  * @param[in]   env       Execution environment
  * @param[in]   mod_id    Module instance handle
- * @param[in]   func_ofs  Function offset in module
- *
- * @return `true` on success or `false` on error.
  *
  * @ingroup jit
  */
-_Bool pwasm_jit_compile(
+void pwasm_jit_save_mod(
   pwasm_jit_t *jit, // JIT compiler
-  pwasm_buf_t *dst, // destination buffer
+  const pwasm_buf_t *fns, // compiled functions
   pwasm_env_t *env, // env
-  const uint32_t mod_id, // module instance handle
-  const size_t func_ofs // function offset
+  const uint32_t mod_id // module instance handle
 );
 
 /**
@@ -2037,6 +2584,40 @@ struct pwasm_native_t {
   const pwasm_native_table_t * const tables; ///< Tables
 };
 
+/**
+ * Snapshot flag: save memory contents to copy-on-write memory images.
+ *
+ * Save the contents of each memory to an anonymous in-memory file
+ * (`memfd_create()`) instead of the snapshot arena.  Restoring the
+ * snapshot maps the image over the memory with a private (copy-on-write)
+ * mapping instead of copying it, so resetting an instance only touches
+ * the pages that were written since the previous restore.
+ *
+ * Only supported by the interpreter environment on Linux; ignored
+ * otherwise.
+ *
+ * @ingroup env-low
+ *
+ * @see pwasm_env_snapshot_mod_with_flags()
+ */
+#define PWASM_ENV_SNAPSHOT_FLAG_MEMFD (1 << 0)
+
+/**
+ * Module instance snapshot.
+ *
+ * Saved contents of the memories, globals, and tables defined by a
+ * module instance.  Created by `pwasm_env_snapshot_mod()`, applied to
+ * instances of the same module by `pwasm_env_restore_mod()`, and freed
+ * by `pwasm_env_snapshot_fini()`.
+ *
+ * @ingroup env-low
+ */
+typedef struct {
+  pwasm_arena_t arena; ///< backing memory for saved state
+  uint64_t flags; ///< snapshot flags
+  const void *data; ///< saved state (internal)
+} pwasm_env_snapshot_t;
+
 /**
  * Execution environment interface.
  *
@@ -2472,6 +3053,21 @@ typedef struct {
     const uint32_t table_ofs // table index in module
   );
 
+  /**
+   * Map module memory index to environment memory handle.
+   *
+   * @param[in]   env         Execution environment
+   * @param[in]   mod_id      Module instance handle
+   * @param[in]   mem_ofs     Memory offset in module
+   *
+   * @return Memory handle, or `0` on error.
+   */
+  uint32_t (*get_mem_index)(
+    pwasm_env_t *env, // env
+    const uint32_t mod_id, // module instance handle
+    const uint32_t mem_ofs // memory index in module
+  );
+
   /**
    * Call function within module instance.
    *
@@ -2487,7 +3083,140 @@ typedef struct {
     const uint32_t func_ofs // global index in module
   );
 
+  /**
+   * Get direct call slot of module function (optional).
+   *
+   * Returns a pointer to the slot which holds the direct entry point
+   * of the compiled function at offset `func_ofs` in module instance
+   * `mod_id`.  JIT compilers store the direct entry point of each
+   * function in its slot after compiling it, and emit direct calls
+   * through the slot for calls between functions in the same module.
+   *
+   * Slots are `NULL` until the corresponding function is compiled.
+   *
+   * @param[in]   env         Execution environment
+   * @param[in]   mod_id      Module instance handle
+   * @param[in]   func_ofs    Function offset in module
+   *
+   * @return Pointer to slot, or `NULL` if direct calls are not
+   * supported.
+   */
+  void **(*get_call_slot)(
+    pwasm_env_t *env, // env
+    const uint32_t mod_id, // module instance handle
+    const uint32_t func_ofs // function offset in module
+  );
+
+  /**
+   * Save state of module instance (optional).
+   *
+   * Save the contents of the memories, globals, and tables defined by
+   * module instance `mod_id` to `snap`.  Imported items are not saved.
+   *
+   * @param[in]   env     Execution environment
+   * @param[in]   mod_id  Module instance handle
+   * @param[out]  snap    Destination snapshot
+   *
+   * @return `true` on success or `false` on error.
+   *
+   * @note This callback implements `pwasm_env_snapshot_mod()`.
+   */
+  _Bool (*snapshot_mod)(
+    pwasm_env_t *env, // env
+    const uint32_t mod_id, // module instance handle
+    pwasm_env_snapshot_t *snap // destination snapshot
+  );
+
+  /**
+   * Restore state of module instance from snapshot (optional).
+   *
+   * Reset the memories, globals, and tables defined by module instance
+   * `mod_id` to the state saved in `snap`.  The snapshot must have been
+   * taken from an instance of the same module.  Imports, element and
+   * data segments, and the start function are not processed again.
+   *
+   * @param[in]   env     Execution environment
+   * @param[in]   mod_id  Module instance handle
+   * @param[in]   snap    Snapshot
+   *
+   * @return `true` on success or `false` on error.
+   *
+   * @note This callback implements `pwasm_env_restore_mod()`.
+   */
+  _Bool (*restore_mod)(
+    pwasm_env_t *env, // env
+    const uint32_t mod_id, // module instance handle
+    const pwasm_env_snapshot_t *snap // snapshot
+  );
+
+  /**
+   * Call table element indirectly (optional).
+   *
+   * Check that element `elem_ofs` of table `table_id` is set and that
+   * its function type matches function type `type_ofs` of module
+   * instance `mod_id`, then call the function.  Environments which
+   * assign canonical IDs to function types can check the type with a
+   * single comparison.
+   *
+   * @param[in]   env       Execution environment
+   * @param[in]   mod_id    Module instance handle of caller
+   * @param[in]   table_id  Table handle
+   * @param[in]   type_ofs  Function type index in caller module
+   * @param[in]   elem_ofs  Element offset
+   *
+   * @return `true` on success or `false` on error.
+   *
+   * @note This callback implements `pwasm_env_call_indirect()`.
+   */
+  _Bool (*call_indirect)(
+    pwasm_env_t *env, // env
+    const uint32_t mod_id, // module instance handle
+    const uint32_t table_id, // table handle
+    const uint32_t type_ofs, // function type index in module
+    const uint32_t elem_ofs // element offset
+  );
+
   pwasm_jit_t *jit; ///< JIT compiler
+
+  /**
+   * JIT tier-up threshold.
+   *
+   * Number of calls and loop iterations after which a function is
+   * compiled by the JIT compiler.  In tiered environments, functions
+   * are interpreted until they cross the threshold; a threshold of
+   * `1` compiles each function on its first call.  If this value is
+   * zero, then functions are never compiled.  AOT JIT environments
+   * ignore this value and compile all functions when a module is
+   * added.
+   *
+   * @see pwasm_tiered_jit_get_cbs()
+   * @see pwasm_lazy_jit_get_cbs()
+   */
+  uint32_t jit_threshold;
+
+  /**
+   * Number of threads used to compile module functions when a module
+   * is added.
+   *
+   * Only used by AOT JIT environments.  If this value is zero or
+   * one, then functions are compiled on the calling thread.  Otherwise
+   * the `compile` callback of the JIT compiler and the callbacks of
+   * the memory context must be thread-safe.
+   *
+   * @see pwasm_parallel_jit_get_cbs()
+   */
+  size_t jit_threads;
+
+  /**
+   * Maximum call depth of an interpreter environment.
+   *
+   * Calls which would exceed this depth fail with an error instead of
+   * exhausting the stack of the host thread.  If this value is zero,
+   * then `PWASM_DEFAULT_MAX_CALL_DEPTH` is used.
+   *
+   * @see pwasm_new_interpreter_get_cbs_with_max_depth()
+   */
+  size_t max_call_depth;
 } pwasm_env_cbs_t;
 
 /**
@@ -2501,6 +3230,7 @@ struct pwasm_env_t {
   pwasm_stack_t *stack;       ///< stack pointer
   void *env_data;             ///< internal environment data
   void *user_data;            ///< user data
+  size_t call_depth;          ///< depth of calls into compiled code
 };
 
 /**
@@ -2643,6 +3373,22 @@ const pwasm_buf_t *pwasm_env_get_mod_name(
   const uint32_t mod_id
 );
 
+/**
+ * Get the maximum call depth of an execution environment.
+ *
+ * Returns the `max_call_depth` field of the environment callbacks, or
+ * `PWASM_DEFAULT_MAX_CALL_DEPTH` if it is zero.
+ *
+ * @ingroup env-low
+ *
+ * @param env     Execution environment
+ *
+ * @return Maximum call depth.
+ */
+size_t pwasm_env_get_max_call_depth(
+  const pwasm_env_t *env
+);
+
 /**
  * Find module and return handle.
  *
@@ -2956,6 +3702,31 @@ _Bool pwasm_env_get_elem(
   uint32_t * const ret     ///< Return value
 );
 
+/**
+ * Call table element indirectly.
+ *
+ * Check that element `elem_ofs` of table `table_id` is set and that
+ * its function type matches function type `type_ofs` of module
+ * instance `mod_id`, then call the function.
+ *
+ * @ingroup env-low
+ *
+ * @param[in]   env       Execution environment
+ * @param[in]   mod_id    Module handle of caller
+ * @param[in]   table_id  Table handle
+ * @param[in]   type_ofs  Function type index in caller module
+ * @param[in]   elem_ofs  Element offset in table
+ *
+ * @return `true` on success, or `false` on error.
+ */
+_Bool pwasm_env_call_indirect(
+  pwasm_env_t * const env,  ///< Execution environment
+  const uint32_t mod_id,    ///< Module handle of caller
+  const uint32_t table_id,  ///< Table handle
+  const uint32_t type_ofs,  ///< Function type index in caller module
+  const uint32_t elem_ofs   ///< Element offset in table
+);
+
 /**
  * Get table handle from module handle and table offset.
  *
@@ -2973,6 +3744,134 @@ uint32_t pwasm_env_get_table_index(
   const uint32_t table_ofs  ///< Table offset in module
 );
 
+/**
+ * Get memory handle from module handle and memory offset.
+ *
+ * @ingroup env-low
+ *
+ * @param[in]   env       Execution environment
+ * @param[in]   mod_id    Module handle
+ * @param[in]   mem_ofs   Memory offset in module
+ *
+ * @return Memory handle on success, or `0` on error.
+ */
+uint32_t pwasm_env_get_mem_index(
+  pwasm_env_t * const env,  ///< Execution environment
+  const uint32_t mod_id,    ///< Module handle
+  const uint32_t mem_ofs    ///< Memory offset in module
+);
+
+/**
+ * Get direct call slot from module handle and function offset.
+ *
+ * @ingroup env-low
+ *
+ * @param[in]   env       Execution environment
+ * @param[in]   mod_id    Module handle
+ * @param[in]   func_ofs  Function offset in module
+ *
+ * @return Pointer to direct call slot, or `NULL` if the execution
+ * environment does not support direct calls.
+ *
+ * @see pwasm_env_cbs_t
+ */
+void **pwasm_env_get_call_slot(
+  pwasm_env_t * const env,  ///< Execution environment
+  const uint32_t mod_id,    ///< Module handle
+  const uint32_t func_ofs   ///< Function offset in module
+);
+
+/**
+ * Save state of module instance.
+ *
+ * Save the contents of the memories, globals, and tables defined by
+ * module instance `mod_id`, typically immediately after the module was
+ * added with `pwasm_env_add_mod()`.
+ *
+ * Use `pwasm_env_restore_mod()` to reset an instance of the same
+ * module to the saved state without re-running imports, element and
+ * data segment initialization, or the start function, and use
+ * `pwasm_env_snapshot_fini()` to free the snapshot.
+ *
+ * @ingroup env-low
+ *
+ * @param[in]   env     Execution environment
+ * @param[in]   mod_id  Module handle
+ * @param[out]  snap    Destination snapshot
+ *
+ * @return `true` on success, or `false` on error or if the execution
+ * environment does not support snapshots.
+ *
+ * @see pwasm_env_restore_mod()
+ */
+_Bool pwasm_env_snapshot_mod(
+  pwasm_env_t * const env,          ///< Execution environment
+  const uint32_t mod_id,            ///< Module handle
+  pwasm_env_snapshot_t * const snap ///< Destination snapshot
+);
+
+/**
+ * Save state of module instance with flags.
+ *
+ * Equivalent to `pwasm_env_snapshot_mod()`, with `flags` stored in the
+ * `flags` field of the snapshot for the environment callback.
+ *
+ * @ingroup env-low
+ *
+ * @param[in]   env     Execution environment
+ * @param[in]   mod_id  Module handle
+ * @param[out]  snap    Destination snapshot
+ * @param[in]   flags   Snapshot flags
+ *
+ * @return `true` on success, or `false` on error or if the execution
+ * environment does not support snapshots.
+ *
+ * @see pwasm_env_snapshot_mod()
+ * @see PWASM_ENV_SNAPSHOT_FLAG_MEMFD
+ */
+_Bool pwasm_env_snapshot_mod_with_flags(
+  pwasm_env_t * const env,            ///< Execution environment
+  const uint32_t mod_id,              ///< Module handle
+  pwasm_env_snapshot_t * const snap,  ///< Destination snapshot
+  const uint64_t flags                ///< Snapshot flags
+);
+
+/**
+ * Restore state of module instance from snapshot.
+ *
+ * Reset the memories, globals, and tables defined by module instance
+ * `mod_id` to the state saved by `pwasm_env_snapshot_mod()`.  The
+ * snapshot must have been taken from an instance of the same module in
+ * the same execution environment.
+ *
+ * @ingroup env-low
+ *
+ * @param[in] env     Execution environment
+ * @param[in] mod_id  Module handle
+ * @param[in] snap    Snapshot
+ *
+ * @return `true` on success, or `false` on error or if the execution
+ * environment does not support snapshots.
+ *
+ * @see pwasm_env_snapshot_mod()
+ */
+_Bool pwasm_env_restore_mod(
+  pwasm_env_t * const env,                ///< Execution environment
+  const uint32_t mod_id,                  ///< Module handle
+  const pwasm_env_snapshot_t * const snap ///< Snapshot
+);
+
+/**
+ * Free snapshot created by `pwasm_env_snapshot_mod()`.
+ *
+ * @ingroup env-low
+ *
+ * @param[in] snap Snapshot
+ */
+void pwasm_env_snapshot_fini(
+  pwasm_env_snapshot_t * const snap ///< Snapshot
+);
+
 /**
  * Get handle to import.
  *
@@ -3182,6 +4081,38 @@ _Bool pwasm_call(
  */
 const pwasm_env_cbs_t *pwasm_new_interpreter_get_cbs(void);
 
+/**
+ * Default maximum call depth for interpreter environments.
+ *
+ * @ingroup interp
+ *
+ * @see pwasm_new_interpreter_get_cbs_with_max_depth()
+ */
+#define PWASM_DEFAULT_MAX_CALL_DEPTH 65536
+
+/**
+ * Get callbacks for interpreter environment with a maximum call depth.
+ *
+ * Populate environment callbacks for an interpreter environment which
+ * limits the depth of nested calls to `max_depth`.  The interpreter
+ * keeps call frames on the heap rather than the stack of the host
+ * thread, so deeply recursive modules fail with an error when they
+ * exceed the limit instead of crashing the host.
+ *
+ * @ingroup interp
+ *
+ * @param[out]  cbs       Pointer to execution environment callbacks.
+ * @param[in]   max_depth Maximum call depth, or `0` to use
+ * `PWASM_DEFAULT_MAX_CALL_DEPTH`.
+ *
+ * @see pwasm_env_init()
+ * @see pwasm_new_interpreter_get_cbs()
+ */
+void pwasm_new_interpreter_get_cbs_with_max_depth(
+  pwasm_env_cbs_t * const cbs,
+  const size_t max_depth
+);
+
 /**
  * Get AOT JIT environment callbacks.
  *
@@ -3200,6 +4131,94 @@ void pwasm_aot_jit_get_cbs(
   pwasm_jit_t * const jit
 );
 
+/**
+ * Default tier-up threshold for tiered JIT environments.
+ *
+ * @ingroup jit
+ *
+ * @see pwasm_tiered_jit_get_cbs()
+ */
+#define PWASM_TIERED_JIT_DEFAULT_THRESHOLD 1000
+
+/**
+ * Get tiered JIT environment callbacks.
+ *
+ * Populate environment variable callbacks for a tiered environment.
+ * Functions in a tiered environment start out in the interpreter (see
+ * `pwasm_new_interpreter_get_cbs()`).  The environment counts calls
+ * and loop back-edges for each function, and functions which reach
+ * `threshold` are compiled with the JIT compiler on their next call.
+ * Compiled functions are called directly by other compiled functions
+ * in the same module.
+ *
+ * Snapshots of tiered environments do not use memory images
+ * (`PWASM_ENV_SNAPSHOT_FLAG_MEMFD`), because compiled code may refer
+ * to the address of a memory.
+ *
+ * @ingroup jit
+ *
+ * @param[out]  cbs       Pointer to execution environment callbacks.
+ * @param[in]   jit       Pointer to JIT compiler.
+ * @param[in]   threshold Tier-up threshold, or `0` to use
+ * `PWASM_TIERED_JIT_DEFAULT_THRESHOLD`.
+ *
+ * @see pwasm_env_init()
+ */
+void pwasm_tiered_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit,
+  const uint32_t threshold
+);
+
+/**
+ * Get lazy JIT environment callbacks.
+ *
+ * Populate environment variable callbacks for a lazy JIT environment.
+ * Functions in a lazy environment are not compiled when a module is
+ * added; each function is compiled the first time it is called.  This
+ * is equivalent to a tiered environment with a threshold of `1`.
+ *
+ * @ingroup jit
+ *
+ * @param[out]  cbs Pointer to execution environment callbacks.
+ * @param[in]   jit Pointer to JIT compiler.
+ *
+ * @see pwasm_env_init()
+ * @see pwasm_tiered_jit_get_cbs()
+ */
+void pwasm_lazy_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit
+);
+
+/**
+ * Get parallel AOT JIT environment callbacks.
+ *
+ * Populate environment variable callbacks for an AOT JIT environment
+ * which compiles the functions of each added module on `num_threads`
+ * threads.  If a function fails to compile, then the error for the
+ * first failed function is reported, as in the single-threaded case.
+ *
+ * The compile callback of the JIT compiler and the callbacks of the
+ * memory context must be thread-safe.  The DynASM JIT compiler is
+ * thread-safe.
+ *
+ * @ingroup jit
+ *
+ * @param[out]  cbs         Pointer to execution environment callbacks.
+ * @param[in]   jit         Pointer to JIT compiler.
+ * @param[in]   num_threads Number of compiler threads, or `0` to use
+ * one thread per online processor.
+ *
+ * @see pwasm_env_init()
+ * @see pwasm_aot_jit_get_cbs()
+ */
+void pwasm_parallel_jit_get_cbs(
+  pwasm_env_cbs_t * const cbs,
+  pwasm_jit_t * const jit,
+  const size_t num_threads
+);
+
 #ifdef __cplusplus
 };
 #endif /* __cplusplus */